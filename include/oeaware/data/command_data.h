@@ -27,6 +27,37 @@ typedef struct {
     char *itemAttr[ATTR_MAX_LENGTH];
     CommandIter *items;
 } CommandData;
+
+typedef enum {
+    COMMAND_COLUMN_NUMERIC,
+    COMMAND_COLUMN_TEXT,
+} CommandColumnType;
+
+typedef enum {
+    COMMAND_SOURCE_EXEC,      // parsed from the output of the sysstat command
+    COMMAND_SOURCE_NATIVE,    // computed in process from /proc
+} CommandSource;
+
+/*
+ * Column-major typed table of one output section, published by the "<command>_typed" topics.
+ * The header (colNames/colTypes) is sent once per publication, schemaId only changes when the header changes,
+ * so consumers can resolve column indexes once and reuse them.
+ * values[col * rowLen + row] is the numeric cell, NAN for text columns or unparsable cells.
+ * textOffset[col * rowLen + row] is the offset of the text cell in textPool, -1 for numeric columns.
+ */
+typedef struct {
+    unsigned long long schemaId;
+    int source;
+    int intervalMs;             // measurement interval of the rows, 0 if unknown
+    int colLen;
+    int rowLen;
+    char **colNames;
+    int *colTypes;
+    double *values;
+    int *textOffset;
+    int textPoolLen;
+    char *textPool;
+} CommandTypedData;
 #ifdef __cplusplus
 }
 #endif
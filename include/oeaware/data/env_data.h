@@ -60,6 +60,8 @@ typedef enum {
     CPU_UTIL_TYPE_MAX,
 } EnvCpuUtilType;
 
+#define ENV_CACHE_LINE_SIZE 64
+
 typedef struct {
     int dataReady;
     int cpuNumConfig;
@@ -67,10 +69,56 @@ typedef struct {
      * (cpuNumConfig + 1) * CPU_UTIL_TYPE_MAX
      *  times[1][CPU_USER] / times[1][CPU_TIME_SUM] is cpu1 user util
      *  times[cpuNumConfig][CPU_USER] / times[cpuNumConfig][CPU_TIME_SUM] is system user util
+     * the rows point into matrix.
      */
     uint64_t **times;
+    /*
+     * contiguous [cpu][type] matrix aligned to ENV_CACHE_LINE_SIZE, allocated by posix_memalign,
+     * matrix[cpu * CPU_UTIL_TYPE_MAX + type] == times[cpu][type]
+     */
+    uint64_t *matrix;
+    /*
+     * rollups, [index * CPU_UTIL_TYPE_MAX + type] is the sum of the cpus in that numa node/cluster/core.
+     * cpu2Cluster and cpu2Core are cpuNumConfig long, -1 means the cpu does not belong to any of them.
+     */
+    int numaNum;
+    uint64_t *nodeTimes;
+    int clusterNum;           // 0 if the system has no cluster
+    int *cpu2Cluster;         // same as Topology, cluster = cpu / cpus of one cluster
+    uint64_t *clusterTimes;
+    int coreNum;              // physical cores, the SMT siblings of a core are rolled up together
+    int *cpu2Core;
+    uint64_t *coreTimes;
+    /*
+     * EWMA of times[cpu][type] / times[cpu][CPU_TIME_SUM], (cpuNumConfig + 1) * CPU_UTIL_TYPE_MAX.
+     * ewmaWindow is the number of periods, ewmaUtil is null if ewmaWindow is 0.
+     */
+    int ewmaWindow;
+    double *ewmaUtil;
 } EnvCpuUtilParam;
 
+typedef enum {
+    CPU_HR_BUSY,     // task time, user and system are not split
+    CPU_HR_IDLE,
+    CPU_HR_IRQ,
+    CPU_HR_SOFTIRQ,
+    CPU_HR_TIME_SUM, // sum of all above
+    CPU_HR_TYPE_MAX,
+} EnvCpuUtilHrType;
+
+// env_info_hr_collector::cpu_util_hr, accounted by eBPF from sched_switch and irq tracepoints
+typedef struct {
+    int dataReady;
+    int cpuNumConfig;
+    uint64_t intervalNs;      // time between the two reads
+    /*
+     * (cpuNumConfig + 1) * CPU_HR_TYPE_MAX, nanoseconds spent in the interval
+     *  times[1 * CPU_HR_TYPE_MAX + CPU_HR_BUSY] / times[1 * CPU_HR_TYPE_MAX + CPU_HR_TIME_SUM] is cpu1 busy util
+     *  the row cpuNumConfig is the system
+     */
+    uint64_t *times;
+} EnvCpuUtilHrParam;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,47 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2024-2024. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef OEAWARE_DATA_HOT_FUNCTION_DATA_H
+#define OEAWARE_DATA_HOT_FUNCTION_DATA_H
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef enum {
+    HOT_FUNCTION_SELF,       // functions ranked by the samples they are on top of the stack
+    HOT_FUNCTION_PATH,       // folded call paths "root;...;leaf" ranked by samples
+    HOT_FUNCTION_REGRESSION  // functions ranked by the growth against the previous window
+} HotFunctionType;
+
+typedef struct {
+    int type; // HotFunctionType
+    char *group; // "<comm>:<pid>", or the container id when grouped by container
+    char *name;
+    uint64_t samples;
+    int64_t delta; // samples - samples of the previous window
+} HotFunctionItem;
+
+/*
+ * Top-N hot functions and call paths of one window of hot_function_analysis.
+ * truncated counts the samples that were folded into a shorter path because the profile reached its size limit.
+ */
+typedef struct {
+    uint64_t windowMs;
+    uint64_t samples;
+    uint64_t truncated;
+    int len;
+    HotFunctionItem *items;
+} HotFunctionData;
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,48 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef OE_MULTI_NET_PATH_DATA
+#define OE_MULTI_NET_PATH_DATA
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MULTI_NET_PATH_COMM_LEN 16
+
+/*
+ * multi_net_path_tune::queue_locality, published every period while open.
+ * The packets are those of the last period on the tuned devices, local ones arrive on queues whose irqs are
+ * bound to the home node of the app.
+ */
+#define OE_TOPIC_MULTI_NET_PATH_LOCALITY "queue_locality"
+typedef struct {
+    int pid;
+    char comm[MULTI_NET_PATH_COMM_LEN];
+    int node;               // home node, the node the app runs on most, -1 if not known yet
+    int queues;             // queues of the tuned devices bound to the home node
+    uint64_t rxPackets;
+    uint64_t localPackets;
+    float locality;         // localPackets / rxPackets, 0 without packets
+} MultiNetPathAppLocality;
+
+typedef struct {
+    uint64_t intervalMs;
+    int count;
+    MultiNetPathAppLocality *apps;
+} MultiNetPathLocalityList;
+
+#ifdef __cplusplus
+}
+#endif
+#endif
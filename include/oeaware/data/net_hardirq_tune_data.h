@@ -13,6 +13,9 @@
 #ifndef OE_NET_HIRQ_TUNE_DATA
 #define OE_NET_HIRQ_TUNE_DATA
 
+#include <stdint.h>
+#include <net/if.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -22,6 +25,47 @@ typedef struct {
     char *log;
 } NetHirqTuneDebugInfo;
 
+/*
+ * net_hirq_analysis::net_hirq_queue_stat, published every period while open.
+ * Rates are rx packets per second from net:napi_gro_receive_entry, the statistics are over the per period
+ * rates kept in a ring of the last windowLen periods.
+ */
+#define OE_TOPIC_NET_HIRQ_QUEUE_STAT "net_hirq_queue_stat"
+#define OE_NET_HIRQ_STAT_WINDOW 60
+typedef struct {
+    float rate;         // last period
+    float mean;
+    float p50;
+    float p95;
+    float p99;
+    float burstiness;   // coefficient of variation, stddev / mean
+} NetHirqRateStat;
+
+struct NetHirqQueueStat {
+    char dev[IFNAMSIZ];
+    int queueId;
+    NetHirqRateStat stat;
+    int rssWeight;      // suggested `ethtool -X <dev> weight` of the queue, 0 means no change
+};
+
+struct NetHirqDevStat {
+    char dev[IFNAMSIZ];
+    int rxQueues;       // rx queues of the device
+    int activeQueues;   // queues with packets in the window
+    NetHirqRateStat stat;
+    float gini;         // imbalance of the queue mean rates, 0 balanced, close to 1 one queue takes all
+    int suggestQueues;  // suggested `ethtool -L <dev> combined`, 0 means no change
+};
+
+typedef struct {
+    uint64_t intervalMs;
+    int windowLen;      // periods in the ring now
+    int devCount;
+    struct NetHirqDevStat *dev;
+    int queueCount;
+    struct NetHirqQueueStat *queue;
+} NetHirqStatList;
+
 #ifdef __cplusplus
 }
 #endif
@@ -105,6 +105,32 @@ typedef struct {
     struct NetThreadQueData *queData;
 } NetThreadQueDataList;
 
+// topic
+#define OE_NET_FLOW_LATENCY "net_flow_latency"
+// params of net_flow_latency
+#define OE_PARA_NET_LATENCY_USER_DEBUG "net_flow_latency_usr_debug"
+#define OE_PARA_PID_LATENCY "pid_latency"
+#define OE_NET_LATENCY_SLOTS 32
+#define OE_NET_LATENCY_COMM_LEN 16
+/*
+* tcp latency of every process in the last period, ipv4 and ipv6
+* log2 histograms in us, slot 0 counts [0, 2), slot i counts [2^i, 2^(i+1)), the last slot has no upper bound
+* rtt and retransmits are counted for the process which last sent or received on the socket
+*/
+struct NetFlowLatencyData {
+    uint32_t pid;
+    char comm[OE_NET_LATENCY_COMM_LEN];
+    uint64_t retrans;                           // retransmitted segments
+    uint64_t rttUs[OE_NET_LATENCY_SLOTS];       // smoothed rtt, one sample per received segment
+    uint64_t rcvQueUs[OE_NET_LATENCY_SLOTS];    // time from a segment being queued to the socket to being read
+};
+
+typedef struct {
+    uint64_t intervalMs;
+    int count;
+    struct NetFlowLatencyData *latency;
+} NetFlowLatencyDataList;
+
 #ifdef __cplusplus
 }
 #endif
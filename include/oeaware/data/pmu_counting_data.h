@@ -21,7 +21,20 @@ typedef struct {
     struct PmuData *pmuData;
     int len;
     uint64_t interval;
+    // 1 if the counts are estimated without a supported PMU, see pmu_counting_collector.
+    int approximate;
 } PmuCountingData;
+
+/*
+ * Derived metric of pmu_counting_collector, such as ipc. All operands come from one read of the counting group.
+ * values[cpu] is the metric of every cpu, total is computed from the operands summed over all cpus.
+ */
+typedef struct {
+    int len;
+    double *values;
+    double total;
+    uint64_t intervalNs;
+} PmuDerivedData;
 #ifdef __cplusplus
 }
 #endif
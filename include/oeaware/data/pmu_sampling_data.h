@@ -21,6 +21,11 @@ typedef struct {
     struct PmuData *pmuData;
     int len;
     uint64_t interval;
+    // effective sample period of the records, the sample frequency in Hz if useFreq is set.
+    uint64_t period;
+    int useFreq;
+    // period / default period, the collector raises it to stay in its overhead budget.
+    int scale;
 } PmuSamplingData;
 #ifdef __cplusplus
 }
@@ -0,0 +1,41 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2024-2024. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef OEAWARE_DATA_PMU_SNAPSHOT_DATA_H
+#define OEAWARE_DATA_PMU_SNAPSHOT_DATA_H
+#include <libkperf/pmu.h>
+#include "pmu_uncore_data.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/*
+ * Core, uncore (hha) and l3c counts read back-to-back in one period.
+ * All counts cover the same window [startTs, endTs], CLOCK_MONOTONIC in ns.
+ * Core counts are scaled by time_enabled / time_running.
+ */
+typedef struct {
+    uint64_t startTs;
+    uint64_t endTs;
+    struct PmuData *coreData;
+    int coreLen;
+    struct PmuData *uncoreData;
+    int uncoreLen;
+    struct PmuData *l3cData;
+    int l3cLen;
+    // uncore and l3c counts by location, nullptr if the topic has no uncore events.
+    UncoreTopoData *uncoreTopo;
+} PmuSnapshotData;
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -22,6 +22,30 @@ typedef struct {
     int len;
     uint64_t interval;
 } PmuSpeData;
+
+// Quantiles of the spe latency: p50, p90, p99 and max.
+#define PMU_SPE_LAT_QUANTILE_NUM 4
+
+// Access count of a thread from the node of its cpu to the node of the page.
+typedef struct {
+    int pid;
+    int tid;
+    int cpuNode;
+    int memNode;
+    uint64_t count;
+} PmuSpeAccess;
+
+// Post-processed spe records of one period, published by the "spe_access" topic.
+typedef struct {
+    PmuSpeAccess *access;
+    int len;
+    uint64_t interval;
+    // records counted in access and records whose page node could not be resolved.
+    uint64_t records;
+    uint64_t unresolved;
+    // cycles between issue and completion of the counted records.
+    uint32_t latQuantiles[PMU_SPE_LAT_QUANTILE_NUM];
+} PmuSpeAccessData;
 #ifdef __cplusplus
 }
 #endif
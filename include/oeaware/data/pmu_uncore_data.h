@@ -23,6 +23,49 @@ typedef struct {
     uint64_t interval;
 } PmuUncoreData;
 
+// Location of one hha or l3c device, "hisi_sccl<dieId>_hha<index>", socket and node of the cpus of its die.
+typedef struct {
+    int socketId;
+    int dieId;
+    int index;
+    int numaId;
+} UncoreLocation;
+
+typedef struct {
+    UncoreLocation loc;
+    char *evt; // event without the device, e.g. "rx_outer"
+    uint64_t count;
+} UncoreRecord;
+
+// Rates of one numa node, summed over the hha and l3c devices of the node.
+typedef struct {
+    int numaId;
+    int socketId;
+    double opsRate; // rx_ops_num per second
+    double bandwidth; // bytes per second, opsRate * UNCORE_OP_BYTES
+    double remoteRatio; // (rx_outer + rx_sccl) / rx_ops_num, requests from other dies and sockets
+    double l3cHitRate; // l3c_hit per second
+} UncoreNodeStat;
+
+#define UNCORE_OP_BYTES 64
+
+/*
+ * Uncore counts keyed by (socket, die, index, event) with a topology header and per-node series.
+ * Published by pmu_uncore_collector::uncore_node, pmu_l3c_collector::l3c_node and with pmu_snapshot_collector.
+ */
+typedef struct {
+    uint64_t intervalNs;
+    int socketNum;
+    int dieNum;
+    int nodeNum;
+    int hhaNum;
+    int l3cNum;
+    UncoreRecord *records;
+    int len;
+    UncoreNodeStat *nodes;
+    int nodeLen;
+} UncoreTopoData;
+
 #ifdef __cplusplus
 }
 #endif
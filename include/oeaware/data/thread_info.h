@@ -14,11 +14,38 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
+#include <stdint.h>
+
+#define THREAD_SCHED_NAME_LEN 16
+
 typedef struct {
     int pid;
     int tid;
     char *name;
 } ThreadInfo;
+
+/*
+ * thread_collector::thread_sched_stat, fixed width so that the array is serialized as a whole.
+ * The counters are the deltas since the last publication of the thread, intervalNs is 0 for a new thread.
+ */
+typedef struct {
+    int pid;
+    int tid;
+    char name[THREAD_SCHED_NAME_LEN];
+    uint64_t intervalNs;
+    uint64_t runTime;              // ns on cpu
+    uint64_t waitTime;             // ns waiting on a run queue
+    uint64_t voluntarySwitches;
+    uint64_t involuntarySwitches;
+    uint64_t migrations;           // 0 if the kernel does not provide /proc/<pid>/task/<tid>/sched
+    int cpu;                       // last cpu
+    int node;                      // numa node of the last cpu
+} ThreadSchedStat;
+
+typedef struct {
+    int len;
+    ThreadSchedStat *stats;
+} ThreadSchedStatList;
 #ifdef __cplusplus
 }
 #endif
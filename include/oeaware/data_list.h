@@ -17,6 +17,7 @@
 #define OE_PMU_SPE_COLLECTOR         "pmu_spe_collector"
 #define OE_PMU_UNCORE_COLLECTOR      "pmu_uncore_collector"
 #define OE_PMU_L3C_COLLECTOR         "pmu_l3c_collector"
+#define OE_PMU_SNAPSHOT_COLLECTOR    "pmu_snapshot_collector"
 #define OE_DOCKER_COLLECTOR          "docker_collector"
 #define OE_KERNEL_CONFIG_COLLECTOR   "kernel_config"
 #define OE_THREAD_COLLECTOR          "thread_collector"
@@ -34,7 +35,9 @@
 #define OE_NUMA_ANALYSIS             "numa_analysis"
 #define OE_DOCKER_COORDINATION_BURST_ANALYSIS         "docker_coordination_burst_analysis"
 #define OE_MICRO_ARCH_TIDNOCMP_ANALYSIS   "microarch_tidnocmp_analysis"
+#define OE_HOT_FUNCTION_ANALYSIS     "hot_function_analysis"
 #define OE_ENV_INFO                  "env_info_collector"
+#define OE_ENV_INFO_HR               "env_info_hr_collector"
 #define OE_NET_INTF_INFO             "net_interface_info"
 #define OE_UNIXBENCH_TUNE            "unixbench_tune"
 #define OE_DOCKER_CPU_BURST_TUNE     "docker_cpu_burst"
@@ -50,6 +53,8 @@
 #define OE_XCALL_TUNE                "xcall_tune"
 #define OE_NETHARDIRQ_TUNE           "net_hard_irq_tune"
 #define OE_MULTI_NET_PATH_TUNE       "multi_net_path_tune"
+#define OE_NET_COALESCE_TUNE         "net_coalesce_tune"
+#define OE_NET_AFFINITY_TUNE         "net_affinity_tune"
 #define OE_TRANSPARENT_HUGEPAGE_TUNE "transparent_hugepage_tune"
 #define OE_PRELOAD_TUNE              "preload_tune"
 #define OE_NUMA_SCHED_TUNE           "numa_sched_tune"
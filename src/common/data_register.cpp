@@ -6,15 +6,18 @@
 #include "oeaware/data/pmu_sampling_data.h"
 #include "oeaware/data/pmu_spe_data.h"
 #include "oeaware/data/pmu_uncore_data.h"
+#include "oeaware/data/pmu_snapshot_data.h"
 #include "libkperf/symbol.h"
 #endif
 #include "oeaware/data/thread_info.h"
 #include "oeaware/data/kernel_data.h"
 #include "oeaware/data/command_data.h"
 #include "oeaware/data/analysis_data.h"
+#include "oeaware/data/hot_function_data.h"
 #include "oeaware/data/env_data.h"
 #include "oeaware/data/network_interface_data.h"
 #include "oeaware/data/net_hardirq_tune_data.h"
+#include "oeaware/data/multi_net_path_data.h"
 
 namespace oeaware {
 void TopicFree(CTopic *topic)
@@ -167,7 +170,7 @@ int PmuCountingDataSerialize(const void *data, OutStream &out)
     uint64_t interval = tmpData->interval;
     int len = tmpData->len;
     PmuData *pmuData = tmpData->pmuData;
-    out << interval << len;
+    out << interval << len << tmpData->approximate;
     for (int i = 0; i < len; i++) {
         int count = 0;
         auto tmp = pmuData[i].stack;
@@ -199,7 +202,7 @@ int PmuCountingDataDeserialize(void **data, InStream &in)
     *data = new PmuCountingData();
     int len;
     uint64_t interval;
-    in >> interval >> len;
+    in >> interval >> len >> ((PmuCountingData*)(*data))->approximate;
     ((PmuCountingData*)(*data))->len = len;
     ((PmuCountingData*)(*data))->interval = interval;
     PmuData *pmuData = new struct PmuData[len];
@@ -250,13 +253,51 @@ int PmuCountingDataDeserialize(void **data, InStream &in)
     return 0;
 }
 
+void PmuDerivedDataFree(void *data)
+{
+    auto tmpData = static_cast<PmuDerivedData*>(data);
+    if (tmpData == nullptr) {
+        return;
+    }
+    delete[] tmpData->values;
+    tmpData->values = nullptr;
+    delete tmpData;
+}
+
+int PmuDerivedDataSerialize(const void *data, OutStream &out)
+{
+    auto tmpData = static_cast<const PmuDerivedData*>(data);
+    out << tmpData->len << tmpData->total << tmpData->intervalNs;
+    for (int i = 0; i < tmpData->len; ++i) {
+        out << tmpData->values[i];
+    }
+    return 0;
+}
+
+int PmuDerivedDataDeserialize(void **data, InStream &in)
+{
+    auto tmpData = new PmuDerivedData();
+    *data = tmpData;
+    in >> tmpData->len >> tmpData->total >> tmpData->intervalNs;
+    tmpData->values = new double[tmpData->len];
+    for (int i = 0; i < tmpData->len; ++i) {
+        in >> tmpData->values[i];
+    }
+    return 0;
+}
+
+static std::string NullSafeString(const char *str)
+{
+    return str == nullptr ? std::string() : std::string(str);
+}
+
 int PmuSamplingDataSerialize(const void *data, OutStream &out)
 {
     auto tmpData = static_cast<const PmuSamplingData*>(data);
     uint64_t interval = tmpData->interval;
     int len = tmpData->len;
     PmuData *pmuData = tmpData->pmuData;
-    out << interval << len;
+    out << interval << len << tmpData->period << tmpData->useFreq << tmpData->scale;
     for (int i = 0; i < len; i++) {
         int count = 0;
         auto tmp = pmuData[i].stack;
@@ -267,13 +308,13 @@ int PmuSamplingDataSerialize(const void *data, OutStream &out)
         out << count;
         tmp = pmuData[i].stack;
         while (count--) {
-            std::string module(tmp->symbol->module);
-            std::string symbolName(tmp->symbol->symbolName);
-            std::string mangleName(tmp->symbol->mangleName);
-            std::string fileName(tmp->symbol->fileName);
-            out << tmp->symbol->addr << module << symbolName << mangleName << fileName
-                << tmp->symbol->lineNum << tmp->symbol->offset << tmp->symbol->codeMapEndAddr
-                << tmp->symbol->codeMapAddr << tmp->symbol->count << tmp->count;
+            // without symbol resolving only the address of a frame is set.
+            Symbol empty = {};
+            const Symbol *symbol = tmp->symbol != nullptr ? tmp->symbol : &empty;
+            out << symbol->addr << NullSafeString(symbol->module) << NullSafeString(symbol->symbolName)
+                << NullSafeString(symbol->mangleName) << NullSafeString(symbol->fileName)
+                << symbol->lineNum << symbol->offset << symbol->codeMapEndAddr
+                << symbol->codeMapAddr << symbol->count << tmp->count;
             tmp = tmp->next;
         }
         out << pmuData[i].evt << pmuData[i].ts << pmuData[i].pid << pmuData[i].tid << pmuData[i].cpu
@@ -291,6 +332,8 @@ int PmuSamplingDataDeserialize(void **data, InStream &in)
     in >> interval >> len;
     ((PmuSamplingData*)(*data))->len = len;
     ((PmuSamplingData*)(*data))->interval = interval;
+    in >> ((PmuSamplingData*)(*data))->period >> ((PmuSamplingData*)(*data))->useFreq >>
+        ((PmuSamplingData*)(*data))->scale;
     PmuData *pmuData = new struct PmuData[len];
     for (int i = 0; i < len; i++) {
         int count;
@@ -431,6 +474,51 @@ int PmuSpeDataDeserialize(void **data, InStream &in)
     return 0;
 }
 
+void PmuSpeAccessDataFree(void *data)
+{
+    auto tmpData = static_cast<PmuSpeAccessData*>(data);
+    if (tmpData == nullptr) {
+        return;
+    }
+    delete[] tmpData->access;
+    tmpData->access = nullptr;
+    delete tmpData;
+}
+
+int PmuSpeAccessDataSerialize(const void *data, OutStream &out)
+{
+    auto tmpData = static_cast<const PmuSpeAccessData*>(data);
+    out << tmpData->len << tmpData->interval << tmpData->records << tmpData->unresolved;
+    for (int i = 0; i < PMU_SPE_LAT_QUANTILE_NUM; ++i) {
+        out << tmpData->latQuantiles[i];
+    }
+    for (int i = 0; i < tmpData->len; ++i) {
+        auto &access = tmpData->access[i];
+        out << access.pid << access.tid << access.cpuNode << access.memNode << access.count;
+    }
+    return 0;
+}
+
+int PmuSpeAccessDataDeserialize(void **data, InStream &in)
+{
+    auto tmpData = new PmuSpeAccessData();
+    *data = tmpData;
+    in >> tmpData->len >> tmpData->interval >> tmpData->records >> tmpData->unresolved;
+    for (int i = 0; i < PMU_SPE_LAT_QUANTILE_NUM; ++i) {
+        in >> tmpData->latQuantiles[i];
+    }
+    if (tmpData->len <= 0) {
+        tmpData->len = 0;
+        return 0;
+    }
+    tmpData->access = new PmuSpeAccess[tmpData->len];
+    for (int i = 0; i < tmpData->len; ++i) {
+        auto &access = tmpData->access[i];
+        in >> access.pid >> access.tid >> access.cpuNode >> access.memNode >> access.count;
+    }
+    return 0;
+}
+
 int PmuUncoreDataSerialize(const void *data, OutStream &out)
 {
     auto tmpData = static_cast<const PmuUncoreData*>(data);
@@ -520,6 +608,160 @@ int PmuUncoreDataDeserialize(void **data, InStream &in)
     return 0;
 }
 
+// Only the deserialized copies are released here, the collector keeps the buffers returned by PmuRead.
+void UncoreTopoDataFree(void *data)
+{
+    auto tmpData = static_cast<UncoreTopoData*>(data);
+    if (tmpData == nullptr) {
+        return;
+    }
+    for (int i = 0; i < tmpData->len; ++i) {
+        delete[] tmpData->records[i].evt;
+    }
+    delete[] tmpData->records;
+    tmpData->records = nullptr;
+    delete[] tmpData->nodes;
+    tmpData->nodes = nullptr;
+    delete tmpData;
+}
+
+int UncoreTopoDataSerialize(const void *data, OutStream &out)
+{
+    auto tmpData = static_cast<const UncoreTopoData*>(data);
+    out << tmpData->intervalNs << tmpData->socketNum << tmpData->dieNum << tmpData->nodeNum << tmpData->hhaNum
+        << tmpData->l3cNum << tmpData->len;
+    for (int i = 0; i < tmpData->len; ++i) {
+        auto &record = tmpData->records[i];
+        out << record.loc.socketId << record.loc.dieId << record.loc.index << record.loc.numaId
+            << std::string(record.evt == nullptr ? "" : record.evt) << record.count;
+    }
+    out << tmpData->nodeLen;
+    for (int i = 0; i < tmpData->nodeLen; ++i) {
+        auto &node = tmpData->nodes[i];
+        out << node.numaId << node.socketId << node.opsRate << node.bandwidth << node.remoteRatio << node.l3cHitRate;
+    }
+    return 0;
+}
+
+int UncoreTopoDataDeserialize(void **data, InStream &in)
+{
+    auto tmpData = new UncoreTopoData();
+    *data = tmpData;
+    in >> tmpData->intervalNs >> tmpData->socketNum >> tmpData->dieNum >> tmpData->nodeNum >> tmpData->hhaNum
+        >> tmpData->l3cNum >> tmpData->len;
+    if (tmpData->len < 0) {
+        tmpData->len = 0;
+    }
+    tmpData->records = new UncoreRecord[tmpData->len];
+    for (int i = 0; i < tmpData->len; ++i) {
+        auto &record = tmpData->records[i];
+        std::string evt;
+        in >> record.loc.socketId >> record.loc.dieId >> record.loc.index >> record.loc.numaId >> evt
+            >> record.count;
+        record.evt = new char[evt.size() + 1];
+        strcpy_s(record.evt, evt.size() + 1, evt.c_str());
+    }
+    in >> tmpData->nodeLen;
+    if (tmpData->nodeLen < 0) {
+        tmpData->nodeLen = 0;
+    }
+    tmpData->nodes = new UncoreNodeStat[tmpData->nodeLen];
+    for (int i = 0; i < tmpData->nodeLen; ++i) {
+        auto &node = tmpData->nodes[i];
+        in >> node.numaId >> node.socketId >> node.opsRate >> node.bandwidth >> node.remoteRatio >> node.l3cHitRate;
+    }
+    return 0;
+}
+
+static void SnapshotPmuDataFree(PmuData *pmuData, int len)
+{
+    if (pmuData == nullptr) {
+        return;
+    }
+    for (int i = 0; i < len; ++i) {
+        delete[] pmuData[i].evt;
+        delete pmuData[i].cpuTopo;
+    }
+    delete[] pmuData;
+}
+
+void PmuSnapshotDataFree(void *data)
+{
+    auto tmpData = static_cast<PmuSnapshotData*>(data);
+    if (tmpData == nullptr) {
+        return;
+    }
+    SnapshotPmuDataFree(tmpData->coreData, tmpData->coreLen);
+    SnapshotPmuDataFree(tmpData->uncoreData, tmpData->uncoreLen);
+    SnapshotPmuDataFree(tmpData->l3cData, tmpData->l3cLen);
+    UncoreTopoDataFree(tmpData->uncoreTopo);
+    delete tmpData;
+}
+
+static void SnapshotPmuDataSerialize(const PmuData *pmuData, int len, OutStream &out)
+{
+    out << len;
+    for (int i = 0; i < len; ++i) {
+        std::string evt(pmuData[i].evt == nullptr ? "" : pmuData[i].evt);
+        int numaId = pmuData[i].cpuTopo == nullptr ? -1 : pmuData[i].cpuTopo->numaId;
+        out << evt << pmuData[i].cpu << numaId << pmuData[i].count << pmuData[i].countPercent;
+    }
+}
+
+static PmuData *SnapshotPmuDataDeserialize(int &len, InStream &in)
+{
+    in >> len;
+    if (len <= 0) {
+        len = 0;
+        return nullptr;
+    }
+    PmuData *pmuData = new PmuData[len]();
+    for (int i = 0; i < len; ++i) {
+        std::string evt;
+        pmuData[i].cpuTopo = new CpuTopology();
+        in >> evt >> pmuData[i].cpu >> pmuData[i].cpuTopo->numaId >> pmuData[i].count >> pmuData[i].countPercent;
+        char *evtName = new char[evt.size() + 1];
+        if (strcpy_s(evtName, evt.size() + 1, evt.c_str()) != EOK) {
+            evtName[0] = 0;
+        }
+        pmuData[i].evt = evtName;
+    }
+    return pmuData;
+}
+
+int PmuSnapshotDataSerialize(const void *data, OutStream &out)
+{
+    auto tmpData = static_cast<const PmuSnapshotData*>(data);
+    out << tmpData->startTs << tmpData->endTs;
+    SnapshotPmuDataSerialize(tmpData->coreData, tmpData->coreLen, out);
+    SnapshotPmuDataSerialize(tmpData->uncoreData, tmpData->uncoreLen, out);
+    SnapshotPmuDataSerialize(tmpData->l3cData, tmpData->l3cLen, out);
+    int hasTopo = tmpData->uncoreTopo != nullptr;
+    out << hasTopo;
+    if (hasTopo) {
+        UncoreTopoDataSerialize(tmpData->uncoreTopo, out);
+    }
+    return 0;
+}
+
+int PmuSnapshotDataDeserialize(void **data, InStream &in)
+{
+    auto tmpData = new PmuSnapshotData();
+    *data = tmpData;
+    in >> tmpData->startTs >> tmpData->endTs;
+    tmpData->coreData = SnapshotPmuDataDeserialize(tmpData->coreLen, in);
+    tmpData->uncoreData = SnapshotPmuDataDeserialize(tmpData->uncoreLen, in);
+    tmpData->l3cData = SnapshotPmuDataDeserialize(tmpData->l3cLen, in);
+    int hasTopo = 0;
+    in >> hasTopo;
+    if (hasTopo) {
+        void *topo = nullptr;
+        UncoreTopoDataDeserialize(&topo, in);
+        tmpData->uncoreTopo = static_cast<UncoreTopoData*>(topo);
+    }
+    return 0;
+}
+
 #endif
 
 void ThreadInfoFree(void *data)
@@ -555,6 +797,46 @@ int ThreadInfoDeserialize(void **data, InStream &in)
     return 0;
 }
 
+void ThreadSchedStatListFree(void *data)
+{
+    auto statList = static_cast<ThreadSchedStatList*>(data);
+    if (statList == nullptr) {
+        return;
+    }
+    delete[] statList->stats;
+    statList->stats = nullptr;
+    delete statList;
+}
+
+int ThreadSchedStatListSerialize(const void *data, OutStream &out)
+{
+    auto statList = static_cast<const ThreadSchedStatList*>(data);
+    out << statList->len;
+    for (int i = 0; i < statList->len; ++i) {
+        auto &stat = statList->stats[i];
+        std::string name(stat.name, strnlen(stat.name, THREAD_SCHED_NAME_LEN));
+        out << stat.pid << stat.tid << name << stat.intervalNs << stat.runTime << stat.waitTime <<
+            stat.voluntarySwitches << stat.involuntarySwitches << stat.migrations << stat.cpu << stat.node;
+    }
+    return 0;
+}
+
+int ThreadSchedStatListDeserialize(void **data, InStream &in)
+{
+    auto statList = new ThreadSchedStatList();
+    *data = statList;
+    in >> statList->len;
+    statList->stats = new ThreadSchedStat[statList->len];
+    for (int i = 0; i < statList->len; ++i) {
+        auto &stat = statList->stats[i];
+        std::string name;
+        in >> stat.pid >> stat.tid >> name >> stat.intervalNs >> stat.runTime >> stat.waitTime >>
+            stat.voluntarySwitches >> stat.involuntarySwitches >> stat.migrations >> stat.cpu >> stat.node;
+        strncpy_s(stat.name, THREAD_SCHED_NAME_LEN, name.data(), THREAD_SCHED_NAME_LEN - 1);
+    }
+    return 0;
+}
+
 void KernelDataFree(void *data)
 {
     auto tmpData = static_cast<const KernelData*>(data);
@@ -705,6 +987,81 @@ int CommandDataDeserialize(void **data, InStream &in)
     return 0;
 }
 
+void CommandTypedDataFree(void *data)
+{
+    auto typedData = static_cast<CommandTypedData*>(data);
+    if (typedData == nullptr) {
+        return;
+    }
+    if (typedData->colNames != nullptr) {
+        for (int i = 0; i < typedData->colLen; ++i) {
+            delete[] typedData->colNames[i];
+        }
+        delete[] typedData->colNames;
+        typedData->colNames = nullptr;
+    }
+    delete[] typedData->colTypes;
+    typedData->colTypes = nullptr;
+    delete[] typedData->values;
+    typedData->values = nullptr;
+    delete[] typedData->textOffset;
+    typedData->textOffset = nullptr;
+    delete[] typedData->textPool;
+    typedData->textPool = nullptr;
+    delete typedData;
+}
+
+int CommandTypedDataSerialize(const void *data, OutStream &out)
+{
+    auto typedData = static_cast<const CommandTypedData*>(data);
+    out << typedData->schemaId << typedData->source << typedData->intervalMs << typedData->colLen
+        << typedData->rowLen;
+    for (int i = 0; i < typedData->colLen; ++i) {
+        out << std::string(typedData->colNames[i]) << typedData->colTypes[i];
+    }
+    size_t cells = static_cast<size_t>(typedData->colLen) * typedData->rowLen;
+    // Cells are written as raw arrays, one append per array instead of one per value.
+    out.Append(reinterpret_cast<const char*>(typedData->values), cells * sizeof(double));
+    out.Append(reinterpret_cast<const char*>(typedData->textOffset), cells * sizeof(int));
+    out << typedData->textPoolLen;
+    out.Append(typedData->textPool, typedData->textPoolLen);
+    return 0;
+}
+
+int CommandTypedDataDeserialize(void **data, InStream &in)
+{
+    *data = new CommandTypedData();
+    auto typedData = static_cast<CommandTypedData*>(*data);
+    in >> typedData->schemaId >> typedData->source >> typedData->intervalMs >> typedData->colLen
+        >> typedData->rowLen;
+    if (typedData->colLen < 0 || typedData->rowLen < 0) {
+        return -1;
+    }
+    typedData->colNames = new char *[typedData->colLen];
+    typedData->colTypes = new int[typedData->colLen];
+    for (int i = 0; i < typedData->colLen; ++i) {
+        std::string name;
+        in >> name >> typedData->colTypes[i];
+        typedData->colNames[i] = new char[name.size() + 1];
+        if (strcpy_s(typedData->colNames[i], name.size() + 1, name.data()) != EOK) {
+            return -1;
+        }
+    }
+    size_t cells = static_cast<size_t>(typedData->colLen) * typedData->rowLen;
+    typedData->values = new double[cells];
+    in.Deserialize(reinterpret_cast<char*>(typedData->values), cells * sizeof(double));
+    typedData->textOffset = new int[cells];
+    in.Deserialize(reinterpret_cast<char*>(typedData->textOffset), cells * sizeof(int));
+    in >> typedData->textPoolLen;
+    if (typedData->textPoolLen < 0) {
+        return -1;
+    }
+    typedData->textPool = new char[typedData->textPoolLen + 1];
+    in.Deserialize(typedData->textPool, typedData->textPoolLen);
+    typedData->textPool[typedData->textPoolLen] = '\0';
+    return 0;
+}
+
 void AnalysisDataFree(void *data)
 {
     auto analysisData = static_cast<AnalysisReport*>(data);
@@ -845,6 +1202,24 @@ void EnvRealTimeDataFree(void *data)
     envData = nullptr;
 }
 
+template <typename T>
+static void SerializeArray(OutStream &out, const T *array, int len)
+{
+    for (int i = 0; i < len; ++i) {
+        out << array[i];
+    }
+}
+
+template <typename T>
+static T *DeserializeArray(InStream &in, int len)
+{
+    T *array = new T[len];
+    for (int i = 0; i < len; ++i) {
+        in >> array[i];
+    }
+    return array;
+}
+
 int EnvCpuUtilSerialize(const void *data, OutStream &out)
 {
     auto envData = static_cast<const EnvCpuUtilParam *>(data);
@@ -855,7 +1230,19 @@ int EnvCpuUtilSerialize(const void *data, OutStream &out)
             out << envData->times[cpu][type];
         }
     }
-
+    out << envData->numaNum;
+    SerializeArray(out, envData->nodeTimes, envData->numaNum * CPU_UTIL_TYPE_MAX);
+    out << envData->clusterNum;
+    SerializeArray(out, envData->cpu2Cluster, envData->cpuNumConfig);
+    SerializeArray(out, envData->clusterTimes, envData->clusterNum * CPU_UTIL_TYPE_MAX);
+    out << envData->coreNum;
+    SerializeArray(out, envData->cpu2Core, envData->cpuNumConfig);
+    SerializeArray(out, envData->coreTimes, envData->coreNum * CPU_UTIL_TYPE_MAX);
+    int ewmaWindow = envData->ewmaUtil == nullptr ? 0 : envData->ewmaWindow;
+    out << ewmaWindow;
+    if (ewmaWindow > 0) {
+        SerializeArray(out, envData->ewmaUtil, (envData->cpuNumConfig + 1) * CPU_UTIL_TYPE_MAX);
+    }
     return 0;
 }
 
@@ -865,13 +1252,31 @@ int EnvCpuUtilDeserialize(void **data, InStream &in)
     auto envData = static_cast<EnvCpuUtilParam *>(*data);
     in >> envData->dataReady;
     in >> envData->cpuNumConfig;
-    envData->times = new uint64_t *[envData->cpuNumConfig + 1];
-    for (int cpu = 0; cpu < envData->cpuNumConfig + 1; ++cpu) {
-        envData->times[cpu] = new uint64_t[CPU_UTIL_TYPE_MAX];
+    int rowNum = envData->cpuNumConfig + 1;
+    void *matrix = nullptr;
+    if (posix_memalign(&matrix, ENV_CACHE_LINE_SIZE, sizeof(uint64_t) * rowNum * CPU_UTIL_TYPE_MAX) != 0) {
+        return -1;
+    }
+    envData->matrix = static_cast<uint64_t *>(matrix);
+    envData->times = new uint64_t *[rowNum];
+    for (int cpu = 0; cpu < rowNum; ++cpu) {
+        envData->times[cpu] = envData->matrix + cpu * CPU_UTIL_TYPE_MAX;
         for (int type = 0; type < CPU_UTIL_TYPE_MAX; ++type) {
             in >> envData->times[cpu][type];
         }
     }
+    in >> envData->numaNum;
+    envData->nodeTimes = DeserializeArray<uint64_t>(in, envData->numaNum * CPU_UTIL_TYPE_MAX);
+    in >> envData->clusterNum;
+    envData->cpu2Cluster = DeserializeArray<int>(in, envData->cpuNumConfig);
+    envData->clusterTimes = DeserializeArray<uint64_t>(in, envData->clusterNum * CPU_UTIL_TYPE_MAX);
+    in >> envData->coreNum;
+    envData->cpu2Core = DeserializeArray<int>(in, envData->cpuNumConfig);
+    envData->coreTimes = DeserializeArray<uint64_t>(in, envData->coreNum * CPU_UTIL_TYPE_MAX);
+    in >> envData->ewmaWindow;
+    if (envData->ewmaWindow > 0) {
+        envData->ewmaUtil = DeserializeArray<double>(in, rowNum * CPU_UTIL_TYPE_MAX);
+    }
     return 0;
 }
 
@@ -881,21 +1286,53 @@ void EnvCpuUtilFree(void *data)
     if (cpuData == nullptr) {
         return;
     }
-    if (cpuData->times != nullptr) {
-        for (int cpu = 0; cpu < cpuData->cpuNumConfig + 1; ++cpu) {
-            if (cpuData->times[cpu] == nullptr) {
-                continue;
-            }
-            delete[] cpuData->times[cpu];
-            cpuData->times[cpu] = nullptr;
-        }
-        delete[] cpuData->times;
-        cpuData->times = nullptr;
-    }
+    // the rows of times point into matrix
+    delete[] cpuData->times;
+    cpuData->times = nullptr;
+    free(cpuData->matrix);
+    cpuData->matrix = nullptr;
+    delete[] cpuData->nodeTimes;
+    delete[] cpuData->cpu2Cluster;
+    delete[] cpuData->clusterTimes;
+    delete[] cpuData->cpu2Core;
+    delete[] cpuData->coreTimes;
+    delete[] cpuData->ewmaUtil;
     delete cpuData;
     cpuData = nullptr;
 }
 
+int EnvCpuUtilHrSerialize(const void *data, OutStream &out)
+{
+    auto envData = static_cast<const EnvCpuUtilHrParam *>(data);
+    out << envData->dataReady;
+    out << envData->cpuNumConfig;
+    out << envData->intervalNs;
+    SerializeArray(out, envData->times, (envData->cpuNumConfig + 1) * CPU_HR_TYPE_MAX);
+    return 0;
+}
+
+int EnvCpuUtilHrDeserialize(void **data, InStream &in)
+{
+    *data = new EnvCpuUtilHrParam();
+    auto envData = static_cast<EnvCpuUtilHrParam *>(*data);
+    in >> envData->dataReady;
+    in >> envData->cpuNumConfig;
+    in >> envData->intervalNs;
+    envData->times = DeserializeArray<uint64_t>(in, (envData->cpuNumConfig + 1) * CPU_HR_TYPE_MAX);
+    return 0;
+}
+
+void EnvCpuUtilHrFree(void *data)
+{
+    auto cpuData = static_cast<EnvCpuUtilHrParam *>(data);
+    if (cpuData == nullptr) {
+        return;
+    }
+    delete[] cpuData->times;
+    cpuData->times = nullptr;
+    delete cpuData;
+}
+
 static int DataItemDeserialize(DataItem *dataItem, int len, InStream &in)
 {
     for (int i = 0; i < len; ++i) {
@@ -960,6 +1397,55 @@ int AnalysisResultItemDeserialize(void **data, InStream &in)
     return 0;
 }
 
+void HotFunctionDataFree(void *data)
+{
+    auto tmpData = static_cast<HotFunctionData*>(data);
+    if (tmpData == nullptr) {
+        return;
+    }
+    for (int i = 0; i < tmpData->len; ++i) {
+        delete[] tmpData->items[i].group;
+        delete[] tmpData->items[i].name;
+    }
+    delete[] tmpData->items;
+    tmpData->items = nullptr;
+    delete tmpData;
+}
+
+int HotFunctionDataSerialize(const void *data, OutStream &out)
+{
+    auto tmpData = static_cast<const HotFunctionData*>(data);
+    out << tmpData->windowMs << tmpData->samples << tmpData->truncated << tmpData->len;
+    for (int i = 0; i < tmpData->len; ++i) {
+        auto &item = tmpData->items[i];
+        out << item.type << std::string(item.group) << std::string(item.name) << item.samples << item.delta;
+    }
+    return 0;
+}
+
+int HotFunctionDataDeserialize(void **data, InStream &in)
+{
+    auto tmpData = new HotFunctionData();
+    *data = tmpData;
+    in >> tmpData->windowMs >> tmpData->samples >> tmpData->truncated >> tmpData->len;
+    if (tmpData->len <= 0) {
+        tmpData->len = 0;
+        return 0;
+    }
+    tmpData->items = new HotFunctionItem[tmpData->len];
+    for (int i = 0; i < tmpData->len; ++i) {
+        auto &item = tmpData->items[i];
+        std::string group;
+        std::string name;
+        in >> item.type >> group >> name >> item.samples >> item.delta;
+        item.group = new char[group.size() + 1];
+        strcpy_s(item.group, group.size() + 1, group.data());
+        item.name = new char[name.size() + 1];
+        strcpy_s(item.name, name.size() + 1, name.data());
+    }
+    return 0;
+}
+
 void AnalysisResultItemFree(void *data)
 {
     if (data == nullptr) {
@@ -1212,6 +1698,210 @@ void NetThreadQueFree(void *data)
     netData = nullptr;
 }
 
+int NetFlowLatencySerialize(const void *data, OutStream &out)
+{
+    auto latencyData = static_cast<const NetFlowLatencyDataList *>(data);
+    out << latencyData->intervalMs;
+    out << latencyData->count;
+    for (int n = 0; n < latencyData->count; ++n) {
+        auto &latency = latencyData->latency[n];
+        out << latency.pid;
+        out << std::string(latency.comm, strnlen(latency.comm, OE_NET_LATENCY_COMM_LEN));
+        out << latency.retrans;
+        for (int i = 0; i < OE_NET_LATENCY_SLOTS; ++i) {
+            out << latency.rttUs[i];
+        }
+        for (int i = 0; i < OE_NET_LATENCY_SLOTS; ++i) {
+            out << latency.rcvQueUs[i];
+        }
+    }
+    return 0;
+}
+
+int NetFlowLatencyDeserialize(void **data, InStream &in)
+{
+    *data = new NetFlowLatencyDataList();
+    auto latencyData = static_cast<NetFlowLatencyDataList *>(*data);
+    in >> latencyData->intervalMs;
+    in >> latencyData->count;
+    if (latencyData->count <= 0) {
+        return 0;
+    }
+    latencyData->latency = new NetFlowLatencyData[latencyData->count];
+    for (int n = 0; n < latencyData->count; ++n) {
+        auto &latency = latencyData->latency[n];
+        std::string comm;
+        in >> latency.pid;
+        in >> comm;
+        CopyStringToCharArray(comm, latency.comm, sizeof(latency.comm));
+        in >> latency.retrans;
+        for (int i = 0; i < OE_NET_LATENCY_SLOTS; ++i) {
+            in >> latency.rttUs[i];
+        }
+        for (int i = 0; i < OE_NET_LATENCY_SLOTS; ++i) {
+            in >> latency.rcvQueUs[i];
+        }
+    }
+    return 0;
+}
+
+void NetFlowLatencyFree(void *data)
+{
+    auto latencyData = static_cast<NetFlowLatencyDataList*>(data);
+    if (latencyData == nullptr) {
+        return;
+    }
+    delete[] latencyData->latency;
+    latencyData->latency = nullptr;
+    delete latencyData;
+}
+
+static void SerializeRateStat(const NetHirqRateStat &stat, OutStream &out)
+{
+    out << stat.rate;
+    out << stat.mean;
+    out << stat.p50;
+    out << stat.p95;
+    out << stat.p99;
+    out << stat.burstiness;
+}
+
+static void DeserializeRateStat(NetHirqRateStat &stat, InStream &in)
+{
+    in >> stat.rate;
+    in >> stat.mean;
+    in >> stat.p50;
+    in >> stat.p95;
+    in >> stat.p99;
+    in >> stat.burstiness;
+}
+
+int NetHirqStatSerialize(const void *data, OutStream &out)
+{
+    auto statData = static_cast<const NetHirqStatList *>(data);
+    out << statData->intervalMs;
+    out << statData->windowLen;
+    out << statData->devCount;
+    for (int n = 0; n < statData->devCount; ++n) {
+        out << std::string(statData->dev[n].dev);
+        out << statData->dev[n].rxQueues;
+        out << statData->dev[n].activeQueues;
+        SerializeRateStat(statData->dev[n].stat, out);
+        out << statData->dev[n].gini;
+        out << statData->dev[n].suggestQueues;
+    }
+    out << statData->queueCount;
+    for (int n = 0; n < statData->queueCount; ++n) {
+        out << std::string(statData->queue[n].dev);
+        out << statData->queue[n].queueId;
+        SerializeRateStat(statData->queue[n].stat, out);
+        out << statData->queue[n].rssWeight;
+    }
+    return 0;
+}
+
+int NetHirqStatDeserialize(void **data, InStream &in)
+{
+    *data = new NetHirqStatList();
+    auto statData = static_cast<NetHirqStatList *>(*data);
+    in >> statData->intervalMs;
+    in >> statData->windowLen;
+    in >> statData->devCount;
+    if (statData->devCount > 0) {
+        statData->dev = new NetHirqDevStat[statData->devCount];
+    }
+    for (int n = 0; n < statData->devCount; ++n) {
+        std::string dev;
+        in >> dev;
+        CopyStringToCharArray(dev, statData->dev[n].dev, sizeof(statData->dev[n].dev));
+        in >> statData->dev[n].rxQueues;
+        in >> statData->dev[n].activeQueues;
+        DeserializeRateStat(statData->dev[n].stat, in);
+        in >> statData->dev[n].gini;
+        in >> statData->dev[n].suggestQueues;
+    }
+    in >> statData->queueCount;
+    if (statData->queueCount > 0) {
+        statData->queue = new NetHirqQueueStat[statData->queueCount];
+    }
+    for (int n = 0; n < statData->queueCount; ++n) {
+        std::string dev;
+        in >> dev;
+        CopyStringToCharArray(dev, statData->queue[n].dev, sizeof(statData->queue[n].dev));
+        in >> statData->queue[n].queueId;
+        DeserializeRateStat(statData->queue[n].stat, in);
+        in >> statData->queue[n].rssWeight;
+    }
+    return 0;
+}
+
+void NetHirqStatFree(void *data)
+{
+    auto statData = static_cast<NetHirqStatList*>(data);
+    if (statData == nullptr) {
+        return;
+    }
+    delete[] statData->dev;
+    statData->dev = nullptr;
+    delete[] statData->queue;
+    statData->queue = nullptr;
+    delete statData;
+}
+
+int MultiNetPathLocalitySerialize(const void *data, OutStream &out)
+{
+    auto localityData = static_cast<const MultiNetPathLocalityList *>(data);
+    out << localityData->intervalMs;
+    out << localityData->count;
+    for (int n = 0; n < localityData->count; ++n) {
+        auto &app = localityData->apps[n];
+        out << app.pid;
+        out << std::string(app.comm, strnlen(app.comm, MULTI_NET_PATH_COMM_LEN));
+        out << app.node;
+        out << app.queues;
+        out << app.rxPackets;
+        out << app.localPackets;
+        out << app.locality;
+    }
+    return 0;
+}
+
+int MultiNetPathLocalityDeserialize(void **data, InStream &in)
+{
+    *data = new MultiNetPathLocalityList();
+    auto localityData = static_cast<MultiNetPathLocalityList *>(*data);
+    in >> localityData->intervalMs;
+    in >> localityData->count;
+    if (localityData->count <= 0) {
+        return 0;
+    }
+    localityData->apps = new MultiNetPathAppLocality[localityData->count];
+    for (int n = 0; n < localityData->count; ++n) {
+        auto &app = localityData->apps[n];
+        std::string comm;
+        in >> app.pid;
+        in >> comm;
+        CopyStringToCharArray(comm, app.comm, sizeof(app.comm));
+        in >> app.node;
+        in >> app.queues;
+        in >> app.rxPackets;
+        in >> app.localPackets;
+        in >> app.locality;
+    }
+    return 0;
+}
+
+void MultiNetPathLocalityFree(void *data)
+{
+    auto localityData = static_cast<MultiNetPathLocalityList*>(data);
+    if (localityData == nullptr) {
+        return;
+    }
+    delete[] localityData->apps;
+    localityData->apps = nullptr;
+    delete localityData;
+}
+
 void Register::RegisterData(const std::string &name, const RegisterEntry &entry)
 {
     registerEntry[name] = entry;
@@ -1227,14 +1917,26 @@ void Register::InitRegisterData()
 #if defined(__arm__) || defined(__aarch64__) || defined(__riscv)
     RegisterData("pmu_counting_collector", RegisterEntry(PmuCountingDataSerialize, PmuCountingDataDeserialize,
         PmuBaseDataFree));
+    for (auto &metric : {"ipc", "cpu_busy_ratio", "l1d_tlb_miss_rate", "l2d_cache_mpki"}) {
+        RegisterData(std::string("pmu_counting_collector::") + metric, RegisterEntry(PmuDerivedDataSerialize,
+            PmuDerivedDataDeserialize, PmuDerivedDataFree));
+    }
 
     RegisterData("pmu_sampling_collector", RegisterEntry(PmuSamplingDataSerialize, PmuSamplingDataDeserialize,
         PmuBaseDataFree));
 
     RegisterData("pmu_spe_collector", RegisterEntry(PmuSpeDataSerialize, PmuSpeDataDeserialize, PmuBaseDataFree));
+    RegisterData("pmu_spe_collector::spe_access", RegisterEntry(PmuSpeAccessDataSerialize,
+        PmuSpeAccessDataDeserialize, PmuSpeAccessDataFree));
 
     RegisterData("pmu_uncore_collector", RegisterEntry(PmuUncoreDataSerialize, PmuUncoreDataDeserialize,
         PmuBaseDataFree));
+    RegisterData("pmu_uncore_collector::uncore_node", RegisterEntry(UncoreTopoDataSerialize,
+        UncoreTopoDataDeserialize, UncoreTopoDataFree));
+    RegisterData("pmu_l3c_collector::l3c_node", RegisterEntry(UncoreTopoDataSerialize, UncoreTopoDataDeserialize,
+        UncoreTopoDataFree));
+    RegisterData("pmu_snapshot_collector", RegisterEntry(PmuSnapshotDataSerialize, PmuSnapshotDataDeserialize,
+        PmuSnapshotDataFree));
     RegisterData("smc_d_analysis", RegisterEntry(AnalysisResultItemSerialize, AnalysisResultItemDeserialize,
         AnalysisResultItemFree));
     RegisterData("hugepage_analysis", RegisterEntry(AnalysisResultItemSerialize, AnalysisResultItemDeserialize,
@@ -1251,14 +1953,24 @@ void Register::InitRegisterData()
         AnalysisResultItemDeserialize, AnalysisResultItemFree));
     RegisterData("docker_coordination_burst_analysis", RegisterEntry(AnalysisResultItemSerialize,
         AnalysisResultItemDeserialize, AnalysisResultItemFree));
+    RegisterData(OE_HOT_FUNCTION_ANALYSIS, RegisterEntry(HotFunctionDataSerialize, HotFunctionDataDeserialize,
+        HotFunctionDataFree));
 #endif
     RegisterData("thread_collector", RegisterEntry(ThreadInfoSerialize, ThreadInfoDeserialize, ThreadInfoFree));
+    RegisterData("thread_collector::thread_sched_stat", RegisterEntry(ThreadSchedStatListSerialize,
+        ThreadSchedStatListDeserialize, ThreadSchedStatListFree));
     RegisterData("kernel_config", RegisterEntry(KernelDataSerialize, KernelDataDeserialize, KernelDataFree));
     RegisterData("thread_scenario", RegisterEntry(ThreadInfoSerialize, ThreadInfoDeserialize, ThreadInfoFree));
     RegisterData("command_collector", RegisterEntry(CommandDataSerialize, CommandDataDeserialize, CommandDataFree));
+    for (auto cmd : {"mpstat", "iostat", "vmstat", "sar", "pidstat"}) {
+        RegisterData(Concat({OE_COMMAND_COLLECTOR, std::string(cmd) + "_typed"}, "::"),
+            RegisterEntry(CommandTypedDataSerialize, CommandTypedDataDeserialize, CommandTypedDataFree));
+    }
     RegisterData("env_info_collector::static", RegisterEntry(EnvStaticDataSerialize, EnvStaticDataDeserialize, EnvStaticDataFree));
     RegisterData("env_info_collector::realtime", RegisterEntry(EnvRealTimeDataSerialize, EnvRealTimeDataDeserialize, EnvRealTimeDataFree));
     RegisterData("env_info_collector::cpu_util", RegisterEntry(EnvCpuUtilSerialize, EnvCpuUtilDeserialize, EnvCpuUtilFree));
+    RegisterData("env_info_hr_collector::cpu_util_hr", RegisterEntry(EnvCpuUtilHrSerialize, EnvCpuUtilHrDeserialize,
+        EnvCpuUtilHrFree));
     std::string name = std::string(OE_NET_INTF_INFO) + std::string("::") + std::string(OE_NETWORK_INTERFACE_BASE_TOPIC);
     RegisterData(name, RegisterEntry(NetIntfBaseSerialize, NetIntfBaseDeserialize, NetIntfBaseFree));
     name = std::string(OE_NET_INTF_INFO) + std::string("::") + std::string(OE_NETWORK_INTERFACE_DRIVER_TOPIC);
@@ -1269,6 +1981,13 @@ void Register::InitRegisterData()
     RegisterData(name, RegisterEntry(NetHirqTuneDebugSerialize, NetHirqTuneDebugDeserialize, NetHirqTuneDebugFree));
     name = std::string(OE_NET_INTF_INFO) + std::string("::") + std::string(OE_NET_THREAD_QUE_DATA);
     RegisterData(name, RegisterEntry(NetThreadQueSerialize, NetThreadQueDeserialize, NetThreadQueFree));
+    name = std::string(OE_NET_INTF_INFO) + std::string("::") + std::string(OE_NET_FLOW_LATENCY);
+    RegisterData(name, RegisterEntry(NetFlowLatencySerialize, NetFlowLatencyDeserialize, NetFlowLatencyFree));
+    name = std::string(OE_NET_HIRQ_ANALYSIS) + std::string("::") + std::string(OE_TOPIC_NET_HIRQ_QUEUE_STAT);
+    RegisterData(name, RegisterEntry(NetHirqStatSerialize, NetHirqStatDeserialize, NetHirqStatFree));
+    name = std::string(OE_MULTI_NET_PATH_TUNE) + std::string("::") + std::string(OE_TOPIC_MULTI_NET_PATH_LOCALITY);
+    RegisterData(name, RegisterEntry(MultiNetPathLocalitySerialize, MultiNetPathLocalityDeserialize,
+        MultiNetPathLocalityFree));
 }
 
 SerializeFunc Register::GetDataSerialize(const std::string &name)
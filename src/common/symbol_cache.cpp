@@ -0,0 +1,327 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "symbol_cache.h"
+#include <algorithm>
+#include <cstring>
+#include <cxxabi.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace oeaware {
+namespace {
+constexpr size_t MAX_MAPS_PIDS = 1024;
+constexpr size_t MAX_FILES = 1024;
+constexpr size_t MAX_MODULES = 32;
+constexpr int HEX_BASE = 16;
+constexpr uint32_t GNU_NOTE_NAME_SIZE = 4;
+
+std::string Demangle(const std::string &name)
+{
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+    if (demangled == nullptr) {
+        return name;
+    }
+    std::string result = status == 0 ? demangled : name;
+    free(demangled);
+    return result;
+}
+
+size_t Align4(size_t size)
+{
+    return (size + 3) & ~static_cast<size_t>(3);
+}
+}
+
+void SymbolCache::SetCapacity(size_t symbols)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = std::max<size_t>(symbols, 1);
+    while (lru.size() > capacity) {
+        this->symbols.erase(lru.back().key);
+        lru.pop_back();
+    }
+}
+
+void SymbolCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    maps.clear();
+    buildIds.clear();
+    modules.clear();
+    lru.clear();
+    symbols.clear();
+    hits = 0;
+    misses = 0;
+}
+
+uint64_t SymbolCache::GetHits()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+uint64_t SymbolCache::GetMisses()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+const SymbolCache::Mapping *SymbolCache::FindMapping(int pid, uint64_t addr)
+{
+    auto find = [addr](const std::vector<Mapping> &mappings) -> const Mapping* {
+        for (auto &mapping : mappings) {
+            if (addr >= mapping.start && addr < mapping.end) {
+                return &mapping;
+            }
+        }
+        return nullptr;
+    };
+    auto it = maps.find(pid);
+    if (it != maps.end()) {
+        auto mapping = find(it->second);
+        if (mapping != nullptr) {
+            return mapping;
+        }
+    }
+    // not known yet or a new library has been mapped, read the maps again.
+    std::ifstream file("/proc/" + std::to_string(pid) + "/maps");
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    if (maps.size() >= MAX_MAPS_PIDS && !maps.count(pid)) {
+        maps.clear();
+    }
+    auto &mappings = maps[pid];
+    mappings.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        // start-end perms offset dev inode path
+        std::istringstream ss(line);
+        std::string range, perms, offset, dev, inode, path;
+        if (!(ss >> range >> perms >> offset >> dev >> inode) || perms.find('x') == std::string::npos) {
+            continue;
+        }
+        std::getline(ss >> std::ws, path);
+        auto pos = range.find('-');
+        if (pos == std::string::npos || path.empty() || path[0] != '/') {
+            continue;
+        }
+        Mapping mapping;
+        mapping.start = strtoull(range.substr(0, pos).c_str(), nullptr, HEX_BASE);
+        mapping.end = strtoull(range.substr(pos + 1).c_str(), nullptr, HEX_BASE);
+        mapping.pgoff = strtoull(offset.c_str(), nullptr, HEX_BASE);
+        // files of a container are opened in the root of the process.
+        mapping.path = "/proc/" + std::to_string(pid) + "/root" + path;
+        mappings.emplace_back(mapping);
+    }
+    return find(mappings);
+}
+
+bool SymbolCache::LoadElf(const std::string &file, std::string *buildId, Module *module)
+{
+    int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Elf64_Ehdr)) {
+        close(fd);
+        return false;
+    }
+    size_t size = st.st_size;
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    auto base = static_cast<const char*>(addr);
+    auto ehdr = reinterpret_cast<const Elf64_Ehdr*>(base);
+    bool ok = memcmp(ehdr->e_ident, ELFMAG, SELFMAG) == 0 && ehdr->e_ident[EI_CLASS] == ELFCLASS64 &&
+        ehdr->e_shoff + static_cast<uint64_t>(ehdr->e_shnum) * sizeof(Elf64_Shdr) <= size &&
+        ehdr->e_phoff + static_cast<uint64_t>(ehdr->e_phnum) * sizeof(Elf64_Phdr) <= size;
+    if (!ok) {
+        munmap(addr, size);
+        return false;
+    }
+    auto shdrs = reinterpret_cast<const Elf64_Shdr*>(base + ehdr->e_shoff);
+    auto inFile = [size](uint64_t offset, uint64_t len) { return offset <= size && len <= size - offset; };
+    for (int i = 0; buildId != nullptr && i < ehdr->e_shnum; ++i) {
+        if (shdrs[i].sh_type != SHT_NOTE || !inFile(shdrs[i].sh_offset, shdrs[i].sh_size)) {
+            continue;
+        }
+        size_t pos = 0;
+        while (pos + sizeof(Elf64_Nhdr) <= shdrs[i].sh_size) {
+            auto nhdr = reinterpret_cast<const Elf64_Nhdr*>(base + shdrs[i].sh_offset + pos);
+            size_t desc = pos + sizeof(Elf64_Nhdr) + Align4(nhdr->n_namesz);
+            if (desc + nhdr->n_descsz > shdrs[i].sh_size) {
+                break;
+            }
+            const char *name = reinterpret_cast<const char*>(nhdr + 1);
+            if (nhdr->n_type == NT_GNU_BUILD_ID && nhdr->n_namesz == GNU_NOTE_NAME_SIZE &&
+                memcmp(name, "GNU", GNU_NOTE_NAME_SIZE) == 0) {
+                static const char *hex = "0123456789abcdef";
+                auto id = reinterpret_cast<const unsigned char*>(base + shdrs[i].sh_offset + desc);
+                for (size_t j = 0; j < nhdr->n_descsz; ++j) {
+                    buildId->push_back(hex[id[j] >> 4]);
+                    buildId->push_back(hex[id[j] & 0xf]);
+                }
+                break;
+            }
+            pos = desc + Align4(nhdr->n_descsz);
+        }
+    }
+    if (module != nullptr) {
+        auto phdrs = reinterpret_cast<const Elf64_Phdr*>(base + ehdr->e_phoff);
+        for (int i = 0; i < ehdr->e_phnum; ++i) {
+            if (phdrs[i].p_type == PT_LOAD && (phdrs[i].p_flags & PF_X)) {
+                module->segments.emplace_back(Segment{phdrs[i].p_offset, phdrs[i].p_vaddr, phdrs[i].p_filesz});
+            }
+        }
+        // .symtab is complete, stripped files only have .dynsym.
+        const Elf64_Shdr *symtab = nullptr;
+        for (int i = 0; i < ehdr->e_shnum; ++i) {
+            if (shdrs[i].sh_type == SHT_SYMTAB || (shdrs[i].sh_type == SHT_DYNSYM && symtab == nullptr)) {
+                symtab = &shdrs[i];
+            }
+        }
+        if (symtab != nullptr && symtab->sh_link < ehdr->e_shnum && inFile(symtab->sh_offset, symtab->sh_size) &&
+            inFile(shdrs[symtab->sh_link].sh_offset, shdrs[symtab->sh_link].sh_size)) {
+            auto syms = reinterpret_cast<const Elf64_Sym*>(base + symtab->sh_offset);
+            const char *strtab = base + shdrs[symtab->sh_link].sh_offset;
+            size_t strSize = shdrs[symtab->sh_link].sh_size;
+            for (size_t i = 0; i < symtab->sh_size / sizeof(Elf64_Sym); ++i) {
+                if (ELF64_ST_TYPE(syms[i].st_info) != STT_FUNC || syms[i].st_value == 0 ||
+                    syms[i].st_name >= strSize) {
+                    continue;
+                }
+                module->symbols.emplace_back(Sym{syms[i].st_value, syms[i].st_size,
+                    std::string(strtab + syms[i].st_name, strnlen(strtab + syms[i].st_name,
+                    strSize - syms[i].st_name))});
+            }
+            std::sort(module->symbols.begin(), module->symbols.end());
+        }
+    }
+    munmap(addr, size);
+    return true;
+}
+
+bool SymbolCache::GetBuildId(const std::string &file, std::string &buildId)
+{
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0) {
+        return false;
+    }
+    std::string key = std::to_string(st.st_dev) + ":" + std::to_string(st.st_ino) + ":" +
+        std::to_string(st.st_mtime);
+    auto it = buildIds.find(key);
+    if (it != buildIds.end()) {
+        buildId = it->second;
+        return true;
+    }
+    buildId.clear();
+    if (!LoadElf(file, &buildId, nullptr)) {
+        return false;
+    }
+    if (buildId.empty()) {
+        buildId = key;
+    }
+    if (buildIds.size() >= MAX_FILES) {
+        buildIds.clear();
+    }
+    buildIds[key] = buildId;
+    return true;
+}
+
+const SymbolCache::Module *SymbolCache::GetModule(const std::string &buildId, const std::string &file)
+{
+    for (auto it = modules.begin(); it != modules.end(); ++it) {
+        if (it->first == buildId) {
+            modules.splice(modules.begin(), modules, it);
+            return &modules.front().second;
+        }
+    }
+    Module module;
+    if (!LoadElf(file, nullptr, &module)) {
+        return nullptr;
+    }
+    if (modules.size() >= MAX_MODULES) {
+        modules.pop_back();
+    }
+    modules.emplace_front(buildId, std::move(module));
+    return &modules.front().second;
+}
+
+bool SymbolCache::LookupSymbol(const Module &module, uint64_t offset, std::string &symbol)
+{
+    for (auto &segment : module.segments) {
+        if (offset < segment.offset || offset >= segment.offset + segment.size) {
+            continue;
+        }
+        uint64_t vaddr = offset - segment.offset + segment.vaddr;
+        auto it = std::upper_bound(module.symbols.begin(), module.symbols.end(), Sym{vaddr, 0, ""});
+        if (it == module.symbols.begin()) {
+            return false;
+        }
+        --it;
+        if (it->size != 0 && vaddr >= it->addr + it->size) {
+            return false;
+        }
+        symbol = Demangle(it->name);
+        return true;
+    }
+    return false;
+}
+
+bool SymbolCache::Resolve(int pid, uint64_t addr, std::string &symbol, std::string &module)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto mapping = FindMapping(pid, addr);
+    if (mapping == nullptr) {
+        return false;
+    }
+    module = mapping->path.substr(mapping->path.find("/root/") + strlen("/root"));
+    std::string file = mapping->path;
+    uint64_t offset = addr - mapping->start + mapping->pgoff;
+    std::string buildId;
+    if (!GetBuildId(file, buildId)) {
+        return false;
+    }
+    std::string key = buildId + "+" + std::to_string(offset);
+    auto it = symbols.find(key);
+    if (it != symbols.end()) {
+        ++hits;
+        lru.splice(lru.begin(), lru, it->second);
+        symbol = it->second->symbol;
+        return !symbol.empty();
+    }
+    ++misses;
+    auto elf = GetModule(buildId, file);
+    symbol.clear();
+    if (elf != nullptr) {
+        LookupSymbol(*elf, offset, symbol);
+    }
+    // unresolved offsets are cached too, so they are not looked up again.
+    if (lru.size() >= capacity) {
+        symbols.erase(lru.back().key);
+        lru.pop_back();
+    }
+    lru.push_front(CacheEntry{key, symbol});
+    symbols[key] = lru.begin();
+    return !symbol.empty();
+}
+}
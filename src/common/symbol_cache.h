@@ -0,0 +1,96 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef COMMON_SYMBOL_CACHE_H
+#define COMMON_SYMBOL_CACHE_H
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace oeaware {
+/*
+ * Lazy symbol resolution of sampled addresses.
+ * An address of a process is mapped to (build-id, file offset) with /proc/<pid>/maps, resolved symbols are kept in
+ * a size-bounded LRU keyed by (build-id, offset), so the same library is shared by all processes and survives exec.
+ * The symbol tables of the last used modules are loaded from .symtab or .dynsym on demand. Thread safe.
+ */
+class SymbolCache {
+public:
+    SymbolCache(const SymbolCache&) = delete;
+    SymbolCache& operator=(const SymbolCache&) = delete;
+    static SymbolCache& GetInstance()
+    {
+        static SymbolCache cache;
+        return cache;
+    }
+    // symbol is demangled, module is the path of the mapped file. Return false if the address can not be resolved.
+    bool Resolve(int pid, uint64_t addr, std::string &symbol, std::string &module);
+    void SetCapacity(size_t symbols);
+    void Clear();
+    // lookups served from the LRU and lookups which read the symbol table, since the last clear.
+    uint64_t GetHits();
+    uint64_t GetMisses();
+    static const size_t DEFAULT_CAPACITY = 16384;
+private:
+    SymbolCache() = default;
+    struct Mapping {
+        uint64_t start;
+        uint64_t end;
+        uint64_t pgoff;
+        std::string path;
+    };
+    struct Segment {
+        uint64_t offset;
+        uint64_t vaddr;
+        uint64_t size;
+    };
+    struct Sym {
+        uint64_t addr;
+        uint64_t size;
+        std::string name;
+        bool operator<(const Sym &other) const
+        {
+            return addr < other.addr;
+        }
+    };
+    struct Module {
+        std::vector<Segment> segments;
+        std::vector<Sym> symbols;
+    };
+    struct CacheEntry {
+        std::string key;
+        std::string symbol;
+    };
+    const Mapping *FindMapping(int pid, uint64_t addr);
+    bool GetBuildId(const std::string &file, std::string &buildId);
+    const Module *GetModule(const std::string &buildId, const std::string &file);
+    static bool LoadElf(const std::string &file, std::string *buildId, Module *module);
+    static bool LookupSymbol(const Module &module, uint64_t offset, std::string &symbol);
+
+    std::mutex mutex;
+    size_t capacity = DEFAULT_CAPACITY;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    // key: pid
+    std::unordered_map<int, std::vector<Mapping>> maps;
+    // key: "dev:inode:mtime" of the file, value: build-id, or the key itself if the file has no build-id.
+    std::unordered_map<std::string, std::string> buildIds;
+    // key: build-id, the last used modules are in front.
+    std::list<std::pair<std::string, Module>> modules;
+    std::list<CacheEntry> lru;
+    std::unordered_map<std::string, std::list<CacheEntry>::iterator> symbols;
+};
+}
+
+#endif
@@ -19,4 +19,5 @@ void GetInstance(std::vector<std::shared_ptr<oeaware::Interface>> &interface)
     interface.emplace_back(std::make_shared<PmuSpeCollector>());
     interface.emplace_back(std::make_shared<PmuUncoreCollector>());
     interface.emplace_back(std::make_shared<PmuL3cCollector>());
+    interface.emplace_back(std::make_shared<PmuSnapshotCollector>());
 }
\ No newline at end of file
@@ -18,6 +18,7 @@
 #include "pmu_spe_collector.h"
 #include "pmu_uncore_collector.h"
 #include "pmu_l3c_collector.h"
+#include "pmu_snapshot_collector.h"
 
 extern "C" void GetInstance(std::vector<std::shared_ptr<oeaware::Interface>> &interface);
 
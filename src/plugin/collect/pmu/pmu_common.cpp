@@ -11,11 +11,15 @@
  ******************************************************************************/
 #include "pmu_common.h"
 #include <string>
+#include <algorithm>
 #include <dirent.h>
 #include "oeaware/utils.h"
 #include <fstream>
 
 static const std::string DEVICES_PATH = "/sys/bus/event_source/devices/";
+static const std::string SCOPE_PID = "pid:";
+static const std::string SCOPE_CGROUP = "cgroup:";
+static const std::vector<std::string> CGROUP_ROOTS = {"/sys/fs/cgroup/perf_event/", "/sys/fs/cgroup/"};
 
 bool IsRiscvPmuSupported() {
     std::string cpuTypePath = DEVICES_PATH + "cpu/type";
@@ -50,3 +54,69 @@ bool IsSupportPmu()
     closedir(dir);
     return false;
 }
+
+bool ParsePmuScope(const std::string &params, PmuScope &scope, std::string &err)
+{
+    scope = PmuScope();
+    if (params.empty()) {
+        return true;
+    }
+    if (params.compare(0, SCOPE_PID.size(), SCOPE_PID) == 0) {
+        for (auto &word : oeaware::SplitString(params.substr(SCOPE_PID.size()), " ")) {
+            if (word.empty()) {
+                continue;
+            }
+            if (!oeaware::IsInteger(word) || !oeaware::FileExist("/proc/" + word)) {
+                err = "pid " + word + " is invalid";
+                return false;
+            }
+            scope.pids.emplace_back(atoi(word.c_str()));
+        }
+        if (scope.pids.empty()) {
+            err = "pid list is empty";
+            return false;
+        }
+        std::sort(scope.pids.begin(), scope.pids.end());
+        scope.pids.erase(std::unique(scope.pids.begin(), scope.pids.end()), scope.pids.end());
+        return true;
+    }
+    if (params.compare(0, SCOPE_CGROUP.size(), SCOPE_CGROUP) == 0) {
+        std::string path = params.substr(SCOPE_CGROUP.size());
+        if (path.empty() || path.find("..") != std::string::npos) {
+            err = "cgroup path " + path + " is invalid";
+            return false;
+        }
+        if (path[0] == '/' && oeaware::FileExist(path + "/cgroup.procs")) {
+            scope.cgroupPath = path;
+        }
+        for (size_t i = 0; i < CGROUP_ROOTS.size() && scope.cgroupPath.empty(); ++i) {
+            std::string fullPath = CGROUP_ROOTS[i] + path;
+            if (oeaware::FileExist(fullPath + "/cgroup.procs")) {
+                scope.cgroupPath = fullPath;
+            }
+        }
+        if (scope.cgroupPath.empty() || !UpdateCgroupPids(scope)) {
+            err = "cgroup " + path + " does not exist or has no process";
+            return false;
+        }
+        return true;
+    }
+    err = "params should be empty, pid:<pid> <pid>... or cgroup:<path>";
+    return false;
+}
+
+bool UpdateCgroupPids(PmuScope &scope)
+{
+    std::ifstream file(scope.cgroupPath + "/cgroup.procs");
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<int> pids;
+    int pid;
+    while (file >> pid) {
+        pids.emplace_back(pid);
+    }
+    std::sort(pids.begin(), pids.end());
+    scope.pids.swap(pids);
+    return !scope.pids.empty();
+}
@@ -11,7 +11,30 @@
  ******************************************************************************/
 #ifndef PMU_COMMON_H
 #define PMU_COMMON_H
+#include <string>
+#include <vector>
 
 bool IsSupportPmu();
 
+// cgroup members are read again every CGROUP_REFRESH_MS, the session is reopened if they changed.
+constexpr int CGROUP_REFRESH_MS = 1000;
+
+/*
+ * Scope of a pmu session, parsed from the topic params.
+ * "" is system wide, "pid:<pid> <pid>..." is a pid list, "cgroup:<path>" are the processes of a cgroup, the path is
+ * absolute or relative to /sys/fs/cgroup/perf_event (cgroup v1) or /sys/fs/cgroup (cgroup v2).
+ */
+struct PmuScope {
+    std::vector<int> pids;
+    std::string cgroupPath;
+    bool IsSystem() const
+    {
+        return pids.empty() && cgroupPath.empty();
+    }
+};
+
+bool ParsePmuScope(const std::string &params, PmuScope &scope, std::string &err);
+// Read the pids of scope.cgroupPath into scope.pids, return false if the cgroup is empty or does not exist.
+bool UpdateCgroupPids(PmuScope &scope);
+
 #endif
@@ -13,10 +13,54 @@
 #include <algorithm>
 #include <cstdio>
 #include <iostream>
+#include <numeric>
+#include <unistd.h>
 #include <securec.h>
-#include "oeaware/data/pmu_counting_data.h"
+#include <libkperf/pcerrc.h>
+#include "oeaware/utils.h"
 #include "pmu_common.h"
 
+namespace {
+// Events which are divided by each other, each pair is counted in one perf group.
+const std::vector<std::pair<std::string, std::string>> GROUP_EVENTS = {
+    {"cycles", "instructions"}, {"L1-dcache-loads", "L1-dcache-load-misses"},
+    {"L1-icache-loads", "L1-icache-load-misses"}, {"branch-loads", "branch-load-misses"},
+    {"dTLB-loads", "dTLB-load-misses"}, {"iTLB-loads", "iTLB-load-misses"}, {"cache-references", "cache-misses"},
+    {"l1d_tlb", "l1d_tlb_refill"}, {"l1i_tlb", "l1i_tlb_refill"}, {"l2d_tlb", "l2d_tlb_refill"},
+    {"l2i_tlb", "l2i_tlb_refill"},
+};
+
+// value = numerator * scale / denominator, an empty denominator means the max cycles of the cpu in the interval.
+struct DerivedMetric {
+    std::string name;
+    std::string numerator;
+    std::string denominator;
+    double scale;
+};
+
+const std::vector<DerivedMetric> DERIVED_METRICS = {
+    {"ipc", "instructions", "cycles", 1},
+    {"cpu_busy_ratio", "cycles", "", 1},
+#ifndef __riscv
+    {"l1d_tlb_miss_rate", "l1d_tlb_refill", "l1d_tlb", 1},
+    {"l2d_cache_mpki", "l2d_cache_refill", "instructions", 1000},
+#endif
+};
+
+const DerivedMetric *FindDerivedMetric(const std::string &name)
+{
+    for (auto &metric : DERIVED_METRICS) {
+        if (metric.name == name) {
+            return &metric;
+        }
+    }
+    return nullptr;
+}
+
+constexpr double NS_PER_SEC = 1e9;
+constexpr uint64_t NS_PER_MS = 1000000;
+}
+
 PmuCountingCollector::PmuCountingCollector(): oeaware::Interface()
 {
     this->name = OE_PMU_COUNTING_COLLECTOR;
@@ -32,6 +76,13 @@ PmuCountingCollector::PmuCountingCollector(): oeaware::Interface()
         topic.params = "";
         supportTopics.push_back(topic);
     }
+    for (const auto &metric : DERIVED_METRICS) {
+        oeaware::Topic topic;
+        topic.instanceName = this->name;
+        topic.topicName = metric.name;
+        topic.params = "";
+        supportTopics.push_back(topic);
+    }
 }
 
 void PmuCountingCollector::InitCountingAttr(struct PmuAttr &attr)
@@ -53,79 +104,226 @@ void PmuCountingCollector::InitCountingAttr(struct PmuAttr &attr)
     attr.includeNewFork = 0;
 }
 
-int PmuCountingCollector::OpenCounting(const oeaware::Topic &topic)
+int PmuCountingCollector::OpenCounting(Session &session, const std::vector<std::string> &events)
 {
     struct PmuAttr attr = {};
     InitCountingAttr(attr);
+    if (!session.scope.IsSystem()) {
+        attr.pidList = session.scope.pids.data();
+        attr.numPid = session.scope.pids.size();
+        attr.includeNewFork = 1;
+    }
 
-    char *evtList[1];
-    evtList[0] = new char[topic.topicName.length() + 1];
-    errno_t ret = strcpy_s(evtList[0], topic.topicName.length() + 1, topic.topicName.c_str());
-    if (ret != EOK) {
-        std::cout << topic.topicName << " open failed, reason: strcpy_s failed" << std::endl;
-        delete[] evtList[0];
-        return -1;
+    std::vector<std::pair<std::string, std::string>> groupPairs = GROUP_EVENTS;
+    for (auto &metric : DERIVED_METRICS) {
+        if (!metric.denominator.empty()) {
+            groupPairs.emplace_back(metric.numerator, metric.denominator);
+        }
     }
-    attr.evtList = evtList;
-    attr.numEvt = 1;
+    // pairs sharing an event are merged into one group, e.g. cycles, instructions and l2d_cache_refill.
+    std::vector<int> groupOf(events.size(), -1);
+    for (auto &pair : groupPairs) {
+        auto first = std::find(events.begin(), events.end(), pair.first) - events.begin();
+        auto second = std::find(events.begin(), events.end(), pair.second) - events.begin();
+        if (first == static_cast<long>(events.size()) || second == static_cast<long>(events.size())) {
+            continue;
+        }
+        int from = groupOf[second];
+        int to = groupOf[first] != -1 ? groupOf[first] : (from != -1 ? from : static_cast<int>(first));
+        groupOf[first] = to;
+        groupOf[second] = to;
+        for (auto &group : groupOf) {
+            if (from != -1 && group == from) {
+                group = to;
+            }
+        }
+    }
+    std::vector<char*> evtList;
+    std::vector<struct EvtAttr> evtAttr(events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        evtList.emplace_back(const_cast<char*>(events[i].c_str()));
+        evtAttr[i].groupId = groupOf[i];
+    }
+    attr.evtList = evtList.data();
+    attr.numEvt = evtList.size();
+    attr.evtAttr = evtAttr.data();
 
     int pd = PmuOpen(COUNTING, &attr);
     if (pd == -1) {
-        std::cout << topic.topicName << " open failed: ";
-        perror("");
+        WARN(logger, "PmuOpen counting failed, " << Perror());
     }
-    delete[] evtList[0];
     return pd;
 }
 
-oeaware::Result PmuCountingCollector::OpenTopic(const oeaware::Topic &topic)
+std::vector<std::string> PmuCountingCollector::GetOpenEvents(const Session &session) const
 {
-    if (topic.instanceName != this->name) {
-        return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, instanceName is not match");
+    std::vector<std::string> events;
+    for (auto &topicName : topicStr) {
+        auto it = session.topicParams.find(topicName);
+        if (it != session.topicParams.end() && it->second.open &&
+            std::find(events.begin(), events.end(), topicName) == events.end()) {
+            events.emplace_back(topicName);
+        }
+    }
+    for (auto &p : session.derivedParams) {
+        auto metric = FindDerivedMetric(p.first);
+        if (!p.second.open || metric == nullptr) {
+            continue;
+        }
+        for (auto &evt : {metric->numerator, metric->denominator}) {
+            if (!evt.empty() && std::find(events.begin(), events.end(), evt) == events.end()) {
+                events.emplace_back(evt);
+            }
+        }
     }
+    return events;
+}
 
-    if (topic.params != "") {
-        return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, params is not empty");
+void PmuCountingCollector::RetireGroup(Session &session)
+{
+    if (session.groupPd == -1) {
+        return;
     }
+    PmuDisable(session.groupPd);
+    retiredGroups.emplace_back(RetiredGroup{session.groupPd, session.groupData});
+    session.groupPd = -1;
+    session.groupData = nullptr;
+}
 
-    for (auto &iter : topicStr) {
-        if (iter != topic.topicName) {
-            continue;
+void PmuCountingCollector::ReleaseRetiredGroups()
+{
+    for (auto &group : retiredGroups) {
+        if (group.data != nullptr) {
+            PmuDataFree(group.data);
         }
-        if (topicParams[iter].open) {
-            WARN(logger, topic.GetType() << " has been opened before!");
-            return oeaware::Result(OK);
+        PmuClose(group.pd);
+    }
+    retiredGroups.clear();
+}
+
+bool PmuCountingCollector::RebuildGroup(Session &session, const std::vector<std::string> &events)
+{
+    int pd = -1;
+    if (!events.empty()) {
+        pd = OpenCounting(session, events);
+        if (pd == -1) {
+            return false;
         }
-        topicParams[iter].pmuId = OpenCounting(topic);
-        if (topicParams[iter].pmuId == -1) {
-            return oeaware::Result(FAILED, "OpenTopic failed, PmuOpen failed");
+    }
+    // the counts of the old group since the last period are dropped, every topic restarts its interval.
+    RetireGroup(session);
+    session.groupPd = pd;
+    if (session.groupPd != -1) {
+        PmuEnable(session.groupPd);
+    }
+    session.timestamp = std::chrono::high_resolution_clock::now();
+    return true;
+}
+
+oeaware::Result PmuCountingCollector::OpenTopic(const oeaware::Topic &topic)
+{
+    if (topic.instanceName != this->name) {
+        return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, instanceName is not match");
+    }
+    auto metric = FindDerivedMetric(topic.topicName);
+    if (metric == nullptr && std::find(topicStr.begin(), topicStr.end(), topic.topicName) == topicStr.end()) {
+        return oeaware::Result(FAILED, "OpenTopic " + topic.GetType() + "failed, no support topic!");
+    }
+    if (fallback) {
+        return OpenFallbackTopic(topic);
+    }
+    bool newSession = !sessions.count(topic.params);
+    auto &session = sessions[topic.params];
+    if (newSession) {
+        std::string err;
+        if (!ParsePmuScope(topic.params, session.scope, err)) {
+            sessions.erase(topic.params);
+            return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, " + err);
         }
-        PmuEnable(topicParams[iter].pmuId);
-        topicParams[iter].timestamp = std::chrono::high_resolution_clock::now();
-        topicParams[iter].open = true;
+        session.refreshTime = std::chrono::high_resolution_clock::now();
+    }
+    bool &open = metric != nullptr ? session.derivedParams[topic.topicName].open :
+        session.topicParams[topic.topicName].open;
+    if (open) {
+        WARN(logger, topic.GetType() << " has been opened before!");
+        return oeaware::Result(OK);
+    }
+    open = true;
+    if (!RebuildGroup(session, GetOpenEvents(session))) {
+        open = false;
+        return oeaware::Result(FAILED, "OpenTopic failed, PmuOpen failed");
+    }
+    if (metric != nullptr && metric->denominator.empty() && maxCycles.empty()) {
+        InitMaxCycles();
+    }
+    return oeaware::Result(OK);
+}
+
+oeaware::Result PmuCountingCollector::OpenFallbackTopic(const oeaware::Topic &topic)
+{
+    if (!topic.params.empty() || FindDerivedMetric(topic.topicName) != nullptr) {
+        return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, not supported without PMU");
+    }
+    auto &param = fallbackTopics[topic.topicName];
+    if (param.open) {
+        WARN(logger, topic.GetType() << " has been opened before!");
         return oeaware::Result(OK);
     }
-    return oeaware::Result(FAILED, "OpenTopic " + topic.GetType() + "failed, no support topic!");
+    std::string err;
+    if (!fallbackCounting.Open(topic.topicName, err)) {
+        return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, " + err);
+    }
+    if (std::none_of(fallbackTopics.begin(), fallbackTopics.end(),
+        [](const std::pair<const std::string, TopicParam> &p) { return p.second.open; })) {
+        fallbackTimestamp = std::chrono::high_resolution_clock::now();
+    }
+    param.open = true;
+    return oeaware::Result(OK);
 }
 
 void PmuCountingCollector::CloseTopic(const oeaware::Topic &topic)
 {
-    if (!topicParams[topic.topicName].open) {
+    auto fallbackIt = fallbackTopics.find(topic.topicName);
+    if (fallback && topic.params.empty() && fallbackIt != fallbackTopics.end() && fallbackIt->second.open) {
+        // the buffer of the topic is kept, it may be referenced by the last publication.
+        fallbackIt->second.open = false;
+        fallbackCounting.Close(topic.topicName);
+        return;
+    }
+    auto it = sessions.find(topic.params);
+    if (it == sessions.end()) {
         WARN(logger, "CloseTopic failed, " + topic.GetType() + " not open.");
         return;
     }
-    PmuDisable(topicParams[topic.topicName].pmuId);
-    PmuClose(topicParams[topic.topicName].pmuId);
-    topicParams[topic.topicName].pmuId = -1;
-    topicParams[topic.topicName].open = false;
+    auto &session = it->second;
+    bool derived = FindDerivedMetric(topic.topicName) != nullptr;
+    bool &open = derived ? session.derivedParams[topic.topicName].open : session.topicParams[topic.topicName].open;
+    if (!open) {
+        WARN(logger, "CloseTopic failed, " + topic.GetType() + " not open.");
+        return;
+    }
+    open = false;
+    // the session without topics is removed in the next period, after its last publication has been handled.
+    if (!RebuildGroup(session, GetOpenEvents(session))) {
+        // keep counting the remaining events in the old group, the closed one is not published any more.
+        WARN(logger, "reopen counting group failed after closing " << topic.GetType());
+    }
 }
 
 oeaware::Result PmuCountingCollector::Enable(const std::string &param)
 {
     (void)param;
-    if (!IsSupportPmu()) {
-        return oeaware::Result(FAILED, "the system does not support PMU.");
+    bool supportPmu = IsSupportPmu();
+    if (!supportPmu && !fallback) {
+        INFO(logger, "the system does not support PMU, counting events with perf_event_open, data is approximate.");
     }
+    fallback = !supportPmu;
+    ReleaseRetiredGroups();
+    cpuNum = sysconf(_SC_NPROCESSORS_CONF);
+    if (cpuNum <= 0) {
+        return oeaware::Result(FAILED, "can not get cpu num.");
+    }
+    maxCycles.clear();
     return oeaware::Result(OK);
 }
 
@@ -140,32 +338,197 @@ void PmuCountingCollector::UpdateData(const DataList &dataList)
     return;
 }
 
-void PmuCountingCollector::Run()
+void PmuCountingCollector::PublishTopic(const std::string &topicName, const std::string &params, TopicParam &param,
+    uint64_t interval)
 {
-    for (auto &topicName : topicStr) {
-        if (!topicParams[topicName].open) {
+    param.data.pmuData = param.pmuData.data();
+    param.data.len = static_cast<int>(param.pmuData.size());
+    param.data.interval = interval;
+    param.data.approximate = fallback ? 1 : 0;
+    DataList dataList;
+    if (!oeaware::SetDataListTopic(&dataList, name, topicName, params)) {
+        return;
+    }
+    dataList.data = new void *[1];
+    dataList.len = 1;
+    dataList.data[0] = &param.data;
+    Publish(dataList, false);
+}
+
+void PmuCountingCollector::InitMaxCycles()
+{
+    maxCycles.assign(cpuNum, 0);
+    uint64_t dmiFreq = 0;
+    for (int cpu = 0; cpu < cpuNum; ++cpu) {
+        maxCycles[cpu] = oeaware::GetCpuCycles(cpu);
+        if (maxCycles[cpu] == 0) {
+            // dmidecode is slow, only run it once
+            if (dmiFreq == 0) {
+                dmiFreq = oeaware::GetCpuFreqByDmi();
+            }
+            maxCycles[cpu] = dmiFreq;
+        }
+    }
+}
+
+void PmuCountingCollector::PublishDerived(const std::string &params, Session &session,
+    const std::unordered_map<std::string, std::vector<double>> &cpuCounts,
+    const std::unordered_map<std::string, double> &totalCounts, uint64_t intervalNs)
+{
+    const std::vector<double> zero(cpuNum, 0);
+    auto getCounts = [&](const std::string &evt) -> const std::vector<double>& {
+        auto it = cpuCounts.find(evt);
+        return it == cpuCounts.end() ? zero : it->second;
+    };
+    auto getTotal = [&](const std::string &evt) {
+        auto it = totalCounts.find(evt);
+        return it == totalCounts.end() ? 0.0 : it->second;
+    };
+    std::vector<double> intervalMaxCycles(cpuNum, 0);
+    for (int cpu = 0; cpu < cpuNum && cpu < static_cast<int>(maxCycles.size()); ++cpu) {
+        intervalMaxCycles[cpu] = maxCycles[cpu] * (intervalNs / NS_PER_SEC);
+    }
+    for (auto &metric : DERIVED_METRICS) {
+        auto it = session.derivedParams.find(metric.name);
+        if (it == session.derivedParams.end() || !it->second.open) {
             continue;
         }
-        int pmuId = topicParams[topicName].pmuId;
-        PmuCountingData *data = new PmuCountingData();
-        PmuDisable(pmuId);
-        data->len = PmuRead(pmuId, &(data->pmuData));
-        PmuEnable(pmuId);
-        // calculate the actual collection time
-        auto now = std::chrono::high_resolution_clock::now();
-        data->interval = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - topicParams[topicName].timestamp).count();
-        topicParams[topicName].timestamp = now;
+        auto &param = it->second;
+        auto &num = getCounts(metric.numerator);
+        auto &den = metric.denominator.empty() ? intervalMaxCycles : getCounts(metric.denominator);
+        param.values.assign(cpuNum, 0);
+        for (int cpu = 0; cpu < cpuNum; ++cpu) {
+            param.values[cpu] = den[cpu] > 0 ? num[cpu] * metric.scale / den[cpu] : 0;
+        }
+        // task scoped counts may have no cpu, the total is computed from all counts.
+        double numSum = getTotal(metric.numerator);
+        double denSum = metric.denominator.empty() ? std::accumulate(den.begin(), den.end(), 0.0) :
+            getTotal(metric.denominator);
+        param.data.len = cpuNum;
+        param.data.values = param.values.data();
+        param.data.total = denSum > 0 ? numSum * metric.scale / denSum : 0;
+        param.data.intervalNs = intervalNs;
         DataList dataList;
-        dataList.topic.instanceName = new char[name.size() + 1];
-        strcpy_s(dataList.topic.instanceName, name.size() + 1, name.data());
-        dataList.topic.topicName = new char[topicName.size() + 1];
-        strcpy_s(dataList.topic.topicName, topicName.size() + 1, topicName.data());
-        dataList.topic.params = new char[1];
-        dataList.topic.params[0] = 0;
+        if (!oeaware::SetDataListTopic(&dataList, name, metric.name, params)) {
+            continue;
+        }
         dataList.data = new void *[1];
         dataList.len = 1;
-        dataList.data[0] = data;
-        Publish(dataList);
+        dataList.data[0] = &param.data;
+        Publish(dataList, false);
+    }
+}
+
+void PmuCountingCollector::RefreshScope(Session &session)
+{
+    auto now = std::chrono::high_resolution_clock::now();
+    if (session.scope.cgroupPath.empty() ||
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - session.refreshTime).count() < CGROUP_REFRESH_MS) {
+        return;
+    }
+    session.refreshTime = now;
+    auto oldPids = session.scope.pids;
+    if (!UpdateCgroupPids(session.scope)) {
+        // keep counting the old tasks, the cgroup may be filled again.
+        session.scope.pids = oldPids;
+        return;
+    }
+    if (session.scope.pids != oldPids && !RebuildGroup(session, GetOpenEvents(session))) {
+        WARN(logger, "reopen counting group of cgroup " << session.scope.cgroupPath << " failed.");
+    }
+}
+
+void PmuCountingCollector::ReadSession(const std::string &params, Session &session)
+{
+    RefreshScope(session);
+    if (session.groupPd == -1) {
+        return;
+    }
+    PmuData *data = nullptr;
+    PmuDisable(session.groupPd);
+    int len = PmuRead(session.groupPd, &data);
+    PmuEnable(session.groupPd);
+    // calculate the actual collection time
+    auto now = std::chrono::high_resolution_clock::now();
+    uint64_t intervalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - session.timestamp).count();
+    session.timestamp = now;
+    if (session.groupData != nullptr) {
+        PmuDataFree(session.groupData);
     }
-}
\ No newline at end of file
+    session.groupData = data;
+    for (auto &p : session.topicParams) {
+        p.second.pmuData.clear();
+    }
+    bool derivedOpen = std::any_of(session.derivedParams.begin(), session.derivedParams.end(),
+        [](const std::pair<const std::string, DerivedParam> &p) { return p.second.open; });
+    // key: event, value: scaled count of every cpu.
+    std::unordered_map<std::string, std::vector<double>> cpuCounts;
+    std::unordered_map<std::string, double> totalCounts;
+    for (int i = 0; i < len; ++i) {
+        if (data[i].evt == nullptr) {
+            continue;
+        }
+        PmuData pmuData = data[i];
+        // countPercent is time_running / time_enabled, estimate the count of the whole period.
+        if (pmuData.countPercent > 0 && pmuData.countPercent < 1) {
+            pmuData.count = static_cast<uint64_t>(pmuData.count / pmuData.countPercent);
+        }
+        if (derivedOpen) {
+            totalCounts[pmuData.evt] += pmuData.count;
+            if (pmuData.cpu >= 0 && pmuData.cpu < cpuNum) {
+                auto &counts = cpuCounts[pmuData.evt];
+                counts.resize(cpuNum, 0);
+                counts[pmuData.cpu] += pmuData.count;
+            }
+        }
+        auto it = session.topicParams.find(pmuData.evt);
+        if (it == session.topicParams.end() || !it->second.open) {
+            continue;
+        }
+        it->second.pmuData.emplace_back(pmuData);
+    }
+    for (auto &topicName : topicStr) {
+        auto it = session.topicParams.find(topicName);
+        if (it == session.topicParams.end() || !it->second.open) {
+            continue;
+        }
+        PublishTopic(topicName, params, it->second, intervalNs / NS_PER_MS);
+    }
+    if (derivedOpen) {
+        PublishDerived(params, session, cpuCounts, totalCounts, intervalNs);
+    }
+}
+
+void PmuCountingCollector::ReadFallback()
+{
+    auto now = std::chrono::high_resolution_clock::now();
+    uint64_t interval = std::chrono::duration_cast<std::chrono::milliseconds>(now - fallbackTimestamp).count();
+    fallbackTimestamp = now;
+    for (auto &topicName : topicStr) {
+        auto it = fallbackTopics.find(topicName);
+        if (it == fallbackTopics.end() || !it->second.open) {
+            continue;
+        }
+        it->second.pmuData.clear();
+        fallbackCounting.Read(topicName, it->second.pmuData);
+        PublishTopic(topicName, "", it->second, interval);
+    }
+}
+
+void PmuCountingCollector::Run()
+{
+    if (fallback) {
+        ReadFallback();
+        return;
+    }
+    // the publications of the last period have been handled, the buffers of closed groups can be released.
+    ReleaseRetiredGroups();
+    for (auto it = sessions.begin(); it != sessions.end();) {
+        if (it->second.groupPd == -1) {
+            it = sessions.erase(it);
+            continue;
+        }
+        ReadSession(it->first, it->second);
+        ++it;
+    }
+}
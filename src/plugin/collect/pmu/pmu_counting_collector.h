@@ -14,7 +14,25 @@
 #define PMU_COUNTING_COLLECTOR_H
 #include <unordered_map>
 #include <chrono>
+#include <string>
+#include <vector>
 #include "oeaware/interface.h"
+#include "oeaware/data/pmu_counting_data.h"
+#include "pmu_common.h"
+#include "pmu_fallback.h"
+
+/*
+ * All open counting topics share one PmuOpen, every topic is a member of the event list. Events whose counts are
+ * divided by each other (loads and misses, tlb and tlb_refill) are put in one perf group so that they are scheduled
+ * together when the kernel multiplexes the counters, the other events are multiplexed individually.
+ * The group is read once per period and the data is split into one publication per topic, counts are scaled by
+ * time_enabled / time_running.
+ * Derived topics (ipc, cpu_busy_ratio, ...) are defined by an expression table, their operands are added to the
+ * group and the metrics are computed from the same read, see PmuDerivedData.
+ * The topic params select the scope (see PmuScope), topics with the same params share one session, the session is
+ * closed when its last topic is closed.
+ * Without a supported PMU the system wide topics are counted by CountingFallback and marked as approximate.
+ */
 
 class PmuCountingCollector : public oeaware::Interface {
 public:
@@ -29,8 +47,28 @@ public:
 private:
     struct TopicParam {
         bool open = false;
-        int pmuId = -1;
+        // publication of the topic, points to pmuData and is reused every period.
+        PmuCountingData data;
+        std::vector<PmuData> pmuData;
+    };
+    struct DerivedParam {
+        bool open = false;
+        PmuDerivedData data;
+        std::vector<double> values;
+    };
+    struct Session {
+        PmuScope scope;
+        std::unordered_map<std::string, TopicParam> topicParams;
+        std::unordered_map<std::string, DerivedParam> derivedParams;
+        int groupPd = -1;
+        PmuData *groupData = nullptr;
         std::chrono::time_point<std::chrono::high_resolution_clock> timestamp;
+        std::chrono::time_point<std::chrono::high_resolution_clock> refreshTime;
+    };
+    // a closed pmu group, released in the next period after its last publication has been handled.
+    struct RetiredGroup {
+        int pd;
+        PmuData *data;
     };
 #ifdef __riscv
     std::vector<std::string> topicStr = {"cycles", "net:netif_rx", "L1-dcache-load-misses", "L1-dcache-loads", 
@@ -45,9 +83,33 @@ private:
         "l2i_tlb", "l2i_tlb_refill", "inst_retired", "instructions", "sched:sched_process_fork",
         "sched:sched_process_exit"};
 #endif
-    std::unordered_map<std::string, TopicParam> topicParams;
+    // key: topic params
+    std::unordered_map<std::string, Session> sessions;
+    int cpuNum = 0;
+    // max cycles per second of every cpu, used by cpu_busy_ratio.
+    std::vector<uint64_t> maxCycles;
+    std::vector<RetiredGroup> retiredGroups;
+    bool fallback = false;
+    CountingFallback fallbackCounting;
+    // key: topic name, topics counted by fallbackCounting.
+    std::unordered_map<std::string, TopicParam> fallbackTopics;
+    std::chrono::time_point<std::chrono::high_resolution_clock> fallbackTimestamp;
     void InitCountingAttr(struct PmuAttr &attr);
-    int OpenCounting(const oeaware::Topic &topic);
+    int OpenCounting(Session &session, const std::vector<std::string> &events);
+    bool RebuildGroup(Session &session, const std::vector<std::string> &events);
+    void RetireGroup(Session &session);
+    void ReleaseRetiredGroups();
+    std::vector<std::string> GetOpenEvents(const Session &session) const;
+    void RefreshScope(Session &session);
+    void ReadSession(const std::string &params, Session &session);
+    void PublishTopic(const std::string &topicName, const std::string &params, TopicParam &param,
+        uint64_t interval);
+    void InitMaxCycles();
+    oeaware::Result OpenFallbackTopic(const oeaware::Topic &topic);
+    void ReadFallback();
+    void PublishDerived(const std::string &params, Session &session,
+        const std::unordered_map<std::string, std::vector<double>> &cpuCounts,
+        const std::unordered_map<std::string, double> &totalCounts, uint64_t intervalNs);
 };
 
 #endif
@@ -0,0 +1,620 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "pmu_fallback.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "oeaware/utils.h"
+
+namespace {
+const std::vector<std::string> TRACEFS_PATHS = {"/sys/kernel/tracing/events/", "/sys/kernel/debug/tracing/events/"};
+const std::string SCHEDSTAT_PATH = "/proc/schedstat";
+const std::string NODE_PATH = "/sys/devices/system/node/";
+const std::string CPU_PATH = "/sys/devices/system/cpu/";
+const char *EMPTY_COMM = "";
+constexpr double NS_PER_SEC = 1e9;
+constexpr uint64_t HZ_PER_KHZ = 1000;
+// the 7th field of a cpu line in /proc/schedstat is the time spent running tasks in ns.
+constexpr size_t SCHEDSTAT_RUN_TIME_FIELD = 7;
+// data pages of every sampling ring, a power of 2.
+constexpr size_t RING_DATA_PAGES = 64;
+constexpr size_t RAW_ALIGN = sizeof(uint64_t);
+
+uint64_t HwCacheConfig(uint64_t cache, uint64_t op, uint64_t result)
+{
+    return cache | (op << 8) | (result << 16);
+}
+
+const std::unordered_map<std::string, std::pair<uint32_t, uint64_t>> &EventTable()
+{
+    static const std::unordered_map<std::string, std::pair<uint32_t, uint64_t>> table = {
+        {"cycles", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES}},
+        {"instructions", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS}},
+        {"cache-references", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES}},
+        {"cache-misses", {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES}},
+        {"L1-dcache-loads", {PERF_TYPE_HW_CACHE, HwCacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+            PERF_COUNT_HW_CACHE_RESULT_ACCESS)}},
+        {"L1-dcache-load-misses", {PERF_TYPE_HW_CACHE, HwCacheConfig(PERF_COUNT_HW_CACHE_L1D,
+            PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)}},
+        {"L1-icache-loads", {PERF_TYPE_HW_CACHE, HwCacheConfig(PERF_COUNT_HW_CACHE_L1I, PERF_COUNT_HW_CACHE_OP_READ,
+            PERF_COUNT_HW_CACHE_RESULT_ACCESS)}},
+        {"L1-icache-load-misses", {PERF_TYPE_HW_CACHE, HwCacheConfig(PERF_COUNT_HW_CACHE_L1I,
+            PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)}},
+        {"branch-loads", {PERF_TYPE_HW_CACHE, HwCacheConfig(PERF_COUNT_HW_CACHE_BPU, PERF_COUNT_HW_CACHE_OP_READ,
+            PERF_COUNT_HW_CACHE_RESULT_ACCESS)}},
+        {"branch-load-misses", {PERF_TYPE_HW_CACHE, HwCacheConfig(PERF_COUNT_HW_CACHE_BPU,
+            PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)}},
+        {"dTLB-loads", {PERF_TYPE_HW_CACHE, HwCacheConfig(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+            PERF_COUNT_HW_CACHE_RESULT_ACCESS)}},
+        {"dTLB-load-misses", {PERF_TYPE_HW_CACHE, HwCacheConfig(PERF_COUNT_HW_CACHE_DTLB,
+            PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)}},
+        {"iTLB-loads", {PERF_TYPE_HW_CACHE, HwCacheConfig(PERF_COUNT_HW_CACHE_ITLB, PERF_COUNT_HW_CACHE_OP_READ,
+            PERF_COUNT_HW_CACHE_RESULT_ACCESS)}},
+        {"iTLB-load-misses", {PERF_TYPE_HW_CACHE, HwCacheConfig(PERF_COUNT_HW_CACHE_ITLB,
+            PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)}},
+#ifdef __aarch64__
+        // common architectural events of the armv8 pmu, counted when the pmu is not supported by libkperf.
+        {"l1i_tlb_refill", {PERF_TYPE_RAW, 0x02}},
+        {"l1d_cache_refill", {PERF_TYPE_RAW, 0x03}},
+        {"l1d_tlb_refill", {PERF_TYPE_RAW, 0x05}},
+        {"inst_retired", {PERF_TYPE_RAW, 0x08}},
+        {"l2d_cache_refill", {PERF_TYPE_RAW, 0x17}},
+        {"l1d_tlb", {PERF_TYPE_RAW, 0x25}},
+        {"l1i_tlb", {PERF_TYPE_RAW, 0x26}},
+        {"l2d_tlb_refill", {PERF_TYPE_RAW, 0x2D}},
+        {"l2i_tlb_refill", {PERF_TYPE_RAW, 0x2E}},
+        {"l2d_tlb", {PERF_TYPE_RAW, 0x2F}},
+        {"l2i_tlb", {PERF_TYPE_RAW, 0x30}},
+#endif
+    };
+    return table;
+}
+
+bool ReadTracepointId(const std::string &root, const std::string &evt, uint64_t &id)
+{
+    auto pos = evt.find(':');
+    if (pos == std::string::npos) {
+        return false;
+    }
+    for (auto &path : TRACEFS_PATHS) {
+        std::ifstream file(root + path + evt.substr(0, pos) + "/" + evt.substr(pos + 1) + "/id");
+        if (file.is_open() && (file >> id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LookupEvent(const std::string &root, const std::string &evt, uint32_t &type, uint64_t &config)
+{
+    if (evt.find(':') != std::string::npos) {
+        type = PERF_TYPE_TRACEPOINT;
+        return ReadTracepointId(root, evt, config);
+    }
+    auto &table = EventTable();
+    auto it = table.find(evt);
+    if (it == table.end()) {
+        return false;
+    }
+    type = it->second.first;
+    config = it->second.second;
+    return true;
+}
+
+std::string EventNotFound(const std::string &evt)
+{
+    return evt.find(':') != std::string::npos ? "tracepoint " + evt + " is not found in tracefs" :
+        "event " + evt + " is not supported without PMU";
+}
+
+int PerfEventOpen(struct perf_event_attr &attr, int pid, int cpu)
+{
+    return syscall(SYS_perf_event_open, &attr, pid, cpu, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+int GetCpuNum()
+{
+    int cpuNum = sysconf(_SC_NPROCESSORS_CONF);
+    return cpuNum > 0 ? cpuNum : 0;
+}
+
+std::vector<CpuTopology> GetCpuTopology(const std::string &root, int cpuNum)
+{
+    std::vector<CpuTopology> cpuTopo(cpuNum);
+    for (int cpu = 0; cpu < cpuNum; ++cpu) {
+        cpuTopo[cpu].coreId = cpu;
+        cpuTopo[cpu].numaId = -1;
+        cpuTopo[cpu].socketId = -1;
+    }
+    for (auto &name : oeaware::DirectoryWalker::ListFiles(root + NODE_PATH)) {
+        if (name.compare(0, strlen("node"), "node") != 0 || !oeaware::IsInteger(name.substr(strlen("node")))) {
+            continue;
+        }
+        std::ifstream file(root + NODE_PATH + name + "/cpulist");
+        std::string cpuList;
+        if (!std::getline(file, cpuList)) {
+            continue;
+        }
+        for (auto cpu : oeaware::ParseRange(cpuList)) {
+            if (cpu >= 0 && cpu < cpuNum) {
+                cpuTopo[cpu].numaId = atoi(name.c_str() + strlen("node"));
+            }
+        }
+    }
+    return cpuTopo;
+}
+
+uint64_t ReadCpuFreq(const std::string &root, int cpu)
+{
+    std::ifstream file(root + CPU_PATH + "cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq");
+    uint64_t freq = 0;
+    if (!file.is_open() || !(file >> freq)) {
+        return 0;
+    }
+    return freq * HZ_PER_KHZ;
+}
+
+// Copies len bytes at offset of the data area of a ring, the record may wrap around its end.
+void CopyFromRing(const char *ringData, size_t ringSize, uint64_t offset, char *dst, size_t len)
+{
+    size_t begin = offset & (ringSize - 1);
+    size_t first = std::min(len, ringSize - begin);
+    memcpy(dst, ringData + begin, first);
+    memcpy(dst + first, ringData, len - first);
+}
+}
+
+CyclesEstimate::CyclesEstimate(int cpuNum, const std::string &root) : cpuNum(cpuNum), root(root)
+{
+}
+
+bool CyclesEstimate::Init()
+{
+    if (!ReadSchedstat(lastRunNs)) {
+        return false;
+    }
+    cyclesPerNs.assign(cpuNum, 1);
+    uint64_t dmiFreq = 0;
+    for (int cpu = 0; cpu < cpuNum; ++cpu) {
+        uint64_t freq = ReadCpuFreq(root, cpu);
+        // dmidecode is slow, only run it once, and never for fixture files.
+        if (freq == 0 && dmiFreq == 0 && root.empty()) {
+            dmiFreq = oeaware::GetCpuFreqByDmi();
+        }
+        freq = freq != 0 ? freq : dmiFreq;
+        if (freq != 0) {
+            cyclesPerNs[cpu] = freq / NS_PER_SEC;
+        }
+    }
+    return true;
+}
+
+bool CyclesEstimate::ReadSchedstat(std::vector<uint64_t> &runNs) const
+{
+    std::ifstream file(root + SCHEDSTAT_PATH);
+    if (!file.is_open()) {
+        return false;
+    }
+    runNs.assign(cpuNum, 0);
+    std::string line;
+    bool found = false;
+    while (std::getline(file, line)) {
+        if (line.compare(0, strlen("cpu"), "cpu") != 0) {
+            continue;
+        }
+        std::istringstream ss(line);
+        std::string name;
+        ss >> name;
+        int cpu = atoi(name.c_str() + strlen("cpu"));
+        std::vector<uint64_t> fields;
+        uint64_t value = 0;
+        while (ss >> value) {
+            fields.emplace_back(value);
+        }
+        if (fields.size() >= SCHEDSTAT_RUN_TIME_FIELD && cpu >= 0 && cpu < cpuNum) {
+            runNs[cpu] = fields[SCHEDSTAT_RUN_TIME_FIELD - 1];
+            found = true;
+        }
+    }
+    return found;
+}
+
+bool CyclesEstimate::Read(std::vector<uint64_t> &cycles)
+{
+    std::vector<uint64_t> runNs;
+    if (!ReadSchedstat(runNs)) {
+        return false;
+    }
+    cycles.assign(cpuNum, 0);
+    for (int cpu = 0; cpu < cpuNum; ++cpu) {
+        uint64_t delta = runNs[cpu] >= lastRunNs[cpu] ? runNs[cpu] - lastRunNs[cpu] : 0;
+        cycles[cpu] = static_cast<uint64_t>(delta * cyclesPerNs[cpu]);
+    }
+    lastRunNs = runNs;
+    return true;
+}
+
+CountingFallback::CountingFallback(const std::string &root) : root(root)
+{
+    cpuNum = GetCpuNum();
+    cpuTopo = GetCpuTopology(root, cpuNum);
+}
+
+CountingFallback::~CountingFallback()
+{
+    CloseAll();
+}
+
+bool CountingFallback::GetEventConfig(const std::string &evt, uint32_t &type, uint64_t &config) const
+{
+    return LookupEvent(root, evt, type, config);
+}
+
+bool CountingFallback::OpenPerf(Event &event, uint32_t type, uint64_t config, std::string &err)
+{
+    struct perf_event_attr attr = {};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    event.fds.assign(cpuNum, -1);
+    bool opened = false;
+    for (int cpu = 0; cpu < cpuNum; ++cpu) {
+        // offline cpus fail and are skipped.
+        event.fds[cpu] = PerfEventOpen(attr, -1, cpu);
+        opened |= event.fds[cpu] >= 0;
+    }
+    if (!opened) {
+        err = "perf_event_open " + std::string(event.name) + " failed, " + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool CountingFallback::Open(const std::string &evt, std::string &err)
+{
+    if (events.count(evt)) {
+        return true;
+    }
+    Event event;
+    // the name is referenced by published data, it is kept after the event is closed.
+    event.name = names.insert(evt).first->c_str();
+    event.lastValue.assign(cpuNum, 0);
+    event.lastEnabled.assign(cpuNum, 0);
+    event.lastRunning.assign(cpuNum, 0);
+    uint32_t type = 0;
+    uint64_t config = 0;
+    if (!GetEventConfig(evt, type, config)) {
+        err = EventNotFound(evt);
+        return false;
+    }
+    if (!OpenPerf(event, type, config, err)) {
+        if (evt != "cycles") {
+            return false;
+        }
+        // no cycles counter, estimate cycles from the run time.
+        event.fds.clear();
+        event.estimate.reset(new CyclesEstimate(cpuNum, root));
+        if (!event.estimate->Init()) {
+            return false;
+        }
+    }
+    events.emplace(evt, std::move(event));
+    return true;
+}
+
+void CountingFallback::Close(const std::string &evt)
+{
+    auto it = events.find(evt);
+    if (it == events.end()) {
+        return;
+    }
+    for (auto fd : it->second.fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    events.erase(it);
+}
+
+void CountingFallback::CloseAll()
+{
+    while (!events.empty()) {
+        Close(events.begin()->first);
+    }
+}
+
+void CountingFallback::ReadCyclesEstimate(Event &event, std::vector<PmuData> &data)
+{
+    std::vector<uint64_t> cycles;
+    if (!event.estimate->Read(cycles)) {
+        return;
+    }
+    for (int cpu = 0; cpu < cpuNum; ++cpu) {
+        PmuData pmuData = {};
+        pmuData.evt = event.name;
+        pmuData.cpu = cpu;
+        pmuData.cpuTopo = &cpuTopo[cpu];
+        pmuData.comm = EMPTY_COMM;
+        pmuData.count = cycles[cpu];
+        pmuData.countPercent = 1;
+        data.emplace_back(pmuData);
+    }
+}
+
+void CountingFallback::Read(const std::string &evt, std::vector<PmuData> &data)
+{
+    auto it = events.find(evt);
+    if (it == events.end()) {
+        return;
+    }
+    auto &event = it->second;
+    if (event.estimate != nullptr) {
+        ReadCyclesEstimate(event, data);
+        return;
+    }
+    for (int cpu = 0; cpu < cpuNum; ++cpu) {
+        // value, time_enabled, time_running
+        uint64_t values[3] = {0, 0, 0};
+        if (event.fds[cpu] < 0 || read(event.fds[cpu], values, sizeof(values)) != sizeof(values)) {
+            continue;
+        }
+        uint64_t count = values[0] - event.lastValue[cpu];
+        uint64_t enabled = values[1] - event.lastEnabled[cpu];
+        uint64_t running = values[2] - event.lastRunning[cpu];
+        event.lastValue[cpu] = values[0];
+        event.lastEnabled[cpu] = values[1];
+        event.lastRunning[cpu] = values[2];
+        PmuData pmuData = {};
+        pmuData.evt = event.name;
+        pmuData.cpu = cpu;
+        pmuData.cpuTopo = &cpuTopo[cpu];
+        pmuData.comm = EMPTY_COMM;
+        pmuData.countPercent = enabled > 0 ? static_cast<double>(running) / enabled : 1;
+        // the counter was multiplexed, estimate the count of the whole period.
+        pmuData.count = (pmuData.countPercent > 0 && pmuData.countPercent < 1) ?
+            static_cast<uint64_t>(count / pmuData.countPercent) : count;
+        data.emplace_back(pmuData);
+    }
+}
+
+SamplingFallback::SamplingFallback(const std::string &root) : root(root)
+{
+    pageSize = sysconf(_SC_PAGESIZE);
+    cpuTopo = GetCpuTopology(root, GetCpuNum());
+}
+
+SamplingFallback::~SamplingFallback()
+{
+    Close();
+}
+
+bool SamplingFallback::OpenRing(struct perf_event_attr &attr, int pid, int cpu)
+{
+    Ring ring;
+    ring.fd = PerfEventOpen(attr, pid, cpu);
+    if (ring.fd < 0) {
+        return false;
+    }
+    ring.size = (RING_DATA_PAGES + 1) * pageSize;
+    void *base = mmap(nullptr, ring.size, PROT_READ | PROT_WRITE, MAP_SHARED, ring.fd, 0);
+    if (base == MAP_FAILED) {
+        close(ring.fd);
+        return false;
+    }
+    ring.base = static_cast<char*>(base);
+    rings.emplace_back(ring);
+    fds.emplace_back(ring.fd);
+    return true;
+}
+
+bool SamplingFallback::Open(const std::string &evt, const std::vector<int> &pids, uint64_t period, bool useFreq,
+    bool callStack, std::string &err)
+{
+    Close();
+    evtName = evt;
+    struct perf_event_attr attr = {};
+    attr.size = sizeof(attr);
+    uint32_t type = 0;
+    uint64_t config = 0;
+    if (!LookupEvent(root, evt, type, config)) {
+        err = EventNotFound(evt);
+        return false;
+    }
+    attr.type = type;
+    attr.config = config;
+    attr.freq = useFreq ? 1 : 0;
+    attr.sample_period = period;
+    attr.sample_type = PERF_SAMPLE_IP | PERF_SAMPLE_TID | PERF_SAMPLE_TIME | PERF_SAMPLE_CPU | PERF_SAMPLE_PERIOD;
+    if (callStack) {
+        attr.sample_type |= PERF_SAMPLE_CALLCHAIN;
+    }
+    if (type == PERF_TYPE_TRACEPOINT) {
+        attr.sample_type |= PERF_SAMPLE_RAW;
+    }
+    sampleType = attr.sample_type;
+    attr.disabled = 1;
+    auto openAll = [&]() {
+        if (pids.empty()) {
+            // offline cpus fail and are skipped.
+            for (int cpu = 0; cpu < static_cast<int>(cpuTopo.size()); ++cpu) {
+                OpenRing(attr, -1, cpu);
+            }
+        } else {
+            // exited tasks fail and are skipped.
+            for (auto pid : pids) {
+                OpenRing(attr, pid, -1);
+            }
+        }
+        return !rings.empty();
+    };
+    if (!openAll() && evt == "cycles") {
+        // no cycles counter, sample the cpu clock at the same frequency.
+        attr.type = PERF_TYPE_SOFTWARE;
+        attr.config = PERF_COUNT_SW_CPU_CLOCK;
+        openAll();
+    }
+    if (rings.empty()) {
+        err = "perf_event_open " + evt + " failed, " + strerror(errno);
+        return false;
+    }
+    for (auto &ring : rings) {
+        ioctl(ring.fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    return true;
+}
+
+void SamplingFallback::Close()
+{
+    for (auto &ring : rings) {
+        munmap(ring.base, ring.size);
+        close(ring.fd);
+    }
+    rings.clear();
+    fds.clear();
+}
+
+void SamplingFallback::ParseSample(const char *sample, size_t size)
+{
+    size_t pos = 0;
+    auto next = [&](void *dst, size_t len) {
+        if (pos + len > size) {
+            return false;
+        }
+        memcpy(dst, sample + pos, len);
+        pos += len;
+        return true;
+    };
+    // fields in the order of the record layout, see perf_event_open(2).
+    Sample s = {};
+    uint32_t cpuRes[2] = {0, 0};
+    if (!next(&s.ip, sizeof(s.ip)) || !next(&s.pid, sizeof(s.pid)) || !next(&s.tid, sizeof(s.tid)) ||
+        !next(&s.time, sizeof(s.time)) || !next(cpuRes, sizeof(cpuRes)) || !next(&s.period, sizeof(s.period))) {
+        return;
+    }
+    s.cpu = cpuRes[0];
+    s.frameBegin = ips.size();
+    if (sampleType & PERF_SAMPLE_CALLCHAIN) {
+        uint64_t nr = 0;
+        if (!next(&nr, sizeof(nr)) || nr > (size - pos) / sizeof(uint64_t)) {
+            return;
+        }
+        for (uint64_t i = 0; i < nr; ++i) {
+            uint64_t ip = 0;
+            next(&ip, sizeof(ip));
+            // context markers (kernel, user, ...) are not frames.
+            if (ip < static_cast<uint64_t>(PERF_CONTEXT_MAX)) {
+                ips.emplace_back(ip);
+            }
+        }
+    } else {
+        ips.emplace_back(s.ip);
+    }
+    s.frameNum = ips.size() - s.frameBegin;
+    if (sampleType & PERF_SAMPLE_RAW) {
+        uint32_t rawSize = 0;
+        if (!next(&rawSize, sizeof(rawSize)) || rawSize > size - pos) {
+            ips.resize(s.frameBegin);
+            return;
+        }
+        // the raw record is copied to an aligned offset, it is decoded by casts to the tracepoint format.
+        s.raw = true;
+        s.rawBegin = (rawBuf.size() + RAW_ALIGN - 1) / RAW_ALIGN * RAW_ALIGN;
+        rawBuf.resize(s.rawBegin + rawSize);
+        next(rawBuf.data() + s.rawBegin, rawSize);
+    }
+    samples.emplace_back(s);
+}
+
+void SamplingFallback::DrainRing(Ring &ring)
+{
+    auto meta = reinterpret_cast<struct perf_event_mmap_page*>(ring.base);
+    const char *ringData = ring.base + pageSize;
+    size_t ringSize = ring.size - pageSize;
+    uint64_t head = __atomic_load_n(&meta->data_head, __ATOMIC_ACQUIRE);
+    uint64_t tail = meta->data_tail;
+    while (tail + sizeof(struct perf_event_header) <= head) {
+        struct perf_event_header header;
+        CopyFromRing(ringData, ringSize, tail, reinterpret_cast<char*>(&header), sizeof(header));
+        if (header.size < sizeof(header) || tail + header.size > head) {
+            break;
+        }
+        if (header.type == PERF_RECORD_SAMPLE) {
+            record.resize(header.size);
+            CopyFromRing(ringData, ringSize, tail, record.data(), header.size);
+            ParseSample(record.data() + sizeof(header), header.size - sizeof(header));
+        }
+        tail += header.size;
+    }
+    __atomic_store_n(&meta->data_tail, head, __ATOMIC_RELEASE);
+}
+
+const char *SamplingFallback::GetComm(uint32_t pid)
+{
+    auto it = comms.find(pid);
+    if (it != comms.end()) {
+        return it->second.c_str();
+    }
+    std::ifstream file(root + "/proc/" + std::to_string(pid) + "/comm");
+    std::string comm;
+    std::getline(file, comm);
+    return comms.emplace(pid, comm).first->second.c_str();
+}
+
+int SamplingFallback::Read(PmuData *&data)
+{
+    samples.clear();
+    ips.clear();
+    rawBuf.clear();
+    comms.clear();
+    for (auto &ring : rings) {
+        DrainRing(ring);
+    }
+    // every buffer has its final size, pointers into them are stable until the next read.
+    symbols.assign(ips.size(), Symbol{});
+    stacks.assign(ips.size(), Stack{});
+    raws.assign(samples.size(), SampleRawData{});
+    pmuData.assign(samples.size(), PmuData{});
+    for (size_t i = 0; i < ips.size(); ++i) {
+        symbols[i].addr = ips[i];
+        stacks[i].symbol = &symbols[i];
+    }
+    for (size_t i = 0; i < samples.size(); ++i) {
+        auto &s = samples[i];
+        auto &out = pmuData[i];
+        for (size_t frame = s.frameBegin; frame < s.frameBegin + s.frameNum; ++frame) {
+            stacks[frame].next = frame + 1 < s.frameBegin + s.frameNum ? &stacks[frame + 1] : nullptr;
+            stacks[frame].prev = frame > s.frameBegin ? &stacks[frame - 1] : nullptr;
+        }
+        out.stack = s.frameNum > 0 ? &stacks[s.frameBegin] : nullptr;
+        out.evt = evtName.c_str();
+        out.ts = static_cast<int64_t>(s.time);
+        out.pid = static_cast<pid_t>(s.pid);
+        out.tid = static_cast<int>(s.tid);
+        out.cpu = static_cast<int>(s.cpu);
+        out.cpuTopo = s.cpu < cpuTopo.size() ? &cpuTopo[s.cpu] : &unknownTopo;
+        out.comm = GetComm(s.pid);
+        out.period = s.period;
+        if (s.raw) {
+            raws[i].data = rawBuf.data() + s.rawBegin;
+            out.rawData = &raws[i];
+        }
+    }
+    data = pmuData.data();
+    return static_cast<int>(pmuData.size());
+}
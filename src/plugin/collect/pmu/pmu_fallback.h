@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef PMU_FALLBACK_H
+#define PMU_FALLBACK_H
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <libkperf/pmu.h>
+
+struct perf_event_attr;
+
+/*
+ * Cycles of every cpu estimated from the time spent running tasks (the 7th field of a cpu line in /proc/schedstat)
+ * and the cpu frequency, used when the cpu cycles counter is missing.
+ * Files are read under root, which is only changed by tests to read fixture files.
+ */
+class CyclesEstimate {
+public:
+    explicit CyclesEstimate(int cpuNum, const std::string &root = "");
+    // Reads the cpu frequencies and the start values, false if /proc/schedstat can not be read.
+    bool Init();
+    bool ReadSchedstat(std::vector<uint64_t> &runNs) const;
+    // Cycles of every cpu since the last read.
+    bool Read(std::vector<uint64_t> &cycles);
+private:
+    int cpuNum;
+    std::string root;
+    std::vector<uint64_t> lastRunNs;
+    // unknown frequencies count one cycle per ns.
+    std::vector<double> cyclesPerNs;
+};
+
+/*
+ * System wide counting without libkperf, used by pmu_counting_collector and pmu_snapshot_collector when the system
+ * has no supported PMU, e.g. in a virtual machine.
+ * Generic hardware and cache events, and on aarch64 the common architectural events used by the tlb and cache
+ * topics, are opened with perf_event_open on every cpu, tracepoints ("sys:name") with their id in tracefs. If the
+ * cpu cycles counter is missing, cycles are estimated by CyclesEstimate. The data has the same layout as libkperf
+ * counting data, it is approximate.
+ */
+class CountingFallback {
+public:
+    explicit CountingFallback(const std::string &root = "");
+    ~CountingFallback();
+    CountingFallback(const CountingFallback&) = delete;
+    CountingFallback &operator=(const CountingFallback&) = delete;
+    bool Open(const std::string &evt, std::string &err);
+    void Close(const std::string &evt);
+    void CloseAll();
+    // Counts of every cpu since the last read, scaled by time_enabled / time_running.
+    void Read(const std::string &evt, std::vector<PmuData> &data);
+    // perf_event_open type and config of evt, false if it is unknown.
+    bool GetEventConfig(const std::string &evt, uint32_t &type, uint64_t &config) const;
+private:
+    struct Event {
+        const char *name = nullptr;
+        // fd of every cpu, -1 if the cpu can not be counted.
+        std::vector<int> fds;
+        // set if cycles are estimated.
+        std::unique_ptr<CyclesEstimate> estimate;
+        std::vector<uint64_t> lastValue;
+        std::vector<uint64_t> lastEnabled;
+        std::vector<uint64_t> lastRunning;
+    };
+    bool OpenPerf(Event &event, uint32_t type, uint64_t config, std::string &err);
+    void ReadCyclesEstimate(Event &event, std::vector<PmuData> &data);
+
+    std::string root;
+    int cpuNum;
+    std::vector<CpuTopology> cpuTopo;
+    std::unordered_map<std::string, Event> events;
+    std::unordered_set<std::string> names;
+};
+
+/*
+ * Sampling without libkperf, used by pmu_sampling_collector when the system has no supported PMU.
+ * Events are looked up like CountingFallback, "cycles" is sampled with the cpu-clock software event if the cycles
+ * counter is missing. Every cpu, or every task of a task scope, has a ring buffer which is drained by Read.
+ * Samples have the libkperf layout: the stack holds the raw addresses of the ip or of the call chain, symbols are
+ * not resolved, and tracepoint samples carry their raw record in rawData.
+ */
+class SamplingFallback {
+public:
+    explicit SamplingFallback(const std::string &root = "");
+    ~SamplingFallback();
+    SamplingFallback(const SamplingFallback&) = delete;
+    SamplingFallback &operator=(const SamplingFallback&) = delete;
+    // pids is empty for every cpu, period is the frequency in Hz if useFreq is set.
+    bool Open(const std::string &evt, const std::vector<int> &pids, uint64_t period, bool useFreq, bool callStack,
+        std::string &err);
+    void Close();
+    // perf fds of the rings, used to change the period in place.
+    const std::vector<int> &GetFds() const
+    {
+        return fds;
+    }
+    // Samples since the last read, valid until the next read or close.
+    int Read(PmuData *&data);
+private:
+    struct Ring {
+        int fd = -1;
+        char *base = nullptr;
+        size_t size = 0;
+    };
+    // a parsed sample, frames and raw records are offsets in ips and rawBuf.
+    struct Sample {
+        uint64_t ip;
+        uint32_t pid;
+        uint32_t tid;
+        uint64_t time;
+        uint32_t cpu;
+        uint64_t period;
+        size_t frameBegin;
+        size_t frameNum;
+        size_t rawBegin;
+        bool raw;
+    };
+    bool OpenRing(struct perf_event_attr &attr, int pid, int cpu);
+    void DrainRing(Ring &ring);
+    void ParseSample(const char *record, size_t size);
+    const char *GetComm(uint32_t pid);
+
+    std::string root;
+    std::string evtName;
+    uint64_t sampleType = 0;
+    size_t pageSize;
+    std::vector<CpuTopology> cpuTopo;
+    CpuTopology unknownTopo = {-1, -1, -1};
+    std::vector<Ring> rings;
+    std::vector<int> fds;
+    std::vector<char> record;
+    // buffers of the last read, referenced by pmuData.
+    std::vector<Sample> samples;
+    std::vector<uint64_t> ips;
+    std::vector<char> rawBuf;
+    std::vector<Symbol> symbols;
+    std::vector<Stack> stacks;
+    std::vector<SampleRawData> raws;
+    std::vector<PmuData> pmuData;
+    std::unordered_map<uint32_t, std::string> comms;
+};
+
+#endif
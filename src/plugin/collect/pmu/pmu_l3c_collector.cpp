@@ -17,6 +17,7 @@
 #include "oeaware/data/pmu_l3c_data.h"
 #include "pmu_uncore.h"
 #include "libkperf/pcerrc.h"
+#include "oeaware/utils.h"
 
 PmuL3cCollector::PmuL3cCollector(): oeaware::Interface()
 {
@@ -33,6 +34,8 @@ PmuL3cCollector::PmuL3cCollector(): oeaware::Interface()
     topic.topicName = topicStr;
     topic.params = "";
     supportTopics.push_back(topic);
+    topic.topicName = nodeTopicStr;
+    supportTopics.push_back(topic);
 }
 
 int PmuL3cCollector::OpenL3c()
@@ -78,10 +81,14 @@ int PmuL3cCollector::OpenL3c()
 
 oeaware::Result PmuL3cCollector::OpenTopic(const oeaware::Topic &topic)
 {
-    if (topic.instanceName != this->name || topic.topicName != topicStr || topic.params != "") {
+    if (topic.instanceName != this->name || (topic.topicName != topicStr && topic.topicName != nodeTopicStr) ||
+        topic.params != "") {
         return oeaware::Result(FAILED, "OpenTopic: " + topic.GetType() + " failed, topic not match");
     }
-
+    if (openTopics.count(topic.topicName)) {
+        return oeaware::Result(FAILED);
+    }
+    // both topics share one pmu.
     if (pmuId == -1) {
         pmuId = OpenL3c();
         if (pmuId == -1) {
@@ -89,22 +96,25 @@ oeaware::Result PmuL3cCollector::OpenTopic(const oeaware::Topic &topic)
         }
         PmuEnable(pmuId);
         timestamp = std::chrono::high_resolution_clock::now();
-        return oeaware::Result(OK);
     }
-
-    return oeaware::Result(FAILED);
+    openTopics.insert(topic.topicName);
+    return oeaware::Result(OK);
 }
 
 void PmuL3cCollector::CloseTopic(const oeaware::Topic &topic)
 {
-    if (topic.instanceName != this->name || topic.topicName != topicStr || topic.params != "") {
+    if (topic.instanceName != this->name || (topic.topicName != topicStr && topic.topicName != nodeTopicStr) ||
+        topic.params != "") {
         WARN(logger, "CloseTopic:" + topic.GetType() + " failed, topic not match.");
         return;
     }
-    if (pmuId == -1) {
+    if (pmuId == -1 || openTopics.erase(topic.topicName) == 0) {
         WARN(logger, "CloseTopic:" + topic.GetType() + " failed, pmuId = -1");
         return;
     }
+    if (!openTopics.empty()) {
+        return;
+    }
     PmuDisable(pmuId);
     PmuClose(pmuId);
     UncoreConfigFini();
@@ -131,6 +141,20 @@ void PmuL3cCollector::UpdateData(const DataList &dataList)
     return;
 }
 
+void PmuL3cCollector::PublishTopo(const PmuData *pmuData, int len, uint64_t intervalNs)
+{
+    auto topo = topoBuilder.Build({{pmuData, len}}, intervalNs);
+    DataList dataList;
+    if (!oeaware::SetDataListTopic(&dataList, name, nodeTopicStr, "")) {
+        return;
+    }
+    dataList.len = 1;
+    dataList.data = new void *[1];
+    // the builder keeps the buffers until the next period.
+    dataList.data[0] = topo;
+    Publish(dataList, false);
+}
+
 void PmuL3cCollector::Run()
 {
     if (pmuId == -1) {
@@ -140,15 +164,28 @@ void PmuL3cCollector::Run()
     PmuL3cData *l3cData = new PmuL3cData();
     PmuDisable(pmuId);
     l3cData->len = PmuRead(pmuId, &(l3cData->pmuData));
+    PmuEnable(pmuId);
     if (l3cNum != l3cData->len) {
         WARN(logger, "PmuL3cCollector collect data length error.");
+        if (l3cData->pmuData != nullptr) {
+            PmuDataFree(l3cData->pmuData);
+        }
+        delete l3cData;
         return;
     }
-    PmuEnable(pmuId);
 
     auto now = std::chrono::high_resolution_clock::now();
+    uint64_t intervalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - timestamp).count();
     l3cData->interval = std::chrono::duration_cast<std::chrono::milliseconds>(now - timestamp).count();
     timestamp = now;
+    if (openTopics.count(nodeTopicStr)) {
+        PublishTopo(l3cData->pmuData, l3cData->len, intervalNs);
+    }
+    if (!openTopics.count(topicStr)) {
+        PmuDataFree(l3cData->pmuData);
+        delete l3cData;
+        return;
+    }
 
     DataList dataList;
     dataList.topic.instanceName = new char[name.size() + 1];
@@ -161,4 +198,4 @@ void PmuL3cCollector::Run()
     dataList.data = new void *[1];
     dataList.data[0] = l3cData;
     Publish(dataList);
-}
\ No newline at end of file
+}
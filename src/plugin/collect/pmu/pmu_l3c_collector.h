@@ -12,8 +12,10 @@
 #ifndef PMU_L3C_COLLECTOR_H
 #define PMU_L3C_COLLECTOR_H
 #include <unordered_map>
+#include <unordered_set>
 #include <chrono>
 #include "oeaware/interface.h"
+#include "pmu_uncore.h"
 
 class PmuL3cCollector : public oeaware::Interface {
 public:
@@ -28,10 +30,15 @@ public:
 private:
     int pmuId;
     std::string topicStr = "l3c";
+    // the same counts as UncoreTopoData, keyed by location with per-node series.
+    std::string nodeTopicStr = "l3c_node";
+    std::unordered_set<std::string> openTopics;
+    UncoreTopoBuilder topoBuilder;
     std::vector<std::string> eventStr;
     std::chrono::time_point<std::chrono::high_resolution_clock> timestamp;
     const std::string l3cPath = "/sys/devices/hisi_sccl1_l3c0";
     int OpenL3c();
+    void PublishTopo(const PmuData *pmuData, int len, uint64_t intervalNs);
 };
 
 #endif
@@ -0,0 +1,134 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "pmu_sampling_budget.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iterator>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/perf_event.h>
+#include "oeaware/utils.h"
+
+namespace {
+const std::string SELF_FD_PATH = "/proc/self/fd/";
+const char *PERF_EVENT_LINK = "anon_inode:[perf_event]";
+constexpr int SCALE_STEP = 2;
+// the scale is reduced only when the load is below LOW_WATERMARK of the budget.
+constexpr double LOW_WATERMARK = 0.2;
+constexpr double PERCENT = 100.0;
+constexpr double US_PER_MS = 1000.0;
+constexpr double MS_PER_SEC = 1000.0;
+constexpr int MAX_OVERHEAD_PERCENT = 100;
+}
+
+bool SamplingBudget::ParseParam(const std::string &param, std::string &err)
+{
+    for (auto &p : oeaware::GetKeyValueFromString(param)) {
+        if (!oeaware::IsInteger(p.second)) {
+            err = p.first + " value is not a integer.";
+            return false;
+        }
+        if (p.first == "max_records") {
+            maxRecords = std::stoull(p.second);
+        } else if (p.first == "max_overhead") {
+            int value = atoi(p.second.c_str());
+            if (value < 0 || value > MAX_OVERHEAD_PERCENT) {
+                err = "the max_overhead range is [0, 100], but is " + p.second;
+                return false;
+            }
+            maxOverhead = value;
+        } else {
+            err = "params (" + p.first + ") invalid.";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SamplingBudget::Update(uint64_t records, uint64_t intervalMs, uint64_t readUs)
+{
+    if (intervalMs == 0) {
+        return false;
+    }
+    double load = 0;
+    if (maxRecords > 0) {
+        load = std::max(load, records * MS_PER_SEC / intervalMs / maxRecords);
+    }
+    if (maxOverhead > 0) {
+        load = std::max(load, readUs / US_PER_MS / intervalMs * PERCENT / maxOverhead);
+    }
+    int old = scale;
+    if (load > 1) {
+        scale = std::min(scale * SCALE_STEP, maxScale);
+    } else if (load < LOW_WATERMARK) {
+        scale = std::max(scale / SCALE_STEP, 1);
+    }
+    return scale != old;
+}
+
+uint64_t SamplingBudget::GetPeriod(uint64_t defaultPeriod, bool useFreq) const
+{
+    if (useFreq) {
+        return std::max<uint64_t>(defaultPeriod / scale, 1);
+    }
+    return defaultPeriod * scale;
+}
+
+std::vector<int> SamplingBudget::ListPerfFds()
+{
+    std::vector<int> fds;
+    DIR *dir = opendir(SELF_FD_PATH.c_str());
+    if (dir == nullptr) {
+        return fds;
+    }
+    struct dirent *entry;
+    char link[PATH_MAX];
+    while ((entry = readdir(dir)) != nullptr) {
+        if (!oeaware::IsInteger(entry->d_name)) {
+            continue;
+        }
+        ssize_t len = readlink((SELF_FD_PATH + entry->d_name).c_str(), link, sizeof(link) - 1);
+        if (len <= 0) {
+            continue;
+        }
+        link[len] = '\0';
+        if (strcmp(link, PERF_EVENT_LINK) == 0) {
+            fds.emplace_back(atoi(entry->d_name));
+        }
+    }
+    closedir(dir);
+    std::sort(fds.begin(), fds.end());
+    return fds;
+}
+
+std::vector<int> SamplingBudget::NewPerfFds(const std::vector<int> &before)
+{
+    auto after = ListPerfFds();
+    std::vector<int> fds;
+    std::set_difference(after.begin(), after.end(), before.begin(), before.end(), std::back_inserter(fds));
+    return fds;
+}
+
+bool SamplingBudget::SetPeriod(const std::vector<int> &fds, uint64_t value)
+{
+    if (fds.empty()) {
+        return false;
+    }
+    for (auto fd : fds) {
+        if (ioctl(fd, PERF_EVENT_IOC_PERIOD, &value) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
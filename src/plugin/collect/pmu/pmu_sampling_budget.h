@@ -0,0 +1,53 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef PMU_SAMPLING_BUDGET_H
+#define PMU_SAMPLING_BUDGET_H
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Overhead budget of a sampling pmu.
+ * After every read the records per second and the share of the interval spent in PmuRead are compared with the
+ * budget. The sample period is doubled while the budget is exceeded and halved again when the load falls below
+ * a fifth of it, the factor between the current and the default period is the scale.
+ */
+class SamplingBudget {
+public:
+    SamplingBudget(double maxOverhead, int maxScale) : maxOverhead(maxOverhead), maxScale(maxScale) { }
+    // Enable params "max_records:<records per second>,max_overhead:<percent>", 0 means no limit.
+    bool ParseParam(const std::string &param, std::string &err);
+    void Reset()
+    {
+        scale = 1;
+    }
+    // Returns true if the scale changed.
+    bool Update(uint64_t records, uint64_t intervalMs, uint64_t readUs);
+    int GetScale() const
+    {
+        return scale;
+    }
+    // Period to open the pmu with, a frequency is divided and a period is multiplied by the scale.
+    uint64_t GetPeriod(uint64_t defaultPeriod, bool useFreq) const;
+    // perf_event fds of this process, the difference before and after PmuOpen are the fds of the new pmu.
+    static std::vector<int> ListPerfFds();
+    static std::vector<int> NewPerfFds(const std::vector<int> &before);
+    // Change the period or frequency of running events with PERF_EVENT_IOC_PERIOD, no reopen is needed.
+    static bool SetPeriod(const std::vector<int> &fds, uint64_t value);
+private:
+    uint64_t maxRecords = 0;
+    double maxOverhead;
+    int maxScale;
+    int scale = 1;
+};
+
+#endif
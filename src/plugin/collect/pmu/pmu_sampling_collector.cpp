@@ -13,9 +13,16 @@
 #include <algorithm>
 #include <iostream>
 #include <securec.h>
+#include "oeaware/utils.h"
 #include "oeaware/data/pmu_sampling_data.h"
 #include "pmu_common.h"
 
+namespace {
+const std::string SYMBOL_PARAM = "symbol";
+const std::string CALLSTACK_PARAM = "callstack";
+const char PARAM_SEPARATOR = ';';
+}
+
 PmuSamplingCollector::PmuSamplingCollector(): oeaware::Interface()
 {
     this->name = OE_PMU_SAMPLING_COLLECTOR;
@@ -50,83 +57,194 @@ void PmuSamplingCollector::InitSamplingAttr(struct PmuAttr &attr)
     attr.includeNewFork = 0;
 }
 
-int PmuSamplingCollector::OpenSampling(const oeaware::Topic &topic)
+int PmuSamplingCollector::OpenSampling(TopicParam &param)
 {
     struct PmuAttr attr = {};
     InitSamplingAttr(attr);
+    if (!param.scope.IsSystem()) {
+        attr.pidList = param.scope.pids.data();
+        attr.numPid = param.scope.pids.size();
+    }
+    const std::string &topicName = param.topic.topicName;
 
     char *evtList[1];
-    evtList[0] = new char[topic.topicName.length() + 1];
-    errno_t ret = strcpy_s(evtList[0], topic.topicName.length() + 1, topic.topicName.c_str());
+    evtList[0] = new char[topicName.length() + 1];
+    errno_t ret = strcpy_s(evtList[0], topicName.length() + 1, topicName.c_str());
     if (ret != EOK) {
-        std::cout << topic.topicName << " open failed, reason: strcpy_s failed" << std::endl;
+        std::cout << topicName << " open failed, reason: strcpy_s failed" << std::endl;
         delete[] evtList[0];
         return -1;
     }
     attr.evtList = evtList;
     attr.numEvt = 1;
-    if (topic.topicName == "cycles") {
-        attr.freq = CYCLES_FREQ;
+    uint64_t period = param.budget.GetPeriod(DefaultPeriod(topicName), IsFreqTopic(topicName));
+    if (IsFreqTopic(topicName)) {
+        attr.freq = period;
         attr.useFreq = 1;
-        attr.symbolMode = RESOLVE_ELF;
+        attr.symbolMode = param.symbol ? RESOLVE_ELF : NO_SYMBOL_RESOLVE;
+        attr.callStack = param.callStack ? 1 : 0;
     } else {
-        attr.period = NET_RECEIVE_TRACE_SAMPLE_PERIOD;
+        attr.period = period;
     }
+    auto fdsBefore = SamplingBudget::ListPerfFds();
     int pd = PmuOpen(SAMPLING, &attr);
     if (pd == -1) {
-        std::cout << topic.topicName << " open failed" << std::endl;
+        std::cout << topicName << " open failed" << std::endl;
+    } else {
+        param.perfFds = SamplingBudget::NewPerfFds(fdsBefore);
     }
     delete[] evtList[0];
     return pd;
 }
 
-oeaware::Result PmuSamplingCollector::OpenTopic(const oeaware::Topic &topic)
+bool PmuSamplingCollector::OpenFallback(TopicParam &param)
 {
-    if (topic.instanceName != this->name) {
-        return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, instanceName is not match");
+    const std::string &topicName = param.topic.topicName;
+    std::unique_ptr<FallbackSession> session(new FallbackSession());
+    uint64_t period = param.budget.GetPeriod(DefaultPeriod(topicName), IsFreqTopic(topicName));
+    std::vector<int> pids = param.scope.IsSystem() ? std::vector<int>() : param.scope.pids;
+    std::string err;
+    if (!session->sampling.Open(topicName, pids, period, IsFreqTopic(topicName), param.callStack, err)) {
+        WARN(logger, "open " << param.topic.GetType() << " without PMU failed, " << err);
+        return false;
     }
+    param.perfFds = session->sampling.GetFds();
+    param.fallback = std::move(session);
+    return true;
+}
 
-    if (topic.params != "") {
-        return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, params is not empty");
+bool PmuSamplingCollector::StartSampling(TopicParam &param)
+{
+    if (fallback) {
+        return OpenFallback(param);
     }
+    param.pmuId = OpenSampling(param);
+    if (param.pmuId == -1) {
+        return false;
+    }
+    PmuEnable(param.pmuId);
+    return true;
+}
 
-    for (auto &iter : topicStr) {
-        if (iter != topic.topicName) {
-            continue;
-        }
-        if (topicParams[iter].open) {
-            WARN(logger, topic.GetType() << " has been opened before!");
-            return oeaware::Result(OK);
-        }
-        topicParams[iter].pmuId = OpenSampling(topic);
-        if (topicParams[iter].pmuId == -1) {
-            return oeaware::Result(FAILED, "OpenTopic failed, PmuOpen failed");
+void PmuSamplingCollector::StopSampling(TopicParam &param)
+{
+    if (param.fallback != nullptr) {
+        // the samples of the last read may still be referenced by the last publication.
+        param.fallback->sampling.Close();
+        retiredFallbacks.emplace_back(std::move(param.fallback));
+        return;
+    }
+    PmuDisable(param.pmuId);
+    PmuClose(param.pmuId);
+}
+
+void PmuSamplingCollector::AdjustPeriod(TopicParam &param)
+{
+    const std::string &topicName = param.topic.topicName;
+    param.adjust = false;
+    uint64_t period = param.budget.GetPeriod(DefaultPeriod(topicName), IsFreqTopic(topicName));
+    if (!param.reopen && SamplingBudget::SetPeriod(param.perfFds, period)) {
+        INFO(logger, "PmuSamplingCollector " << topicName << " adjust period to " << period << " in place.");
+        return;
+    }
+    // the task list changed or the kernel refused PERF_EVENT_IOC_PERIOD, reopen the pmu
+    param.reopen = false;
+    StopSampling(param);
+    param.perfFds.clear();
+    INFO(logger, "PmuSamplingCollector " << param.topic.GetType() << " reopen with period " << period << ".");
+    if (!StartSampling(param)) {
+        param.open = false;
+        return;
+    }
+    param.timestamp = std::chrono::high_resolution_clock::now();
+}
+
+bool PmuSamplingCollector::ParseTopicParams(const std::string &params, TopicParam &param, std::string &err)
+{
+    param.symbol = false;
+    param.callStack = false;
+    // leading options, then the scope: "[symbol;][callstack;]<scope>"
+    size_t begin = 0;
+    while (begin < params.size()) {
+        size_t end = params.find(PARAM_SEPARATOR, begin);
+        std::string option = params.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+        if (option == SYMBOL_PARAM) {
+            param.symbol = true;
+        } else if (option == CALLSTACK_PARAM) {
+            param.callStack = true;
+        } else {
+            break;
         }
-        PmuEnable(topicParams[iter].pmuId);
-        topicParams[iter].timestamp = std::chrono::high_resolution_clock::now();
-        topicParams[iter].open = true;
+        begin = (end == std::string::npos ? params.size() : end + 1);
+    }
+    return ParsePmuScope(params.substr(begin), param.scope, err);
+}
+
+oeaware::Result PmuSamplingCollector::OpenTopic(const oeaware::Topic &topic)
+{
+    if (topic.instanceName != this->name) {
+        return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, instanceName is not match");
+    }
+    if (std::find(topicStr.begin(), topicStr.end(), topic.topicName) == topicStr.end()) {
+        return oeaware::Result(FAILED, "OpenTopic " + topic.GetType() + "failed, no support topic!");
+    }
+    auto &param = topicParams[topic.GetType()];
+    if (param.open) {
+        WARN(logger, topic.GetType() << " has been opened before!");
         return oeaware::Result(OK);
     }
-    return oeaware::Result(FAILED, "OpenTopic " + topic.GetType() + "failed, no support topic!");
+    std::string err;
+    if (!ParseTopicParams(topic.params, param, err)) {
+        topicParams.erase(topic.GetType());
+        return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, " + err);
+    }
+    param.topic = topic;
+    param.budget = budgetConfig;
+    param.adjust = false;
+    param.reopen = false;
+    if (!StartSampling(param)) {
+        topicParams.erase(topic.GetType());
+        return oeaware::Result(FAILED, "OpenTopic failed, PmuOpen failed");
+    }
+    param.timestamp = std::chrono::high_resolution_clock::now();
+    param.refreshTime = param.timestamp;
+    param.open = true;
+    return oeaware::Result(OK);
 }
 
 void PmuSamplingCollector::CloseTopic(const oeaware::Topic &topic)
 {
-    if (!topicParams[topic.topicName].open) {
+    auto it = topicParams.find(topic.GetType());
+    if (it == topicParams.end() || !it->second.open) {
         WARN(logger, "CloseTopic failed, " + topic.GetType() + " not open.");
         return;
     }
-    PmuDisable(topicParams[topic.topicName].pmuId);
-    PmuClose(topicParams[topic.topicName].pmuId);
-    topicParams[topic.topicName].pmuId = -1;
-    topicParams[topic.topicName].open = false;
+    StopSampling(it->second);
+    topicParams.erase(it);
 }
 
 oeaware::Result PmuSamplingCollector::Enable(const std::string &param)
 {
-    (void)param;
-    if (!IsSupportPmu()) {
-        return oeaware::Result(FAILED, "the system does not support PMU.");
+    bool supportPmu = IsSupportPmu();
+    if (!supportPmu && !fallback) {
+        INFO(logger, "the system does not support PMU, sampling with perf_event_open, symbols are not resolved.");
+    }
+    fallback = !supportPmu;
+    budgetConfig = SamplingBudget(SAMPLING_MAX_OVERHEAD, SAMPLING_MAX_SCALE);
+    // an instance enabled by a subscription gets the topic params, they are checked by OpenTopic.
+    // every item is given to both parsers, it is invalid only if neither accepts it.
+    for (auto &item : oeaware::SplitString(param, ",")) {
+        if (item.empty()) {
+            continue;
+        }
+        TopicParam topicParam;
+        std::string topicErr;
+        std::string budgetErr;
+        bool topicOk = ParseTopicParams(item, topicParam, topicErr);
+        bool budgetOk = budgetConfig.ParseParam(item, budgetErr);
+        if (!topicOk && !budgetOk) {
+            return oeaware::Result(FAILED, topicErr + ", " + budgetErr);
+        }
     }
     return oeaware::Result(OK);
 }
@@ -142,32 +260,83 @@ void PmuSamplingCollector::UpdateData(const DataList &dataList)
     return;
 }
 
-void PmuSamplingCollector::Run()
+void PmuSamplingCollector::RefreshScope(TopicParam &param)
 {
-    for (auto &topicName : topicStr) {
-        if (!topicParams[topicName].open) {
-            continue;
-        }
-        int pmuId = topicParams[topicName].pmuId;
-        PmuSamplingData *data = new PmuSamplingData();
+    auto now = std::chrono::high_resolution_clock::now();
+    if (param.scope.cgroupPath.empty() ||
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - param.refreshTime).count() < CGROUP_REFRESH_MS) {
+        return;
+    }
+    param.refreshTime = now;
+    auto oldPids = param.scope.pids;
+    if (!UpdateCgroupPids(param.scope)) {
+        // keep sampling the old tasks, the cgroup may be filled again.
+        param.scope.pids = oldPids;
+        return;
+    }
+    if (param.scope.pids != oldPids) {
+        param.reopen = true;
+        param.adjust = true;
+    }
+}
+
+void PmuSamplingCollector::ReadTopic(TopicParam &param)
+{
+    const std::string &topicName = param.topic.topicName;
+    int pmuId = param.pmuId;
+    // the data of a fallback session is owned by the session and reused every period.
+    bool owned = param.fallback != nullptr;
+    PmuSamplingData *data = owned ? &param.fallback->data : new PmuSamplingData();
+    auto readBegin = std::chrono::high_resolution_clock::now();
+    if (owned) {
+        data->len = param.fallback->sampling.Read(data->pmuData);
+    } else {
         PmuDisable(pmuId);
+        readBegin = std::chrono::high_resolution_clock::now();
         data->len = PmuRead(pmuId, &(data->pmuData));
+    }
+    auto now = std::chrono::high_resolution_clock::now();
+    if (!owned) {
         PmuEnable(pmuId);
-        // calculate the actual collection time
-        auto now = std::chrono::high_resolution_clock::now();
-        data->interval = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - topicParams[topicName].timestamp).count();
-        topicParams[topicName].timestamp = now;
-        DataList dataList;
-        dataList.topic.instanceName = new char[name.size() + 1];
-        strcpy_s(dataList.topic.instanceName, name.size() + 1, name.data());
-        dataList.topic.topicName = new char[topicName.size() + 1];
-        strcpy_s(dataList.topic.topicName, topicName.size() + 1, topicName.data());
-        dataList.topic.params = new char[1];
-        dataList.topic.params[0] = 0;
-        dataList.data = new void *[1];
-        dataList.len = 1;
-        dataList.data[0] = data;
-        Publish(dataList);
+    }
+    uint64_t readUs = std::chrono::duration_cast<std::chrono::microseconds>(now - readBegin).count();
+    // calculate the actual collection time
+    data->interval = std::chrono::duration_cast<std::chrono::milliseconds>(now - param.timestamp).count();
+    param.timestamp = now;
+    data->useFreq = IsFreqTopic(topicName);
+    data->period = param.budget.GetPeriod(DefaultPeriod(topicName), data->useFreq);
+    data->scale = param.budget.GetScale();
+    param.adjust = param.budget.Update(data->len > 0 ? data->len : 0, data->interval, readUs);
+    DataList dataList;
+    if (!oeaware::SetDataListTopic(&dataList, name, topicName, param.topic.params)) {
+        if (!owned) {
+            PmuDataFree(data->pmuData);
+            delete data;
+        }
+        return;
+    }
+    dataList.data = new void *[1];
+    dataList.len = 1;
+    dataList.data[0] = data;
+    Publish(dataList, !owned);
+}
+
+void PmuSamplingCollector::Run()
+{
+    // the publications of the last period have been handled, the samples of closed fallbacks can be released.
+    retiredFallbacks.clear();
+    for (auto it = topicParams.begin(); it != topicParams.end();) {
+        auto &param = it->second;
+        RefreshScope(param);
+        // the period is adjusted after other plugins have finished using the last data
+        if (param.adjust) {
+            AdjustPeriod(param);
+        }
+        if (!param.open) {
+            it = topicParams.erase(it);
+            continue;
+        }
+        ReadTopic(param);
+        ++it;
     }
 }
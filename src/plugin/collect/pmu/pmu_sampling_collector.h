@@ -14,10 +14,18 @@
 #define PMU_SAMPLING_COLLECTOR_H
 #include <unordered_map>
 #include <chrono>
+#include <memory>
+#include <vector>
 #include "oeaware/interface.h"
+#include "oeaware/data/pmu_sampling_data.h"
+#include "pmu_sampling_budget.h"
+#include "pmu_common.h"
+#include "pmu_fallback.h"
 
 constexpr int NET_RECEIVE_TRACE_SAMPLE_PERIOD = 10;
 constexpr int CYCLES_FREQ = 100;
+constexpr int SAMPLING_MAX_OVERHEAD = 5;
+constexpr int SAMPLING_MAX_SCALE = 64;
 
 class PmuSamplingCollector : public oeaware::Interface {
 public:
@@ -30,15 +38,58 @@ public:
     void Disable() override;
     void Run() override;
 private:
+    /*
+     * The topic params select the scope of the session, see PmuScope. Samples carry raw addresses, a subscriber
+     * that needs symbols prefixes the params with "symbol", e.g. "symbol" or "symbol;pid:<pid>", then libkperf
+     * resolves the symbols of that session. Others resolve addresses lazily with oeaware::SymbolCache.
+     * "callstack" records the call chain of every sample, e.g. "symbol;callstack".
+     * Without a supported PMU the topics are sampled by SamplingFallback, symbols are never resolved.
+     */
+    // a topic sampled without PMU, kept until its last publication has been handled.
+    struct FallbackSession {
+        SamplingFallback sampling;
+        PmuSamplingData data = {};
+    };
     struct TopicParam {
+        oeaware::Topic topic;
+        PmuScope scope;
+        bool symbol = false;
+        bool callStack = false;
+        std::chrono::time_point<std::chrono::high_resolution_clock> refreshTime;
+        bool reopen = false;
         bool open = false;
         int pmuId = -1;
         std::chrono::time_point<std::chrono::high_resolution_clock> timestamp;
+        SamplingBudget budget{SAMPLING_MAX_OVERHEAD, SAMPLING_MAX_SCALE};
+        bool adjust = false;
+        // perf fds of pmuId, used to change the period in place.
+        std::vector<int> perfFds;
+        std::unique_ptr<FallbackSession> fallback;
     };
     std::vector<std::string> topicStr = { "cycles", "skb:skb_copy_datagram_iovec", "net:napi_gro_receive_entry" };
+    // key: topic type
     std::unordered_map<std::string, TopicParam> topicParams;
+    // budget parsed from the enable params, copied to every opened topic.
+    SamplingBudget budgetConfig{SAMPLING_MAX_OVERHEAD, SAMPLING_MAX_SCALE};
+    bool fallback = false;
+    std::vector<std::unique_ptr<FallbackSession>> retiredFallbacks;
     void InitSamplingAttr(struct PmuAttr &attr);
-    int OpenSampling(const oeaware::Topic &topic);
+    int OpenSampling(TopicParam &param);
+    bool OpenFallback(TopicParam &param);
+    bool StartSampling(TopicParam &param);
+    void StopSampling(TopicParam &param);
+    void AdjustPeriod(TopicParam &param);
+    void RefreshScope(TopicParam &param);
+    void ReadTopic(TopicParam &param);
+    static bool ParseTopicParams(const std::string &params, TopicParam &param, std::string &err);
+    static bool IsFreqTopic(const std::string &topicName)
+    {
+        return topicName == "cycles";
+    }
+    static uint64_t DefaultPeriod(const std::string &topicName)
+    {
+        return IsFreqTopic(topicName) ? CYCLES_FREQ : NET_RECEIVE_TRACE_SAMPLE_PERIOD;
+    }
 };
 
 #endif
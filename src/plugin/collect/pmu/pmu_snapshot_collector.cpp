@@ -0,0 +1,301 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "pmu_snapshot_collector.h"
+#include <algorithm>
+#include <chrono>
+#include <securec.h>
+#include <libkperf/pcerrc.h>
+#include "oeaware/utils.h"
+#include "pmu_common.h"
+#include "pmu_uncore.h"
+
+namespace {
+const std::string HHA_WORD = "hha";
+const std::string L3C_WORD = "l3c";
+const std::vector<std::string> HHA_EVENTS = {"rx_outer", "rx_sccl", "rx_ops_num"};
+const std::vector<std::string> L3C_EVENTS = {"l3c_hit"};
+
+uint64_t GetMonotonicNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+PmuSnapshotCollector::PmuSnapshotCollector(): oeaware::Interface()
+{
+    this->name = OE_PMU_SNAPSHOT_COLLECTOR;
+    this->version = "1.0.0";
+    this->description = "collect core, uncore and l3c pmu events in one window";
+    this->priority = 0;
+    this->type = 0;
+    this->period = 1000;
+    oeaware::Topic topic;
+    topic.instanceName = this->name;
+    topic.topicName = topicStr;
+    topic.params = "";
+    supportTopics.push_back(topic);
+}
+
+bool PmuSnapshotCollector::ParseEvents(const std::string &params, std::vector<std::string> (&events)[PART_NUM],
+    std::string &err)
+{
+    for (auto &word : oeaware::SplitString(params, " ")) {
+        if (word.empty()) {
+            continue;
+        }
+        int part = CORE_PART;
+        std::vector<std::string> names{word};
+        if (fallback && (word == HHA_WORD || word == L3C_WORD)) {
+            WARN(logger, "snapshot " << word << " events are not counted without PMU.");
+            continue;
+        }
+        if (word == HHA_WORD) {
+            part = UNCORE_PART;
+            names = ListUncoreEvents(HHA_WORD, HHA_EVENTS);
+        } else if (word == L3C_WORD) {
+            part = L3C_PART;
+            names = ListUncoreEvents(L3C_WORD, L3C_EVENTS);
+        }
+        if (names.empty()) {
+            err = "the system does not support " + word + " events";
+            return false;
+        }
+        for (auto &evt : names) {
+            if (std::find(events[part].begin(), events[part].end(), evt) == events[part].end()) {
+                events[part].emplace_back(evt);
+            }
+        }
+    }
+    if (events[CORE_PART].empty() && events[UNCORE_PART].empty() && events[L3C_PART].empty()) {
+        err = "params is empty, e.g. \"cycles instructions hha l3c\"";
+        return false;
+    }
+    return true;
+}
+
+int PmuSnapshotCollector::OpenPart(const std::vector<std::string> &events)
+{
+    struct PmuAttr attr = {};
+    std::vector<char*> evtList;
+    for (auto &evt : events) {
+        evtList.emplace_back(const_cast<char*>(evt.c_str()));
+    }
+    attr.evtList = evtList.data();
+    attr.numEvt = evtList.size();
+    int pd = PmuOpen(COUNTING, &attr);
+    if (pd == -1) {
+        WARN(logger, "PmuOpen snapshot events failed, " << Perror());
+    }
+    return pd;
+}
+
+bool PmuSnapshotCollector::OpenFallback(Session &session, const std::vector<std::string> &events, std::string &err)
+{
+    // a session reopened in place keeps its fallback, the event names are referenced by the last publication.
+    if (session.fallback == nullptr) {
+        session.fallback.reset(new CountingFallback());
+    }
+    for (auto &evt : events) {
+        if (!session.fallback->Open(evt, err)) {
+            session.fallback->CloseAll();
+            return false;
+        }
+    }
+    session.fallbackEvents = events;
+    return true;
+}
+
+oeaware::Result PmuSnapshotCollector::OpenTopic(const oeaware::Topic &topic)
+{
+    if (topic.instanceName != this->name || topic.topicName != topicStr) {
+        return oeaware::Result(FAILED, "OpenTopic: " + topic.GetType() + " failed, topic not match");
+    }
+    auto it = sessions.find(topic.params);
+    if (it != sessions.end() && it->second.open) {
+        WARN(logger, topic.GetType() << " has been opened before!");
+        return oeaware::Result(OK);
+    }
+    std::vector<std::string> events[PART_NUM];
+    std::string err;
+    if (!ParseEvents(topic.params, events, err)) {
+        return oeaware::Result(FAILED, "OpenTopic: " + topic.GetType() + " failed, " + err);
+    }
+    // a session closed in this period is still referenced by its last publication, it is replaced in place.
+    auto &session = sessions[topic.params];
+    CloseSession(session);
+    if (fallback && !OpenFallback(session, events[CORE_PART], err)) {
+        return oeaware::Result(FAILED, "OpenTopic: " + topic.GetType() + " failed, " + err);
+    }
+    for (int part = 0; part < PART_NUM; ++part) {
+        if (events[part].empty()) {
+            continue;
+        }
+        session.pds[part] = OpenPart(events[part]);
+        if (session.pds[part] == -1) {
+            CloseSession(session);
+            return oeaware::Result(FAILED, "OpenTopic: " + topic.GetType() + " failed, PmuOpen failed");
+        }
+    }
+    for (int part = 0; part < PART_NUM; ++part) {
+        if (session.pds[part] != -1) {
+            PmuEnable(session.pds[part]);
+        }
+    }
+    session.startTs = GetMonotonicNs();
+    session.open = true;
+    return oeaware::Result(OK);
+}
+
+void PmuSnapshotCollector::CloseSession(Session &session)
+{
+    for (int part = 0; part < PART_NUM; ++part) {
+        if (session.pds[part] == -1) {
+            continue;
+        }
+        PmuDisable(session.pds[part]);
+        retiredPds.emplace_back(RetiredPd{session.pds[part], session.data[part]});
+        session.pds[part] = -1;
+        session.data[part] = nullptr;
+    }
+    if (session.fallback != nullptr) {
+        session.fallback->CloseAll();
+    }
+    session.open = false;
+}
+
+void PmuSnapshotCollector::ReleaseRetiredPds()
+{
+    for (auto &retired : retiredPds) {
+        if (retired.data != nullptr) {
+            PmuDataFree(retired.data);
+        }
+        PmuClose(retired.pd);
+    }
+    retiredPds.clear();
+}
+
+void PmuSnapshotCollector::CloseTopic(const oeaware::Topic &topic)
+{
+    auto it = sessions.find(topic.params);
+    if (it == sessions.end() || !it->second.open) {
+        WARN(logger, "CloseTopic failed, " + topic.GetType() + " not open.");
+        return;
+    }
+    // the session is removed in the next period, after its last publication has been handled.
+    CloseSession(it->second);
+}
+
+oeaware::Result PmuSnapshotCollector::Enable(const std::string &param)
+{
+    (void)param;
+    bool supportPmu = IsSupportPmu();
+    if (!supportPmu && !fallback) {
+        INFO(logger, "the system does not support PMU, counting snapshot core events with perf_event_open.");
+    }
+    fallback = !supportPmu;
+    ReleaseRetiredPds();
+    return oeaware::Result(OK);
+}
+
+void PmuSnapshotCollector::Disable()
+{
+    return;
+}
+
+void PmuSnapshotCollector::UpdateData(const DataList &dataList)
+{
+    (void)dataList;
+    return;
+}
+
+void PmuSnapshotCollector::ReadSession(const std::string &params, Session &session)
+{
+    // stop all pmus first, the window of every part ends at nearly the same time.
+    for (int part = 0; part < PART_NUM; ++part) {
+        if (session.pds[part] != -1) {
+            PmuDisable(session.pds[part]);
+        }
+    }
+    uint64_t endTs = GetMonotonicNs();
+    int len[PART_NUM] = {0, 0, 0};
+    for (int part = 0; part < PART_NUM; ++part) {
+        if (session.data[part] != nullptr) {
+            PmuDataFree(session.data[part]);
+            session.data[part] = nullptr;
+        }
+        if (session.pds[part] != -1) {
+            len[part] = PmuRead(session.pds[part], &session.data[part]);
+        }
+    }
+    if (session.fallback != nullptr) {
+        session.fallbackData.clear();
+        for (auto &evt : session.fallbackEvents) {
+            session.fallback->Read(evt, session.fallbackData);
+        }
+    }
+    for (int part = 0; part < PART_NUM; ++part) {
+        if (session.pds[part] != -1) {
+            PmuEnable(session.pds[part]);
+        }
+    }
+    uint64_t startTs = session.startTs;
+    session.startTs = GetMonotonicNs();
+    for (int i = 0; i < len[CORE_PART]; ++i) {
+        auto &pmuData = session.data[CORE_PART][i];
+        // countPercent is time_running / time_enabled, estimate the count of the whole window.
+        if (pmuData.countPercent > 0 && pmuData.countPercent < 1) {
+            pmuData.count = static_cast<uint64_t>(pmuData.count / pmuData.countPercent);
+        }
+    }
+    auto &snapshot = session.snapshot;
+    snapshot.startTs = startTs;
+    snapshot.endTs = endTs;
+    snapshot.coreData = session.data[CORE_PART];
+    snapshot.coreLen = std::max(len[CORE_PART], 0);
+    if (session.fallback != nullptr) {
+        snapshot.coreData = session.fallbackData.data();
+        snapshot.coreLen = static_cast<int>(session.fallbackData.size());
+    }
+    snapshot.uncoreData = session.data[UNCORE_PART];
+    snapshot.uncoreLen = std::max(len[UNCORE_PART], 0);
+    snapshot.l3cData = session.data[L3C_PART];
+    snapshot.l3cLen = std::max(len[L3C_PART], 0);
+    snapshot.uncoreTopo = nullptr;
+    if (session.pds[UNCORE_PART] != -1 || session.pds[L3C_PART] != -1) {
+        snapshot.uncoreTopo = session.topoBuilder.Build({{snapshot.uncoreData, snapshot.uncoreLen},
+            {snapshot.l3cData, snapshot.l3cLen}}, endTs - startTs);
+    }
+
+    DataList dataList;
+    if (!oeaware::SetDataListTopic(&dataList, name, topicStr, params)) {
+        return;
+    }
+    dataList.data = new void *[1];
+    dataList.len = 1;
+    dataList.data[0] = &snapshot;
+    Publish(dataList, false);
+}
+
+void PmuSnapshotCollector::Run()
+{
+    // the publications of the last period have been handled, the buffers of closed sessions can be released.
+    ReleaseRetiredPds();
+    for (auto it = sessions.begin(); it != sessions.end();) {
+        if (!it->second.open) {
+            it = sessions.erase(it);
+            continue;
+        }
+        ReadSession(it->first, it->second);
+        ++it;
+    }
+}
@@ -0,0 +1,79 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef PMU_SNAPSHOT_COLLECTOR_H
+#define PMU_SNAPSHOT_COLLECTOR_H
+#include <memory>
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include "oeaware/interface.h"
+#include "oeaware/data/pmu_snapshot_data.h"
+#include "pmu_fallback.h"
+#include "pmu_uncore.h"
+
+/*
+ * Reads core counting, uncore (hha) and l3c events in lock-step.
+ * The topic params are the space separated event set, "hha" stands for rx_outer, rx_sccl and rx_ops_num of all hha
+ * devices, "l3c" for l3c_hit of all l3c devices, other words are core counting events, e.g.
+ * "cycles instructions hha l3c". Every period all pmus of a topic are disabled, read and enabled again one after
+ * another, so the counts share one window and cross-pmu ratios are computed from the same interval.
+ * Uncore and l3c counts are also published by location in uncoreTopo.
+ * Without a supported PMU the core events are counted by CountingFallback, uncore and l3c events are skipped.
+ */
+class PmuSnapshotCollector : public oeaware::Interface {
+public:
+    PmuSnapshotCollector();
+    ~PmuSnapshotCollector() override = default;
+    oeaware::Result OpenTopic(const oeaware::Topic &topic) override;
+    void CloseTopic(const oeaware::Topic &topic) override;
+    void UpdateData(const DataList &dataList) override;
+    oeaware::Result Enable(const std::string &param = "") override;
+    void Disable() override;
+    void Run() override;
+private:
+    enum SnapshotPart {
+        CORE_PART = 0,
+        UNCORE_PART,
+        L3C_PART,
+        PART_NUM,
+    };
+    struct Session {
+        int pds[PART_NUM] = {-1, -1, -1};
+        // data of the last read, referenced by the publication and released in the next period.
+        PmuData *data[PART_NUM] = {nullptr, nullptr, nullptr};
+        PmuSnapshotData snapshot = {};
+        UncoreTopoBuilder topoBuilder;
+        uint64_t startTs = 0;
+        bool open = false;
+        // core events counted without PMU, the data of the last read is referenced by the publication.
+        std::unique_ptr<CountingFallback> fallback;
+        std::vector<std::string> fallbackEvents;
+        std::vector<PmuData> fallbackData;
+    };
+    struct RetiredPd {
+        int pd;
+        PmuData *data;
+    };
+    std::string topicStr = "snapshot";
+    // key: topic params
+    std::unordered_map<std::string, Session> sessions;
+    std::vector<RetiredPd> retiredPds;
+    bool fallback = false;
+    bool ParseEvents(const std::string &params, std::vector<std::string> (&events)[PART_NUM], std::string &err);
+    int OpenPart(const std::vector<std::string> &events);
+    bool OpenFallback(Session &session, const std::vector<std::string> &events, std::string &err);
+    void CloseSession(Session &session);
+    void ReleaseRetiredPds();
+    void ReadSession(const std::string &params, Session &session);
+};
+
+#endif
@@ -0,0 +1,186 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "pmu_spe_access.h"
+#include <algorithm>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+namespace {
+// event bit of the spe record, the access missed the last level cache.
+constexpr uint64_t SPE_EV_LLC_MISS = 0x200;
+// user addresses are below 2^52, the page number takes 40 bits and the pid the bits above.
+constexpr unsigned int PAGE_KEY_PID_SHIFT = 40;
+constexpr uint64_t CACHE_MAX_AGE = 10;
+constexpr size_t MOVE_PAGES_BATCH = 1024;
+constexpr double QUANTILES[PMU_SPE_LAT_QUANTILE_NUM] = {0.5, 0.9, 0.99, 1.0};
+}
+
+SpeAccessAggregator::SpeAccessAggregator(size_t cacheSize) : cacheSize(cacheSize)
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    pageShift = 0;
+    while (pageSize > 1) {
+        pageSize >>= 1;
+        ++pageShift;
+    }
+}
+
+uint64_t SpeAccessAggregator::PageKey(int pid, uint64_t va) const
+{
+    return (static_cast<uint64_t>(pid) << PAGE_KEY_PID_SHIFT) | (va >> pageShift);
+}
+
+bool SpeAccessAggregator::LookupCache(uint64_t key, int &node)
+{
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        return false;
+    }
+    if (period - it->second->age > CACHE_MAX_AGE) {
+        lru.erase(it->second);
+        cache.erase(it);
+        return false;
+    }
+    lru.splice(lru.begin(), lru, it->second);
+    node = it->second->node;
+    return true;
+}
+
+void SpeAccessAggregator::InsertCache(uint64_t key, int node)
+{
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        it->second->node = node;
+        it->second->age = period;
+        lru.splice(lru.begin(), lru, it->second);
+        return;
+    }
+    if (cache.size() >= cacheSize && !lru.empty()) {
+        cache.erase(lru.back().key);
+        lru.pop_back();
+    }
+    lru.push_front(CacheEntry{key, node, period});
+    cache[key] = lru.begin();
+}
+
+void SpeAccessAggregator::ResolvePages(int pid, const std::vector<uint64_t> &pages)
+{
+    std::vector<void*> addrs;
+    std::vector<int> status;
+    for (size_t begin = 0; begin < pages.size(); begin += MOVE_PAGES_BATCH) {
+        size_t num = std::min(MOVE_PAGES_BATCH, pages.size() - begin);
+        addrs.resize(num);
+        status.assign(num, -1);
+        for (size_t i = 0; i < num; ++i) {
+            addrs[i] = reinterpret_cast<void*>(pages[begin + i] << pageShift);
+        }
+        // nodes is null, only the node of every page is queried.
+        if (syscall(SYS_move_pages, pid, num, addrs.data(), nullptr, status.data(), 0) != 0) {
+            // the process has exited or can not be accessed, the rest of its pages fail too.
+            return;
+        }
+        for (size_t i = 0; i < num; ++i) {
+            if (status[i] >= 0) {
+                uint64_t key = PageKey(pid, pages[begin + i] << pageShift);
+                InsertCache(key, status[i]);
+                pageNodes[key] = status[i];
+            }
+        }
+    }
+}
+
+void SpeAccessAggregator::Process(const PmuData *data, int len, uint64_t interval)
+{
+    ++period;
+    counts.clear();
+    latency.clear();
+    pageNodes.clear();
+    result.records = 0;
+    result.unresolved = 0;
+    // pages missing in the cache, key: pid.
+    std::unordered_map<int, std::vector<uint64_t>> missPages;
+    std::vector<int> valid;
+    for (int i = 0; i < len; ++i) {
+        auto &record = data[i];
+        if (record.ext == nullptr || record.pid <= 0 || record.ext->va == 0 ||
+            (record.ext->event & SPE_EV_LLC_MISS) == 0) {
+            continue;
+        }
+        valid.emplace_back(i);
+        uint64_t key = PageKey(record.pid, record.ext->va);
+        int node;
+        if (pageNodes.count(key)) {
+            continue;
+        }
+        if (LookupCache(key, node)) {
+            pageNodes[key] = node;
+        } else {
+            missPages[record.pid].emplace_back(record.ext->va >> pageShift);
+        }
+    }
+    for (auto &item : missPages) {
+        auto &pages = item.second;
+        std::sort(pages.begin(), pages.end());
+        pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+        ResolvePages(item.first, pages);
+    }
+    for (auto i : valid) {
+        auto &record = data[i];
+        auto it = pageNodes.find(PageKey(record.pid, record.ext->va));
+        if (it == pageNodes.end()) {
+            result.unresolved++;
+            continue;
+        }
+        int memNode = it->second;
+        int cpuNode = record.cpuTopo != nullptr ? record.cpuTopo->numaId : -1;
+        counts[AccessKey{record.pid, record.tid, cpuNode, memNode}]++;
+        latency.emplace_back(record.ext->lat);
+        result.records++;
+    }
+    access.clear();
+    access.reserve(counts.size());
+    for (auto &item : counts) {
+        access.emplace_back(PmuSpeAccess{item.first.pid, item.first.tid, item.first.cpuNode, item.first.memNode,
+            item.second});
+    }
+    CalculateQuantiles();
+    result.access = access.data();
+    result.len = static_cast<int>(access.size());
+    result.interval = interval;
+}
+
+void SpeAccessAggregator::CalculateQuantiles()
+{
+    size_t begin = 0;
+    for (int i = 0; i < PMU_SPE_LAT_QUANTILE_NUM; ++i) {
+        result.latQuantiles[i] = 0;
+        if (latency.empty()) {
+            continue;
+        }
+        size_t pos = std::min(latency.size() - 1, static_cast<size_t>(QUANTILES[i] * latency.size()));
+        // the quantiles are ascending, every nth_element only reorders the part after the previous one.
+        std::nth_element(latency.begin() + begin, latency.begin() + pos, latency.end());
+        result.latQuantiles[i] = latency[pos];
+        begin = pos;
+    }
+}
+
+void SpeAccessAggregator::Clear()
+{
+    lru.clear();
+    cache.clear();
+    pageNodes.clear();
+    counts.clear();
+    latency.clear();
+    access.clear();
+    result = PmuSpeAccessData();
+}
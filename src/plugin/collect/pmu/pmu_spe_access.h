@@ -0,0 +1,79 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef PMU_SPE_ACCESS_H
+#define PMU_SPE_ACCESS_H
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "oeaware/data/pmu_spe_data.h"
+
+/*
+ * Turns raw spe records into [pid][tid][cpuNode][memNode] access counts and latency quantiles.
+ * Records of memory accesses that missed the last level cache are kept, their addresses are deduplicated by page
+ * and the node of every page is looked up in a page -> node LRU cache, the misses of a process are resolved with
+ * batched move_pages calls. Cached nodes expire after a few periods since pages can be migrated.
+ */
+class SpeAccessAggregator {
+public:
+    explicit SpeAccessAggregator(size_t cacheSize = DEFAULT_CACHE_SIZE);
+    // Aggregate the records of one period, the result stays valid until the next call.
+    void Process(const PmuData *data, int len, uint64_t interval);
+    PmuSpeAccessData &GetData()
+    {
+        return result;
+    }
+    void Clear();
+    static const size_t DEFAULT_CACHE_SIZE = 65536;
+private:
+    struct CacheEntry {
+        uint64_t key;
+        int node;
+        uint64_t age;
+    };
+    struct AccessKey {
+        int pid;
+        int tid;
+        int cpuNode;
+        int memNode;
+        bool operator==(const AccessKey &other) const
+        {
+            return pid == other.pid && tid == other.tid && cpuNode == other.cpuNode && memNode == other.memNode;
+        }
+    };
+    struct AccessKeyHash {
+        size_t operator()(const AccessKey &key) const
+        {
+            return std::hash<uint64_t>()((static_cast<uint64_t>(key.pid) << 32) ^ static_cast<uint32_t>(key.tid)) ^
+                std::hash<int>()((key.cpuNode << 16) ^ key.memNode);
+        }
+    };
+    uint64_t PageKey(int pid, uint64_t va) const;
+    bool LookupCache(uint64_t key, int &node);
+    void InsertCache(uint64_t key, int node);
+    void ResolvePages(int pid, const std::vector<uint64_t> &pages);
+    void CalculateQuantiles();
+
+    size_t cacheSize;
+    unsigned int pageShift;
+    uint64_t period = 0;
+    std::list<CacheEntry> lru;
+    std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> cache;
+    // nodes of the pages accessed in this period, the cache may be smaller than the pages of one period.
+    std::unordered_map<uint64_t, int> pageNodes;
+    std::unordered_map<AccessKey, uint64_t, AccessKeyHash> counts;
+    std::vector<uint32_t> latency;
+    std::vector<PmuSpeAccess> access;
+    PmuSpeAccessData result = {};
+};
+
+#endif
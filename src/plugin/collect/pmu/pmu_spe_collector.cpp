@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <securec.h>
 #include "oeaware/data/pmu_spe_data.h"
+#include "oeaware/utils.h"
 
 PmuSpeCollector::PmuSpeCollector(): oeaware::Interface()
 {
@@ -23,11 +24,13 @@ PmuSpeCollector::PmuSpeCollector(): oeaware::Interface()
     this->type = 0;
     this->period = 100;
     pmuId = -1;
-    oeaware::Topic topic;
-    topic.instanceName = this->name;
-    topic.topicName = topicStr;
-    topic.params = "";
-    supportTopics.push_back(topic);
+    for (auto &topicName : {topicStr, accessTopicStr}) {
+        oeaware::Topic topic;
+        topic.instanceName = this->name;
+        topic.topicName = topicName;
+        topic.params = "";
+        supportTopics.push_back(topic);
+    }
 }
 
 void PmuSpeCollector::InitSpeAttr(struct PmuAttr &attr)
@@ -55,40 +58,35 @@ int PmuSpeCollector::OpenSpe()
 {
     struct PmuAttr attr = {};
     InitSpeAttr(attr);
+    auto fdsBefore = SamplingBudget::ListPerfFds();
     int pd = PmuOpen(SPE_SAMPLING, &attr);
     if (pd == -1) {
         WARN(logger, "open spe failed.");
+    } else {
+        perfFds = SamplingBudget::NewPerfFds(fdsBefore);
     }
 
     return pd;
 }
 
-void PmuSpeCollector::DynamicAdjustPeriod(int interval)
+void PmuSpeCollector::DynamicAdjustPeriod()
 {
-    if (pmuId == -1) {
+    if (pmuId == -1 || !adjust) {
         return;
     }
+    adjust = false;
     int srcPeriod = attrPeriod;
-    // The values of the upper and lower bounds of the interval cannot be close,
-    // otherwise it may lead to frequent modifications of the attrPeriod
-    if (interval > timeoutMs) {
-        attrPeriod *= periodThreshold;
-        if (attrPeriod > maxAttrPeriod) {
-            attrPeriod = maxAttrPeriod;
-        }
-    } else if (interval < notTimeoutMs) {
-        attrPeriod /= periodThreshold;
-        if (attrPeriod < minAttrPeriod) {
-            attrPeriod = minAttrPeriod;
-        }
-    }
+    attrPeriod = static_cast<int>(budget.GetPeriod(minAttrPeriod, false));
     if (attrPeriod == srcPeriod) {
         return;
     }
+    INFO(logger, "PmuSpeCollector dynamic adjust period from " << srcPeriod << " to " << attrPeriod << ".");
+    if (SamplingBudget::SetPeriod(perfFds, attrPeriod)) {
+        return;
+    }
     PmuDisable(pmuId);
     PmuClose(pmuId);
-    INFO(logger, "PmuSpeCollector dynamic adjust period from " << srcPeriod << " to " <<
-        attrPeriod << ", PmuRead interval is " << interval << " ms.");
+    perfFds.clear();
     pmuId = OpenSpe();
     if (pmuId != -1) {
         PmuEnable(pmuId);
@@ -97,30 +95,41 @@ void PmuSpeCollector::DynamicAdjustPeriod(int interval)
 
 oeaware::Result PmuSpeCollector::OpenTopic(const oeaware::Topic &topic)
 {
-    if (topic.instanceName != this->name || topic.topicName != topicStr || topic.params != "") {
+    if (topic.instanceName != this->name || (topic.topicName != topicStr && topic.topicName != accessTopicStr) ||
+        topic.params != "") {
         return oeaware::Result(FAILED, "OpenTopic: " + topic.GetType() + " failed, topic not match");
     }
-    attrPeriod = minAttrPeriod;
-    readTimeMs = 0;
+    if (openTopics.count(topic.topicName)) {
+        return oeaware::Result(FAILED);
+    }
     if (pmuId == -1) {
+        budget.Reset();
+        adjust = false;
+        attrPeriod = minAttrPeriod;
         pmuId = OpenSpe();
         if (pmuId == -1) {
             return oeaware::Result(FAILED, "OpenTopic failed, PmuOpen failed");
         }
         PmuEnable(pmuId);
         timestamp = std::chrono::high_resolution_clock::now();
-        return oeaware::Result(OK);
     }
-
-    return oeaware::Result(FAILED);
+    openTopics.insert(topic.topicName);
+    return oeaware::Result(OK);
 }
 
 void PmuSpeCollector::CloseTopic(const oeaware::Topic &topic)
 {
-    if (topic.instanceName != this->name || topic.topicName != topicStr || topic.params != "") {
+    if (topic.instanceName != this->name || !openTopics.count(topic.topicName) || topic.params != "") {
         WARN(logger, "CloseTopic:" + topic.GetType() + " failed, topic not match");
         return;
     }
+    openTopics.erase(topic.topicName);
+    if (topic.topicName == accessTopicStr) {
+        aggregator.Clear();
+    }
+    if (!openTopics.empty()) {
+        return;
+    }
     if (pmuId == -1) {
         WARN(logger, "CloseTopic:" + topic.GetType() + " failed, pmuId = -1");
         return;
@@ -128,14 +137,19 @@ void PmuSpeCollector::CloseTopic(const oeaware::Topic &topic)
     PmuDisable(pmuId);
     PmuClose(pmuId);
     pmuId = -1;
+    perfFds.clear();
 }
 
 oeaware::Result PmuSpeCollector::Enable(const std::string &param)
 {
-    (void)param;
     if (!oeaware::FileExist(spePath)) {
         return oeaware::Result(FAILED, "the system does not support SPE.");
     }
+    budget = SamplingBudget(maxOverhead, maxAttrPeriod / minAttrPeriod);
+    std::string err;
+    if (!budget.ParseParam(param, err)) {
+        return oeaware::Result(FAILED, err);
+    }
     return oeaware::Result(OK);
 }
 
@@ -154,7 +168,7 @@ void PmuSpeCollector::Run()
 {
     // adjust period will pmuclose and free spe data
     // so adjust period should be done after other plugins have finished using SPE data
-    DynamicAdjustPeriod(readTimeMs);
+    DynamicAdjustPeriod();
     if (pmuId == -1) {
         return;
     }
@@ -162,12 +176,29 @@ void PmuSpeCollector::Run()
     PmuDisable(pmuId);
     auto readBegin = std::chrono::high_resolution_clock::now();
     data->len = PmuRead(pmuId, &(data->pmuData));
-    readTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+    uint64_t readUs = std::chrono::duration_cast<std::chrono::microseconds>(
         std::chrono::high_resolution_clock::now() - readBegin).count();
     PmuEnable(pmuId);
     auto now = std::chrono::high_resolution_clock::now();
     data->interval = std::chrono::duration_cast<std::chrono::milliseconds>(now - timestamp).count();
     timestamp = std::chrono::high_resolution_clock::now();
+    adjust = budget.Update(data->len > 0 ? data->len : 0, data->interval, readUs);
+    // the access topic is aggregated before the raw data is handed over to the framework.
+    if (openTopics.count(accessTopicStr)) {
+        PublishAccess(data);
+    }
+    if (openTopics.count(topicStr)) {
+        PublishRaw(data);
+    } else {
+        if (data->pmuData != nullptr) {
+            PmuDataFree(data->pmuData);
+        }
+        delete data;
+    }
+}
+
+void PmuSpeCollector::PublishRaw(PmuSpeData *data)
+{
     DataList dataList;
     dataList.topic.instanceName = new char[name.size() + 1];
     strcpy_s(dataList.topic.instanceName, name.size() + 1, name.data());
@@ -179,4 +210,18 @@ void PmuSpeCollector::Run()
     dataList.data = new void *[1];
     dataList.data[0] = data;
     Publish(dataList);
-}
\ No newline at end of file
+}
+
+void PmuSpeCollector::PublishAccess(PmuSpeData *data)
+{
+    aggregator.Process(data->pmuData, data->len, data->interval);
+    DataList dataList;
+    if (!oeaware::SetDataListTopic(&dataList, name, accessTopicStr, "")) {
+        return;
+    }
+    dataList.len = 1;
+    dataList.data = new void *[1];
+    // owned by the aggregator and valid until the next period.
+    dataList.data[0] = &aggregator.GetData();
+    Publish(dataList, false);
+}
@@ -14,8 +14,16 @@
 #define PMU_SPE_COLLECTOR_H
 #include <unordered_map>
 #include <chrono>
+#include <vector>
+#include <set>
 #include "oeaware/interface.h"
+#include "pmu_sampling_budget.h"
+#include "pmu_spe_access.h"
 
+/*
+ * "spe" publishes the raw records, "spe_access" the access counts and latency quantiles aggregated in the collector
+ * (see SpeAccessAggregator). Both topics share one spe pmu.
+ */
 class PmuSpeCollector : public oeaware::Interface {
 public:
     PmuSpeCollector();
@@ -27,21 +35,28 @@ public:
     void Disable() override;
     void Run() override;
 private:
-    void DynamicAdjustPeriod(int interval);
+    void DynamicAdjustPeriod();
     void InitSpeAttr(struct PmuAttr &attr);
     int OpenSpe();
+    void PublishRaw(PmuSpeData *data);
+    void PublishAccess(PmuSpeData *data);
 
     int pmuId;
     int attrPeriod = 2048;
     std::string topicStr = "spe";
+    std::string accessTopicStr = "spe_access";
+    std::set<std::string> openTopics;
+    SpeAccessAggregator aggregator;
     std::chrono::time_point<std::chrono::high_resolution_clock> timestamp;
     const std::string spePath = "/sys/bus/event_source/devices/arm_spe_0";
-    const int timeoutMs = 50;
-    const int notTimeoutMs = 10;
-    const int periodThreshold = 2;
-    const int minAttrPeriod = 2048;
-    const int maxAttrPeriod = 2048000;
-    int readTimeMs = 0; // last period PmuRead() time
+    // PmuRead may take half of the period, the period is raised up to maxAttrPeriod.
+    static const int maxOverhead = 50;
+    static const int minAttrPeriod = 2048;
+    static const int maxAttrPeriod = 2048000;
+    SamplingBudget budget{maxOverhead, maxAttrPeriod / minAttrPeriod};
+    bool adjust = false;
+    // perf fds of pmuId, used to change the period in place.
+    std::vector<int> perfFds;
 };
 
 #endif
\ No newline at end of file
@@ -13,6 +13,10 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
 #include <dirent.h>
 #include <securec.h>
 
@@ -201,3 +205,166 @@ void UncoreConfigFini(void)
     UncoreConfigFree(uncoreL3cHit);
     hhaNum = 0;
 }
+
+std::vector<std::string> ListUncoreEvents(const std::string &device, const std::vector<std::string> &events)
+{
+    std::vector<std::string> devices;
+    DIR *dir = opendir(DEVICE_PATH.data());
+    if (dir == nullptr) {
+        return {};
+    }
+    struct dirent *dent = nullptr;
+    while ((dent = readdir(dir)) != nullptr) {
+        if (strstr(dent->d_name, device.c_str()) != nullptr) {
+            devices.emplace_back(dent->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(devices.begin(), devices.end());
+    std::vector<std::string> names;
+    for (auto &event : events) {
+        for (auto &dev : devices) {
+            names.emplace_back(dev + "/" + event + "/");
+        }
+    }
+    return names;
+}
+
+static int ParseNumberAfter(const std::string &str, const std::string &word)
+{
+    auto pos = str.find(word);
+    if (pos == std::string::npos) {
+        return -1;
+    }
+    pos += word.size();
+    size_t end = pos;
+    while (end < str.size() && isdigit(static_cast<unsigned char>(str[end]))) {
+        ++end;
+    }
+    return end == pos ? -1 : atoi(str.substr(pos, end - pos).c_str());
+}
+
+static bool ReadFirstLine(const std::string &path, std::string &line)
+{
+    std::ifstream file(path);
+    return file.is_open() && static_cast<bool>(std::getline(file, line));
+}
+
+bool UncoreTopoBuilder::GetLocation(const std::string &device, UncoreLocation &loc)
+{
+    auto it = locations.find(device);
+    if (it != locations.end()) {
+        loc = it->second;
+        return loc.dieId >= 0;
+    }
+    loc = {-1, -1, -1, -1};
+    std::string type = device.find("hha") != std::string::npos ? "hha" : "l3c";
+    std::string cpumask;
+    loc.dieId = ParseNumberAfter(device, "sccl");
+    loc.index = ParseNumberAfter(device, type);
+    if (loc.dieId >= 0 && ReadFirstLine(sysPath + device + "/cpumask", cpumask)) {
+        // the cpumask of an uncore pmu is one cpu of its die, "0" or "0-47" on some kernels.
+        int cpu = atoi(cpumask.c_str());
+        std::string cpuPath = sysPath + "system/cpu/cpu" + std::to_string(cpu);
+        std::string socket;
+        if (ReadFirstLine(cpuPath + "/topology/physical_package_id", socket)) {
+            loc.socketId = atoi(socket.c_str());
+        }
+        DIR *dir = opendir(cpuPath.c_str());
+        struct dirent *dent = nullptr;
+        while (dir != nullptr && (dent = readdir(dir)) != nullptr) {
+            int node = ParseNumberAfter(dent->d_name, "node");
+            if (strncmp(dent->d_name, "node", strlen("node")) == 0 && node >= 0) {
+                loc.numaId = node;
+                break;
+            }
+        }
+        if (dir != nullptr) {
+            closedir(dir);
+        }
+    }
+    if (loc.socketId < 0 || loc.numaId < 0) {
+        loc.dieId = -1;
+    }
+    locations[device] = loc;
+    return loc.dieId >= 0;
+}
+
+UncoreTopoData *UncoreTopoBuilder::Build(const std::vector<std::pair<const PmuData*, int>> &parts,
+    uint64_t intervalNs)
+{
+    records.clear();
+    nodes.clear();
+    std::set<int> sockets;
+    std::set<std::pair<int, int>> dies;
+    std::set<std::pair<int, int>> hhas;
+    std::set<std::pair<int, int>> l3cs;
+    // key: numa node, value: index in nodes
+    std::map<int, size_t> nodeIndex;
+    // rx_outer + rx_sccl and rx_ops_num of every node
+    std::map<int, std::pair<uint64_t, uint64_t>> remoteOps;
+    double seconds = intervalNs / 1e9;
+    for (auto &part : parts) {
+        for (int i = 0; i < part.second; ++i) {
+            auto &pmuData = part.first[i];
+            if (pmuData.evt == nullptr) {
+                continue;
+            }
+            // "<device>/<event>/"
+            std::string name = pmuData.evt;
+            auto pos = name.find('/');
+            if (pos == std::string::npos) {
+                continue;
+            }
+            std::string device = name.substr(0, pos);
+            std::string evt = name.substr(pos + 1);
+            if (!evt.empty() && evt.back() == '/') {
+                evt.pop_back();
+            }
+            UncoreLocation loc;
+            if (!GetLocation(device, loc)) {
+                continue;
+            }
+            bool isHha = device.find("hha") != std::string::npos;
+            sockets.insert(loc.socketId);
+            dies.emplace(loc.socketId, loc.dieId);
+            (isHha ? hhas : l3cs).emplace(loc.dieId, loc.index);
+            auto evtName = evtNames.emplace(evt).first;
+            records.emplace_back(UncoreRecord{loc, const_cast<char*>(evtName->c_str()), pmuData.count});
+
+            if (!nodeIndex.count(loc.numaId)) {
+                nodeIndex[loc.numaId] = nodes.size();
+                nodes.emplace_back(UncoreNodeStat{loc.numaId, loc.socketId, 0, 0, 0, 0});
+            }
+            auto &node = nodes[nodeIndex[loc.numaId]];
+            double rate = seconds > 0 ? pmuData.count / seconds : 0;
+            if (evt == "rx_ops_num") {
+                node.opsRate += rate;
+                remoteOps[loc.numaId].second += pmuData.count;
+            } else if (evt == "rx_outer" || evt == "rx_sccl") {
+                remoteOps[loc.numaId].first += pmuData.count;
+            } else if (evt == "l3c_hit") {
+                node.l3cHitRate += rate;
+            }
+        }
+    }
+    for (auto &node : nodes) {
+        node.bandwidth = node.opsRate * UNCORE_OP_BYTES;
+        auto &ops = remoteOps[node.numaId];
+        node.remoteRatio = ops.second > 0 ? static_cast<double>(ops.first) / ops.second : 0;
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const UncoreNodeStat &a, const UncoreNodeStat &b) {
+        return a.numaId < b.numaId;
+    });
+    data.intervalNs = intervalNs;
+    data.socketNum = sockets.size();
+    data.dieNum = dies.size();
+    data.nodeNum = nodes.size();
+    data.hhaNum = hhas.size();
+    data.l3cNum = l3cs.size();
+    data.records = records.data();
+    data.len = records.size();
+    data.nodes = nodes.data();
+    data.nodeLen = nodes.size();
+    return &data;
+}
@@ -12,6 +12,11 @@
 #ifndef __PMU_UNCORE_H__
 #define __PMU_UNCORE_H__
 #include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <libkperf/pmu.h>
+#include "oeaware/data/pmu_uncore_data.h"
 
 const int UNCORE_NAME_SIZE = 256;
 const int MAX_PATH_LEN = 256;
@@ -35,5 +40,31 @@ UncoreConfig *GetL3cHit(void);
 int HhaUncoreConfigInit(void);
 int L3cUncoreConfigInit(void);
 void UncoreConfigFini(void);
+/*
+ * Event names "<device>/<event>/" of every device under DEVICE_PATH whose name contains device, ordered by event and
+ * then by device, the same layout as the hha and l3c configs above. Does not touch the global configs.
+ */
+std::vector<std::string> ListUncoreEvents(const std::string &device, const std::vector<std::string> &events);
+
+/*
+ * Builds UncoreTopoData from the counts of hha and l3c events "<device>/<event>/".
+ * The location of a device is read once from its name and the first cpu of its cpumask.
+ * The returned data is valid until the next Build.
+ */
+class UncoreTopoBuilder {
+public:
+    explicit UncoreTopoBuilder(const std::string &sysPath = "/sys/devices/") : sysPath(sysPath) { }
+    UncoreTopoData *Build(const std::vector<std::pair<const PmuData*, int>> &parts, uint64_t intervalNs);
+    bool GetLocation(const std::string &device, UncoreLocation &loc);
+private:
+    std::string sysPath;
+    // key: device, devices without a location have dieId -1.
+    std::unordered_map<std::string, UncoreLocation> locations;
+    // names referenced by the records.
+    std::unordered_set<std::string> evtNames;
+    std::vector<UncoreRecord> records;
+    std::vector<UncoreNodeStat> nodes;
+    UncoreTopoData data = {};
+};
 
 #endif
@@ -17,6 +17,7 @@
 #include "oeaware/data/pmu_uncore_data.h"
 #include "pmu_uncore.h"
 #include "libkperf/pcerrc.h"
+#include "oeaware/utils.h"
 
 PmuUncoreCollector::PmuUncoreCollector(): oeaware::Interface()
 {
@@ -33,6 +34,8 @@ PmuUncoreCollector::PmuUncoreCollector(): oeaware::Interface()
     topic.topicName = topicStr;
     topic.params = "";
     supportTopics.push_back(topic);
+    topic.topicName = nodeTopicStr;
+    supportTopics.push_back(topic);
 }
 
 int PmuUncoreCollector::OpenUncore()
@@ -86,10 +89,14 @@ int PmuUncoreCollector::OpenUncore()
 
 oeaware::Result PmuUncoreCollector::OpenTopic(const oeaware::Topic &topic)
 {
-    if (topic.instanceName != this->name || topic.topicName != topicStr || topic.params != "") {
+    if (topic.instanceName != this->name || (topic.topicName != topicStr && topic.topicName != nodeTopicStr) ||
+        topic.params != "") {
         return oeaware::Result(FAILED, "OpenTopic: " + topic.GetType() + " failed, topic not match");
     }
-
+    if (openTopics.count(topic.topicName)) {
+        return oeaware::Result(FAILED);
+    }
+    // both topics share one pmu.
     if (pmuId == -1) {
         pmuId = OpenUncore();
         if (pmuId == -1) {
@@ -97,22 +104,25 @@ oeaware::Result PmuUncoreCollector::OpenTopic(const oeaware::Topic &topic)
         }
         PmuEnable(pmuId);
         timestamp = std::chrono::high_resolution_clock::now();
-        return oeaware::Result(OK);
     }
-
-    return oeaware::Result(FAILED);
+    openTopics.insert(topic.topicName);
+    return oeaware::Result(OK);
 }
 
 void PmuUncoreCollector::CloseTopic(const oeaware::Topic &topic)
 {
-    if (topic.instanceName != this->name || topic.topicName != topicStr || topic.params != "") {
+    if (topic.instanceName != this->name || (topic.topicName != topicStr && topic.topicName != nodeTopicStr) ||
+        topic.params != "") {
         WARN(logger, "CloseTopic:" + topic.GetType() + " failed, topic not match.");
         return;
     }
-    if (pmuId == -1) {
+    if (pmuId == -1 || openTopics.erase(topic.topicName) == 0) {
         WARN(logger, "CloseTopic:" + topic.GetType() + " failed, pmuId = -1");
         return;
     }
+    if (!openTopics.empty()) {
+        return;
+    }
     PmuDisable(pmuId);
     PmuClose(pmuId);
     UncoreConfigFini();
@@ -139,6 +149,20 @@ void PmuUncoreCollector::UpdateData(const DataList &dataList)
     return;
 }
 
+void PmuUncoreCollector::PublishTopo(const PmuData *pmuData, int len, uint64_t intervalNs)
+{
+    auto topo = topoBuilder.Build({{pmuData, len}}, intervalNs);
+    DataList dataList;
+    if (!oeaware::SetDataListTopic(&dataList, name, nodeTopicStr, "")) {
+        return;
+    }
+    dataList.len = 1;
+    dataList.data = new void *[1];
+    // the builder keeps the buffers until the next period.
+    dataList.data[0] = topo;
+    Publish(dataList, false);
+}
+
 void PmuUncoreCollector::Run()
 {
     if (pmuId == -1) {
@@ -150,8 +174,19 @@ void PmuUncoreCollector::Run()
     PmuEnable(pmuId);
 
     auto now = std::chrono::high_resolution_clock::now();
+    uint64_t intervalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - timestamp).count();
     data->interval = std::chrono::duration_cast<std::chrono::milliseconds>(now - timestamp).count();
     timestamp = now;
+    if (openTopics.count(nodeTopicStr)) {
+        PublishTopo(data->pmuData, data->len, intervalNs);
+    }
+    if (!openTopics.count(topicStr)) {
+        if (data->pmuData != nullptr) {
+            PmuDataFree(data->pmuData);
+        }
+        delete data;
+        return;
+    }
 
     DataList dataList;
     dataList.topic.instanceName = new char[name.size() + 1];
@@ -164,4 +199,4 @@ void PmuUncoreCollector::Run()
     dataList.data = new void *[1];
     dataList.data[0] = data;
     Publish(dataList);
-}
\ No newline at end of file
+}
@@ -13,8 +13,10 @@
 #ifndef PMU_UNCORE_COLLECTOR_H
 #define PMU_UNCORE_COLLECTOR_H
 #include <unordered_map>
+#include <unordered_set>
 #include <chrono>
 #include "oeaware/interface.h"
+#include "pmu_uncore.h"
 
 class PmuUncoreCollector : public oeaware::Interface {
 public:
@@ -29,10 +31,15 @@ public:
 private:
     int pmuId;
     std::string topicStr = "uncore";
+    // the same counts as UncoreTopoData, keyed by location with per-node series.
+    std::string nodeTopicStr = "uncore_node";
+    std::unordered_set<std::string> openTopics;
+    UncoreTopoBuilder topoBuilder;
     std::vector<std::string> eventStr;
     std::chrono::time_point<std::chrono::high_resolution_clock> timestamp;
     const std::string uncorePath = "/sys/bus/event_source/devices/hisi_sccl1_hha2";
     int OpenUncore();
+    void PublishTopo(const PmuData *pmuData, int len, uint64_t intervalNs);
 };
 
 #endif
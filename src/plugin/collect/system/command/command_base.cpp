@@ -15,6 +15,7 @@
 #include <sys/wait.h>
 #include "oeaware/data/command_data.h"
 #include "oeaware/data_list.h"
+#include "oeaware/utils.h"
 int PopenProcess::Pclose()
 {
     if (fclose(stream) == EOF) {
@@ -75,9 +76,18 @@ bool CommandBase::ValidateCmd(const std::string &cmd)
     return true;
 }
 
+std::string CommandBase::GetCommandName(const std::string &topicName)
+{
+    const std::string typedSuffix = "_typed";
+    if (oeaware::EndWith(topicName, typedSuffix)) {
+        return topicName.substr(0, topicName.size() - typedSuffix.size());
+    }
+    return topicName;
+}
+
 bool CommandBase::ValidateArgs(const oeaware::Topic& topic)
 {
-    if (std::find(command.begin(), command.end(), topic.topicName) == command.end()) {
+    if (std::find(command.begin(), command.end(), GetCommandName(topic.topicName)) == command.end()) {
         return false;
     }
     return ValidateCmd(topic.params);
@@ -130,7 +140,7 @@ void CommandBase::ParseLine(const std::string& line)
 
 std::string CommandBase::GetCommand(const oeaware::Topic& topic)
 {
-    return topic.topicName + " " + topic.params;
+    return GetCommandName(topic.topicName) + " " + topic.params;
 }
 
 bool CommandBase::FillDataStruct(void* dataStruct)
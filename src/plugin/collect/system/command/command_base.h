@@ -22,6 +22,8 @@
 class CommandBase {
 public:
     std::mutex dataMutex;
+    // Held while new data is published, so the data is not closed under the publisher.
+    std::mutex publishMutex;
     std::atomic<bool> isRunning{false};
     std::atomic<bool> hasNewData{false};
     // key: attribute row type(topic type + attrsFirst), value: attribute row.
@@ -39,10 +41,16 @@ public:
     virtual ~CommandBase() = default;
     static bool ValidateArgs(const oeaware::Topic& topic);
     static bool ValidateCmd(const std::string &cmd);
-    void ParseLine(const std::string& line);
+    virtual void ParseLine(const std::string& line);
+    virtual void ParseLine(char *line, size_t len)
+    {
+        ParseLine(std::string(line, len));
+    }
+    // "<command>_typed" topics run the same command as "<command>".
+    static std::string GetCommandName(const std::string &topicName);
     static std::string GetCommand(const oeaware::Topic& topic);
-    bool FillDataStruct(void* dataStruct);
-    void Close();
+    virtual bool FillDataStruct(void* dataStruct);
+    virtual void Close();
 };
 
 class PopenProcess {
@@ -11,6 +11,7 @@
  ******************************************************************************/
 #include "command_collector.h"
 #include <unistd.h>
+#include "command_parser.h"
 
 CommandCollector::CommandCollector(): oeaware::Interface()
 {
@@ -31,43 +32,64 @@ CommandCollector::CommandCollector(): oeaware::Interface()
 
 void CommandCollector::CollectThread(const oeaware::Topic &topic, CommandBase* collector)
 {
+    auto typed = dynamic_cast<TypedCommand*>(collector);
+    if (typed != nullptr && typed->IsNative()) {
+        typed->CollectNative();
+        // publish the last sample here, the publish thread may not poll again before it stops
+        std::lock_guard<std::mutex> lock(collector->publishMutex);
+        PublishNewData(topic, collector);
+        collector->Close();
+        return;
+    }
     std::string cmd = collector->GetCommand(topic);
     PopenProcess p;
     p.Popen(cmd);
     if (!p.stream) {
         return;
     }
-    char buffer[256];
-    while (collector->isRunning && fgets(buffer, sizeof(buffer), p.stream) != nullptr) {
-        collector->ParseLine(std::string(buffer));
+    char *line = nullptr;
+    size_t cap = 0;
+    ssize_t len;
+    while (collector->isRunning && (len = getline(&line, &cap, p.stream)) != -1) {
+        collector->ParseLine(line, len);
     }
+    free(line);
     int waitTime = 100 * 1000;
     usleep(waitTime);
     p.Pclose();
     collector->Close();
 }
 
+void CommandCollector::PublishNewData(const oeaware::Topic &topic, CommandBase* collector)
+{
+    if (!collector->hasNewData.exchange(false)) {
+        return;
+    }
+    DataList dataList;
+    dataList.topic.instanceName = new char[name.size() + 1];
+    if (strcpy_s(dataList.topic.instanceName, name.size() + 1, name.c_str()) != EOK) {
+        return;
+    }
+    dataList.topic.topicName = new char[topic.topicName.size() + 1];
+    if (strcpy_s(dataList.topic.topicName, topic.topicName.size() + 1, topic.topicName.c_str()) != EOK) {
+        return;
+    }
+    dataList.topic.params = new char[topic.params.length() + 1];
+    if (strcpy_s(dataList.topic.params, topic.params.length() + 1, topic.params.c_str()) != EOK) {
+        return;
+    }
+    if (!collector->FillDataStruct(&dataList)) {
+        return;
+    }
+    Publish(dataList);
+}
+
 void CommandCollector::PublishThread(const oeaware::Topic &topic, CommandBase* collector)
 {
     while (collector->isRunning) {
-        if (collector->hasNewData.exchange(false)) {
-            DataList dataList;
-            dataList.topic.instanceName = new char[name.size() + 1];
-            if (strcpy_s(dataList.topic.instanceName, name.size() + 1, name.c_str()) != EOK) {
-                continue;
-            }
-            dataList.topic.topicName = new char[topic.topicName.size() + 1];
-            if (strcpy_s(dataList.topic.topicName, topic.topicName.size() + 1, topic.topicName.c_str()) != EOK) {
-                continue;
-            }
-            dataList.topic.params = new char[topic.params.length() + 1];
-            if (strcpy_s(dataList.topic.params, topic.params.length() + 1, topic.params.c_str()) != EOK) {
-                continue;
-            }
-            if (!collector->FillDataStruct(&dataList)) {
-                continue;
-            }
-            Publish(dataList);
+        {
+            std::lock_guard<std::mutex> lock(collector->publishMutex);
+            PublishNewData(topic, collector);
         }
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
@@ -82,8 +104,14 @@ oeaware::Result CommandCollector::OpenTopic(const oeaware::Topic &topic)
     std::lock_guard<std::mutex> lock(topicMutex[topicType]);
     auto it = collectors.find(topicType);
     if (it == collectors.end()) {
-        collectors[topicType] = std::make_unique<CommandBase>();
-        collectors[topicType]->topic = topic;
+        if (CommandBase::GetCommandName(topic.topicName) != topic.topicName) {
+            auto typed = std::make_unique<TypedCommand>();
+            typed->Init(topic);
+            collectors[topicType] = std::move(typed);
+        } else {
+            collectors[topicType] = std::make_unique<CommandBase>();
+            collectors[topicType]->topic = topic;
+        }
     }
     auto &cmd = collectors[topicType];
     if (cmd->isRunning) {
@@ -27,13 +27,16 @@ public:
     void Disable() override;
     void Run() override;
 private:
-    std::vector<std::string> topicStr = {"mpstat", "iostat", "vmstat", "sar", "pidstat"};
+    std::vector<std::string> topicStr = {"mpstat", "iostat", "vmstat", "sar", "pidstat",
+        "mpstat_typed", "iostat_typed", "vmstat_typed", "sar_typed", "pidstat_typed"};
     std::unordered_map<std::string, std::unique_ptr<CommandBase>> collectors;
     std::unordered_map<std::string, std::thread> collectThreads;
     std::unordered_map<std::string, std::thread> publishThreads;
     std::unordered_map<std::string, std::mutex> topicMutex;
     void CollectThread(const oeaware::Topic &topic, CommandBase* collector);
     void PublishThread(const oeaware::Topic &topic, CommandBase* collector);
+    // The caller holds collector->publishMutex.
+    void PublishNewData(const oeaware::Topic &topic, CommandBase* collector);
 };
 
 #endif
@@ -0,0 +1,317 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "command_parser.h"
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include "oeaware/data_list.h"
+#include "oeaware/utils.h"
+
+static uint64_t HashSchema(const std::string &attr, const std::vector<std::string> &names)
+{
+    // FNV-1a
+    const uint64_t prime = 1099511628211ULL;
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash, prime](const std::string &s) {
+        for (unsigned char c : s) {
+            hash = (hash ^ c) * prime;
+        }
+        hash = (hash ^ 0xff) * prime;
+    };
+    mix(attr);
+    for (auto &name : names) {
+        mix(name);
+    }
+    return hash;
+}
+
+void CommandSection::SetHeader(const std::string &newAttr, const std::vector<std::string> &names)
+{
+    attr = newAttr;
+    colNames = names;
+    colTypes.assign(names.size(), COMMAND_COLUMN_NUMERIC);
+    typesResolved = false;
+    schemaId = HashSchema(attr, colNames);
+    values.assign(names.size(), std::vector<double>());
+    textOffset.assign(names.size(), std::vector<int>());
+    textPool.clear();
+    rowLen = 0;
+}
+
+void CommandSection::AppendNumber(size_t col, double value)
+{
+    if (col >= colNames.size() || values[col].size() > static_cast<size_t>(rowLen)) {
+        return;
+    }
+    if (!typesResolved) {
+        colTypes[col] = COMMAND_COLUMN_NUMERIC;
+    }
+    values[col].emplace_back(value);
+    textOffset[col].emplace_back(-1);
+}
+
+void CommandSection::AppendText(size_t col, const char *text, size_t len)
+{
+    if (col >= colNames.size() || values[col].size() > static_cast<size_t>(rowLen)) {
+        return;
+    }
+    if (!typesResolved) {
+        colTypes[col] = COMMAND_COLUMN_TEXT;
+    }
+    values[col].emplace_back(NAN);
+    textOffset[col].emplace_back(static_cast<int>(textPool.size()));
+    textPool.append(text, len);
+    textPool.push_back('\0');
+}
+
+void CommandSection::EndRow()
+{
+    // Fill the cells missing in a short row.
+    for (size_t col = 0; col < colNames.size(); ++col) {
+        if (values[col].size() > static_cast<size_t>(rowLen)) {
+            continue;
+        }
+        if (colTypes[col] == COMMAND_COLUMN_TEXT) {
+            AppendText(col, "", 0);
+        } else {
+            AppendNumber(col, NAN);
+        }
+    }
+    typesResolved = true;
+    rowLen++;
+}
+
+void CommandSection::Clear()
+{
+    for (size_t col = 0; col < colNames.size(); ++col) {
+        values[col].clear();
+        textOffset[col].clear();
+    }
+    textPool.clear();
+    rowLen = 0;
+}
+
+CommandTypedData *CommandSection::ToTypedData(int source, int intervalMs) const
+{
+    auto *data = new CommandTypedData();
+    data->schemaId = schemaId;
+    data->source = source;
+    data->intervalMs = intervalMs;
+    data->colLen = static_cast<int>(colNames.size());
+    data->rowLen = rowLen;
+    data->colNames = new char *[data->colLen];
+    data->colTypes = new int[data->colLen];
+    data->values = new double[data->colLen * rowLen];
+    data->textOffset = new int[data->colLen * rowLen];
+    for (int col = 0; col < data->colLen; ++col) {
+        auto &name = colNames[col];
+        data->colNames[col] = new char[name.size() + 1];
+        strcpy_s(data->colNames[col], name.size() + 1, name.c_str());
+        data->colTypes[col] = colTypes[col];
+        if (rowLen == 0) {
+            continue;
+        }
+        memcpy_s(data->values + col * rowLen, rowLen * sizeof(double), values[col].data(), rowLen * sizeof(double));
+        memcpy_s(data->textOffset + col * rowLen, rowLen * sizeof(int), textOffset[col].data(),
+            rowLen * sizeof(int));
+    }
+    data->textPoolLen = static_cast<int>(textPool.size());
+    data->textPool = new char[data->textPoolLen + 1];
+    memcpy_s(data->textPool, data->textPoolLen + 1, textPool.data(), data->textPoolLen);
+    data->textPool[data->textPoolLen] = '\0';
+    return data;
+}
+
+void TypedCommand::Init(const oeaware::Topic &newTopic)
+{
+    topic = newTopic;
+    std::vector<std::string> options;
+    std::vector<int> nums;
+    for (auto &arg : oeaware::SplitString(topic.params, " ")) {
+        if (arg.empty()) {
+            continue;
+        }
+        if (oeaware::IsInteger(arg)) {
+            nums.emplace_back(atoi(arg.c_str()));
+        } else {
+            options.emplace_back(arg);
+        }
+    }
+    const int msPerSec = 1000;
+    intervalMs = (nums.empty() || nums[0] <= 0) ? msPerSec : nums[0] * msPerSec;
+    count = nums.size() > 1 ? nums[1] : 0;
+    cmdName = GetCommandName(topic.topicName);
+    native = NativeStat::Create(cmdName, options);
+    if (native != nullptr) {
+        sections.resize(1);
+        sections[0].SetHeader(native->GetAttr(), native->GetColNames());
+    }
+}
+
+int TypedCommand::FindHeader(const char *line) const
+{
+    auto it = attrsFirst.find(cmdName);
+    if (it == attrsFirst.end()) {
+        return -1;
+    }
+    for (size_t i = 0; i < it->second.size(); ++i) {
+        if (strstr(line, it->second[i].c_str()) != nullptr) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void TypedCommand::ParseLine(const std::string &line)
+{
+    std::vector<char> buf(line.begin(), line.end());
+    buf.push_back('\0');
+    ParseLine(buf.data(), line.size());
+}
+
+void TypedCommand::ParseLine(char *line, size_t len)
+{
+    while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+        line[--len] = '\0';
+    }
+    char *end = line + len;
+    char *p = line;
+    while (p < end && isspace(static_cast<unsigned char>(*p))) {
+        ++p;
+    }
+    if (p == end || strstr(line, "Linux") != nullptr) {
+        return;
+    }
+    for (auto &skip : skipLine) {
+        if (strstr(line, skip.c_str()) != nullptr) {
+            return;
+        }
+    }
+    int header = FindHeader(line);
+    std::lock_guard<std::mutex> lock(dataMutex);
+    if (header >= 0) {
+        const std::string &attr = attrsFirst[cmdName][header];
+        nowSection = -1;
+        for (size_t i = 0; i < sections.size(); ++i) {
+            if (sections[i].attr == attr) {
+                nowSection = static_cast<int>(i);
+                return;
+            }
+        }
+        std::vector<std::string> names;
+        for (auto &name : oeaware::SplitString(std::string(line, len), " ")) {
+            if (name.empty() || name == "avg-cpu:" || name == "#") {
+                continue;
+            }
+            names.emplace_back(name);
+        }
+        sections.emplace_back();
+        sections.back().SetHeader(attr, names);
+        nowSection = static_cast<int>(sections.size()) - 1;
+        return;
+    }
+    if (nowSection < 0) {
+        return;
+    }
+    auto &section = sections[nowSection];
+    size_t col = 0;
+    while (p < end && col < section.colNames.size()) {
+        char *token = p;
+        while (p < end && !isspace(static_cast<unsigned char>(*p))) {
+            ++p;
+        }
+        char *tokenEnd = p;
+        while (p < end && isspace(static_cast<unsigned char>(*p))) {
+            ++p;
+        }
+        if (section.typesResolved && section.colTypes[col] == COMMAND_COLUMN_TEXT) {
+            section.AppendText(col++, token, tokenEnd - token);
+            continue;
+        }
+        char *numEnd = nullptr;
+        double value = strtod(token, &numEnd);
+        if (numEnd == tokenEnd) {
+            section.AppendNumber(col++, value);
+        } else if (!section.typesResolved) {
+            section.AppendText(col++, token, tokenEnd - token);
+        } else {
+            section.AppendNumber(col++, NAN);
+        }
+    }
+    section.EndRow();
+    hasNewData = true;
+}
+
+void TypedCommand::CollectNative()
+{
+    const int checkStepMs = 100;
+    auto &section = sections[0];
+    auto last = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(dataMutex);
+        // a reopened topic starts from new counters, not from those of the last run
+        native->Reset();
+        native->Sample(section, 0);
+    }
+    int sampleCount = 0;
+    while (isRunning) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(checkStepMs));
+        auto now = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last).count();
+        if (elapsed < intervalMs) {
+            continue;
+        }
+        const double msPerSec = 1000.0;
+        {
+            std::lock_guard<std::mutex> lock(dataMutex);
+            if (!native->Sample(section, elapsed / msPerSec)) {
+                break;
+            }
+            measuredMs = static_cast<int>(elapsed);
+        }
+        last = now;
+        hasNewData = true;
+        if (count > 0 && ++sampleCount >= count) {
+            break;
+        }
+    }
+}
+
+bool TypedCommand::FillDataStruct(void *dataStruct)
+{
+    DataList *dataList = static_cast<DataList*>(dataStruct);
+    std::vector<CommandTypedData*> typedDatas;
+    std::lock_guard<std::mutex> lock(dataMutex);
+    int source = IsNative() ? COMMAND_SOURCE_NATIVE : COMMAND_SOURCE_EXEC;
+    int dataIntervalMs = IsNative() ? measuredMs : intervalMs;
+    for (auto &section : sections) {
+        if (section.rowLen == 0) {
+            continue;
+        }
+        typedDatas.emplace_back(section.ToTypedData(source, dataIntervalMs));
+        section.Clear();
+    }
+    dataList->len = typedDatas.size();
+    dataList->data = new void* [typedDatas.size()];
+    for (size_t i = 0; i < typedDatas.size(); ++i) {
+        dataList->data[i] = typedDatas[i];
+    }
+    return true;
+}
+
+void TypedCommand::Close()
+{
+    std::lock_guard<std::mutex> lock(dataMutex);
+    for (auto &section : sections) {
+        section.Clear();
+    }
+}
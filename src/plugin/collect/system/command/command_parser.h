@@ -0,0 +1,69 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+#include <memory>
+#include "command_base.h"
+#include "native_stat.h"
+#include "oeaware/data/command_data.h"
+
+// One output section(one header row) stored column by column.
+// Buffers keep their capacity across publications, so steady state parsing does not allocate.
+class CommandSection {
+public:
+    std::string attr;
+    std::vector<std::string> colNames;
+    std::vector<int> colTypes;
+    bool typesResolved = false;
+    uint64_t schemaId = 0;
+    int rowLen = 0;
+    std::vector<std::vector<double>> values;
+    std::vector<std::vector<int>> textOffset;
+    std::string textPool;
+    void SetHeader(const std::string &newAttr, const std::vector<std::string> &names);
+    void AppendNumber(size_t col, double value);
+    void AppendText(size_t col, const char *text, size_t len);
+    void EndRow();
+    void Clear();
+    CommandTypedData *ToTypedData(int source, int intervalMs) const;
+};
+
+// Streaming, typed variant of CommandBase used by the "<command>_typed" topics.
+// Lines are tokenized in place and numbers are converted once with strtod.
+// When a native backend exists for the command, /proc is read directly instead of forking the command.
+class TypedCommand : public CommandBase {
+public:
+    TypedCommand() = default;
+    ~TypedCommand() override = default;
+    void Init(const oeaware::Topic &newTopic);
+    bool IsNative() const
+    {
+        return native != nullptr;
+    }
+    void ParseLine(const std::string &line) override;
+    void ParseLine(char *line, size_t len) override;
+    bool FillDataStruct(void *dataStruct) override;
+    void CollectNative();
+    void Close() override;
+private:
+    std::string cmdName;
+    std::vector<CommandSection> sections;
+    int nowSection = -1;
+    std::unique_ptr<NativeStat> native;
+    int intervalMs = 0;
+    // Interval actually elapsed between the last two native samples.
+    int measuredMs = 0;
+    int count = 0;
+    int FindHeader(const char *line) const;
+};
+
+#endif
@@ -0,0 +1,503 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "native_stat.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include "command_parser.h"
+
+namespace {
+constexpr size_t PROC_READ_CHUNK = 16 * 1024;
+constexpr double PERCENT = 100.0;
+constexpr double KB = 1024.0;
+constexpr double SECTOR_KB = 0.5;
+constexpr double MS_PER_SEC = 1000.0;
+
+const char *NextToken(const char *&p, const char *end, size_t &len)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+    if (p >= end) {
+        return nullptr;
+    }
+    const char *start = p;
+    while (p < end && *p != ' ' && *p != '\t') {
+        ++p;
+    }
+    len = p - start;
+    return start;
+}
+
+uint64_t ToU64(const char *s, size_t len)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < len && s[i] >= '0' && s[i] <= '9'; ++i) {
+        value = value * 10 + (s[i] - '0');
+    }
+    return value;
+}
+
+// Call func(lineBegin, lineEnd) for each line in the buffer.
+template<typename F>
+void ForEachLine(const char *data, size_t size, F func)
+{
+    const char *end = data + size;
+    while (data < end) {
+        const char *lineEnd = static_cast<const char*>(memchr(data, '\n', end - data));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+        func(data, lineEnd);
+        data = lineEnd + 1;
+    }
+}
+
+bool StartWith(const char *begin, const char *end, const char *prefix)
+{
+    size_t len = strlen(prefix);
+    return static_cast<size_t>(end - begin) >= len && memcmp(begin, prefix, len) == 0;
+}
+
+double Rate(uint64_t now, uint64_t last, double intervalSec)
+{
+    if (intervalSec <= 0 || now < last) {
+        return 0;
+    }
+    return (now - last) / intervalSec;
+}
+
+// Values of "Key:   value kB" lines in /proc/meminfo or "key value" lines in /proc/vmstat.
+void ReadKeyValues(const ProcReader &reader, const std::vector<std::string> &keys, std::vector<uint64_t> &values)
+{
+    values.assign(keys.size(), 0);
+    ForEachLine(reader.Data(), reader.Size(), [&](const char *begin, const char *end) {
+        const char *p = begin;
+        size_t len;
+        const char *key = NextToken(p, end, len);
+        if (key == nullptr) {
+            return;
+        }
+        if (key[len - 1] == ':') {
+            --len;
+        }
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i].size() == len && memcmp(keys[i].data(), key, len) == 0) {
+                const char *value = NextToken(p, end, len);
+                values[i] = value == nullptr ? 0 : ToU64(value, len);
+                return;
+            }
+        }
+    });
+}
+}
+
+ProcReader::~ProcReader()
+{
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool ProcReader::Read()
+{
+    if (fd < 0) {
+        fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+    }
+    if (buf.empty()) {
+        buf.resize(PROC_READ_CHUNK);
+    }
+    len = 0;
+    while (true) {
+        if (len == buf.size()) {
+            buf.resize(buf.size() * 2);
+        }
+        ssize_t n = pread(fd, buf.data() + len, buf.size() - len, len);
+        if (n < 0) {
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        len += n;
+    }
+    return true;
+}
+
+std::unique_ptr<NativeStat> NativeStat::Create(const std::string &cmd, const std::vector<std::string> &options)
+{
+    auto onlyHas = [&options](const std::vector<std::string> &allowed) {
+        for (auto &opt : options) {
+            if (std::find(allowed.begin(), allowed.end(), opt) == allowed.end()) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (cmd == "mpstat" && onlyHas({"-P", "ALL", "-u"})) {
+        bool perCpu = std::find(options.begin(), options.end(), "ALL") != options.end();
+        return std::unique_ptr<NativeStat>(new MpstatNative(perCpu));
+    }
+    // only the extended device report is sampled natively, plain "-d" has other columns and runs iostat
+    bool extended = std::find(options.begin(), options.end(), "-x") != options.end();
+    if (cmd == "iostat" && extended && onlyHas({"-d", "-x", "-k", "-y"})) {
+        return std::unique_ptr<NativeStat>(new IostatNative());
+    }
+    if (cmd == "vmstat" && onlyHas({"-n"})) {
+        return std::unique_ptr<NativeStat>(new VmstatNative());
+    }
+    if (cmd == "sar" && options.size() == 2 && options[0] == "-n" && options[1] == "DEV") {
+        return std::unique_ptr<NativeStat>(new SarDevNative());
+    }
+    return nullptr;
+}
+
+enum ProcStatCpuField {
+    STAT_USER,
+    STAT_NICE,
+    STAT_SYSTEM,
+    STAT_IDLE,
+    STAT_IOWAIT,
+    STAT_IRQ,
+    STAT_SOFTIRQ,
+    STAT_STEAL,
+    STAT_GUEST,
+    STAT_GNICE,
+    STAT_FIELD_MAX,
+};
+
+std::vector<std::string> MpstatNative::GetColNames() const
+{
+    return {"CPU", "%usr", "%nice", "%sys", "%iowait", "%irq", "%soft", "%steal", "%guest", "%gnice", "%idle"};
+}
+
+bool MpstatNative::Sample(CommandSection &section, double intervalSec)
+{
+    (void)intervalSec;
+    if (!stat.Read()) {
+        return false;
+    }
+    uint64_t now[STAT_FIELD_MAX];
+    ForEachLine(stat.Data(), stat.Size(), [&](const char *begin, const char *end) {
+        if (!StartWith(begin, end, "cpu")) {
+            return;
+        }
+        const char *p = begin;
+        size_t len;
+        const char *label = NextToken(p, end, len);
+        size_t idLen = len - strlen("cpu");
+        bool isAll = (idLen == 0);
+        if (!isAll && !perCpu) {
+            return;
+        }
+        size_t index = isAll ? 0 : ToU64(label + strlen("cpu"), idLen) + 1;
+        for (int i = 0; i < STAT_FIELD_MAX; ++i) {
+            const char *value = NextToken(p, end, len);
+            now[i] = value == nullptr ? 0 : ToU64(value, len);
+        }
+        if (index >= lastTimes.size()) {
+            lastTimes.resize(index + 1);
+        }
+        auto &last = lastTimes[index];
+        if (last.empty()) {
+            last.assign(now, now + STAT_FIELD_MAX);
+            return;
+        }
+        uint64_t delta[STAT_FIELD_MAX];
+        uint64_t total = 0;
+        for (int i = 0; i < STAT_FIELD_MAX; ++i) {
+            delta[i] = now[i] >= last[i] ? now[i] - last[i] : 0;
+            last[i] = now[i];
+        }
+        // user and nice already include guest and guest_nice.
+        delta[STAT_USER] -= std::min(delta[STAT_USER], delta[STAT_GUEST]);
+        delta[STAT_NICE] -= std::min(delta[STAT_NICE], delta[STAT_GNICE]);
+        for (int i = 0; i < STAT_FIELD_MAX; ++i) {
+            total += delta[i];
+        }
+        double scale = total == 0 ? 0 : PERCENT / total;
+        if (isAll) {
+            section.AppendText(0, "all", strlen("all"));
+        } else {
+            section.AppendText(0, label + strlen("cpu"), idLen);
+        }
+        const int order[] = {STAT_USER, STAT_NICE, STAT_SYSTEM, STAT_IOWAIT, STAT_IRQ, STAT_SOFTIRQ, STAT_STEAL,
+            STAT_GUEST, STAT_GNICE, STAT_IDLE};
+        for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); ++i) {
+            section.AppendNumber(i + 1, delta[order[i]] * scale);
+        }
+        section.EndRow();
+    });
+    return true;
+}
+
+enum DiskStatField {
+    DISK_READS,
+    DISK_READ_MERGED,
+    DISK_READ_SECTORS,
+    DISK_READ_TICKS,
+    DISK_WRITES,
+    DISK_WRITE_MERGED,
+    DISK_WRITE_SECTORS,
+    DISK_WRITE_TICKS,
+    DISK_IN_FLIGHT,
+    DISK_IO_TICKS,
+    DISK_QUEUE_TICKS,
+    DISK_FIELD_MAX,
+};
+
+std::vector<std::string> IostatNative::GetColNames() const
+{
+    return {"Device", "r/s", "rkB/s", "rrqm/s", "r_await", "w/s", "wkB/s", "wrqm/s", "w_await", "aqu-sz", "%util"};
+}
+
+bool IostatNative::Sample(CommandSection &section, double intervalSec)
+{
+    if (!diskStats.Read()) {
+        return false;
+    }
+    uint64_t now[DISK_FIELD_MAX];
+    ForEachLine(diskStats.Data(), diskStats.Size(), [&](const char *begin, const char *end) {
+        const char *p = begin;
+        size_t len;
+        // major and minor
+        if (NextToken(p, end, len) == nullptr || NextToken(p, end, len) == nullptr) {
+            return;
+        }
+        const char *dev = NextToken(p, end, len);
+        if (dev == nullptr) {
+            return;
+        }
+        size_t devLen = len;
+        name.assign(dev, devLen);
+        for (int i = 0; i < DISK_FIELD_MAX; ++i) {
+            const char *value = NextToken(p, end, len);
+            now[i] = value == nullptr ? 0 : ToU64(value, len);
+        }
+        auto it = lastStats.find(name);
+        if (it == lastStats.end()) {
+            // Only whole disks are listed in /sys/block, partitions are skipped like iostat without -p.
+            it = lastStats.emplace(name, DiskStat()).first;
+            it->second.isDisk = access(("/sys/block/" + name).c_str(), F_OK) == 0;
+        }
+        auto &disk = it->second;
+        if (!disk.isDisk) {
+            return;
+        }
+        if (!disk.primed) {
+            disk.fields.assign(now, now + DISK_FIELD_MAX);
+            disk.primed = true;
+            return;
+        }
+        auto &last = disk.fields;
+        if (now[DISK_READS] + now[DISK_WRITES] == 0) {
+            return;
+        }
+        uint64_t reads = now[DISK_READS] - std::min(now[DISK_READS], last[DISK_READS]);
+        uint64_t writes = now[DISK_WRITES] - std::min(now[DISK_WRITES], last[DISK_WRITES]);
+        uint64_t readTicks = now[DISK_READ_TICKS] - std::min(now[DISK_READ_TICKS], last[DISK_READ_TICKS]);
+        uint64_t writeTicks = now[DISK_WRITE_TICKS] - std::min(now[DISK_WRITE_TICKS], last[DISK_WRITE_TICKS]);
+        double intervalMs = intervalSec * MS_PER_SEC;
+        section.AppendText(0, dev, devLen);
+        section.AppendNumber(1, Rate(now[DISK_READS], last[DISK_READS], intervalSec));
+        section.AppendNumber(2, Rate(now[DISK_READ_SECTORS], last[DISK_READ_SECTORS], intervalSec) * SECTOR_KB);
+        section.AppendNumber(3, Rate(now[DISK_READ_MERGED], last[DISK_READ_MERGED], intervalSec));
+        section.AppendNumber(4, reads == 0 ? 0 : static_cast<double>(readTicks) / reads);
+        section.AppendNumber(5, Rate(now[DISK_WRITES], last[DISK_WRITES], intervalSec));
+        section.AppendNumber(6, Rate(now[DISK_WRITE_SECTORS], last[DISK_WRITE_SECTORS], intervalSec) * SECTOR_KB);
+        section.AppendNumber(7, Rate(now[DISK_WRITE_MERGED], last[DISK_WRITE_MERGED], intervalSec));
+        section.AppendNumber(8, writes == 0 ? 0 : static_cast<double>(writeTicks) / writes);
+        section.AppendNumber(9, intervalMs <= 0 ? 0 :
+            (now[DISK_QUEUE_TICKS] - std::min(now[DISK_QUEUE_TICKS], last[DISK_QUEUE_TICKS])) / intervalMs);
+        section.AppendNumber(10, intervalMs <= 0 ? 0 : std::min(PERCENT,
+            (now[DISK_IO_TICKS] - std::min(now[DISK_IO_TICKS], last[DISK_IO_TICKS])) * PERCENT / intervalMs));
+        section.EndRow();
+        last.assign(now, now + DISK_FIELD_MAX);
+    });
+    return true;
+}
+
+enum NetDevField {
+    RX_BYTES,
+    RX_PACKETS,
+    RX_ERRS,
+    RX_DROP,
+    RX_FIFO,
+    RX_FRAME,
+    RX_COMPRESSED,
+    RX_MULTICAST,
+    TX_BYTES,
+    TX_PACKETS,
+    TX_ERRS,
+    TX_DROP,
+    TX_FIFO,
+    TX_COLLS,
+    TX_CARRIER,
+    TX_COMPRESSED,
+    NET_DEV_FIELD_MAX,
+};
+
+std::vector<std::string> SarDevNative::GetColNames() const
+{
+    return {"IFACE", "rxpck/s", "txpck/s", "rxkB/s", "txkB/s", "rxcmp/s", "txcmp/s", "rxmcst/s"};
+}
+
+bool SarDevNative::Sample(CommandSection &section, double intervalSec)
+{
+    if (!netDev.Read()) {
+        return false;
+    }
+    uint64_t now[NET_DEV_FIELD_MAX];
+    ForEachLine(netDev.Data(), netDev.Size(), [&](const char *begin, const char *end) {
+        const char *colon = static_cast<const char*>(memchr(begin, ':', end - begin));
+        if (colon == nullptr) {
+            return;
+        }
+        const char *dev = begin;
+        while (dev < colon && *dev == ' ') {
+            ++dev;
+        }
+        name.assign(dev, colon - dev);
+        const char *p = colon + 1;
+        size_t len;
+        for (int i = 0; i < NET_DEV_FIELD_MAX; ++i) {
+            const char *value = NextToken(p, end, len);
+            now[i] = value == nullptr ? 0 : ToU64(value, len);
+        }
+        auto &last = lastStats[name];
+        if (last.empty()) {
+            last.assign(now, now + NET_DEV_FIELD_MAX);
+            return;
+        }
+        section.AppendText(0, dev, colon - dev);
+        section.AppendNumber(1, Rate(now[RX_PACKETS], last[RX_PACKETS], intervalSec));
+        section.AppendNumber(2, Rate(now[TX_PACKETS], last[TX_PACKETS], intervalSec));
+        section.AppendNumber(3, Rate(now[RX_BYTES], last[RX_BYTES], intervalSec) / KB);
+        section.AppendNumber(4, Rate(now[TX_BYTES], last[TX_BYTES], intervalSec) / KB);
+        section.AppendNumber(5, Rate(now[RX_COMPRESSED], last[RX_COMPRESSED], intervalSec));
+        section.AppendNumber(6, Rate(now[TX_COMPRESSED], last[TX_COMPRESSED], intervalSec));
+        section.AppendNumber(7, Rate(now[RX_MULTICAST], last[RX_MULTICAST], intervalSec));
+        section.EndRow();
+        last.assign(now, now + NET_DEV_FIELD_MAX);
+    });
+    return true;
+}
+
+enum VmstatCounter {
+    VM_INTR,
+    VM_CTXT,
+    VM_CPU_USER,
+    VM_CPU_NICE,
+    VM_CPU_SYSTEM,
+    VM_CPU_IDLE,
+    VM_CPU_IOWAIT,
+    VM_CPU_IRQ,
+    VM_CPU_SOFTIRQ,
+    VM_CPU_STEAL,
+    VM_PSWPIN,
+    VM_PSWPOUT,
+    VM_PGPGIN,
+    VM_PGPGOUT,
+    VM_COUNTER_MAX,
+};
+
+std::vector<std::string> VmstatNative::GetColNames() const
+{
+    return {"r", "b", "swpd", "free", "buff", "cache", "si", "so", "bi", "bo", "in", "cs",
+        "us", "sy", "id", "wa", "st"};
+}
+
+bool VmstatNative::Sample(CommandSection &section, double intervalSec)
+{
+    if (!stat.Read() || !memInfo.Read() || !vmStat.Read()) {
+        return false;
+    }
+    std::vector<uint64_t> now(VM_COUNTER_MAX, 0);
+    uint64_t running = 0;
+    uint64_t blocked = 0;
+    ForEachLine(stat.Data(), stat.Size(), [&](const char *begin, const char *end) {
+        const char *p = begin;
+        size_t len;
+        const char *key = NextToken(p, end, len);
+        if (key == nullptr) {
+            return;
+        }
+        std::string k(key, len);
+        const char *value = NextToken(p, end, len);
+        if (value == nullptr) {
+            return;
+        }
+        if (k == "cpu") {
+            for (int i = VM_CPU_USER; i <= VM_CPU_STEAL && value != nullptr; ++i) {
+                now[i] = ToU64(value, len);
+                value = NextToken(p, end, len);
+            }
+        } else if (k == "intr") {
+            now[VM_INTR] = ToU64(value, len);
+        } else if (k == "ctxt") {
+            now[VM_CTXT] = ToU64(value, len);
+        } else if (k == "procs_running") {
+            running = ToU64(value, len);
+        } else if (k == "procs_blocked") {
+            blocked = ToU64(value, len);
+        }
+    });
+    static const std::vector<std::string> vmKeys{"pswpin", "pswpout", "pgpgin", "pgpgout"};
+    std::vector<uint64_t> vmValues;
+    ReadKeyValues(vmStat, vmKeys, vmValues);
+    now[VM_PSWPIN] = vmValues[0];
+    now[VM_PSWPOUT] = vmValues[1];
+    now[VM_PGPGIN] = vmValues[2];
+    now[VM_PGPGOUT] = vmValues[3];
+    if (!primed) {
+        lastCounters = now;
+        primed = true;
+        return true;
+    }
+    static const std::vector<std::string> memKeys{"MemFree", "Buffers", "Cached", "SReclaimable",
+        "SwapTotal", "SwapFree"};
+    std::vector<uint64_t> mem;
+    ReadKeyValues(memInfo, memKeys, mem);
+    auto delta = [&](int i) {
+        return now[i] - std::min(now[i], lastCounters[i]);
+    };
+    uint64_t cpuTotal = 0;
+    for (int i = VM_CPU_USER; i <= VM_CPU_STEAL; ++i) {
+        cpuTotal += delta(i);
+    }
+    double cpuScale = cpuTotal == 0 ? 0 : PERCENT / cpuTotal;
+    double pageKb = sysconf(_SC_PAGESIZE) / KB;
+    section.AppendNumber(0, running);
+    section.AppendNumber(1, blocked);
+    section.AppendNumber(2, mem[4] - std::min(mem[4], mem[5]));
+    section.AppendNumber(3, mem[0]);
+    section.AppendNumber(4, mem[1]);
+    section.AppendNumber(5, mem[2] + mem[3]);
+    section.AppendNumber(6, Rate(now[VM_PSWPIN], lastCounters[VM_PSWPIN], intervalSec) * pageKb);
+    section.AppendNumber(7, Rate(now[VM_PSWPOUT], lastCounters[VM_PSWPOUT], intervalSec) * pageKb);
+    section.AppendNumber(8, Rate(now[VM_PGPGIN], lastCounters[VM_PGPGIN], intervalSec));
+    section.AppendNumber(9, Rate(now[VM_PGPGOUT], lastCounters[VM_PGPGOUT], intervalSec));
+    section.AppendNumber(10, Rate(now[VM_INTR], lastCounters[VM_INTR], intervalSec));
+    section.AppendNumber(11, Rate(now[VM_CTXT], lastCounters[VM_CTXT], intervalSec));
+    section.AppendNumber(12, (delta(VM_CPU_USER) + delta(VM_CPU_NICE)) * cpuScale);
+    section.AppendNumber(13, (delta(VM_CPU_SYSTEM) + delta(VM_CPU_IRQ) + delta(VM_CPU_SOFTIRQ)) * cpuScale);
+    section.AppendNumber(14, delta(VM_CPU_IDLE) * cpuScale);
+    section.AppendNumber(15, delta(VM_CPU_IOWAIT) * cpuScale);
+    section.AppendNumber(16, delta(VM_CPU_STEAL) * cpuScale);
+    section.EndRow();
+    lastCounters = now;
+    return true;
+}
@@ -0,0 +1,141 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef NATIVE_STAT_H
+#define NATIVE_STAT_H
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+class CommandSection;
+
+// Reads a procfs file with pread into a reusable buffer, the fd is kept open between reads.
+class ProcReader {
+public:
+    explicit ProcReader(const std::string &path) : path(path) { }
+    ~ProcReader();
+    ProcReader(const ProcReader&) = delete;
+    ProcReader& operator=(const ProcReader&) = delete;
+    bool Read();
+    const char *Data() const
+    {
+        return buf.data();
+    }
+    size_t Size() const
+    {
+        return len;
+    }
+private:
+    std::string path;
+    int fd = -1;
+    std::vector<char> buf;
+    size_t len = 0;
+};
+
+// In-process implementation of a sysstat command, the column names follow the command output.
+class NativeStat {
+public:
+    virtual ~NativeStat() = default;
+    // Return nullptr if the command or one of its options is not supported natively.
+    static std::unique_ptr<NativeStat> Create(const std::string &cmd, const std::vector<std::string> &options);
+    virtual std::string GetAttr() const = 0;
+    virtual std::vector<std::string> GetColNames() const = 0;
+    // The first call only records the counters, the following calls append the rates since the previous call.
+    virtual bool Sample(CommandSection &section, double intervalSec) = 0;
+    // Forget the counters of the previous run, so the next Sample records them again.
+    virtual void Reset() = 0;
+};
+
+class MpstatNative : public NativeStat {
+public:
+    explicit MpstatNative(bool perCpu) : perCpu(perCpu) { }
+    std::string GetAttr() const override
+    {
+        return "CPU";
+    }
+    std::vector<std::string> GetColNames() const override;
+    bool Sample(CommandSection &section, double intervalSec) override;
+    void Reset() override
+    {
+        lastTimes.clear();
+    }
+private:
+    bool perCpu;
+    ProcReader stat{"/proc/stat"};
+    // [0] is "all", [cpu + 1] is cpu, value is the jiffies of each field in /proc/stat.
+    std::vector<std::vector<uint64_t>> lastTimes;
+};
+
+class IostatNative : public NativeStat {
+public:
+    std::string GetAttr() const override
+    {
+        return "Device";
+    }
+    std::vector<std::string> GetColNames() const override;
+    bool Sample(CommandSection &section, double intervalSec) override;
+    void Reset() override
+    {
+        lastStats.clear();
+    }
+private:
+    struct DiskStat {
+        bool isDisk = false;
+        bool primed = false;
+        std::vector<uint64_t> fields;
+    };
+    ProcReader diskStats{"/proc/diskstats"};
+    std::unordered_map<std::string, DiskStat> lastStats;
+    std::string name;
+};
+
+class SarDevNative : public NativeStat {
+public:
+    std::string GetAttr() const override
+    {
+        return "IFACE";
+    }
+    std::vector<std::string> GetColNames() const override;
+    bool Sample(CommandSection &section, double intervalSec) override;
+    void Reset() override
+    {
+        lastStats.clear();
+    }
+private:
+    ProcReader netDev{"/proc/net/dev"};
+    std::unordered_map<std::string, std::vector<uint64_t>> lastStats;
+    std::string name;
+};
+
+class VmstatNative : public NativeStat {
+public:
+    std::string GetAttr() const override
+    {
+        return "swpd";
+    }
+    std::vector<std::string> GetColNames() const override;
+    bool Sample(CommandSection &section, double intervalSec) override;
+    void Reset() override
+    {
+        lastCounters.clear();
+        primed = false;
+    }
+private:
+    ProcReader stat{"/proc/stat"};
+    ProcReader memInfo{"/proc/meminfo"};
+    ProcReader vmStat{"/proc/vmstat"};
+    std::vector<uint64_t> lastCounters;
+    bool primed = false;
+};
+
+#endif
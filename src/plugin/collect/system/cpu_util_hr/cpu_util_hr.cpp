@@ -0,0 +1,239 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "cpu_util_hr.h"
+#include <algorithm>
+#include <ctime>
+#include <unistd.h>
+#include "oeaware/utils.h"
+
+CpuUtilHr::CpuUtilHr()
+{
+    name = OE_ENV_INFO_HR;
+    version = "1.0.0";
+    period = DEFAULT_PERIOD;
+    priority = 0;
+    type = 0;
+    oeaware::Topic topic;
+    topic.instanceName = this->name;
+    topic.topicName = "cpu_util_hr";
+    topic.params = "";
+    supportTopics.push_back(topic);
+    description += "[introduction] \n";
+    description += "               Collect high resolution cpu utilization by eBPF \n";
+    description += "[version] \n";
+    description += "         " + version + "\n";
+    description += "[instance name]\n";
+    description += "                 " + name + "\n";
+    description += "[instance period]\n";
+    description += "                 " + std::to_string(MIN_PERIOD) + " ~ " + std::to_string(DEFAULT_PERIOD) +
+        " ms, set by the topic params\n";
+    description += "[running require environment]\n";
+    description += "                 eBPF enabled when building\n";
+    description += "[provide topics]\n";
+    description += "                 topicName:cpu_util_hr, params:\"\" or interval ms in steps of 10, "
+                   "usage:get cpu busy/idle/irq/softirq time in ns\n";
+}
+
+oeaware::Result CpuUtilHr::OpenTopic(const oeaware::Topic &topic)
+{
+    if (topic.instanceName != this->name || topic.topicName != "cpu_util_hr") {
+        return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, topic is not supported");
+    }
+    int interval = DEFAULT_PERIOD;
+    if (!topic.params.empty()) {
+        if (!oeaware::IsInteger(topic.params) || topic.params.size() > std::to_string(DEFAULT_PERIOD).size()) {
+            return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, params is invalid");
+        }
+        interval = std::atoi(topic.params.c_str());
+        // the instance scheduler wakes up every MIN_PERIOD ms, other periods would never be due
+        if (interval < MIN_PERIOD || interval > DEFAULT_PERIOD || interval % MIN_PERIOD != 0) {
+            return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, interval should be " +
+                std::to_string(MIN_PERIOD) + " ~ " + std::to_string(DEFAULT_PERIOD) + " ms and a multiple of " +
+                std::to_string(MIN_PERIOD));
+        }
+    }
+    auto &state = openTopics[topic.params];
+    ResetTopicState(state);
+    state.interval = interval;
+    state.data.cpuNumConfig = cpuNumConfig;
+    state.data.times = new uint64_t[(cpuNumConfig + 1) * CPU_HR_TYPE_MAX]();
+    UpdatePeriod();
+    return oeaware::Result(OK);
+}
+
+void CpuUtilHr::CloseTopic(const oeaware::Topic &topic)
+{
+    auto it = openTopics.find(topic.params);
+    if (it == openTopics.end()) {
+        return;
+    }
+    ResetTopicState(it->second);
+    openTopics.erase(it);
+    UpdatePeriod();
+}
+
+void CpuUtilHr::UpdateData(const DataList &dataList)
+{
+    (void)dataList;
+}
+
+void CpuUtilHr::UpdatePeriod()
+{
+    period = DEFAULT_PERIOD;
+    for (auto &p : openTopics) {
+        period = std::min(period, p.second.interval);
+    }
+}
+
+oeaware::Result CpuUtilHr::Enable(const std::string &param)
+{
+    (void)param;
+#if ENABLE_EBPF
+    cpuNumConfig = sysconf(_SC_NPROCESSORS_CONF);
+    possibleCpuNum = libbpf_num_possible_cpus();
+    if (cpuNumConfig <= 0 || possibleCpuNum <= 0) {
+        return oeaware::Result(FAILED, "failed to get the number of cpus.");
+    }
+    skel = cpu_util_hr_bpf__open_and_load();
+    if (!skel) {
+        return oeaware::Result(FAILED, "failed to open and load bpf program.");
+    }
+    int err = cpu_util_hr_bpf__attach(skel);
+    if (err) {
+        cpu_util_hr_bpf__destroy(skel);
+        skel = nullptr;
+        return oeaware::Result(FAILED, "failed to attach bpf program, " + std::to_string(err) + ".");
+    }
+    acctBuf.resize(possibleCpuNum);
+    return oeaware::Result(OK);
+#else
+    return oeaware::Result(FAILED, "eBPF is not enabled.");
+#endif
+}
+
+void CpuUtilHr::ResetTopicState(TopicState &state)
+{
+    state.lastReadNs = 0;
+    state.lastTimes.clear();
+    state.data.dataReady = ENV_DATA_NOT_READY;
+    state.data.cpuNumConfig = 0;
+    state.data.intervalNs = 0;
+    delete[] state.data.times;
+    state.data.times = nullptr;
+}
+
+void CpuUtilHr::Disable()
+{
+    for (auto &p : openTopics) {
+        ResetTopicState(p.second);
+    }
+    openTopics.clear();
+    UpdatePeriod();
+#if ENABLE_EBPF
+    if (skel) {
+        cpu_util_hr_bpf__destroy(skel);
+        skel = nullptr;
+    }
+#endif
+    curTimes.clear();
+}
+
+bool CpuUtilHr::ReadCpuAcct(uint64_t &now)
+{
+#if ENABLE_EBPF
+    uint32_t key = 0;
+    if (skel == nullptr || bpf_map__lookup_elem(skel->maps.cpu_acct, &key, sizeof(key), acctBuf.data(),
+        sizeof(struct CpuAcct) * acctBuf.size(), 0)) {
+        return false;
+    }
+    struct timespec ts;
+    // bpf_ktime_get_ns() is CLOCK_MONOTONIC
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    now = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+    curTimes.assign(cpuNumConfig, std::vector<uint64_t>(CPU_HR_TYPE_MAX, 0));
+    for (int cpu = 0; cpu < cpuNumConfig && cpu < possibleCpuNum; ++cpu) {
+        const auto &acct = acctBuf[cpu];
+        auto &times = curTimes[cpu];
+        times[CPU_HR_BUSY] = acct.busy;
+        times[CPU_HR_IDLE] = acct.idle;
+        times[CPU_HR_IRQ] = acct.irq;
+        times[CPU_HR_SOFTIRQ] = acct.softirq;
+        // the running slice has not been accounted by sched_switch yet
+        if (acct.lastSwitch != 0 && now > acct.lastSwitch) {
+            uint64_t slice = now - acct.lastSwitch;
+            uint64_t irqInSlice = acct.irq + acct.softirq - acct.irqAtSwitch;
+            slice = slice > irqInSlice ? slice - irqInSlice : 0;
+            times[acct.curIdle ? CPU_HR_IDLE : CPU_HR_BUSY] += slice;
+        }
+    }
+    return true;
+#else
+    (void)now;
+    return false;
+#endif
+}
+
+bool CpuUtilHr::UpdateCpuUtilHr(TopicState &state, uint64_t now)
+{
+    constexpr uint64_t nsPerMs = 1000000;
+    // tolerate half of the run period of jitter, otherwise a topic may skip one of its intervals
+    if (state.lastReadNs != 0 && now - state.lastReadNs + period * nsPerMs / 2 < state.interval * nsPerMs) {
+        return false;
+    }
+    auto &data = state.data;
+    bool ready = !state.lastTimes.empty() && now > state.lastReadNs;
+    uint64_t *sys = data.times + cpuNumConfig * CPU_HR_TYPE_MAX;
+    std::fill(sys, sys + CPU_HR_TYPE_MAX, 0);
+    for (int cpu = 0; ready && cpu < cpuNumConfig; ++cpu) {
+        uint64_t *row = data.times + cpu * CPU_HR_TYPE_MAX;
+        row[CPU_HR_TIME_SUM] = 0;
+        for (int type = 0; type < CPU_HR_TIME_SUM; ++type) {
+            // the running slice is estimated with the user space clock, keep the delta monotonic
+            auto cur = curTimes[cpu][type];
+            auto last = state.lastTimes[cpu][type];
+            row[type] = cur > last ? cur - last : 0;
+            row[CPU_HR_TIME_SUM] += row[type];
+            sys[type] += row[type];
+        }
+        sys[CPU_HR_TIME_SUM] += row[CPU_HR_TIME_SUM];
+    }
+    data.intervalNs = ready ? now - state.lastReadNs : 0;
+    data.dataReady = ready ? ENV_DATA_READY : ENV_DATA_NOT_READY;
+    state.lastTimes = curTimes;
+    state.lastReadNs = now;
+    return ready;
+}
+
+void CpuUtilHr::Run()
+{
+    if (openTopics.empty()) {
+        return;
+    }
+    uint64_t now = 0;
+    if (!ReadCpuAcct(now)) {
+        WARN(logger, "failed to read cpu_acct map.");
+        return;
+    }
+    for (auto &p : openTopics) {
+        if (!UpdateCpuUtilHr(p.second, now)) {
+            continue;
+        }
+        DataList dataList;
+        if (!oeaware::SetDataListTopic(&dataList, name, "cpu_util_hr", p.first)) {
+            continue;
+        }
+        dataList.len = 1;
+        dataList.data = new void* [1];
+        dataList.data[0] = &p.second.data;
+        Publish(dataList, false);
+    }
+}
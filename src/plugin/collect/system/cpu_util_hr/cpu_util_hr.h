@@ -0,0 +1,68 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef OEAWARE_MANAGER_CPU_UTIL_HR_H
+#define OEAWARE_MANAGER_CPU_UTIL_HR_H
+#include <unordered_map>
+#include <vector>
+#include "oeaware/interface.h"
+#include "oeaware/data/env_data.h"
+#include "ebpf/cpu_util_hr_comm.h"
+#if ENABLE_EBPF
+#include "ebpf/cpu_util_hr.skel.h"
+#endif
+
+/*
+ * topic: cpu_util_hr, high resolution cpu utilization accounted by eBPF in a per-cpu map.
+ * params: "" or the publication interval in ms, 10 ~ 100 in steps of 10, default 100.
+ *  If several intervals are opened, the instance runs at the smallest one and each topic is
+ *  published with the delta of its own interval.
+ * DataList:
+ *  data: EnvCpuUtilHrParam.
+ */
+class CpuUtilHr : public oeaware::Interface {
+public:
+    CpuUtilHr();
+    ~CpuUtilHr() override = default;
+    oeaware::Result OpenTopic(const oeaware::Topic &topic) override;
+    void CloseTopic(const oeaware::Topic &topic) override;
+    void UpdateData(const DataList &dataList) override;
+    oeaware::Result Enable(const std::string &param = "") override;
+    void Disable() override;
+    void Run() override;
+private:
+    struct TopicState {
+        int interval = DEFAULT_PERIOD;
+        uint64_t lastReadNs = 0;
+        // [cpu][type], accumulated times of the last publication
+        std::vector<std::vector<uint64_t>> lastTimes;
+        EnvCpuUtilHrParam data = {};
+    };
+    bool ReadCpuAcct(uint64_t &now);
+    bool UpdateCpuUtilHr(TopicState &state, uint64_t now);
+    void UpdatePeriod();
+    static void ResetTopicState(TopicState &state);
+
+    static constexpr int DEFAULT_PERIOD = 100;
+    static constexpr int MIN_PERIOD = 10;
+    // key: topic params
+    std::unordered_map<std::string, TopicState> openTopics;
+    int cpuNumConfig = 0;
+    int possibleCpuNum = 0;
+    std::vector<struct CpuAcct> acctBuf;
+    // [cpu][type], accumulated times of the current read
+    std::vector<std::vector<uint64_t>> curTimes;
+#if ENABLE_EBPF
+    struct cpu_util_hr_bpf *skel = nullptr;
+#endif
+};
+
+#endif // OEAWARE_MANAGER_CPU_UTIL_HR_H
@@ -0,0 +1,109 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "vmlinux.h"
+#include <bpf/bpf_helpers.h>
+#include <bpf/bpf_tracing.h>
+#include <bpf/bpf_core_read.h>
+#include "cpu_util_hr_comm.h"
+
+struct {
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __uint(max_entries, 1);
+    __type(key, u32);
+    __type(value, struct CpuAcct);
+} cpu_acct SEC(".maps");
+
+static __always_inline struct CpuAcct *GetAcct(void)
+{
+    u32 key = 0;
+    return bpf_map_lookup_elem(&cpu_acct, &key);
+}
+
+SEC("tracepoint/sched/sched_switch")
+int trace_sched_switch(struct trace_event_raw_sched_switch *ctx)
+{
+    struct CpuAcct *acct = GetAcct();
+    if (!acct) {
+        return 0;
+    }
+    u64 now = bpf_ktime_get_ns();
+    u64 irqTotal = acct->irq + acct->softirq;
+    if (acct->lastSwitch != 0 && now > acct->lastSwitch) {
+        u64 slice = now - acct->lastSwitch;
+        u64 irqInSlice = irqTotal - acct->irqAtSwitch;
+        slice = slice > irqInSlice ? slice - irqInSlice : 0;
+        // pid 0 is the idle task of each cpu
+        if (BPF_CORE_READ(ctx, prev_pid) == 0) {
+            acct->idle += slice;
+        } else {
+            acct->busy += slice;
+        }
+    }
+    acct->lastSwitch = now;
+    acct->irqAtSwitch = irqTotal;
+    acct->curIdle = BPF_CORE_READ(ctx, next_pid) == 0;
+    return 0;
+}
+
+SEC("tracepoint/irq/irq_handler_entry")
+int trace_irq_handler_entry(void *ctx)
+{
+    struct CpuAcct *acct = GetAcct();
+    if (acct) {
+        acct->irqStart = bpf_ktime_get_ns();
+    }
+    return 0;
+}
+
+SEC("tracepoint/irq/irq_handler_exit")
+int trace_irq_handler_exit(void *ctx)
+{
+    struct CpuAcct *acct = GetAcct();
+    if (!acct || acct->irqStart == 0) {
+        return 0;
+    }
+    u64 now = bpf_ktime_get_ns();
+    if (now > acct->irqStart) {
+        acct->irq += now - acct->irqStart;
+    }
+    acct->irqStart = 0;
+    return 0;
+}
+
+SEC("tracepoint/irq/softirq_entry")
+int trace_softirq_entry(void *ctx)
+{
+    struct CpuAcct *acct = GetAcct();
+    if (acct) {
+        acct->softirqStart = bpf_ktime_get_ns();
+        acct->irqAtSoftirq = acct->irq;
+    }
+    return 0;
+}
+
+SEC("tracepoint/irq/softirq_exit")
+int trace_softirq_exit(void *ctx)
+{
+    struct CpuAcct *acct = GetAcct();
+    if (!acct || acct->softirqStart == 0) {
+        return 0;
+    }
+    u64 now = bpf_ktime_get_ns();
+    // hard irqs may interrupt a softirq, they are already counted in irq
+    u64 nested = acct->irq - acct->irqAtSoftirq;
+    u64 duration = now > acct->softirqStart ? now - acct->softirqStart : 0;
+    acct->softirq += duration > nested ? duration - nested : 0;
+    acct->softirqStart = 0;
+    return 0;
+}
+
+char LICENSE[] SEC("license") = "GPL";
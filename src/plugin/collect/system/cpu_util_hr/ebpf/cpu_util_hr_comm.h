@@ -0,0 +1,42 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef OE_CPU_UTIL_HR_COMM_H
+#define OE_CPU_UTIL_HR_COMM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Per-cpu accounting, all times are bpf_ktime_get_ns() nanoseconds.
+ * busy/idle only contain the task time which has been switched out, the running slice
+ * [lastSwitch, now) is added by the reader, it belongs to idle if curIdle is set.
+ */
+struct CpuAcct {
+    uint64_t busy;
+    uint64_t idle;
+    uint64_t irq;
+    uint64_t softirq;
+    uint64_t lastSwitch;
+    uint64_t irqAtSwitch;      // irq + softirq when the running slice started
+    uint64_t irqStart;
+    uint64_t softirqStart;
+    uint64_t irqAtSoftirq;     // irq when the running softirq started
+    uint32_t curIdle;
+    uint32_t pad;
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
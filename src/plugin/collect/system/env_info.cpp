@@ -14,13 +14,49 @@
 #include <numa.h>
 #include <unistd.h>
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <securec.h>
 #include <dirent.h>
 #include <cstdlib>
+#include <map>
+#include <algorithm>
 #include "oeaware/data/env_data.h"
 
 using namespace oeaware;
 
+namespace {
+const std::string CPU_TOPOLOGY_PATH = "/sys/devices/system/cpu/cpu";
+constexpr int MAX_EWMA_WINDOW = 3600;
+
+bool ReadCpuList(const std::string &path, std::vector<int> &cpus)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string line;
+    if (!std::getline(file, line) || line.empty()) {
+        return false;
+    }
+    cpus = ParseRange(line);
+    return !cpus.empty();
+}
+
+void AddCpuRow(uint64_t *dst, const uint64_t *row)
+{
+    for (int type = 0; type < CPU_UTIL_TYPE_MAX; ++type) {
+        dst[type] += row[type];
+    }
+}
+
+void ResetArray(uint64_t *&array)
+{
+    delete[] array;
+    array = nullptr;
+}
+}
+
 bool EnvInfo::UpdateProcStat()
 {
     int cpuNum = envStaticInfo.cpuNumConfig;
@@ -128,12 +164,24 @@ void EnvInfo::ResetEnvCpuUtilInfo()
 {
     envCpuUtilInfo.cpuNumConfig = 0;
     envCpuUtilInfo.dataReady = ENV_DATA_NOT_READY;
-    for (int cpu = 0; cpu < envStaticInfo.cpuNumConfig + 1; cpu++) {
-        delete[] envCpuUtilInfo.times[cpu];
-        envCpuUtilInfo.times[cpu] = nullptr;
-    }
+    // the rows of times point into matrix
     delete[] envCpuUtilInfo.times;
     envCpuUtilInfo.times = nullptr;
+    free(envCpuUtilInfo.matrix);
+    envCpuUtilInfo.matrix = nullptr;
+    envCpuUtilInfo.numaNum = 0;
+    envCpuUtilInfo.clusterNum = 0;
+    envCpuUtilInfo.coreNum = 0;
+    ResetArray(envCpuUtilInfo.nodeTimes);
+    ResetArray(envCpuUtilInfo.clusterTimes);
+    ResetArray(envCpuUtilInfo.coreTimes);
+    delete[] envCpuUtilInfo.cpu2Cluster;
+    envCpuUtilInfo.cpu2Cluster = nullptr;
+    delete[] envCpuUtilInfo.cpu2Core;
+    envCpuUtilInfo.cpu2Core = nullptr;
+    envCpuUtilInfo.ewmaWindow = 0;
+    delete[] envCpuUtilInfo.ewmaUtil;
+    envCpuUtilInfo.ewmaUtil = nullptr;
 }
 
 EnvInfo::EnvInfo()
@@ -170,6 +218,17 @@ EnvInfo::EnvInfo()
 	description += "                 topicName:static, params:\"\", usage:get static environment info\n";
     description += "                 topicName:realtime, params:\"\", usage:get realtime environment info\n";
     description += "                 topicName:cpu_util, params:\"\", usage:get cpu utilization info\n";
+    description += "                 topicName:cpu_util, params:\"<ewma window>\", usage:get cpu utilization info "
+                   "with EWMA smoothing over the window (number of periods)\n";
+}
+
+static bool GetEwmaWindow(const std::string &params, int &window)
+{
+    if (!IsInteger(params) || params.size() > std::to_string(MAX_EWMA_WINDOW).size()) {
+        return false;
+    }
+    window = std::atoi(params.c_str());
+    return window > 0 && window <= MAX_EWMA_WINDOW;
 }
 
 oeaware::Result EnvInfo::OpenTopic(const oeaware::Topic &topic)
@@ -178,22 +237,34 @@ oeaware::Result EnvInfo::OpenTopic(const oeaware::Topic &topic)
         return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, instanceName is not match");
     }
 
-    if (topic.params != "") {
-        return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, params is not empty");
+    int ewmaWindow = 0;
+    if (topic.params != "" && (topic.topicName != "cpu_util" || !GetEwmaWindow(topic.params, ewmaWindow))) {
+        return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, params is invalid");
     }
     for (auto &iter : topicStr) {
         if (iter != topic.topicName) {
             continue;
         }
-        if (topicParams[iter].open) {
+        auto &topicParam = topicParams[topic.GetType()];
+        if (topicParam.open) {
             WARN(logger, topic.GetType() << " has been opened before!");
             return oeaware::Result(OK);
         }
-        topicParams[iter].open = true;
+        if (ewmaWindow > 0 && envCpuUtilInfo.ewmaWindow > 0) {
+            // only one smoothing window is kept, so that every tuner sees the same view
+            return oeaware::Result(FAILED, "OpenTopic:" + topic.GetType() + " failed, ewma window " +
+                std::to_string(envCpuUtilInfo.ewmaWindow) + " has been opened");
+        }
+        topicParam.open = true;
         if (topic.topicName == "realtime") {
             InitEnvRealTimeInfo();
         } else if (topic.topicName == "cpu_util") {
-            InitEnvCpuUtilInfo();
+            if (cpuUtilOpenCnt++ == 0) {
+                InitEnvCpuUtilInfo();
+            }
+            if (ewmaWindow > 0) {
+                InitCpuUtilEwma(ewmaWindow);
+            }
         }
         return oeaware::Result(OK);
     }
@@ -202,16 +273,24 @@ oeaware::Result EnvInfo::OpenTopic(const oeaware::Topic &topic)
 
 void EnvInfo::CloseTopic(const oeaware::Topic &topic)
 {
-    if (!topicParams[topic.topicName].open) {
+    auto it = topicParams.find(topic.GetType());
+    if (it == topicParams.end() || !it->second.open) {
         WARN(logger, "CloseTopic failed, " + topic.GetType() + " not open.");
         return;
     }
-    topicParams[topic.topicName].open = false;
+    it->second.open = false;
     if (topic.topicName == "realtime") {
         ResetEnvRealTimeInfo(envRealTimeInfo);
     }
     if (topic.topicName == "cpu_util") {
-        ResetEnvCpuUtilInfo();
+        if (topic.params != "") {
+            envCpuUtilInfo.ewmaWindow = 0;
+            delete[] envCpuUtilInfo.ewmaUtil;
+            envCpuUtilInfo.ewmaUtil = nullptr;
+        }
+        if (--cpuUtilOpenCnt == 0) {
+            ResetEnvCpuUtilInfo();
+        }
     }
 }
 
@@ -239,25 +318,31 @@ void EnvInfo::Disable()
 
 void EnvInfo::Run()
 {
-    for (auto &topicName : topicStr) {
-        if (!topicParams[topicName].open) {
+    bool cpuUtilUpdated = false;
+    for (auto &p : topicParams) {
+        if (!p.second.open) {
             continue;
         }
+        oeaware::Topic topic = oeaware::Topic::GetTopicFromType(p.first);
         DataList dataList;
-        if (topicName == "static") {
-            oeaware::SetDataListTopic(&dataList, name, topicName, "");
+        if (topic.topicName == "static") {
+            oeaware::SetDataListTopic(&dataList, name, topic.topicName, "");
             dataList.len = 1;
             dataList.data = new void* [1];
             dataList.data[0] = &envStaticInfo; // not need new data
-        } else if (topicName == "realtime") {
+        } else if (topic.topicName == "realtime") {
             GetEnvRealtimeInfo();
-            oeaware::SetDataListTopic(&dataList, name, topicName, "");
+            oeaware::SetDataListTopic(&dataList, name, topic.topicName, "");
             dataList.len = 1;
             dataList.data = new void* [1];
             dataList.data[0] = &envRealTimeInfo;
-        } else if (topicName == "cpu_util") {
-            GetEnvCpuUtilInfo();
-            oeaware::SetDataListTopic(&dataList, name, topicName, "");
+        } else if (topic.topicName == "cpu_util") {
+            // computed once per period and shared by all cpu_util topics
+            if (!cpuUtilUpdated) {
+                GetEnvCpuUtilInfo();
+                cpuUtilUpdated = true;
+            }
+            oeaware::SetDataListTopic(&dataList, name, topic.topicName, topic.params);
             dataList.len = 1;
             dataList.data = new void* [1];
             dataList.data[0] = &envCpuUtilInfo;
@@ -344,6 +429,7 @@ bool EnvInfo::InitEnvStaticInfo()
         return false;
     }
     envStaticInfo.cpu2Node = new int[envStaticInfo.cpuNumConfig];
+    std::fill(envStaticInfo.cpu2Node, envStaticInfo.cpu2Node + envStaticInfo.cpuNumConfig, -1);
     InitCpu2Node(envStaticInfo.numaNum, envStaticInfo.cpu2Node, envStaticInfo.cpuNumConfig);
     envStaticInfo.pageSize = sysconf(_SC_PAGE_SIZE);
     envStaticInfo.pageMask = GetPageMask(envStaticInfo.pageSize);
@@ -362,20 +448,117 @@ bool EnvInfo::InitEnvRealTimeInfo()
 
 void EnvInfo::InitEnvCpuUtilInfo()
 {
+    int rowNum = envStaticInfo.cpuNumConfig + 1;
     cpuTime.clear();
-    cpuTime.resize(envStaticInfo.cpuNumConfig + 1);
-    for (int i = 0; i < envStaticInfo.cpuNumConfig + 1; ++i) {
+    cpuTime.resize(rowNum);
+    for (int i = 0; i < rowNum; ++i) {
         // not need use CPU_UTIL_TYPE_MAX to include CPU_TIME_SUM
         cpuTime[i].resize(CPU_TIME_SUM, 0);
     }
     envCpuUtilInfo.cpuNumConfig = envStaticInfo.cpuNumConfig;
-    envCpuUtilInfo.times = new uint64_t* [envStaticInfo.cpuNumConfig + 1];
-    for (int i = 0; i < envStaticInfo.cpuNumConfig + 1; ++i) {
-        envCpuUtilInfo.times[i] = new uint64_t[CPU_UTIL_TYPE_MAX];
+    void *matrix = nullptr;
+    if (posix_memalign(&matrix, ENV_CACHE_LINE_SIZE, sizeof(uint64_t) * rowNum * CPU_UTIL_TYPE_MAX) != 0) {
+        matrix = nullptr;
     }
+    envCpuUtilInfo.matrix = static_cast<uint64_t*>(matrix);
+    envCpuUtilInfo.times = new uint64_t* [rowNum];
+    for (int i = 0; i < rowNum; ++i) {
+        envCpuUtilInfo.times[i] = envCpuUtilInfo.matrix + i * CPU_UTIL_TYPE_MAX;
+    }
+    InitCpuUtilTopology();
     UpdateProcStat();
 }
 
+void EnvInfo::InitCpuUtilTopology()
+{
+    int cpuNum = envStaticInfo.cpuNumConfig;
+    envCpuUtilInfo.numaNum = envStaticInfo.numaNum;
+    envCpuUtilInfo.nodeTimes = new uint64_t[envCpuUtilInfo.numaNum * CPU_UTIL_TYPE_MAX];
+    envCpuUtilInfo.cpu2Cluster = new int[cpuNum];
+    envCpuUtilInfo.cpu2Core = new int[cpuNum];
+    std::fill(envCpuUtilInfo.cpu2Cluster, envCpuUtilInfo.cpu2Cluster + cpuNum, -1);
+    std::fill(envCpuUtilInfo.cpu2Core, envCpuUtilInfo.cpu2Core + cpuNum, -1);
+
+    // Same as Topology of cluster_affinity, clusters are the consecutive cpu ranges of the size of cpu0's cluster.
+    std::vector<int> clusterCpus;
+    int oneClusterCpuNum = 0;
+    if (ReadCpuList(CPU_TOPOLOGY_PATH + "0/topology/cluster_cpus_list", clusterCpus) &&
+        clusterCpus.front() == 0 && clusterCpus.back() == static_cast<int>(clusterCpus.size()) - 1) {
+        oneClusterCpuNum = clusterCpus.size();
+    }
+    envCpuUtilInfo.clusterNum = oneClusterCpuNum > 0 ? cpuNum / oneClusterCpuNum : 0;
+    for (int cpu = 0; cpu < envCpuUtilInfo.clusterNum * oneClusterCpuNum; ++cpu) {
+        envCpuUtilInfo.cpu2Cluster[cpu] = cpu / oneClusterCpuNum;
+    }
+    envCpuUtilInfo.clusterTimes = new uint64_t[envCpuUtilInfo.clusterNum * CPU_UTIL_TYPE_MAX];
+
+    // key: first cpu of the SMT siblings, value: core index
+    std::map<int, int> coreIndex;
+    for (int cpu = 0; cpu < cpuNum; ++cpu) {
+        std::vector<int> siblings;
+        if (!ReadCpuList(CPU_TOPOLOGY_PATH + std::to_string(cpu) + "/topology/thread_siblings_list", siblings)) {
+            continue;
+        }
+        auto it = coreIndex.emplace(siblings.front(), static_cast<int>(coreIndex.size())).first;
+        envCpuUtilInfo.cpu2Core[cpu] = it->second;
+    }
+    envCpuUtilInfo.coreNum = coreIndex.size();
+    envCpuUtilInfo.coreTimes = new uint64_t[envCpuUtilInfo.coreNum * CPU_UTIL_TYPE_MAX];
+}
+
+void EnvInfo::InitCpuUtilEwma(int window)
+{
+    size_t len = (envStaticInfo.cpuNumConfig + 1) * CPU_UTIL_TYPE_MAX;
+    envCpuUtilInfo.ewmaWindow = window;
+    envCpuUtilInfo.ewmaUtil = new double[len];
+    std::fill(envCpuUtilInfo.ewmaUtil, envCpuUtilInfo.ewmaUtil + len, 0.0);
+    ewmaInit = false;
+}
+
+void EnvInfo::UpdateCpuUtilRollup()
+{
+    std::fill(envCpuUtilInfo.nodeTimes, envCpuUtilInfo.nodeTimes + envCpuUtilInfo.numaNum * CPU_UTIL_TYPE_MAX, 0);
+    std::fill(envCpuUtilInfo.clusterTimes,
+        envCpuUtilInfo.clusterTimes + envCpuUtilInfo.clusterNum * CPU_UTIL_TYPE_MAX, 0);
+    std::fill(envCpuUtilInfo.coreTimes, envCpuUtilInfo.coreTimes + envCpuUtilInfo.coreNum * CPU_UTIL_TYPE_MAX, 0);
+    for (int cpu = 0; cpu < envCpuUtilInfo.cpuNumConfig; ++cpu) {
+        const uint64_t *row = envCpuUtilInfo.matrix + cpu * CPU_UTIL_TYPE_MAX;
+        int node = envStaticInfo.cpu2Node[cpu];
+        if (node >= 0 && node < envCpuUtilInfo.numaNum) {
+            AddCpuRow(envCpuUtilInfo.nodeTimes + node * CPU_UTIL_TYPE_MAX, row);
+        }
+        int cluster = envCpuUtilInfo.cpu2Cluster[cpu];
+        if (cluster >= 0) {
+            AddCpuRow(envCpuUtilInfo.clusterTimes + cluster * CPU_UTIL_TYPE_MAX, row);
+        }
+        int core = envCpuUtilInfo.cpu2Core[cpu];
+        if (core >= 0) {
+            AddCpuRow(envCpuUtilInfo.coreTimes + core * CPU_UTIL_TYPE_MAX, row);
+        }
+    }
+}
+
+void EnvInfo::UpdateCpuUtilEwma()
+{
+    if (envCpuUtilInfo.ewmaUtil == nullptr) {
+        return;
+    }
+    double alpha = 2.0 / (envCpuUtilInfo.ewmaWindow + 1);
+    for (int cpu = 0; cpu < envCpuUtilInfo.cpuNumConfig + 1; ++cpu) {
+        const uint64_t *row = envCpuUtilInfo.matrix + cpu * CPU_UTIL_TYPE_MAX;
+        double *ewma = envCpuUtilInfo.ewmaUtil + cpu * CPU_UTIL_TYPE_MAX;
+        if (row[CPU_TIME_SUM] == 0) {
+            // offline cpu, keep the last value
+            continue;
+        }
+        for (int type = 0; type < CPU_UTIL_TYPE_MAX; ++type) {
+            double util = static_cast<double>(row[type]) / row[CPU_TIME_SUM];
+            ewma[type] = ewmaInit ? alpha * util + (1 - alpha) * ewma[type] : util;
+        }
+    }
+    ewmaInit = true;
+}
+
 bool GetOnlineCpus(std::vector<int> &onlineCpus)
 {
     std::ifstream file("/sys/devices/system/cpu/online");
@@ -414,7 +597,12 @@ void EnvInfo::GetEnvRealtimeInfo()
 void EnvInfo::GetEnvCpuUtilInfo()
 {
     envCpuUtilInfo.dataReady = ENV_DATA_NOT_READY;
+    if (envCpuUtilInfo.matrix == nullptr) {
+        return;
+    }
     if (UpdateCpuDiffTime(cpuTime)) {
+        UpdateCpuUtilRollup();
+        UpdateCpuUtilEwma();
         envCpuUtilInfo.dataReady = ENV_DATA_READY;
     }
 }
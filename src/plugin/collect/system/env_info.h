@@ -30,16 +30,24 @@ private:
     struct TopicParam {
         bool open = false;
     };
+
     std::vector<std::string> topicStr = { "static", "realtime", "cpu_util" };
+    // key: topic type, cpu_util may be opened with an EWMA window as params.
     std::unordered_map<std::string, TopicParam> topicParams;
     EnvStaticInfo envStaticInfo = {};
     EnvRealTimeInfo envRealTimeInfo = {};
     std::vector<std::vector<uint64_t>> cpuTime; // [cpu][type]
     EnvCpuUtilParam envCpuUtilInfo = {};
+    int cpuUtilOpenCnt = 0;
+    bool ewmaInit = false;
     void InitNumaDistance();
     bool InitEnvStaticInfo();
     bool InitEnvRealTimeInfo();
     void InitEnvCpuUtilInfo();
+    void InitCpuUtilTopology();
+    void InitCpuUtilEwma(int window);
+    void UpdateCpuUtilRollup();
+    void UpdateCpuUtilEwma();
     void GetEnvRealtimeInfo();
     void GetEnvCpuUtilInfo();
     bool UpdateProcStat();
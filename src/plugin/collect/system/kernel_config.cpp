@@ -19,6 +19,7 @@
 #include <sys/stat.h>
 #include "oeaware/utils.h"
 #include "command_base.h"
+#include "native_cmd.h"
 #include "oeaware/data/kernel_data.h"
 #include "data_register.h"
 
@@ -81,6 +82,11 @@ oeaware::Result KernelConfig::OpenTopic(const oeaware::Topic &topic)
         while (ss >> word) {
             getTopics[topicType].insert(word);
         }
+    } else if (topic.topicName == "get_kernel_config_diff") {
+        auto &prefixes = diffTopics[topicType];
+        while (ss >> word) {
+            prefixes.emplace_back(word);
+        }
     }
     return oeaware::Result(OK);
 }
@@ -89,6 +95,7 @@ void KernelConfig::CloseTopic(const oeaware::Topic &topic)
 {
     getTopics.erase(topic.GetType());
     getCmds.erase(topic.GetType());
+    diffTopics.erase(topic.GetType());
     setSystemParams.clear();
     cmdRun.clear();
 }
@@ -96,33 +103,19 @@ void KernelConfig::CloseTopic(const oeaware::Topic &topic)
 oeaware::Result KernelConfig::Enable(const std::string &param)
 {
     (void)param;
-    FILE *pipe = popen("sysctl -a", "r");
-    if (!pipe) {
-        return oeaware::Result(FAILED, "Error: popen() filed");
+    if (!sysctlParams.Refresh()) {
+        return oeaware::Result(FAILED, "failed to read /proc/sys.");
     }
-    char buffer[1024];
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        size_t len = strlen(buffer);
-        if (len > 0 && buffer[len - 1] == '\n') {
-            buffer[len - 1] = '\0';
-        }
-        std::string str = buffer;
-        auto values = oeaware::SplitString(str, " = ");
-        constexpr int paramsCnt = 2;
-        if (values.size() != paramsCnt) {
-            continue;
-        }
-        sysctlParams[values[0]] = values[1];
-    }
-    pclose(pipe);
+    sysctlFresh = true;
     return oeaware::Result(OK);
 }
 
 void KernelConfig::Disable()
 {
-    sysctlParams.clear();
+    // sysctlParams is kept, the next Enable only reports the parameters changed since then.
     setSystemParams.clear();
     getTopics.clear();
+    diffTopics.clear();
     cmdRun.clear();
     return;
 }
@@ -192,15 +185,18 @@ void KernelConfig::PublishCmd()
             }
             cmd += cmdPart;
         }
-        PopenProcess pipe;
-        pipe.Popen(cmd);
-        char buffer[1024];
         std::string ret = "";
-        while (fgets(buffer, sizeof(buffer), pipe.stream) != nullptr) {
-            ret += buffer;
-        }
-        if (pipe.Pclose() < 0) {
-            WARN(logger, "pipe close error.");
+        if (!NativeCmd::Run(p.second, ret)) {
+            ret = "";
+            PopenProcess pipe;
+            pipe.Popen(cmd);
+            char buffer[1024];
+            while (fgets(buffer, sizeof(buffer), pipe.stream) != nullptr) {
+                ret += buffer;
+            }
+            if (pipe.Pclose() < 0) {
+                WARN(logger, "pipe close error.");
+            }
         }
         SetKernelData(data, ret);
         dataList.len = 1;
@@ -230,9 +226,7 @@ void KernelConfig::PublishKernelParams()
         KernelDataNode *tmp = nullptr;
         for (auto &name : p.second) {
             std::string value = "";
-            if (sysctlParams.count(name)) {
-                value = sysctlParams[name];
-            } else {
+            if (!sysctlParams.Get(name, value)) {
                 WARN(logger, "invalid params: " << name << ".");
                 continue;
             }
@@ -258,13 +252,64 @@ void KernelConfig::PublishKernelParams()
     }
 }
 
+void KernelConfig::PublishKernelDiff()
+{
+    if (diffTopics.empty()) {
+        return;
+    }
+    // the snapshot only gets a new version when it is refreshed, /proc/sys is walked at most once per run
+    if (!sysctlFresh && !sysctlParams.Refresh()) {
+        WARN(logger, "failed to read /proc/sys.");
+        return;
+    }
+    sysctlFresh = false;
+    for (auto &p : diffTopics) {
+        oeaware::Topic topic = oeaware::Topic::GetTopicFromType(p.first);
+        DataList dataList;
+        if (!oeaware::SetDataListTopic(&dataList, topic.instanceName, topic.topicName, topic.params)) {
+            continue;
+        }
+        KernelData *data = new KernelData();
+        if (data == nullptr) {
+            WARN(logger, "KernelData failed to allocate memory.");
+            continue;
+        }
+        KernelDataNode *tmp = nullptr;
+        for (auto &name : sysctlParams.ChangedSince(diffVersions[p.first], p.second)) {
+            std::string value;
+            if (!sysctlParams.Get(name, value)) {
+                continue;
+            }
+            KernelDataNode *newNode = CreateNode(name.data(), value.data());
+            if (newNode == nullptr) {
+                WARN(logger, "KernelDataNode failed to allocate memory.");
+                continue;
+            }
+            if (data->kernelData == NULL) {
+                data->kernelData = newNode;
+                tmp = newNode;
+            } else {
+                tmp->next = newNode;
+                tmp = tmp->next;
+            }
+            data->len++;
+        }
+        diffVersions[p.first] = sysctlParams.GetVersion();
+        dataList.len = 1;
+        dataList.data = new void* [1];
+        dataList.data[0] = data;
+        Publish(dataList);
+    }
+}
+
 void KernelConfig::PublishKernelConfig()
 {
-    if (getTopics.empty() && getCmds.empty()) {
+    if (getTopics.empty() && getCmds.empty() && diffTopics.empty()) {
         return;
     }
     PublishCmd();
     PublishKernelParams();
+    PublishKernelDiff();
 }
 
 void KernelConfig::WriteSysParam(const std::string &path, const std::string &value)
@@ -15,14 +15,20 @@
 #include <unordered_set>
 #include <string>
 #include "oeaware/interface.h"
+#include "sysctl_snapshot.h"
 
 /*
  * topic: get_kernel_config, obtain the kernel parameter information.
  * params: kernel params name, including
  * 1. sysctl -a -N
  *
+ * topic: get_kernel_config_diff, obtain the kernel parameters changed since the last publication of the same topic.
+ * params: kernel params name prefixes separated by spaces, like "net.core vm", empty means all parameters.
+ * The first publication contains all matched parameters.
+ *
  * topic: get_cmd, the trustlist command is supported.
  * params: each command is seqarated by "@@", include "cat", "grep", "awk", "pgrep", "ls", "ethtool".
+ * "lscpu", "ethtool -l <dev>", "cat <file>" and "grep <string>" are run in process, others by the shell.
  *
  * topic: set_kernel_config, modify kernel parameters.
  * DataList:
@@ -43,6 +49,7 @@ public:
 private:
     void PublishCmd();
     void PublishKernelParams();
+    void PublishKernelDiff();
     void PublishKernelConfig();
     void SetKernelConfig();
     bool InitCmd(std::stringstream &ss, const std::string &topicType);
@@ -51,13 +58,20 @@ private:
     void WriteSysParam(const std::string &path, const std::string &value);
     void GetAllEth();
 
-    std::vector<std::string> topicStr = {"get_kernel_config", "get_cmd", "set_kernel_config"};
+    std::vector<std::string> topicStr = {"get_kernel_config", "get_kernel_config_diff", "get_cmd",
+        "set_kernel_config"};
     // key: topic type, value: parameters to be queried.
     std::unordered_map<std::string, std::unordered_set<std::string>> getTopics;
     std::unordered_map<std::string, std::vector<std::string>> getCmds;
+    // key: topic type, value: parameter name prefixes.
+    std::unordered_map<std::string, std::vector<std::string>> diffTopics;
+    // key: topic type, value: snapshot version already published, kept after the topic is closed.
+    std::unordered_map<std::string, uint64_t> diffVersions;
     std::vector<std::pair<std::string, std::string>> setSystemParams;
     
-    std::unordered_map<std::string, std::string> sysctlParams;
+    SysctlSnapshot sysctlParams;
+    // true while the snapshot taken by Enable has not been published, the next diff uses it without a new walk
+    bool sysctlFresh = false;
     std::vector<std::string> cmdRun;
     static std::vector<std::string> getCmdGroup;
     static std::vector<std::string> cmdGroup;
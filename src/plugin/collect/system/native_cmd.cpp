@@ -0,0 +1,386 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "native_cmd.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <set>
+#include <map>
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/utsname.h>
+#include <net/if.h>
+#include <linux/ethtool.h>
+#include <linux/sockios.h>
+#include <securec.h>
+#include "oeaware/utils.h"
+
+namespace {
+const std::string CPU_PATH = "/sys/devices/system/cpu/";
+const std::string NODE_PATH = "/sys/devices/system/node/";
+const std::string CPU_INFO_PATH = "/proc/cpuinfo";
+constexpr int LSCPU_VALUE_COLUMN = 33;
+constexpr uint64_t SIZE_UNIT = 1024;
+constexpr int HEX_BASE = 16;
+// Characters that make the shell expand or quote an argument, such arguments are left to the shell.
+const char *SHELL_SPECIAL = "*?[]{}~$'\"\\";
+
+bool ReadFirstLine(const std::string &path, std::string &line)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    return static_cast<bool>(std::getline(file, line));
+}
+
+void AppendField(std::string &output, const std::string &name, const std::string &value)
+{
+    output += name;
+    output.append(name.size() < LSCPU_VALUE_COLUMN ? LSCPU_VALUE_COLUMN - name.size() : 1, ' ');
+    output += value + "\n";
+}
+
+// The fields of the first processor in /proc/cpuinfo.
+std::map<std::string, std::string> ReadCpuInfo()
+{
+    std::map<std::string, std::string> fields;
+    std::ifstream file(CPU_INFO_PATH);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            if (!fields.empty()) {
+                break;
+            }
+            continue;
+        }
+        size_t colon = line.find(':');
+        if (colon == std::string::npos || colon == 0) {
+            continue;
+        }
+        size_t keyEnd = line.find_last_not_of(" \t", colon - 1);
+        size_t valueBegin = line.find_first_not_of(" \t", colon + 1);
+        if (keyEnd == std::string::npos) {
+            continue;
+        }
+        fields[line.substr(0, keyEnd + 1)] = valueBegin == std::string::npos ? "" : line.substr(valueBegin);
+    }
+    return fields;
+}
+
+// Names lscpu reports for the arm implementers and the parts seen on openEuler hosts. An unknown part has no
+// "Model name", the pipeline then falls back to the real lscpu.
+void ArmModel(const std::map<std::string, std::string> &cpuInfo, std::string &vendor, std::string &model)
+{
+    static const std::map<int, std::string> implementers = {
+        {0x41, "ARM"}, {0x43, "Cavium"}, {0x46, "FUJITSU"}, {0x48, "HiSilicon"}, {0x4e, "NVIDIA"},
+        {0x51, "Qualcomm"}, {0x61, "Apple"}, {0x70, "Phytium"},
+    };
+    static const std::map<std::pair<int, int>, std::string> parts = {
+        {{0x41, 0xd03}, "Cortex-A53"}, {{0x41, 0xd05}, "Cortex-A55"}, {{0x41, 0xd07}, "Cortex-A57"},
+        {{0x41, 0xd08}, "Cortex-A72"}, {{0x41, 0xd0c}, "Neoverse-N1"}, {{0x41, 0xd40}, "Neoverse-V1"},
+        {{0x41, 0xd49}, "Neoverse-N2"}, {{0x41, 0xd4f}, "Neoverse-V2"}, {{0x48, 0xd01}, "Kunpeng-920"},
+    };
+    auto implementer = cpuInfo.find("CPU implementer");
+    auto part = cpuInfo.find("CPU part");
+    if (implementer == cpuInfo.end()) {
+        return;
+    }
+    int implementerId = static_cast<int>(strtol(implementer->second.c_str(), nullptr, HEX_BASE));
+    auto it = implementers.find(implementerId);
+    if (it != implementers.end()) {
+        vendor = it->second;
+    }
+    if (part == cpuInfo.end()) {
+        return;
+    }
+    auto partIt = parts.find({implementerId, static_cast<int>(strtol(part->second.c_str(), nullptr, HEX_BASE))});
+    if (partIt != parts.end()) {
+        model = partIt->second;
+    }
+}
+
+// Sizes as lscpu prints them, "48 KiB", "1.5 MiB".
+std::string HumanSize(uint64_t bytes)
+{
+    static const char *units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    size_t unit = 0;
+    uint64_t div = 1;
+    while (unit + 1 < sizeof(units) / sizeof(units[0]) && bytes >= div * SIZE_UNIT) {
+        div *= SIZE_UNIT;
+        unit++;
+    }
+    std::ostringstream os;
+    uint64_t whole = bytes / div;
+    const int decimalBase = 10;
+    uint64_t tenth = (bytes % div) * decimalBase / div;
+    os << whole;
+    if (tenth != 0) {
+        os << "." << tenth;
+    }
+    os << " " << units[unit];
+    return os.str();
+}
+
+uint64_t ParseCacheSize(const std::string &size)
+{
+    uint64_t value = strtoull(size.c_str(), nullptr, 10);
+    if (size.find('K') != std::string::npos) {
+        return value * SIZE_UNIT;
+    } else if (size.find('M') != std::string::npos) {
+        return value * SIZE_UNIT * SIZE_UNIT;
+    }
+    return value;
+}
+
+// "L1d cache:" lines, the total of every cache instance shared by online cpus.
+void AppendCaches(std::string &output, const std::vector<int> &onlineCpus)
+{
+    struct CacheInfo {
+        uint64_t total = 0;
+        std::set<std::string> instances;
+    };
+    std::map<std::string, CacheInfo> caches;
+    for (auto cpu : onlineCpus) {
+        std::string cacheDir = CPU_PATH + "cpu" + std::to_string(cpu) + "/cache/";
+        for (auto &index : oeaware::DirectoryWalker::ListFiles(cacheDir)) {
+            if (index.compare(0, strlen("index"), "index") != 0) {
+                continue;
+            }
+            std::string dir = cacheDir + index + "/";
+            std::string level;
+            std::string type;
+            std::string size;
+            std::string shared;
+            if (!ReadFirstLine(dir + "level", level) || !ReadFirstLine(dir + "type", type) ||
+                !ReadFirstLine(dir + "size", size) || !ReadFirstLine(dir + "shared_cpu_list", shared)) {
+                continue;
+            }
+            std::string name = "L" + level;
+            if (type == "Data") {
+                name += "d";
+            } else if (type == "Instruction") {
+                name += "i";
+            }
+            auto &cache = caches[name];
+            if (cache.instances.insert(shared).second) {
+                cache.total += ParseCacheSize(size);
+            }
+        }
+    }
+    for (auto &item : caches) {
+        size_t num = item.second.instances.size();
+        AppendField(output, item.first + " cache:", HumanSize(item.second.total) + " (" + std::to_string(num) +
+            (num == 1 ? " instance)" : " instances)"));
+    }
+}
+
+bool IsPlainArg(const std::string &arg)
+{
+    return !arg.empty() && arg[0] != '-' && arg.find_first_of(SHELL_SPECIAL) == std::string::npos;
+}
+}
+
+namespace NativeCmd {
+bool Lscpu(std::string &output)
+{
+    struct utsname uts;
+    std::string online;
+    std::string present;
+    if (uname(&uts) != 0 || !ReadFirstLine(CPU_PATH + "online", online) ||
+        !ReadFirstLine(CPU_PATH + "present", present)) {
+        return false;
+    }
+    auto onlineCpus = oeaware::ParseRange(online);
+    std::set<int> sockets;
+    std::map<int, std::set<int>> coresPerSocket;
+    size_t threadsPerCore = 1;
+    for (auto cpu : onlineCpus) {
+        std::string topo = CPU_PATH + "cpu" + std::to_string(cpu) + "/topology/";
+        std::string package;
+        std::string core;
+        std::string siblings;
+        if (!ReadFirstLine(topo + "physical_package_id", package) || !ReadFirstLine(topo + "core_id", core)) {
+            continue;
+        }
+        int socketId = atoi(package.c_str());
+        sockets.insert(socketId);
+        coresPerSocket[socketId].insert(atoi(core.c_str()));
+        if (ReadFirstLine(topo + "thread_siblings_list", siblings)) {
+            threadsPerCore = std::max(threadsPerCore, oeaware::ParseRange(siblings).size());
+        }
+    }
+    std::vector<std::pair<int, std::string>> nodes;
+    for (auto &name : oeaware::DirectoryWalker::ListFiles(NODE_PATH)) {
+        std::string cpuList;
+        if (name.compare(0, strlen("node"), "node") != 0 || !oeaware::IsInteger(name.substr(strlen("node"))) ||
+            !ReadFirstLine(NODE_PATH + name + "/cpulist", cpuList)) {
+            continue;
+        }
+        nodes.emplace_back(atoi(name.c_str() + strlen("node")), cpuList);
+    }
+    std::sort(nodes.begin(), nodes.end());
+    auto cpuInfo = ReadCpuInfo();
+    std::string vendor = cpuInfo["vendor_id"];
+    std::string model = cpuInfo["model name"];
+    std::string flags = cpuInfo.count("flags") ? cpuInfo["flags"] : cpuInfo["Features"];
+    if (vendor.empty()) {
+        ArmModel(cpuInfo, vendor, model);
+    }
+    output.clear();
+    AppendField(output, "Architecture:", uts.machine);
+    AppendField(output, "CPU(s):", std::to_string(oeaware::ParseRange(present).size()));
+    AppendField(output, "On-line CPU(s) list:", online);
+    if (!vendor.empty()) {
+        AppendField(output, "Vendor ID:", vendor);
+    }
+    if (!model.empty()) {
+        AppendField(output, "Model name:", model);
+    }
+    AppendField(output, "Thread(s) per core:", std::to_string(threadsPerCore));
+    size_t cores = coresPerSocket.empty() ? 0 : coresPerSocket.begin()->second.size();
+    AppendField(output, "Core(s) per socket:", std::to_string(cores));
+    AppendField(output, "Socket(s):", std::to_string(sockets.size()));
+    if (!flags.empty()) {
+        AppendField(output, "Flags:", flags);
+    }
+    AppendCaches(output, onlineCpus);
+    AppendField(output, "NUMA node(s):", std::to_string(nodes.size()));
+    for (auto &node : nodes) {
+        AppendField(output, "NUMA node" + std::to_string(node.first) + " CPU(s):", node.second);
+    }
+    return true;
+}
+
+bool EthtoolChannels(const std::string &dev, std::string &output)
+{
+    if (dev.empty() || dev.size() >= IFNAMSIZ) {
+        return false;
+    }
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct ethtool_channels channels = {};
+    channels.cmd = ETHTOOL_GCHANNELS;
+    struct ifreq ifr = {};
+    if (strncpy_s(ifr.ifr_name, IFNAMSIZ, dev.c_str(), dev.size()) != EOK) {
+        close(fd);
+        return false;
+    }
+    ifr.ifr_data = reinterpret_cast<char*>(&channels);
+    int ret = ioctl(fd, SIOCETHTOOL, &ifr);
+    close(fd);
+    if (ret < 0) {
+        return false;
+    }
+    std::ostringstream os;
+    os << "Channel parameters for " << dev << ":\n"
+       << "Pre-set maximums:\n"
+       << "RX:\t\t" << channels.max_rx << "\n"
+       << "TX:\t\t" << channels.max_tx << "\n"
+       << "Other:\t\t" << channels.max_other << "\n"
+       << "Combined:\t" << channels.max_combined << "\n"
+       << "Current hardware settings:\n"
+       << "RX:\t\t" << channels.rx_count << "\n"
+       << "TX:\t\t" << channels.tx_count << "\n"
+       << "Other:\t\t" << channels.other_count << "\n"
+       << "Combined:\t" << channels.combined_count << "\n";
+    output = os.str();
+    return true;
+}
+
+bool Cat(const std::vector<std::string> &files, std::string &output)
+{
+    output.clear();
+    for (auto &path : files) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::ostringstream os;
+        os << file.rdbuf();
+        output += os.str();
+    }
+    return true;
+}
+
+void Grep(const std::string &pattern, std::string &text)
+{
+    std::string result;
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = text.find('\n', begin);
+        size_t next = (end == std::string::npos) ? text.size() : end + 1;
+        if (text.substr(begin, next - begin).find(pattern) != std::string::npos) {
+            result.append(text, begin, next - begin);
+        }
+        begin = next;
+    }
+    text.swap(result);
+}
+
+bool Run(const std::vector<std::string> &cmdParts, std::string &output)
+{
+    // Check every part first, nothing is executed if the shell has to run the pipeline anyway.
+    std::vector<std::vector<std::string>> parts;
+    for (size_t i = 0; i < cmdParts.size(); ++i) {
+        std::vector<std::string> words;
+        for (auto &word : oeaware::SplitString(cmdParts[i], " ")) {
+            if (!word.empty()) {
+                words.emplace_back(word);
+            }
+        }
+        if (words.empty()) {
+            return false;
+        }
+        const std::string &cmd = words[0];
+        bool first = (i == 0);
+        if (first && cmd == "lscpu" && words.size() == 1) {
+        } else if (first && cmd == "ethtool" && words.size() == 3 && words[1] == "-l" && IsPlainArg(words[2])) {
+        } else if (first && cmd == "cat" && words.size() > 1 &&
+            std::all_of(words.begin() + 1, words.end(), IsPlainArg)) {
+        } else if (!first && cmd == "grep" && words.size() == 2 && IsPlainArg(words[1]) &&
+            words[1].find_first_of(".^|()+") == std::string::npos) {
+        } else {
+            return false;
+        }
+        parts.emplace_back(words);
+    }
+    // lscpu prints more than the native summary, only a grep for some of its fields is served natively
+    if (parts.empty() || (parts[0][0] == "lscpu" && parts.size() == 1)) {
+        return false;
+    }
+    auto &head = parts[0];
+    bool ok = false;
+    if (head[0] == "lscpu") {
+        ok = Lscpu(output);
+    } else if (head[0] == "ethtool") {
+        ok = EthtoolChannels(head[2], output);
+    } else {
+        ok = Cat(std::vector<std::string>(head.begin() + 1, head.end()), output);
+    }
+    if (!ok) {
+        return false;
+    }
+    for (size_t i = 1; i < parts.size(); ++i) {
+        Grep(parts[i][1], output);
+    }
+    // the real command may have the line grep looks for
+    if (head[0] == "lscpu" && output.empty()) {
+        return false;
+    }
+    return true;
+}
+}
@@ -0,0 +1,32 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef NATIVE_CMD_H
+#define NATIVE_CMD_H
+#include <string>
+#include <vector>
+
+// In-process implementations of the common get_cmd trustlist commands, used instead of forking a shell.
+namespace NativeCmd {
+    // Run a "@@" separated pipeline. Return false if one of the parts is not supported natively,
+    // then the caller runs it with the shell.
+    bool Run(const std::vector<std::string> &cmdParts, std::string &output);
+    // The summary part of lscpu, built from sysfs. Run only uses it with a grep stage.
+    bool Lscpu(std::string &output);
+    // "ethtool -l <dev>" with the ETHTOOL_GCHANNELS ioctl.
+    bool EthtoolChannels(const std::string &dev, std::string &output);
+    // "cat <file>..." without options or shell expansion.
+    bool Cat(const std::vector<std::string> &files, std::string &output);
+    // "grep <fixed string>", keep the lines that contain pattern.
+    void Grep(const std::string &pattern, std::string &text);
+}
+
+#endif
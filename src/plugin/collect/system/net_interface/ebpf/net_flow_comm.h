@@ -32,15 +32,54 @@ struct ThreadData {
 struct SockInfo {
     struct ThreadData client;
     struct ThreadData server;
-    uint64_t flow;
+    uint64_t flow; // bytes since the last read, only counted in flowDelta
+    uint64_t lastNs; // last time the delta is sent as event
 };
 
 struct QueueInfo {
     struct ThreadData td;
     int queueId;
     int ifIdx;
-    uint64_t times;
+    uint64_t times; // packets since the last read, only counted in queDelta
     uint64_t len;
+    uint64_t lastNs;
+};
+
+// event stream mode, deltas are sent when they reach NET_EVENT_FLUSH_BYTES or are older than NET_EVENT_FLUSH_NS
+#define NET_EVENT_RB_SIZE (4 * 1024 * 1024)
+#define NET_EVENT_FLUSH_BYTES (64 * 1024)
+#define NET_EVENT_FLUSH_NS (100 * 1000 * 1000ULL)
+
+enum NetEventType {
+    NET_EVENT_OPEN = 1,
+    NET_EVENT_CLOSE,
+    NET_EVENT_FLOW, // flow is valid
+    NET_EVENT_QUEUE, // queue is valid
+};
+
+struct NetEvent {
+    uint32_t type;
+    struct SockKey key;
+    union {
+        struct SockInfo flow;
+        struct QueueInfo queue;
+    };
+};
+
+// net_latency_kernel, log2 histograms, slot 0 counts [0, 2), slot i counts [2^i, 2^(i+1)), the last one is open
+#define NET_LATENCY_SLOTS 32
+
+struct LatencyHist {
+    struct ThreadData td;
+    uint64_t retrans;
+    uint64_t rttUs[NET_LATENCY_SLOTS]; // smoothed rtt of the sockets of the process, one sample per received segment
+    uint64_t rcvQueUs[NET_LATENCY_SLOTS]; // time from a segment being queued to the process reading it
+};
+
+// an skb with data passed to tcp, removed when it is read
+struct SkbQueued {
+    uint64_t ns;
+    uint64_t sk;
 };
 
 #ifdef __cplusplus
@@ -46,6 +46,40 @@ struct {
     __type(value, struct QueueInfo);
 } rcvQueStatus SEC(".maps");
 
+/*
+* Bytes and packets received since the last read, counted per cpu so tc_ingress never contends on a counter.
+* Every entry carries a copy of the owner info, userspace drains both maps with lookup_and_delete_batch,
+* so only the sockets active in the last period are read and nothing has to be remembered between reads.
+* Per-cpu maps are preallocated for every possible cpu, so queDelta is sized to the sockets active in one period,
+* not to all the sockets known by rcvQueStatus. flowDelta only holds keys of flowStats and is sized like it.
+* Neither is lru: an evicted entry would silently lose its counts, a full map fails the update and the packet
+* is counted in droppedDeltas.
+*/
+struct {
+    __uint(type, BPF_MAP_TYPE_PERCPU_HASH);
+    __uint(max_entries, 1024);
+    __type(key, struct SockKey);
+    __type(value, struct SockInfo);
+} flowDelta SEC(".maps");
+
+struct {
+    __uint(type, BPF_MAP_TYPE_PERCPU_HASH);
+    __uint(max_entries, 4096);
+    __type(key, struct SockKey);
+    __type(value, struct QueueInfo);
+} queDelta SEC(".maps");
+
+// set by userspace before load, 1 means the deltas are also sent to netEvents
+const volatile int eventMode = 0;
+__u64 droppedEvents = 0;
+// packets not counted because the delta map is full
+__u64 droppedDeltas = 0;
+
+struct {
+    __uint(type, BPF_MAP_TYPE_RINGBUF);
+    __uint(max_entries, NET_EVENT_RB_SIZE);
+} netEvents SEC(".maps");
+
 static __always_inline void UpdateThreadData(struct ThreadData *td)
 {
     td->pid = bpf_get_current_pid_tgid() >> 32;
@@ -53,6 +87,122 @@ static __always_inline void UpdateThreadData(struct ThreadData *td)
     bpf_get_current_comm(&td->comm, sizeof(td->comm));
 }
 
+static __always_inline void EmitEvent(__u32 type, struct SockKey *key, struct SockInfo *flow,
+    struct QueueInfo *queue)
+{
+    struct NetEvent *event = bpf_ringbuf_reserve(&netEvents, sizeof(struct NetEvent), 0);
+    if (!event) {
+        __sync_fetch_and_add(&droppedEvents, 1);
+        return;
+    }
+    event->type = type;
+    event->key = *key;
+    if (flow) {
+        event->flow = *flow;
+    } else if (queue) {
+        event->queue = *queue;
+    } else {
+        __builtin_memset(&event->flow, 0, sizeof(event->flow));
+    }
+    bpf_ringbuf_submit(event, 0);
+}
+
+/*
+* The deltas of a closing socket are kept: the closing cpu can only see its own slot, and the other cpus may
+* still hold counts of the socket. Userspace drains the entry with the slots of all cpus summed in the next read,
+* so short connections are not lost. The entry carries the owner, which is gone from flowStats by then.
+*/
+static __always_inline void DeleteSock(struct SockKey *key, struct SockKey *keyReversed)
+{
+    if (eventMode && (bpf_map_lookup_elem(&flowStats, key) || bpf_map_lookup_elem(&flowStats, keyReversed) ||
+        bpf_map_lookup_elem(&rcvQueStatus, key) || bpf_map_lookup_elem(&rcvQueStatus, keyReversed))) {
+        EmitEvent(NET_EVENT_CLOSE, key, NULL, NULL);
+    }
+    bpf_map_delete_elem(&flowStats, key);
+    bpf_map_delete_elem(&flowStats, keyReversed);
+
+    bpf_map_delete_elem(&rcvQueStatus, key);
+    bpf_map_delete_elem(&rcvQueStatus, keyReversed);
+}
+
+static __always_inline void AddFlow(struct SockKey *key, __u32 len)
+{
+    struct SockInfo *info = bpf_map_lookup_elem(&flowStats, key);
+    if (!info) {
+        return;
+    }
+    struct SockInfo *delta = bpf_map_lookup_elem(&flowDelta, key);
+    if (!delta) {
+        struct SockInfo init = *info;
+        init.flow = len;
+        init.lastNs = bpf_ktime_get_ns();
+        if (bpf_map_update_elem(&flowDelta, key, &init, BPF_NOEXIST) == 0) {
+            return;
+        }
+        // created by another cpu at the same time, the slot of this cpu is zero, or the map is full
+        delta = bpf_map_lookup_elem(&flowDelta, key);
+        if (!delta) {
+            __sync_fetch_and_add(&droppedDeltas, 1);
+            return;
+        }
+    }
+    // the server is filled in by accept after the first packets
+    if (delta->client.pid == 0 || delta->server.pid != info->server.pid) {
+        delta->client = info->client;
+        delta->server = info->server;
+    }
+    delta->flow += len;
+    if (eventMode) {
+        __u64 now = bpf_ktime_get_ns();
+        if (delta->flow >= NET_EVENT_FLUSH_BYTES || now - delta->lastNs >= NET_EVENT_FLUSH_NS) {
+            EmitEvent(NET_EVENT_FLOW, key, delta, NULL);
+            delta->flow = 0;
+            delta->lastNs = now;
+        }
+    }
+}
+
+static __always_inline void AddQueue(struct SockKey *key, struct __sk_buff *skb)
+{
+    struct QueueInfo *queInfo = bpf_map_lookup_elem(&rcvQueStatus, key);
+    if (!queInfo) {
+        return;
+    }
+    struct QueueInfo *delta = bpf_map_lookup_elem(&queDelta, key);
+    if (!delta) {
+        struct QueueInfo init = *queInfo;
+        init.ifIdx = skb->ifindex;
+        init.queueId = skb->queue_mapping;
+        init.times = 1;
+        init.len = skb->len;
+        init.lastNs = bpf_ktime_get_ns();
+        if (bpf_map_update_elem(&queDelta, key, &init, BPF_NOEXIST) == 0) {
+            return;
+        }
+        delta = bpf_map_lookup_elem(&queDelta, key);
+        if (!delta) {
+            __sync_fetch_and_add(&droppedDeltas, 1);
+            return;
+        }
+    }
+    if (delta->td.pid == 0) {
+        delta->td = queInfo->td;
+    }
+    delta->ifIdx = skb->ifindex;
+    delta->queueId = skb->queue_mapping;
+    delta->len += skb->len;
+    delta->times++;
+    if (eventMode) {
+        __u64 now = bpf_ktime_get_ns();
+        if (delta->len >= NET_EVENT_FLUSH_BYTES || now - delta->lastNs >= NET_EVENT_FLUSH_NS) {
+            EmitEvent(NET_EVENT_QUEUE, key, NULL, delta);
+            delta->times = 0;
+            delta->len = 0;
+            delta->lastNs = now;
+        }
+    }
+}
+
 static __always_inline void ReadIpAndPort(struct sock *sk, struct SockKey *key, struct SockKey *keyReversed)
 {
     BPF_CORE_READ_INTO(&(key->localIp), sk, __sk_common.skc_rcv_saddr);
@@ -114,6 +264,9 @@ int BPF_KPROBE(tcp_connect, struct sock *sk)
     UpdateThreadData(&info.client);
     if (IsValidData(&info.client)) {
         bpf_map_update_elem(&flowStats, &key, &info, BPF_ANY);
+        if (eventMode) {
+            EmitEvent(NET_EVENT_OPEN, &key, &info, NULL);
+        }
     }
     return 0;
 }
@@ -137,6 +290,9 @@ int BPF_KRETPROBE(inet_csk_accept_exit, struct sock *sk)
         queInfo.times = 0;
         queInfo.len = 0;
         bpf_map_update_elem(&rcvQueStatus, &keyReversed, &queInfo, BPF_ANY);
+        if (eventMode) {
+            EmitEvent(NET_EVENT_OPEN, &keyReversed, NULL, &queInfo);
+        }
     }
     return 0;
 }
@@ -146,11 +302,7 @@ int BPF_KPROBE(tcp_close, struct sock *sk)
 {
     struct SockKey key, keyReversed;
     ReadIpAndPort(sk, &key, &keyReversed);
-    bpf_map_delete_elem(&flowStats, &key);
-    bpf_map_delete_elem(&flowStats, &keyReversed);
-
-    bpf_map_delete_elem(&rcvQueStatus, &key);
-    bpf_map_delete_elem(&rcvQueStatus, &keyReversed);
+    DeleteSock(&key, &keyReversed);
     return 0;
 }
 
@@ -179,10 +331,7 @@ int BPF_KPROBE(tcp_set_state, struct sock *sk, int state)
             bpf_map_update_elem(&flowStats, &keyReversed, &info, BPF_ANY);
         }
     } else if ((oldState == TCP_ESTABLISHED && newState == TCP_FIN_WAIT1) || newState == TCP_CLOSE) {
-        bpf_map_delete_elem(&flowStats, &key);
-        bpf_map_delete_elem(&flowStats, &keyReversed);
-        bpf_map_delete_elem(&rcvQueStatus, &key);
-        bpf_map_delete_elem(&rcvQueStatus, &keyReversed);
+        DeleteSock(&key, &keyReversed);
     }
     return 0;
 }
@@ -230,31 +379,19 @@ int tc_ingress(struct __sk_buff *skb) {
     key.remoteIp = ip->daddr;
     key.localPort = sport;
     key.remotePort = dport;
-    struct SockInfo *info = bpf_map_lookup_elem(&flowStats, &key);
-    if (info) {
-        info->flow += skb->len;
-    }
+    AddFlow(&key, skb->len);
     struct SockKey keyReversed = {
         .localIp = key.remoteIp,
         .remoteIp = key.localIp,
         .localPort = key.remotePort,
         .remotePort = key.localPort
     };
-    info = bpf_map_lookup_elem(&flowStats, &keyReversed);
-    if (info) {
-        info->flow += skb->len;
-    }
+    AddFlow(&keyReversed, skb->len);
     // remote network
     if (skb->ifindex <= 0) {
         return TC_ACT_OK; // not a valid interface
     }
-    struct QueueInfo *queInfo = bpf_map_lookup_elem(&rcvQueStatus, &key);
-    if (queInfo) {
-        queInfo->ifIdx = skb->ifindex;
-        queInfo->queueId = skb->queue_mapping;
-        queInfo->len += skb->len;
-        queInfo->times++;
-    }
+    AddQueue(&key, skb);
     return TC_ACT_OK;
 }
 
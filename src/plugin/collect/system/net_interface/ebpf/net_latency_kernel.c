@@ -0,0 +1,199 @@
+/******************************************************************************
+* Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "vmlinux.h"
+#include <bpf/bpf_helpers.h>
+#include <bpf/bpf_tracing.h>
+#include <bpf/bpf_core_read.h>
+#include "net_flow_comm.h"
+
+#define NSEC_PER_USEC 1000
+#define TCP_DOFF_OFFSET 12 // byte of the tcp header holding doff in the high 4 bits
+
+/*
+* Histograms of the last period by pid, counted per cpu and drained by userspace like flowDelta.
+* rtt and retransmits happen in softirq, they are counted for the owner recorded in sockOwner.
+* The map is preallocated for every possible cpu, it is sized to the processes doing tcp in one period.
+*/
+struct {
+    __uint(type, BPF_MAP_TYPE_PERCPU_HASH);
+    __uint(max_entries, 512);
+    __type(key, __u32);
+    __type(value, struct LatencyHist);
+} latencyHist SEC(".maps");
+
+// sock to the last process which sent or received on it, removed when the sock is freed
+struct {
+    __uint(type, BPF_MAP_TYPE_LRU_HASH);
+    __uint(max_entries, 65536);
+    __type(key, __u64);
+    __type(value, struct ThreadData);
+} sockOwner SEC(".maps");
+
+// skb to the time it was passed to tcp, segments merged into the tail of the queue are evicted by lru
+struct {
+    __uint(type, BPF_MAP_TYPE_LRU_HASH);
+    __uint(max_entries, 65536);
+    __type(key, __u64);
+    __type(value, struct SkbQueued);
+} skbQueued SEC(".maps");
+
+static __always_inline void UpdateThreadData(struct ThreadData *td)
+{
+    td->pid = bpf_get_current_pid_tgid() >> 32;
+    td->tid = (u32)bpf_get_current_pid_tgid();
+    bpf_get_current_comm(&td->comm, sizeof(td->comm));
+}
+
+static __always_inline __u32 Log2Slot(__u64 v)
+{
+    __u32 slot = 0;
+    __u32 shift;
+    shift = (v > 0xFFFFFFFF) << 5;
+    v >>= shift;
+    slot |= shift;
+    shift = (v > 0xFFFF) << 4;
+    v >>= shift;
+    slot |= shift;
+    shift = (v > 0xFF) << 3;
+    v >>= shift;
+    slot |= shift;
+    shift = (v > 0xF) << 2;
+    v >>= shift;
+    slot |= shift;
+    shift = (v > 0x3) << 1;
+    v >>= shift;
+    slot |= shift;
+    slot |= (v >> 1);
+    return slot < NET_LATENCY_SLOTS ? slot : NET_LATENCY_SLOTS - 1;
+}
+
+static __always_inline struct LatencyHist *GetHist(struct ThreadData *td)
+{
+    __u32 pid = td->pid;
+    if (pid == 0) {
+        return NULL;
+    }
+    struct LatencyHist *hist = bpf_map_lookup_elem(&latencyHist, &pid);
+    if (hist) {
+        return hist;
+    }
+    struct LatencyHist init = {};
+    init.td = *td;
+    bpf_map_update_elem(&latencyHist, &pid, &init, BPF_NOEXIST);
+    // created by this cpu or another one at the same time, either way the slot of this cpu is usable
+    return bpf_map_lookup_elem(&latencyHist, &pid);
+}
+
+static __always_inline void SetOwner(struct sock *sk)
+{
+    __u64 key = (__u64)sk;
+    struct ThreadData td = {};
+    UpdateThreadData(&td);
+    struct ThreadData *owner = bpf_map_lookup_elem(&sockOwner, &key);
+    if (owner && owner->pid == td.pid) {
+        return;
+    }
+    bpf_map_update_elem(&sockOwner, &key, &td, BPF_ANY);
+}
+
+SEC("kprobe/tcp_sendmsg")
+int BPF_KPROBE(tcp_sendmsg, struct sock *sk)
+{
+    SetOwner(sk);
+    return 0;
+}
+
+SEC("kprobe/tcp_recvmsg")
+int BPF_KPROBE(tcp_recvmsg, struct sock *sk)
+{
+    SetOwner(sk);
+    return 0;
+}
+
+// the address of a freed sock is reused by new socks, which must not be counted for the old owner
+SEC("kprobe/inet_sock_destruct")
+int BPF_KPROBE(inet_sock_destruct, struct sock *sk)
+{
+    __u64 key = (__u64)sk;
+    bpf_map_delete_elem(&sockOwner, &key);
+    return 0;
+}
+
+SEC("kprobe/tcp_rcv_established")
+int BPF_KPROBE(tcp_rcv_established, struct sock *sk, struct sk_buff *skb)
+{
+    __u64 key = (__u64)sk;
+    struct ThreadData *owner = bpf_map_lookup_elem(&sockOwner, &key);
+    if (!owner) {
+        return 0;
+    }
+    struct tcp_sock *tp = (struct tcp_sock *)sk;
+    // srtt_us is kept left shifted by 3
+    __u32 srtt = BPF_CORE_READ(tp, srtt_us) >> 3;
+    struct LatencyHist *hist = GetHist(owner);
+    if (hist && srtt != 0) {
+        hist->rttUs[Log2Slot(srtt) & (NET_LATENCY_SLOTS - 1)]++;
+    }
+    // skb->data points to the tcp header, pure acks are never read and not recorded
+    unsigned char *data = BPF_CORE_READ(skb, data);
+    __u32 len = BPF_CORE_READ(skb, len);
+    __u8 doff = 0;
+    bpf_probe_read_kernel(&doff, sizeof(doff), data + TCP_DOFF_OFFSET);
+    if (len <= (__u32)(doff >> 4) * 4) {
+        return 0;
+    }
+    __u64 skbKey = (__u64)skb;
+    struct SkbQueued queued = { .ns = bpf_ktime_get_ns(), .sk = key };
+    bpf_map_update_elem(&skbQueued, &skbKey, &queued, BPF_ANY);
+    return 0;
+}
+
+SEC("kprobe/skb_copy_datagram_iter")
+int BPF_KPROBE(skb_copy_datagram_iter, const struct sk_buff *skb)
+{
+    __u64 skbKey = (__u64)skb;
+    struct SkbQueued *queued = bpf_map_lookup_elem(&skbQueued, &skbKey);
+    if (!queued) {
+        return 0;
+    }
+    // the address may have been reused by an skb of another socket since it was recorded
+    __u64 sk = (__u64)BPF_CORE_READ(skb, sk);
+    __u64 now = bpf_ktime_get_ns();
+    if (sk == queued->sk && now > queued->ns) {
+        struct ThreadData td = {};
+        UpdateThreadData(&td);
+        struct LatencyHist *hist = GetHist(&td);
+        if (hist) {
+            hist->rcvQueUs[Log2Slot((now - queued->ns) / NSEC_PER_USEC) & (NET_LATENCY_SLOTS - 1)]++;
+        }
+    }
+    // a segment read in several calls is counted at the first one
+    bpf_map_delete_elem(&skbQueued, &skbKey);
+    return 0;
+}
+
+SEC("tracepoint/tcp/tcp_retransmit_skb")
+int tcp_retransmit_skb(struct trace_event_raw_tcp_event_sk_skb *ctx)
+{
+    __u64 key = (__u64)ctx->skaddr;
+    struct ThreadData *owner = bpf_map_lookup_elem(&sockOwner, &key);
+    if (!owner) {
+        return 0;
+    }
+    struct LatencyHist *hist = GetHist(owner);
+    if (hist) {
+        hist->retrans++;
+    }
+    return 0;
+}
+
+char _license[] SEC("license") = "GPL";
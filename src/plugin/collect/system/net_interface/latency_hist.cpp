@@ -0,0 +1,67 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "latency_hist.h"
+#include <cmath>
+
+namespace oeaware {
+constexpr int UINT64_BITS = 64;
+
+int HistSlot(uint64_t value, int slots)
+{
+    int slot = 0;
+    while (value > 1) {
+        value >>= 1;
+        slot++;
+    }
+    return slot < slots ? slot : slots - 1;
+}
+
+void AddHist(uint64_t *sum, const uint64_t *hist, int slots)
+{
+    for (int i = 0; i < slots; ++i) {
+        sum[i] += hist[i];
+    }
+}
+
+uint64_t HistCount(const uint64_t *hist, int slots)
+{
+    uint64_t count = 0;
+    for (int i = 0; i < slots; ++i) {
+        count += hist[i];
+    }
+    return count;
+}
+
+uint64_t HistPercentile(const uint64_t *hist, int slots, double p)
+{
+    uint64_t count = HistCount(hist, slots);
+    if (count == 0 || slots <= 0) {
+        return 0;
+    }
+    // rank of the sample, at least the first one
+    uint64_t rank = static_cast<uint64_t>(std::ceil(p * count));
+    rank = rank == 0 ? 1 : rank;
+    uint64_t seen = 0;
+    int slot = slots - 1;
+    for (int i = 0; i < slots; ++i) {
+        seen += hist[i];
+        if (seen >= rank) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot == slots - 1) {
+        return slot == 0 ? 0 : 1ULL << slot;
+    }
+    return slot + 1 >= UINT64_BITS ? UINT64_MAX : (1ULL << (slot + 1)) - 1;
+}
+}
@@ -0,0 +1,31 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef OEAWARE_LATENCY_HIST_H
+#define OEAWARE_LATENCY_HIST_H
+
+#include <cstdint>
+
+namespace oeaware {
+/*
+ * log2 histograms as counted by net_latency_kernel, slot 0 counts [0, 2), slot i counts [2^i, 2^(i+1)),
+ * the last slot has no upper bound.
+ */
+// slot of a value, the same as Log2Slot in the kernel
+int HistSlot(uint64_t value, int slots);
+void AddHist(uint64_t *sum, const uint64_t *hist, int slots);
+uint64_t HistCount(const uint64_t *hist, int slots);
+// upper bound of the slot holding the p quantile (0 < p <= 1), the lower bound for the last slot,
+// 0 for an empty histogram
+uint64_t HistPercentile(const uint64_t *hist, int slots, double p);
+}
+
+#endif
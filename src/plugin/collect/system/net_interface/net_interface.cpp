@@ -12,16 +12,35 @@
 #include "net_interface.h"
 #include <iostream>
 #include <cstdint>
+#include <cerrno>
+#include <cstring>
 #include <arpa/inet.h>
+#include <bpf/bpf.h>
 #include <bpf/libbpf.h>
 #include <bpf/libbpf_common.h>
 #include <net/if.h>
 #include <sys/resource.h>
 #include "ebpf/net_flow.skel.h"
+#include "ebpf/net_latency.skel.h"
+#include "latency_hist.h"
 
 constexpr int UINT32_BIT_LEN = 32;
 constexpr uint64_t UINT32_MASK = 0xFFFFFFFFULL;
 constexpr uint64_t TIME_STR_LEN = 20;
+// entries read by one lookup_and_delete_batch call
+constexpr uint32_t MAP_BATCH_SIZE = 256;
+constexpr size_t PERCPU_VALUE_ALIGN = 8;
+constexpr double LATENCY_P50 = 0.5;
+constexpr double LATENCY_P99 = 0.99;
+static_assert(NET_LATENCY_SLOTS == OE_NET_LATENCY_SLOTS, "latency slots of kernel and topic differ");
+
+// size of one entry of a per-cpu map in userspace, the value of every cpu is aligned to 8 bytes
+static size_t PercpuValueSize(const struct bpf_map *map, int cpuNum)
+{
+    size_t size = bpf_map__value_size(map);
+    return (size + PERCPU_VALUE_ALIGN - 1) / PERCPU_VALUE_ALIGN * PERCPU_VALUE_ALIGN * cpuNum;
+}
+
 // Used to uniquely determine the packet receiving information of an interrupt on a thread
 struct ThreadQueKey {
     uint32_t tid;
@@ -47,6 +66,31 @@ namespace std {
     };
 }
 
+// two pid as a unique key
+static uint64_t PidPair(uint32_t pid1, uint32_t pid2)
+{
+    return pid1 < pid2 ? static_cast<uint64_t>(pid1) << UINT32_BIT_LEN | static_cast<uint64_t>(pid2)
+        : static_cast<uint64_t>(pid2) << UINT32_BIT_LEN | static_cast<uint64_t>(pid1);
+}
+
+static bool IsValidFlow(const SockInfo &value)
+{
+    return value.flow != 0 && value.client.pid != 0 && value.server.pid != 0 && value.client.pid != value.server.pid;
+}
+
+// aggregating elements of the same (tid, ifindex, queueId)
+static void AddThreadQueue(std::unordered_map<ThreadQueKey, QueueInfo> &threadQueMap, const QueueInfo &queInfo)
+{
+    ThreadQueKey queKey = { .tid = queInfo.td.tid, .ifindex = queInfo.ifIdx, .queueId = queInfo.queueId };
+    auto it = threadQueMap.find(queKey);
+    if (it == threadQueMap.end()) {
+        threadQueMap[queKey] = queInfo;
+    } else {
+        it->second.times += queInfo.times;
+        it->second.len += queInfo.len;
+    }
+}
+
 /* use this function to filter publish data */
 bool IfTopicParamsData(const std::string &params, const NetIntfBaseInfo &info)
 {
@@ -104,6 +148,14 @@ oeaware::Result NetInterface::OpenTopic(const oeaware::Topic &topic)
         }
     }
 
+    if (topic.topicName == OE_NET_FLOW_LATENCY) {
+        if (topic.params == OE_PARA_PID_LATENCY && !OpenNetLatency()) {
+            return oeaware::Result(FAILED, "open net latency failed");
+        } else if (topic.params == OE_PARA_NET_LATENCY_USER_DEBUG) {
+            debugCtl[topic.params] = true;
+        }
+    }
+
     netTopicInfo[topic.topicName].openedParams.insert(topic.params);
     return oeaware::Result(OK);
 }
@@ -135,6 +187,13 @@ void NetInterface::CloseTopic(const oeaware::Topic &topic)
             debugCtl[topic.params] = false;
         }
     }
+    if (topic.topicName == OE_NET_FLOW_LATENCY) {
+        if (topic.params == OE_PARA_PID_LATENCY) {
+            CloseNetLatency();
+        } else if (topic.params == OE_PARA_NET_LATENCY_USER_DEBUG) {
+            debugCtl[topic.params] = false;
+        }
+    }
 }
 
 void NetInterface::UpdateData(const DataList &dataList)
@@ -153,7 +212,13 @@ static void UpdateNetIntfBaseInfo(std::unordered_map<int, NetIntfBaseInfo> &info
 
 oeaware::Result NetInterface::Enable(const std::string &param)
 {
-    (void)param;
+    netFlowCtl.eventMode = false;
+    for (auto &p : oeaware::GetKeyValueFromString(param)) {
+        if (p.first != "mode" || (p.second != "event" && p.second != "poll")) {
+            return oeaware::Result(FAILED, "params (" + p.first + ":" + p.second + ") invalid.");
+        }
+        netFlowCtl.eventMode = (p.second == "event");
+    }
     UpdateNetIntfBaseInfo(netIntfBaseInfo);
     return oeaware::Result(OK);
 }
@@ -183,6 +248,8 @@ void NetInterface::Run()
                 PublishLocalNetAffiInfo(param);
             } else if (topic == OE_NET_THREAD_QUE_DATA) {
                 PublishNetQueueInfo(param, interval);
+            } else if (topic == OE_NET_FLOW_LATENCY) {
+                PublishNetLatencyInfo(param, interval);
             }
         }
     }
@@ -202,6 +269,8 @@ void NetInterface::InitTopicInfo(const std::string &name)
     } else if (name == OE_NET_THREAD_QUE_DATA) {
         netTopicInfo[name].supportParams = { OE_PARA_THREAD_RECV_QUE_CNT,
             OE_PARA_NET_RECV_QUE_USER_DEBUG, OE_PARA_NET_RECV_QUE_KERN_DEBUG };
+    } else if (name == OE_NET_FLOW_LATENCY) {
+        netTopicInfo[name].supportParams = { OE_PARA_PID_LATENCY, OE_PARA_NET_LATENCY_USER_DEBUG };
     }
 }
 
@@ -354,6 +423,37 @@ void NetInterface::PublishNetQueueInfo(const std::string &params, const int &int
     Publish(dataList);
 }
 
+void NetInterface::PublishNetLatencyInfo(const std::string &params, const int &interval)
+{
+    if (params != OE_PARA_PID_LATENCY) {
+        return;
+    }
+    std::vector<LatencyHist> latency;
+    ReadNetLatency(latency);
+    if (latency.empty()) {
+        return;
+    }
+    DataList dataList;
+    oeaware::SetDataListTopic(&dataList, OE_NET_INTF_INFO, OE_NET_FLOW_LATENCY, params);
+    dataList.len = 1;
+    dataList.data = new void *[1];
+    NetFlowLatencyDataList *data = new NetFlowLatencyDataList;
+
+    data->count = latency.size();
+    data->intervalMs = interval;
+    data->latency = new NetFlowLatencyData[data->count];
+    for (size_t i = 0; i < latency.size(); ++i) {
+        auto &item = data->latency[i];
+        item.pid = latency[i].td.pid;
+        strncpy_s(item.comm, sizeof(item.comm), latency[i].td.comm, sizeof(latency[i].td.comm) - 1);
+        item.retrans = latency[i].retrans;
+        std::copy(latency[i].rttUs, latency[i].rttUs + OE_NET_LATENCY_SLOTS, item.rttUs);
+        std::copy(latency[i].rcvQueUs, latency[i].rcvQueUs + OE_NET_LATENCY_SLOTS, item.rcvQueUs);
+    }
+    dataList.data[0] = data;
+    Publish(dataList);
+}
+
 bool NetInterface::AttachTcProgram(struct net_flow_kernel *obj, std::string name, int ifindex)
 {
     // warning: don't count(name), because the nic may have the same name after being deleted
@@ -402,22 +502,40 @@ bool NetInterface::OpenNetFlow(const std::string &topicName)
     }
 
     int err;
-    struct net_flow_kernel *obj = net_flow_kernel__open_and_load();
+    struct net_flow_kernel *obj = net_flow_kernel__open();
     if (!obj) {
         ERROR(logger, "Failed to open net_flow BPF object");
         return false;
     }
+    obj->rodata->eventMode = netFlowCtl.eventMode ? 1 : 0;
+    err = net_flow_kernel__load(obj);
+    if (err) {
+        ERROR(logger, "Failed to load net_flow BPF object: " << err);
+        net_flow_kernel__destroy(obj);
+        return false;
+    }
     err = net_flow_kernel__attach(obj);
     if (err) {
         ERROR(logger, "Failed to attach BPF programs: " << err);
+        net_flow_kernel__destroy(obj);
         return false;
     }
+    if (netFlowCtl.eventMode) {
+        netFlowCtl.rb = ring_buffer__new(bpf_map__fd(obj->maps.netEvents), HandleNetEvent, this, NULL);
+        if (!netFlowCtl.rb) {
+            ERROR(logger, "Failed to create net event ring buffer, " << -errno);
+            net_flow_kernel__destroy(obj);
+            return false;
+        }
+    }
     for (auto &item : netIntfBaseInfo) {
         if (!AttachTcProgram(obj, item.second.name, item.second.ifindex)) {
             ERROR(logger, "Failed to attach TC program to " << item.second.name);
         }
     }
     if (netFlowCtl.netDevHooks.empty()) {
+        ring_buffer__free(netFlowCtl.rb);
+        netFlowCtl.rb = nullptr;
         net_flow_kernel__destroy(obj);
         return false;
     }
@@ -426,22 +544,173 @@ bool NetInterface::OpenNetFlow(const std::string &topicName)
     return true;
 }
 
+int NetInterface::DrainPercpuMap(struct bpf_map *map, const PercpuHandler &handle)
+{
+    int cpuNum = libbpf_num_possible_cpus();
+    if (cpuNum <= 0) {
+        return 0;
+    }
+    if (!netFlowCtl.batchSupported) {
+        return DrainPercpuMapByKey(map, handle);
+    }
+    int fd = bpf_map__fd(map);
+    size_t keySize = bpf_map__key_size(map);
+    size_t valueSize = PercpuValueSize(map, cpuNum);
+    std::vector<char> keys(keySize * MAP_BATCH_SIZE);
+    std::vector<char> values(valueSize * MAP_BATCH_SIZE);
+    DECLARE_LIBBPF_OPTS(bpf_map_batch_opts, opts, .elem_flags = 0, .flags = 0);
+    // hash maps use the bucket index as batch position
+    uint32_t inBatch = 0;
+    uint32_t outBatch = 0;
+    bool first = true;
+    int total = 0;
+    while (true) {
+        uint32_t count = MAP_BATCH_SIZE;
+        int err = bpf_map_lookup_and_delete_batch(fd, first ? nullptr : &inBatch, &outBatch, keys.data(),
+            values.data(), &count, &opts);
+        err = err < 0 ? errno : 0;
+        if (err != 0 && err != ENOENT) {
+            if (first) {
+                WARN(logger, "lookup_and_delete_batch is not supported(" << err << "), read " <<
+                    bpf_map__name(map) << " key by key.");
+                netFlowCtl.batchSupported = false;
+                return DrainPercpuMapByKey(map, handle);
+            }
+            ERROR(logger, "Failed to read " << bpf_map__name(map) << ", err: " << err);
+            break;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            handle(keys.data() + i * keySize, values.data() + i * valueSize, cpuNum);
+        }
+        total += count;
+        if (err == ENOENT) {
+            break;
+        }
+        inBatch = outBatch;
+        first = false;
+    }
+    return total;
+}
+
+int NetInterface::DrainPercpuMapByKey(struct bpf_map *map, const PercpuHandler &handle)
+{
+    int cpuNum = libbpf_num_possible_cpus();
+    if (cpuNum <= 0) {
+        return 0;
+    }
+    int fd = bpf_map__fd(map);
+    size_t keySize = bpf_map__key_size(map);
+    std::vector<char> keys;
+    std::vector<char> key(keySize);
+    const void *prev = nullptr;
+    while (bpf_map_get_next_key(fd, prev, key.data()) == 0) {
+        keys.insert(keys.end(), key.begin(), key.end());
+        prev = keys.data() + keys.size() - keySize;
+    }
+    std::vector<char> values(PercpuValueSize(map, cpuNum));
+    int total = 0;
+    for (size_t off = 0; off < keys.size(); off += keySize) {
+        if (bpf_map_lookup_elem(fd, keys.data() + off, values.data()) != 0) {
+            continue;
+        }
+        bpf_map_delete_elem(fd, keys.data() + off);
+        handle(keys.data() + off, values.data(), cpuNum);
+        total++;
+    }
+    return total;
+}
+
+int NetInterface::HandleNetEvent(void *ctx, void *data, size_t size)
+{
+    if (size < sizeof(NetEvent)) {
+        return 0;
+    }
+    NetEvent event;
+    memcpy(&event, data, sizeof(event));
+    static_cast<NetInterface *>(ctx)->OnNetEvent(event);
+    return 0;
+}
+
+void NetInterface::OnNetEvent(const NetEvent &event)
+{
+    netFlowCtl.eventNum++;
+    if (event.type == NET_EVENT_FLOW) {
+        if (netFlowCtl.openTopic.count(OE_LOCAL_NET_AFFINITY) && IsValidFlow(event.flow)) {
+            netFlowCtl.eventFlow[PidPair(event.flow.server.pid, event.flow.client.pid)] += event.flow.flow;
+        }
+    } else if (event.type == NET_EVENT_QUEUE) {
+        if (netFlowCtl.openTopic.count(OE_NET_THREAD_QUE_DATA) && event.queue.ifIdx > 0) {
+            netFlowCtl.eventQueue.emplace_back(event.queue);
+        }
+    } else if (debugCtl[OE_PARA_LOC_NET_AFFI_USER_DEBUG] || debugCtl[OE_PARA_NET_RECV_QUE_USER_DEBUG]) {
+        const SockKey &key = event.key;
+        INFO(logger, "NetInterface::OnNetEvent: " << (event.type == NET_EVENT_OPEN ? "open " : "close ")
+            << key.localIp << ":" << key.localPort << " <-> " << key.remoteIp << ":" << key.remotePort);
+    }
+}
+
+void NetInterface::PollNetEvents()
+{
+    uint64_t eventNum = netFlowCtl.eventNum;
+    int err = ring_buffer__poll(netFlowCtl.rb, 0);
+    if (err < 0) {
+        ERROR(logger, "Failed to poll net event ring buffer, " << err);
+    }
+    if (debugCtl[OE_PARA_LOC_NET_AFFI_USER_DEBUG] || debugCtl[OE_PARA_NET_RECV_QUE_USER_DEBUG]) {
+        struct net_flow_kernel *obj = (struct net_flow_kernel *)netFlowCtl.skel;
+        INFO(logger, "PollNetEvents events: " << netFlowCtl.eventNum - eventNum << ", dropped: "
+            << obj->bss->droppedEvents);
+    }
+}
+
+void NetInterface::CheckDroppedDeltas()
+{
+    struct net_flow_kernel *obj = (struct net_flow_kernel *)netFlowCtl.skel;
+    // packets not counted because a delta map is full
+    uint64_t dropped = obj->bss->droppedDeltas;
+    if (dropped != netFlowCtl.droppedDeltas) {
+        WARN(logger, "net flow deltas dropped: " << dropped - netFlowCtl.droppedDeltas << ", total: " << dropped);
+        netFlowCtl.droppedDeltas = dropped;
+    }
+    // deltas flushed by the kernel but lost because the ring buffer is full
+    dropped = obj->bss->droppedEvents;
+    if (dropped != netFlowCtl.droppedEvents) {
+        WARN(logger, "net flow events dropped: " << dropped - netFlowCtl.droppedEvents << ", total: " << dropped);
+        netFlowCtl.droppedEvents = dropped;
+    }
+}
+
 void NetInterface::ReadFlow(std::unordered_map<uint64_t, uint64_t> &flowData)
 {
+    // events only carry deltas which reached the flush threshold, the rest is still in flowDelta.
+    if (netFlowCtl.rb) {
+        PollNetEvents();
+        flowData.swap(netFlowCtl.eventFlow);
+        netFlowCtl.eventFlow.clear();
+    }
     struct net_flow_kernel *obj = (struct net_flow_kernel *)netFlowCtl.skel;
-    struct SockKey key, nextKey;
-    struct SockInfo value;
-    int err;
-    struct bpf_map *map = obj->maps.flowStats;
-    int allkeyNum = 0;
+    struct bpf_map *map = obj->maps.flowDelta;
+    size_t stride = PercpuValueSize(map, 1);
     int validKeyNum = 0;
 
-    err = bpf_map__get_next_key(map, NULL, &key, sizeof(SockKey));
-    while (!err) {
-        allkeyNum++;
-        if (bpf_map__lookup_elem(map, &key, bpf_map__key_size(map), &value, bpf_map__value_size(map), 0)) {
-            break;
+    int allkeyNum = DrainPercpuMap(map, [&](const void *keyData, const char *values, int cpuNum) {
+        struct SockKey key;
+        struct SockInfo value;
+        memcpy(&key, keyData, sizeof(key));
+        // take the owner from a cpu which counted packets, add up the bytes of all cpus
+        uint64_t flow = 0;
+        memset(&value, 0, sizeof(value));
+        for (int cpu = 0; cpu < cpuNum; ++cpu) {
+            const SockInfo *cpuValue = reinterpret_cast<const SockInfo *>(values + cpu * stride);
+            if (cpuValue->flow == 0) {
+                continue;
+            }
+            if (value.client.pid == 0 || value.server.pid == 0) {
+                value = *cpuValue;
+            }
+            flow += cpuValue->flow;
         }
+        value.flow = flow;
         if (debugCtl[OE_PARA_LOC_NET_AFFI_USER_DEBUG]) {
             INFO(logger, "NetInterface::ReadFlow: ("
                 << inet_ntoa(*reinterpret_cast<struct in_addr *>(&key.localIp)) << ") "
@@ -451,26 +720,13 @@ void NetInterface::ReadFlow(std::unordered_map<uint64_t, uint64_t> &flowData)
                 << value.client.comm << " " << value.client.pid << " <-> "
                 << value.server.comm << " " << value.server.pid);
         }
-        if (value.flow == 0 || value.client.pid == 0 || value.server.pid == 0 ||
-            (value.client.pid == value.server.pid)) {
-            err = bpf_map__get_next_key(map, &key, &nextKey, sizeof(SockKey));
-            key = nextKey;
-            continue;
+        if (!IsValidFlow(value)) {
+            return;
         }
         validKeyNum++;
-        uint64_t lastFlow = netFlowCtl.lastSockFlow[key];
-        // a new sock flow which has same 4 ntuple, the value.flow may small than lastFlow
-        uint64_t diffFlow = value.flow > lastFlow ? value.flow - lastFlow : value.flow;
-        netFlowCtl.lastSockFlow[key] = value.flow;
-        // two pid as a unique key
-        uint32_t pid1 = value.server.pid;
-        uint32_t pid2 = value.client.pid;
-        uint64_t pidPair = pid1 < pid2 ? static_cast<uint64_t>(pid1) << UINT32_BIT_LEN | static_cast<uint64_t>(pid2)
-            : static_cast<uint64_t>(pid2) << UINT32_BIT_LEN | static_cast<uint64_t>(pid1);
-        flowData[pidPair] += diffFlow;
-        err = bpf_map__get_next_key(map, &key, &nextKey, sizeof(SockKey));
-        key = nextKey;
-    }
+        flowData[PidPair(value.server.pid, value.client.pid)] += value.flow;
+    });
+    CheckDroppedDeltas();
     if (debugCtl[OE_PARA_LOC_NET_AFFI_USER_DEBUG]) {
         INFO(logger, "ReadFlow allkeyNum: " << allkeyNum << ", validKeyNum: " << validKeyNum << ", flowData size: " << flowData.size());
     }
@@ -478,22 +734,37 @@ void NetInterface::ReadFlow(std::unordered_map<uint64_t, uint64_t> &flowData)
 
 void NetInterface::ReadNetQueue(std::vector<QueueInfo> &threadQueData)
 {
+    std::unordered_map<ThreadQueKey, QueueInfo> threadQueMap; // every element is a unique (thread + queue)
+    if (netFlowCtl.rb) {
+        PollNetEvents();
+        for (const auto &queInfo : netFlowCtl.eventQueue) {
+            AddThreadQueue(threadQueMap, queInfo);
+        }
+        netFlowCtl.eventQueue.clear();
+    }
     struct net_flow_kernel *obj = (struct net_flow_kernel *)netFlowCtl.skel;
-    struct SockKey key;
-    struct SockKey nextKey;
-    struct QueueInfo queInfo;
-    int err;
-    struct bpf_map *map = obj->maps.rcvQueStatus;
-    int allkeyNum = 0;
+    struct bpf_map *map = obj->maps.queDelta;
+    size_t stride = PercpuValueSize(map, 1);
     int validKeyNum = 0;
 
-    std::unordered_map<ThreadQueKey, QueueInfo> threadQueMap; // every element is a unique (thread + queue)
-    err = bpf_map__get_next_key(map, NULL, &key, sizeof(SockKey));
-    while (!err) {
-        allkeyNum++;
-        if (bpf_map__lookup_elem(map, &key, bpf_map__key_size(map), &queInfo, bpf_map__value_size(map), 0)) {
-            break;
+    int allkeyNum = DrainPercpuMap(map, [&](const void *keyData, const char *values, int cpuNum) {
+        struct SockKey key;
+        struct QueueInfo queInfo;
+        memcpy(&key, keyData, sizeof(key));
+        // the queue is the one of the cpu which received most packets
+        uint64_t times = 0;
+        uint64_t len = 0;
+        memset(&queInfo, 0, sizeof(queInfo));
+        for (int cpu = 0; cpu < cpuNum; ++cpu) {
+            const QueueInfo *cpuValue = reinterpret_cast<const QueueInfo *>(values + cpu * stride);
+            if (cpuValue->times > queInfo.times) {
+                queInfo = *cpuValue;
+            }
+            times += cpuValue->times;
+            len += cpuValue->len;
         }
+        queInfo.times = times;
+        queInfo.len = len;
         if (debugCtl[OE_PARA_NET_RECV_QUE_USER_DEBUG]) {
             INFO(logger, "NetInterface::ReadNetQueue: ("
                 << inet_ntoa(*reinterpret_cast<struct in_addr *>(&key.localIp)) << ") "
@@ -504,41 +775,93 @@ void NetInterface::ReadNetQueue(std::vector<QueueInfo> &threadQueData)
                 << queInfo.td.tid << ", ifIdx " << queInfo.ifIdx << ", queId " << queInfo.queueId
                 << ", times " << queInfo.times << ", len " << queInfo.len);
         }
-        if (queInfo.ifIdx <= 0) {
-            err = bpf_map__get_next_key(map, &key, &nextKey, sizeof(SockKey));
-            key = nextKey;
-            continue;
+        if (queInfo.ifIdx <= 0 || queInfo.times == 0) {
+            return;
         }
         validKeyNum++;
-        uint64_t lastQueTimes = netFlowCtl.lastQueTimes[key];
-        uint64_t lastQueLen = netFlowCtl.lastQueLen[key];
-        netFlowCtl.lastQueTimes[key] = queInfo.times;
-        netFlowCtl.lastQueLen[key] = queInfo.len;
-        // a new sock flow which has same 4 ntuple, the queInfo.times may small than lastQueTimes
-        if (queInfo.times > lastQueTimes) {
-            queInfo.times -= lastQueTimes;
-            queInfo.len -= lastQueLen;
-        }
-        // aggregating elements of the same (tid, ifindex, queueId)
-        ThreadQueKey queKey = { .tid = queInfo.td.tid, .ifindex = queInfo.ifIdx, .queueId = queInfo.queueId };
-        if (!threadQueMap.count(queKey)) {
-            threadQueMap[queKey] = queInfo;
-        } else {
-            threadQueMap[queKey].times += queInfo.times;
-            threadQueMap[queKey].len += queInfo.len;
-        }
-        err = bpf_map__get_next_key(map, &key, &nextKey, sizeof(SockKey));
-        key = nextKey;
-    }
+        AddThreadQueue(threadQueMap, queInfo);
+    });
     for (const auto &it : threadQueMap) {
         threadQueData.emplace_back(it.second);
     }
+    CheckDroppedDeltas();
     if (debugCtl[OE_PARA_NET_RECV_QUE_USER_DEBUG]) {
         INFO(logger, "ReadNetQueue allkeyNum: " << allkeyNum << ", validKeyNum: " << validKeyNum
             << ", threadQueData size: " << threadQueData.size());
     }
 }
 
+bool NetInterface::OpenNetLatency()
+{
+    if (latencySkel) {
+        return true;
+    }
+    struct net_latency_kernel *obj = net_latency_kernel__open_and_load();
+    if (!obj) {
+        ERROR(logger, "Failed to open and load net_latency BPF object");
+        return false;
+    }
+    int err = net_latency_kernel__attach(obj);
+    if (err) {
+        ERROR(logger, "Failed to attach net_latency BPF programs: " << err);
+        net_latency_kernel__destroy(obj);
+        return false;
+    }
+    latencySkel = obj;
+    return true;
+}
+
+void NetInterface::CloseNetLatency()
+{
+    struct net_latency_kernel *obj = (struct net_latency_kernel *)latencySkel;
+    if (obj) {
+        net_latency_kernel__detach(obj);
+        net_latency_kernel__destroy(obj);
+        latencySkel = nullptr;
+    }
+}
+
+void NetInterface::ReadNetLatency(std::vector<LatencyHist> &latency)
+{
+    struct net_latency_kernel *obj = (struct net_latency_kernel *)latencySkel;
+    if (!obj) {
+        return;
+    }
+    struct bpf_map *map = obj->maps.latencyHist;
+    size_t stride = PercpuValueSize(map, 1);
+
+    int allkeyNum = DrainPercpuMap(map, [&](const void *keyData, const char *values, int cpuNum) {
+        (void)keyData;
+        // the owner is filled in by the cpus which counted, the slots of the other cpus are zero
+        struct LatencyHist hist;
+        memset(&hist, 0, sizeof(hist));
+        for (int cpu = 0; cpu < cpuNum; ++cpu) {
+            const LatencyHist *cpuValue = reinterpret_cast<const LatencyHist *>(values + cpu * stride);
+            if (hist.td.pid == 0) {
+                hist.td = cpuValue->td;
+            }
+            hist.retrans += cpuValue->retrans;
+            oeaware::AddHist(hist.rttUs, cpuValue->rttUs, NET_LATENCY_SLOTS);
+            oeaware::AddHist(hist.rcvQueUs, cpuValue->rcvQueUs, NET_LATENCY_SLOTS);
+        }
+        if (debugCtl[OE_PARA_NET_LATENCY_USER_DEBUG]) {
+            INFO(logger, "NetInterface::ReadNetLatency: " << hist.td.comm << ", pid " << hist.td.pid
+                << ", rtt p50 " << oeaware::HistPercentile(hist.rttUs, NET_LATENCY_SLOTS, LATENCY_P50)
+                << "us, p99 " << oeaware::HistPercentile(hist.rttUs, NET_LATENCY_SLOTS, LATENCY_P99)
+                << "us, rcv queue p50 " << oeaware::HistPercentile(hist.rcvQueUs, NET_LATENCY_SLOTS, LATENCY_P50)
+                << "us, p99 " << oeaware::HistPercentile(hist.rcvQueUs, NET_LATENCY_SLOTS, LATENCY_P99)
+                << "us, retrans " << hist.retrans);
+        }
+        if (hist.td.pid == 0) {
+            return;
+        }
+        latency.emplace_back(hist);
+    });
+    if (debugCtl[OE_PARA_NET_LATENCY_USER_DEBUG]) {
+        INFO(logger, "ReadNetLatency allkeyNum: " << allkeyNum << ", latency size: " << latency.size());
+    }
+}
+
 void NetInterface::CloseNetFlow(const std::string &topicName)
 {
     netFlowCtl.openTopic.erase(topicName);
@@ -568,13 +891,15 @@ void NetInterface::CloseNetFlow(const std::string &topicName)
 
     netFlowCtl.netDevHooks.clear();
 
+    ring_buffer__free(netFlowCtl.rb);
+    netFlowCtl.rb = nullptr;
+    netFlowCtl.eventFlow.clear();
+    netFlowCtl.eventQueue.clear();
+    netFlowCtl.droppedDeltas = 0;
+    netFlowCtl.droppedEvents = 0;
     if (obj) {
         net_flow_kernel__detach(obj);
         net_flow_kernel__destroy(obj);
         netFlowCtl.skel = nullptr;
     }
-
-    netFlowCtl.lastQueTimes.clear();
-    netFlowCtl.lastQueLen.clear();
-    netFlowCtl.lastSockFlow.clear();
 }
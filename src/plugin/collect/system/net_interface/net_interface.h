@@ -67,7 +67,7 @@ private:
         std::chrono::time_point<std::chrono::high_resolution_clock> timestamp;
     };
     std::vector<std::string> topicStr = { OE_NETWORK_INTERFACE_BASE_TOPIC,
-        OE_NETWORK_INTERFACE_DRIVER_TOPIC, OE_LOCAL_NET_AFFINITY, OE_NET_THREAD_QUE_DATA };
+        OE_NETWORK_INTERFACE_DRIVER_TOPIC, OE_LOCAL_NET_AFFINITY, OE_NET_THREAD_QUE_DATA, OE_NET_FLOW_LATENCY };
     std::unordered_map<int, NetIntfBaseInfo> netIntfBaseInfo; // key is ifindex
     std::unordered_map<std::string, NetIntTopic> netTopicInfo; // topic name to topic info
     std::unordered_map<std::string, bool> debugCtl;
@@ -76,24 +76,44 @@ private:
     void PublishDriverInfo(const std::string &params);
     void PublishLocalNetAffiInfo(const std::string &params);
     void PublishNetQueueInfo(const std::string &params, const int &interval);
+    void PublishNetLatencyInfo(const std::string &params, const int &interval);
     bool AttachTcProgram(struct net_flow_kernel *obj, std::string name, int ifindex);
     bool OpenNetFlow(const std::string &topicName);
     void CloseNetFlow(const std::string &topicName);
     void ReadFlow(std::unordered_map<uint64_t, uint64_t> &flowData);
     void ReadNetQueue(std::vector<QueueInfo> &threadQueData);
+    bool OpenNetLatency();
+    void CloseNetLatency();
+    void ReadNetLatency(std::vector<LatencyHist> &latency);
+    // key, values of all possible cpus (each aligned to 8 bytes), number of cpus
+    using PercpuHandler = std::function<void(const void *, const char *, int)>;
+    // Read and delete all entries of a per-cpu map, return the number of entries read.
+    int DrainPercpuMap(struct bpf_map *map, const PercpuHandler &handle);
+    int DrainPercpuMapByKey(struct bpf_map *map, const PercpuHandler &handle);
+    static int HandleNetEvent(void *ctx, void *data, size_t size);
+    void OnNetEvent(const NetEvent &event);
+    void PollNetEvents();
+    void CheckDroppedDeltas();
 
     struct NetFlowCtl {
         // ebpf net comm
         void *skel = nullptr;
         std::unordered_map<int, NetDevHook> netDevHooks; // key is ifindex
         std::unordered_set<std::string> openTopic;
-        // local net process info
-        std::unordered_map<SockKey, uint64_t> lastSockFlow;
-        // remote recv queue info
-        std::unordered_map<SockKey, uint64_t> lastQueTimes;
-        std::unordered_map<SockKey, uint64_t> lastQueLen;
-
+        // false if the kernel does not support lookup_and_delete_batch, then maps are read key by key
+        bool batchSupported = true;
+        // event stream mode, enabled by "mode:event", the kernel sends deltas to a ring buffer instead of
+        // userspace reading the maps
+        bool eventMode = false;
+        struct ring_buffer *rb = nullptr;
+        uint64_t eventNum = 0;
+        uint64_t droppedDeltas = 0; // droppedDeltas of the kernel at the last read
+        uint64_t droppedEvents = 0; // droppedEvents of the kernel at the last read
+        std::unordered_map<uint64_t, uint64_t> eventFlow; // pid pair to bytes since the last publish
+        std::vector<QueueInfo> eventQueue;
     } netFlowCtl;
+    // ebpf tcp latency histograms, loaded only while net_flow_latency is open
+    void *latencySkel = nullptr;
 };
 
 #endif // OEAWARE_NET_INTERFACE_H
\ No newline at end of file
@@ -0,0 +1,196 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "sysctl_snapshot.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+constexpr size_t VALUE_BUF_SIZE = 4096;
+constexpr size_t PARALLEL_THRESHOLD = 256;
+constexpr unsigned int MAX_READ_THREADS = 4;
+constexpr int MAX_WALK_DEPTH = 16;
+}
+
+std::string SysctlSnapshot::PathToKey(const std::string &path)
+{
+    std::string key = path;
+    for (auto &c : key) {
+        if (c == '.') {
+            c = '/';
+        } else if (c == '/') {
+            c = '.';
+        }
+    }
+    return key;
+}
+
+void SysctlSnapshot::Walk(int dirFd, const std::string &prefix, std::vector<std::string> &files, int depth)
+{
+    if (depth > MAX_WALK_DEPTH) {
+        close(dirFd);
+        return;
+    }
+    DIR *dir = fdopendir(dirFd);
+    if (dir == nullptr) {
+        close(dirFd);
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        std::string path = prefix.empty() ? entry->d_name : prefix + "/" + entry->d_name;
+        struct stat st;
+        if (fstatat(dirfd(dir), entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            int subFd = openat(dirfd(dir), entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (subFd >= 0) {
+                Walk(subFd, path, files, depth + 1);
+            }
+        } else if (S_ISREG(st.st_mode) && (st.st_mode & S_IRUSR)) {
+            // Write only entries such as vm.compact_memory are skipped like sysctl -a does.
+            files.emplace_back(path);
+        }
+    }
+    closedir(dir);
+}
+
+bool SysctlSnapshot::ReadValue(int rootFd, const std::string &path, std::vector<char> &buf, std::string &value)
+{
+    int fd = openat(rootFd, path.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+    if (fd < 0) {
+        return false;
+    }
+    size_t len = 0;
+    while (true) {
+        if (len == buf.size()) {
+            buf.resize(buf.size() * 2);
+        }
+        ssize_t n = pread(fd, buf.data() + len, buf.size() - len, len);
+        if (n <= 0) {
+            close(fd);
+            if (n < 0) {
+                return false;
+            }
+            break;
+        }
+        len += n;
+    }
+    while (len > 0 && buf[len - 1] == '\n') {
+        --len;
+    }
+    value.assign(buf.data(), len);
+    // Multi-line values are printed by sysctl as several "key = line", keep them in one value.
+    std::replace(value.begin(), value.end(), '\n', ' ');
+    return true;
+}
+
+bool SysctlSnapshot::Refresh()
+{
+    int rootFd = open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (rootFd < 0) {
+        return false;
+    }
+    std::vector<std::string> files;
+    int walkFd = dup(rootFd);
+    if (walkFd >= 0) {
+        Walk(walkFd, "", files, 0);
+    }
+    std::vector<std::string> values(files.size());
+    std::vector<char> readOk(files.size(), 0);
+    auto readRange = [&](size_t begin, size_t end) {
+        std::vector<char> buf(VALUE_BUF_SIZE);
+        for (size_t i = begin; i < end; ++i) {
+            readOk[i] = ReadValue(rootFd, files[i], buf, values[i]);
+        }
+    };
+    unsigned int threadNum = std::min(std::max(std::thread::hardware_concurrency(), 1U), MAX_READ_THREADS);
+    if (files.size() < PARALLEL_THRESHOLD || threadNum == 1) {
+        readRange(0, files.size());
+    } else {
+        std::vector<std::thread> threads;
+        size_t step = (files.size() + threadNum - 1) / threadNum;
+        for (size_t begin = 0; begin < files.size(); begin += step) {
+            threads.emplace_back(readRange, begin, std::min(files.size(), begin + step));
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+    }
+    close(rootFd);
+
+    uint64_t next = version + 1;
+    bool changed = false;
+    std::unordered_map<std::string, Entry> newEntries;
+    newEntries.reserve(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!readOk[i]) {
+            continue;
+        }
+        std::string key = PathToKey(files[i]);
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second.value == values[i]) {
+            newEntries.emplace(std::move(key), std::move(it->second));
+            continue;
+        }
+        changed = true;
+        newEntries.emplace(std::move(key), Entry{std::move(values[i]), next});
+    }
+    if (newEntries.size() != entries.size()) {
+        changed = true;
+    }
+    entries.swap(newEntries);
+    if (changed) {
+        version = next;
+    }
+    return true;
+}
+
+bool SysctlSnapshot::Get(const std::string &key, std::string &value) const
+{
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return false;
+    }
+    value = it->second.value;
+    return true;
+}
+
+std::vector<std::string> SysctlSnapshot::ChangedSince(uint64_t since, const std::vector<std::string> &prefixes) const
+{
+    std::vector<std::string> keys;
+    for (auto &p : entries) {
+        if (p.second.version <= since) {
+            continue;
+        }
+        bool match = prefixes.empty();
+        for (auto &prefix : prefixes) {
+            if (p.first.compare(0, prefix.size(), prefix) == 0) {
+                match = true;
+                break;
+            }
+        }
+        if (match) {
+            keys.emplace_back(p.first);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
@@ -0,0 +1,51 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef SYSCTL_SNAPSHOT_H
+#define SYSCTL_SNAPSHOT_H
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/*
+ * In-process replacement of "sysctl -a".
+ * Walks /proc/sys with openat and reads every readable entry with pread, large trees are read by several threads.
+ * Every key remembers the snapshot version in which its value last changed, so callers can ask for the keys
+ * changed after a version they have already seen.
+ */
+class SysctlSnapshot {
+public:
+    struct Entry {
+        std::string value;
+        uint64_t version;
+    };
+    explicit SysctlSnapshot(const std::string &root = "/proc/sys") : root(root) { }
+    // Re-read all parameters. Return false if the root can not be opened.
+    bool Refresh();
+    uint64_t GetVersion() const
+    {
+        return version;
+    }
+    bool Get(const std::string &key, std::string &value) const;
+    // Keys whose value was added or changed after "since", sorted by name.
+    std::vector<std::string> ChangedSince(uint64_t since, const std::vector<std::string> &prefixes) const;
+    // "net/ipv4/conf/eth0.100/forwarding" -> "net.ipv4.conf.eth0/100.forwarding", same as sysctl.
+    static std::string PathToKey(const std::string &path);
+private:
+    void Walk(int dirFd, const std::string &prefix, std::vector<std::string> &files, int depth);
+    static bool ReadValue(int rootFd, const std::string &path, std::vector<char> &buf, std::string &value);
+    std::string root;
+    std::unordered_map<std::string, Entry> entries;
+    uint64_t version = 0;
+};
+
+#endif
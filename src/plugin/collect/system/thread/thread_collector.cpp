@@ -11,17 +11,63 @@
  ******************************************************************************/
 #include "thread_collector.h"
 #include <iostream>
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <fstream>
 #include <unordered_map>
+#include <unordered_set>
 #include <csignal>
 #include <dirent.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <ctime>
+#include <numa.h>
 #include <securec.h>
+#include "oeaware/utils.h"
 #include "data_register.h"
 
+namespace {
+const std::string SCHED_STAT_TOPIC = "thread_sched_stat";
+constexpr size_t PROC_BUF_SIZE = 4096;
+
+// Read a small proc file into buf, return false if it can not be read.
+bool ReadProcFile(const std::string &path, char *buf, size_t size)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t len = read(fd, buf, size - 1);
+    close(fd);
+    if (len <= 0) {
+        return false;
+    }
+    buf[len] = '\0';
+    return true;
+}
+
+// Value of "key:  value" in /proc/<pid>/status or "key  :  value" in /proc/<pid>/sched.
+uint64_t FindProcValue(const char *buf, const char *key)
+{
+    const char *pos = strstr(buf, key);
+    if (pos == nullptr) {
+        return 0;
+    }
+    pos += strlen(key);
+    while (*pos == ' ' || *pos == '\t' || *pos == ':') {
+        ++pos;
+    }
+    return strtoull(pos, nullptr, 10);
+}
+
+uint64_t Delta(uint64_t cur, uint64_t last)
+{
+    return cur > last ? cur - last : 0;
+}
+}
+
 #if ENABLE_EBPF
 std::vector<struct thread_event*> ThreadCollector::threadEvents;
 #endif
@@ -38,19 +84,40 @@ ThreadCollector::ThreadCollector()
     topic.instanceName = this->name;
     topic.topicName = this->name;
     supportTopics.push_back(topic);
+    topic.topicName = SCHED_STAT_TOPIC;
+    supportTopics.push_back(topic);
 }
 
 oeaware::Result ThreadCollector::OpenTopic(const oeaware::Topic &topic)
 {
-    (void)topic;
-    openStatus = true;
+    if (topic.topicName != SCHED_STAT_TOPIC) {
+        openStatus = true;
+        return oeaware::Result(OK);
+    }
+    std::vector<int> pids;
+    for (auto &word : oeaware::SplitString(topic.params, " ")) {
+        if (word.empty()) {
+            continue;
+        }
+        if (!oeaware::IsInteger(word)) {
+            return oeaware::Result(FAILED, "params invalid.");
+        }
+        pids.emplace_back(atoi(word.c_str()));
+    }
+    schedStatTopics[topic.params] = pids;
     return oeaware::Result(OK);
 }
 
 void ThreadCollector::CloseTopic(const oeaware::Topic &topic)
 {
-    (void)topic;
-    openStatus = false;
+    if (topic.topicName != SCHED_STAT_TOPIC) {
+        openStatus = false;
+        return;
+    }
+    schedStatTopics.erase(topic.params);
+    if (schedStatTopics.empty()) {
+        schedCounters.clear();
+    }
 }
 
 void ThreadCollector::UpdateData(const DataList &dataList)
@@ -61,6 +128,12 @@ void ThreadCollector::UpdateData(const DataList &dataList)
 oeaware::Result ThreadCollector::Enable(const std::string &param)
 {
     (void)param;
+    int cpuNum = sysconf(_SC_NPROCESSORS_CONF);
+    cpu2Node.assign(cpuNum > 0 ? cpuNum : 0, -1);
+    for (int cpu = 0; cpu < cpuNum && numa_available() >= 0; ++cpu) {
+        cpu2Node[cpu] = numa_node_of_cpu(cpu);
+    }
+    hasSchedFile = access("/proc/self/sched", R_OK) == 0;
 #if ENABLE_EBPF
     // 先初始化一次所有的线程信息，然后打开ebpf追踪线程变化情况
     INFO(logger, "enable ebpf thread collector");
@@ -78,6 +151,8 @@ void ThreadCollector::Disable()
     }
     threads.clear();
     taskTime.clear();
+    schedStatTopics.clear();
+    schedCounters.clear();
 #if ENABLE_EBPF
     CloseThreadTrace();
     threadEvents.clear();
@@ -86,7 +161,7 @@ void ThreadCollector::Disable()
 
 void ThreadCollector::Run()
 {
-    if (!openStatus) return;
+    if (!openStatus && schedStatTopics.empty()) return;
 #if ENABLE_EBPF
     ReadThreadTrace();
     ParseThreadEvent();
@@ -94,6 +169,16 @@ void ThreadCollector::Run()
 #else
     GetAllThreads();
 #endif
+    if (openStatus) {
+        PublishThreadInfo();
+    }
+    if (!schedStatTopics.empty()) {
+        PublishSchedStat();
+    }
+}
+
+void ThreadCollector::PublishThreadInfo()
+{
     DataList dataList;
     dataList.topic.instanceName = new char[name.size() + 1];
     strcpy_s(dataList.topic.instanceName, name.size() + 1, name.data());
@@ -116,6 +201,112 @@ void ThreadCollector::Run()
     Publish(dataList);
 }
 
+bool ThreadCollector::ReadSchedStat(const ThreadInfo &info, ThreadSchedStat &stat, uint64_t now)
+{
+    char buf[PROC_BUF_SIZE];
+    std::string taskPath = "/proc/" + std::to_string(info.pid) + "/task/" + std::to_string(info.tid) + "/";
+    SchedCounter cur;
+    cur.ts = now;
+    // schedstat: run time, wait time, timeslices
+    if (!ReadProcFile(taskPath + "schedstat", buf, sizeof(buf)) ||
+        sscanf_s(buf, "%lu %lu", &cur.runTime, &cur.waitTime) != 2) {
+        return false;
+    }
+    // stat: the comm may contain spaces, so the fields are counted from the last ')', processor is field 39.
+    constexpr int processorIndex = 39 - 3;
+    stat.cpu = -1;
+    if (ReadProcFile(taskPath + "stat", buf, sizeof(buf))) {
+        char *pos = strrchr(buf, ')');
+        char *savePtr = nullptr;
+        char *token = pos == nullptr ? nullptr : strtok_r(pos + 1, " ", &savePtr);
+        for (int i = 0; token != nullptr && i < processorIndex; ++i) {
+            token = strtok_r(nullptr, " ", &savePtr);
+        }
+        if (token != nullptr) {
+            stat.cpu = atoi(token);
+        }
+    }
+    if (ReadProcFile(taskPath + "status", buf, sizeof(buf))) {
+        cur.voluntarySwitches = FindProcValue(buf, "\nvoluntary_ctxt_switches");
+        cur.involuntarySwitches = FindProcValue(buf, "nonvoluntary_ctxt_switches");
+    }
+    if (hasSchedFile && ReadProcFile(taskPath + "sched", buf, sizeof(buf))) {
+        cur.migrations = FindProcValue(buf, "se.nr_migrations");
+    }
+    stat.pid = info.pid;
+    stat.tid = info.tid;
+    strncpy_s(stat.name, THREAD_SCHED_NAME_LEN, info.name, THREAD_SCHED_NAME_LEN - 1);
+    stat.node = (stat.cpu >= 0 && stat.cpu < static_cast<int>(cpu2Node.size())) ? cpu2Node[stat.cpu] : -1;
+    auto it = schedCounters.find(info.tid);
+    if (it == schedCounters.end()) {
+        stat.intervalNs = 0;
+        stat.runTime = 0;
+        stat.waitTime = 0;
+        stat.voluntarySwitches = 0;
+        stat.involuntarySwitches = 0;
+        stat.migrations = 0;
+    } else {
+        auto &last = it->second;
+        stat.intervalNs = Delta(cur.ts, last.ts);
+        stat.runTime = Delta(cur.runTime, last.runTime);
+        stat.waitTime = Delta(cur.waitTime, last.waitTime);
+        stat.voluntarySwitches = Delta(cur.voluntarySwitches, last.voluntarySwitches);
+        stat.involuntarySwitches = Delta(cur.involuntarySwitches, last.involuntarySwitches);
+        stat.migrations = Delta(cur.migrations, last.migrations);
+    }
+    schedCounters[info.tid] = cur;
+    return true;
+}
+
+void ThreadCollector::PublishSchedStat()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+    // only the threads of the requested pids are read, all threads if a topic has no pids
+    bool allThreads = false;
+    std::unordered_set<int> pids;
+    for (auto &p : schedStatTopics) {
+        allThreads = allThreads || p.second.empty();
+        pids.insert(p.second.begin(), p.second.end());
+    }
+    // every thread is read once per period even if several topics contain it
+    std::unordered_map<int, ThreadSchedStat> stats;
+    for (auto &it : threads) {
+        if (!allThreads && !pids.count(it.second->pid)) {
+            continue;
+        }
+        ThreadSchedStat stat = {};
+        if (ReadSchedStat(*it.second, stat, now)) {
+            stats[it.first] = stat;
+        }
+    }
+    for (auto it = schedCounters.begin(); it != schedCounters.end();) {
+        it = stats.count(it->first) ? std::next(it) : schedCounters.erase(it);
+    }
+    for (auto &p : schedStatTopics) {
+        DataList dataList;
+        if (!oeaware::SetDataListTopic(&dataList, name, SCHED_STAT_TOPIC, p.first)) {
+            continue;
+        }
+        auto statList = new ThreadSchedStatList();
+        statList->stats = new ThreadSchedStat[stats.size()];
+        int len = 0;
+        for (auto &it : stats) {
+            const auto &pids = p.second;
+            if (!pids.empty() && std::find(pids.begin(), pids.end(), it.second.pid) == pids.end()) {
+                continue;
+            }
+            statList->stats[len++] = it.second;
+        }
+        statList->len = len;
+        dataList.len = 1;
+        dataList.data = new void* [1];
+        dataList.data[0] = statList;
+        Publish(dataList);
+    }
+}
+
 #if ENABLE_EBPF
 oeaware::Result ThreadCollector::OpenThreadTrace()
 {
@@ -12,6 +12,7 @@
 #ifndef OEAWARE_MANAGER_THREAD_COLLECTOR_H
 #define OEAWARE_MANAGER_THREAD_COLLECTOR_H
 #include <unordered_map>
+#include <vector>
 #include <dirent.h>
 #include <sys/stat.h>
 #include <stdio.h>
@@ -32,6 +33,15 @@ struct thread_event {
     bool is_create;
 };
 
+/*
+ * topic: thread_collector, pid, tid and name of all threads.
+ *
+ * topic: thread_sched_stat, scheduler statistics of the threads, from /proc/<pid>/task/<tid>/schedstat, stat,
+ * status and sched.
+ * params: "" for all threads, or pids separated by spaces.
+ * DataList:
+ *  data: ThreadSchedStatList.
+ */
 class ThreadCollector: public oeaware::Interface {
 public:
     ThreadCollector();
@@ -48,12 +58,30 @@ private:
     bool IsNotChange(struct stat *task_stat, const std::string &task_path, int pid);
     void CollectThreads(int pid, DIR *task_dir);
     void ClearInvalidThread();
+    void PublishThreadInfo();
+    void PublishSchedStat();
+    bool ReadSchedStat(const ThreadInfo &info, ThreadSchedStat &stat, uint64_t now);
     ThreadInfo* GetThreadInfo(int pid, int tid);
     ThreadInfo* RecordThreadInfo(int pid, int tid, char comm[]);
     bool openStatus = false;
     std::unordered_map<int, ThreadInfo*> threads {};
     std::unordered_map<int, long int> taskTime {};
 
+    struct SchedCounter {
+        uint64_t ts = 0;
+        uint64_t runTime = 0;
+        uint64_t waitTime = 0;
+        uint64_t voluntarySwitches = 0;
+        uint64_t involuntarySwitches = 0;
+        uint64_t migrations = 0;
+    };
+    // key: params of thread_sched_stat, value: pids, empty means all threads.
+    std::unordered_map<std::string, std::vector<int>> schedStatTopics;
+    // key: tid, counters of the last publication.
+    std::unordered_map<int, SchedCounter> schedCounters;
+    std::vector<int> cpu2Node;
+    bool hasSchedFile = false;
+
 #if ENABLE_EBPF
     oeaware::Result OpenThreadTrace();
     void CloseThreadTrace();
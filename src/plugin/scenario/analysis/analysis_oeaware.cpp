@@ -17,6 +17,7 @@
 #include "numa_analysis/numa_analysis.h"
 #include "docker_coordination_burst/docker_coordination_burst_analysis.h"
 #include "microarch_tidnocmp/microarch_tidnocmp_analysis.h"
+#include "hot_function/hot_function_analysis.h"
 #ifdef __riscv
 #include "hwprobe/hwprobe_analysis.h"
 #endif
@@ -31,6 +32,7 @@ extern "C" void GetInstance(std::vector<std::shared_ptr<oeaware::Interface>> &in
     interface.emplace_back(std::make_shared<oeaware::NumaAnalysis>());
     interface.emplace_back(std::make_shared<oeaware::NetHirqAnalysis>());
     interface.emplace_back(std::make_shared<oeaware::HwprobeAnalysis>());
+    interface.emplace_back(std::make_shared<oeaware::HotFunctionAnalysis>());
 #else
     interface.emplace_back(std::make_shared<oeaware::HugePageAnalysis>());
     interface.emplace_back(std::make_shared<oeaware::DynamicSmtAnalysis>());
@@ -40,5 +42,6 @@ extern "C" void GetInstance(std::vector<std::shared_ptr<oeaware::Interface>> &in
     interface.emplace_back(std::make_shared<oeaware::NumaAnalysis>());
     interface.emplace_back(std::make_shared<oeaware::DockerCoordinationBurstAnalysis>());
     interface.emplace_back(std::make_shared<oeaware::MicroarchTidNoCmpAnalysis>());
+    interface.emplace_back(std::make_shared<oeaware::HotFunctionAnalysis>());
 #endif
 }
\ No newline at end of file
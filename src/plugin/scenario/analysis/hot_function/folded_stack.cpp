@@ -0,0 +1,201 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "folded_stack.h"
+#include <algorithm>
+
+namespace oeaware {
+namespace {
+constexpr uint32_t NONE = UINT32_MAX;
+// names of functions and groups, kept across windows so the previous window can be looked up by id.
+constexpr size_t NAMES_PER_NODE = 4;
+constexpr uint64_t FUNC_MASK = 0xffffffff;
+constexpr int GROUP_SHIFT = 32;
+}
+
+uint32_t FoldedStack::Intern(const std::string &str)
+{
+    auto it = nameIds.find(str);
+    if (it != nameIds.end()) {
+        return it->second;
+    }
+    if (names.size() >= maxNodes * NAMES_PER_NODE) {
+        return NONE;
+    }
+    uint32_t id = names.size();
+    names.emplace_back(str);
+    nameIds.emplace(str, id);
+    return id;
+}
+
+uint32_t FoldedStack::GetChild(Window &window, uint32_t node, uint32_t name)
+{
+    auto &children = window.nodes[node].children;
+    auto it = children.find(name);
+    if (it != children.end()) {
+        return it->second;
+    }
+    if (window.nodes.size() >= maxNodes) {
+        return NONE;
+    }
+    uint32_t child = window.nodes.size();
+    children.emplace(name, child);
+    // children may be invalidated by the push below, do not use it after this line.
+    window.nodes.emplace_back(Node{node, name, 0, {}});
+    return child;
+}
+
+void FoldedStack::Add(const std::string &group, const std::vector<std::string> &frames, uint64_t count)
+{
+    cur.samples += count;
+    uint32_t groupId = Intern(group);
+    if (groupId == NONE || frames.empty()) {
+        cur.truncated += count;
+        return;
+    }
+    uint32_t root;
+    auto rootIt = cur.groups.find(groupId);
+    if (rootIt != cur.groups.end()) {
+        root = rootIt->second;
+    } else if (cur.nodes.size() < maxNodes) {
+        root = cur.nodes.size();
+        cur.nodes.emplace_back(Node{NONE, groupId, 0, {}});
+        cur.groups.emplace(groupId, root);
+    } else {
+        cur.truncated += count;
+        return;
+    }
+    uint32_t node = root;
+    for (auto frame = frames.rbegin(); frame != frames.rend(); ++frame) {
+        uint32_t name = Intern(*frame);
+        uint32_t child = (name == NONE ? NONE : GetChild(cur, node, name));
+        if (child == NONE) {
+            cur.truncated += count;
+            break;
+        }
+        node = child;
+    }
+    if (node != root) {
+        auto &self = cur.nodes[node].self;
+        pathRank.erase({self, node});
+        self += count;
+        pathRank.emplace(self, node);
+    }
+
+    uint32_t func = Intern(frames.front());
+    if (func == NONE) {
+        return;
+    }
+    uint64_t key = FuncKey(groupId, func);
+    auto it = cur.funcs.find(key);
+    if (it == cur.funcs.end()) {
+        if (cur.funcs.size() >= maxNodes) {
+            return;
+        }
+        it = cur.funcs.emplace(key, 0).first;
+    }
+    auto prevIt = prev.funcs.find(key);
+    int64_t prevSamples = (prevIt == prev.funcs.end() ? 0 : static_cast<int64_t>(prevIt->second));
+    if (it->second > 0) {
+        funcRank.erase({it->second, key});
+        growthRank.erase({static_cast<int64_t>(it->second) - prevSamples, key});
+    }
+    it->second += count;
+    funcRank.emplace(it->second, key);
+    growthRank.emplace(static_cast<int64_t>(it->second) - prevSamples, key);
+}
+
+std::string FoldedStack::FoldPath(uint32_t node, uint32_t &group) const
+{
+    std::vector<uint32_t> path;
+    while (cur.nodes[node].parent != NONE) {
+        path.emplace_back(cur.nodes[node].name);
+        node = cur.nodes[node].parent;
+    }
+    group = cur.nodes[node].name;
+    std::string folded;
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        if (!folded.empty()) {
+            folded += ";";
+        }
+        folded += names[*it];
+    }
+    return folded;
+}
+
+int64_t FoldedStack::PrevPathSamples(uint32_t node) const
+{
+    std::vector<uint32_t> path;
+    while (cur.nodes[node].parent != NONE) {
+        path.emplace_back(cur.nodes[node].name);
+        node = cur.nodes[node].parent;
+    }
+    auto rootIt = prev.groups.find(cur.nodes[node].name);
+    if (rootIt == prev.groups.end()) {
+        return 0;
+    }
+    uint32_t prevNode = rootIt->second;
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        auto &children = prev.nodes[prevNode].children;
+        auto child = children.find(*it);
+        if (child == children.end()) {
+            return 0;
+        }
+        prevNode = child->second;
+    }
+    return prev.nodes[prevNode].self;
+}
+
+std::vector<FoldedStack::Item> FoldedStack::Top(size_t n) const
+{
+    std::vector<Item> items;
+    auto prevFunc = [this](uint64_t key) {
+        auto it = prev.funcs.find(key);
+        return it == prev.funcs.end() ? 0 : static_cast<int64_t>(it->second);
+    };
+    size_t i = 0;
+    for (auto it = funcRank.rbegin(); it != funcRank.rend() && i < n; ++it, ++i) {
+        uint64_t key = it->second;
+        items.emplace_back(Item{SELF, names[key >> GROUP_SHIFT], names[key & FUNC_MASK], it->first,
+            static_cast<int64_t>(it->first) - prevFunc(key)});
+    }
+    i = 0;
+    for (auto it = pathRank.rbegin(); it != pathRank.rend() && i < n; ++it, ++i) {
+        uint32_t group;
+        std::string folded = FoldPath(it->second, group);
+        items.emplace_back(Item{PATH, names[group], folded, it->first,
+            static_cast<int64_t>(it->first) - PrevPathSamples(it->second)});
+    }
+    i = 0;
+    for (auto it = growthRank.rbegin(); it != growthRank.rend() && i < n && it->first > 0; ++it, ++i) {
+        uint64_t key = it->second;
+        items.emplace_back(Item{REGRESSION, names[key >> GROUP_SHIFT], names[key & FUNC_MASK],
+            cur.funcs.at(key), it->first});
+    }
+    return items;
+}
+
+void FoldedStack::Roll()
+{
+    funcRank.clear();
+    growthRank.clear();
+    pathRank.clear();
+    if (names.size() >= maxNodes * NAMES_PER_NODE) {
+        // the ids of the finished window are dropped with the names, so no deltas for the next window.
+        names.clear();
+        nameIds.clear();
+        prev = Window();
+    } else {
+        prev = std::move(cur);
+    }
+    cur = Window();
+}
+}
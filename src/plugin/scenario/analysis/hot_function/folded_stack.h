@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef FOLDED_STACK_H
+#define FOLDED_STACK_H
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace oeaware {
+/*
+ * Folded-stack profile of one window, kept as a call trie per group (process or container).
+ * Every sample updates the trie and the rankings of its leaf function and call path in place,
+ * so Top() costs O(n) no matter how many samples were added.
+ * The trie is bounded by maxNodes, a sample whose path would need more nodes is counted on its longest known prefix.
+ * Roll() starts a new window, the finished one is kept to compute the deltas of the next.
+ */
+class FoldedStack {
+public:
+    enum ItemType {
+        SELF = 0,
+        PATH,
+        REGRESSION
+    };
+    struct Item {
+        int type;
+        std::string group;
+        std::string name;
+        uint64_t samples;
+        int64_t delta;
+    };
+    explicit FoldedStack(size_t maxNodes = DEFAULT_MAX_NODES) : maxNodes(maxNodes) { }
+    // frames are ordered from the leaf to the root, as libkperf reports them.
+    void Add(const std::string &group, const std::vector<std::string> &frames, uint64_t count = 1);
+    // the n hottest functions, call paths and regressions of the current window.
+    std::vector<Item> Top(size_t n) const;
+    void Roll();
+    uint64_t GetSamples() const
+    {
+        return cur.samples;
+    }
+    uint64_t GetTruncated() const
+    {
+        return cur.truncated;
+    }
+    static const size_t DEFAULT_MAX_NODES = 65536;
+private:
+    struct Node {
+        uint32_t parent;
+        uint32_t name;
+        uint64_t self;
+        std::unordered_map<uint32_t, uint32_t> children;
+    };
+    struct Window {
+        std::vector<Node> nodes;
+        // key: group name id, value: root node
+        std::unordered_map<uint32_t, uint32_t> groups;
+        // key: group id << 32 | function id
+        std::unordered_map<uint64_t, uint64_t> funcs;
+        uint64_t samples = 0;
+        uint64_t truncated = 0;
+    };
+    uint32_t Intern(const std::string &str);
+    uint32_t GetChild(Window &window, uint32_t node, uint32_t name);
+    int64_t PrevPathSamples(uint32_t node) const;
+    std::string FoldPath(uint32_t node, uint32_t &group) const;
+    static uint64_t FuncKey(uint32_t group, uint32_t func)
+    {
+        return (static_cast<uint64_t>(group) << 32) | func;
+    }
+
+    size_t maxNodes;
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> nameIds;
+    Window cur;
+    Window prev;
+    // rankings of the current window, ordered by (value, key).
+    std::set<std::pair<uint64_t, uint64_t>> funcRank;
+    std::set<std::pair<int64_t, uint64_t>> growthRank;
+    std::set<std::pair<uint64_t, uint32_t>> pathRank;
+};
+}
+
+#endif
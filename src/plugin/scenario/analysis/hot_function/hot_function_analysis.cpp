@@ -0,0 +1,308 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "hot_function_analysis.h"
+#include <algorithm>
+#include <fstream>
+#include <securec.h>
+#include "oeaware/utils.h"
+#include "oeaware/data_list.h"
+#include "oeaware/data/pmu_sampling_data.h"
+#include "oeaware/data/hot_function_data.h"
+#include "analysis_utils.h"
+#include "symbol_cache.h"
+
+namespace oeaware {
+namespace {
+constexpr int DEFAULT_WINDOW_SEC = 10;
+constexpr size_t DEFAULT_TOP = 10;
+constexpr size_t MAX_TOP = 1000;
+constexpr size_t CONTAINER_ID_LEN = 64;
+constexpr size_t SHORT_CONTAINER_ID_LEN = 12;
+const std::string HOST_GROUP = "host";
+const std::string UNKNOWN_FRAME = "[unknown]";
+const char FRAME_PID_SEPARATOR = ':';
+const char PATH_SEPARATOR = ';';
+constexpr int HEX_BASE = 16;
+
+// frames are folded as "<pid>:<hex address>", the address is only meaningful in its process.
+std::string FrameKey(int pid, uint64_t addr)
+{
+    std::ostringstream ss;
+    ss << pid << FRAME_PID_SEPARATOR << std::hex << addr;
+    return ss.str();
+}
+
+char *CopyString(const std::string &str)
+{
+    char *result = new char[str.size() + 1];
+    strcpy_s(result, str.size() + 1, str.c_str());
+    return result;
+}
+
+// ".../docker/<id>", ".../docker-<id>.scope" or ".../cri-containerd-<id>.scope" -> short id
+std::string ParseContainerId(const std::string &cgroupPath)
+{
+    std::string name = cgroupPath.substr(cgroupPath.find_last_of('/') + 1);
+    const std::string scope = ".scope";
+    if (name.size() > scope.size() && name.compare(name.size() - scope.size(), scope.size(), scope) == 0) {
+        name.erase(name.size() - scope.size());
+    }
+    if (name.size() > CONTAINER_ID_LEN) {
+        name = name.substr(name.size() - CONTAINER_ID_LEN);
+    }
+    if (name.size() != CONTAINER_ID_LEN || name.find_first_not_of("0123456789abcdef") != std::string::npos) {
+        return "";
+    }
+    return name.substr(0, SHORT_CONTAINER_ID_LEN);
+}
+}
+
+HotFunctionAnalysis::HotFunctionAnalysis()
+{
+    name = OE_HOT_FUNCTION_ANALYSIS;
+    period = ANALYSIS_TIME_PERIOD;
+    priority = 1;
+    type = SCENARIO;
+    version = "1.0.0";
+    for (auto &topic : topicStrs) {
+        supportTopics.emplace_back(Topic{name, topic, ""});
+    }
+}
+
+bool HotFunctionAnalysis::ParseConfig(const std::string &param, TopicStatus &status)
+{
+    status.window = DEFAULT_WINDOW_SEC;
+    status.top = DEFAULT_TOP;
+    auto paramsMap = GetKeyValueFromString(param);
+    if (paramsMap.count("t")) {
+        if (!IsInteger(paramsMap["t"]) || atoi(paramsMap["t"].c_str()) <= 0) {
+            return false;
+        }
+        status.window = atoi(paramsMap["t"].c_str());
+    }
+    if (paramsMap.count("top")) {
+        if (!IsInteger(paramsMap["top"]) || atoi(paramsMap["top"].c_str()) <= 0) {
+            return false;
+        }
+        status.top = std::min<size_t>(atoi(paramsMap["top"].c_str()), MAX_TOP);
+    }
+    if (paramsMap.count("group")) {
+        if (paramsMap["group"] != "process" && paramsMap["group"] != "container") {
+            return false;
+        }
+        status.byContainer = (paramsMap["group"] == "container");
+    }
+    return true;
+}
+
+Result HotFunctionAnalysis::Enable(const std::string &param)
+{
+    (void)param;
+    return Result(OK);
+}
+
+void HotFunctionAnalysis::Disable()
+{
+    topicStatus.clear();
+    containers.clear();
+}
+
+Result HotFunctionAnalysis::OpenTopic(const oeaware::Topic &topic)
+{
+    if (std::find(topicStrs.begin(), topicStrs.end(), topic.topicName) == topicStrs.end()) {
+        return Result(FAILED, "topic " + topic.topicName + " not support!");
+    }
+    auto topicType = topic.GetType();
+    if (topicStatus.count(topicType)) {
+        return Result(OK);
+    }
+    TopicStatus status;
+    if (!ParseConfig(topic.params, status)) {
+        return Result(FAILED, "hot function analysis params " + topic.params + " are invalid.");
+    }
+    status.beginTime = std::chrono::steady_clock::now();
+    if (topicStatus.empty()) {
+        Subscribe(samplingTopic);
+    }
+    topicStatus.emplace(topicType, std::move(status));
+    return Result(OK);
+}
+
+void HotFunctionAnalysis::CloseTopic(const oeaware::Topic &topic)
+{
+    if (topicStatus.erase(topic.GetType()) == 0) {
+        return;
+    }
+    if (topicStatus.empty()) {
+        Unsubscribe(samplingTopic);
+        containers.clear();
+    }
+}
+
+std::string HotFunctionAnalysis::GetGroup(const PmuData &data, bool byContainer)
+{
+    if (!byContainer) {
+        return std::string(data.comm != nullptr ? data.comm : "") + ":" + std::to_string(data.pid);
+    }
+    auto it = containers.find(data.pid);
+    if (it != containers.end()) {
+        return it->second;
+    }
+    std::string group = HOST_GROUP;
+    std::ifstream file("/proc/" + std::to_string(data.pid) + "/cgroup");
+    std::string line;
+    while (std::getline(file, line)) {
+        std::string id = ParseContainerId(line);
+        if (!id.empty()) {
+            group = id;
+            break;
+        }
+    }
+    containers[data.pid] = group;
+    return group;
+}
+
+void HotFunctionAnalysis::UpdateData(const DataList &dataList)
+{
+    std::string instanceName = dataList.topic.instanceName;
+    std::string topicName = dataList.topic.topicName;
+    if (instanceName != OE_PMU_SAMPLING_COLLECTOR || topicName != "cycles" || dataList.len <= 0) {
+        return;
+    }
+    auto samplingData = static_cast<PmuSamplingData*>(dataList.data[0]);
+    for (int i = 0; i < samplingData->len; ++i) {
+        auto &data = samplingData->pmuData[i];
+        if (data.pid <= 0 || data.stack == nullptr) {
+            continue;
+        }
+        frames.clear();
+        for (auto stack = data.stack; stack != nullptr; stack = stack->next) {
+            auto symbol = stack->symbol;
+            frames.emplace_back(symbol != nullptr && symbol->addr != 0 ? FrameKey(data.pid, symbol->addr) :
+                UNKNOWN_FRAME);
+        }
+        for (auto &item : topicStatus) {
+            item.second.profile.Add(GetGroup(data, item.second.byContainer), frames);
+        }
+    }
+}
+
+std::string HotFunctionAnalysis::ResolveFrame(const std::string &frame)
+{
+    auto it = resolved.find(frame);
+    if (it != resolved.end()) {
+        return it->second;
+    }
+    std::string symbol;
+    std::string module;
+    auto pos = frame.find(FRAME_PID_SEPARATOR);
+    if (pos == std::string::npos || !SymbolCache::GetInstance().Resolve(atoi(frame.c_str()),
+        strtoull(frame.c_str() + pos + 1, nullptr, HEX_BASE), symbol, module)) {
+        // kernel frames and frames of exited processes.
+        symbol = UNKNOWN_FRAME;
+    }
+    resolved.emplace(frame, symbol);
+    return symbol;
+}
+
+std::string HotFunctionAnalysis::ResolvePath(const std::string &path)
+{
+    std::string result;
+    for (auto &frame : SplitString(path, std::string(1, PATH_SEPARATOR))) {
+        if (!result.empty()) {
+            result += PATH_SEPARATOR;
+        }
+        result += ResolveFrame(frame);
+    }
+    return result;
+}
+
+std::vector<FoldedStack::Item> HotFunctionAnalysis::ResolveTop(const std::vector<FoldedStack::Item> &items,
+    size_t top)
+{
+    // addresses of different processes in one container group may resolve to the same function, they are merged.
+    std::vector<FoldedStack::Item> result;
+    std::unordered_map<std::string, size_t> index;
+    for (auto &item : items) {
+        std::string name = item.type == FoldedStack::PATH ? ResolvePath(item.name) : ResolveFrame(item.name);
+        std::string key = std::to_string(item.type) + PATH_SEPARATOR + item.group + PATH_SEPARATOR + name;
+        auto it = index.find(key);
+        if (it != index.end()) {
+            result[it->second].samples += item.samples;
+            result[it->second].delta += item.delta;
+            continue;
+        }
+        index.emplace(key, result.size());
+        result.emplace_back(FoldedStack::Item{item.type, item.group, name, item.samples, item.delta});
+    }
+    std::stable_sort(result.begin(), result.end(), [](const FoldedStack::Item &a, const FoldedStack::Item &b) {
+        if (a.type != b.type) {
+            return a.type < b.type;
+        }
+        return a.type == FoldedStack::REGRESSION ? a.delta > b.delta : a.samples > b.samples;
+    });
+    std::vector<FoldedStack::Item> topItems;
+    std::unordered_map<int, size_t> counts;
+    for (auto &item : result) {
+        if (counts[item.type]++ < top) {
+            topItems.emplace_back(item);
+        }
+    }
+    resolved.clear();
+    return topItems;
+}
+
+void HotFunctionAnalysis::PublishData(const std::string &topicType, TopicStatus &status)
+{
+    auto items = ResolveTop(status.profile.Top(status.top), status.top);
+    auto hotFunctionData = new HotFunctionData();
+    hotFunctionData->windowMs = static_cast<uint64_t>(status.window) * 1000;
+    hotFunctionData->samples = status.profile.GetSamples();
+    hotFunctionData->truncated = status.profile.GetTruncated();
+    hotFunctionData->len = items.size();
+    hotFunctionData->items = new HotFunctionItem[items.size()];
+    for (size_t i = 0; i < items.size(); ++i) {
+        auto &item = hotFunctionData->items[i];
+        item.type = items[i].type;
+        item.group = CopyString(items[i].group);
+        item.name = CopyString(items[i].name);
+        item.samples = items[i].samples;
+        item.delta = items[i].delta;
+    }
+    auto topic = Topic::GetTopicFromType(topicType);
+    DataList dataList;
+    SetDataListTopic(&dataList, topic.instanceName, topic.topicName, topic.params);
+    dataList.len = 1;
+    dataList.data = new void *[dataList.len];
+    dataList.data[0] = hotFunctionData;
+    Publish(dataList);
+}
+
+void HotFunctionAnalysis::Run()
+{
+    auto now = std::chrono::steady_clock::now();
+    bool rolled = false;
+    for (auto &item : topicStatus) {
+        auto &status = item.second;
+        if (now - status.beginTime < std::chrono::seconds(status.window)) {
+            continue;
+        }
+        PublishData(item.first, status);
+        status.profile.Roll();
+        status.beginTime = now;
+        rolled = true;
+    }
+    if (rolled) {
+        containers.clear();
+    }
+}
+}
@@ -0,0 +1,66 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2025-2025. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef HOT_FUNCTION_ANALYSIS_H
+#define HOT_FUNCTION_ANALYSIS_H
+#include <chrono>
+#include <unordered_map>
+#include "oeaware/interface.h"
+#include "folded_stack.h"
+
+struct PmuData;
+
+namespace oeaware {
+/*
+ * Hot functions of the host from pmu_sampling_collector::cycles with call stacks.
+ * Samples are folded by raw frame address into a per process (or container) call trie as they arrive, every t
+ * seconds the top functions, call paths and regressions against the previous window are resolved with
+ * oeaware::SymbolCache and published as HotFunctionData. Only the published frames are resolved.
+ * Topic params: "t:<seconds>,top:<n>,group:<process|container>", all optional.
+ */
+class HotFunctionAnalysis : public Interface {
+public:
+    HotFunctionAnalysis();
+    ~HotFunctionAnalysis() override = default;
+    Result OpenTopic(const oeaware::Topic &topic) override;
+    void CloseTopic(const oeaware::Topic &topic) override;
+    void UpdateData(const DataList &dataList) override;
+    Result Enable(const std::string &param) override;
+    void Disable() override;
+    void Run() override;
+private:
+    struct TopicStatus {
+        int window;
+        size_t top;
+        bool byContainer = false;
+        FoldedStack profile;
+        std::chrono::time_point<std::chrono::steady_clock> beginTime;
+    };
+    static bool ParseConfig(const std::string &param, TopicStatus &status);
+    std::string GetGroup(const PmuData &data, bool byContainer);
+    std::string ResolveFrame(const std::string &frame);
+    std::string ResolvePath(const std::string &path);
+    std::vector<FoldedStack::Item> ResolveTop(const std::vector<FoldedStack::Item> &items, size_t top);
+    void PublishData(const std::string &topicType, TopicStatus &status);
+
+    const Topic samplingTopic{OE_PMU_SAMPLING_COLLECTOR, "cycles", "callstack"};
+    std::vector<std::string> topicStrs{"hot_function"};
+    // key: topic type
+    std::unordered_map<std::string, TopicStatus> topicStatus;
+    // key: pid, value: container id, cleared every window since pids are reused.
+    std::unordered_map<int, std::string> containers;
+    std::vector<std::string> frames;
+    // key: frame, value: symbol, resolved frames of one publication.
+    std::unordered_map<std::string, std::string> resolved;
+};
+}
+
+#endif
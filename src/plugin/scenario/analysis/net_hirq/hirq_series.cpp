@@ -0,0 +1,117 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "hirq_series.h"
+#include <algorithm>
+#include <cmath>
+
+namespace oeaware {
+const float PERCENTILE_50 = 50.0;
+const float PERCENTILE_95 = 95.0;
+const float PERCENTILE_99 = 99.0;
+const float GINI_REBALANCE = 0.3;   // above it the rss indirection is suggested to change
+const int RSS_WEIGHT_BASE = 4;      // weight of a queue with the mean rate
+const int RSS_WEIGHT_MAX = 16;
+
+void RateRing::Push(float rate)
+{
+    if (rates.empty()) {
+        return;
+    }
+    rates[head] = rate;
+    head = (head + 1) % rates.size();
+    count = std::min(count + 1, rates.size());
+}
+
+bool RateRing::AllZero() const
+{
+    return std::all_of(rates.begin(), rates.end(), [](float rate) { return rate == 0; });
+}
+
+// nearest rank of the sorted values
+static float Percentile(const std::vector<float> &sorted, float percent)
+{
+    size_t rank = static_cast<size_t>(std::ceil(percent / 100 * sorted.size()));
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+NetHirqRateStat RateRing::Stat() const
+{
+    NetHirqRateStat stat = {};
+    if (count == 0) {
+        return stat;
+    }
+    stat.rate = rates[(head + rates.size() - 1) % rates.size()];
+    // the slots not written yet are at the end before the ring is full
+    std::vector<float> sorted(rates.begin(), rates.begin() + (count < rates.size() ? head : rates.size()));
+    double sum = 0;
+    for (auto rate : sorted) {
+        sum += rate;
+    }
+    stat.mean = sum / sorted.size();
+    double var = 0;
+    for (auto rate : sorted) {
+        var += (rate - stat.mean) * (rate - stat.mean);
+    }
+    stat.burstiness = stat.mean == 0 ? 0 : std::sqrt(var / sorted.size()) / stat.mean;
+    std::sort(sorted.begin(), sorted.end());
+    stat.p50 = Percentile(sorted, PERCENTILE_50);
+    stat.p95 = Percentile(sorted, PERCENTILE_95);
+    stat.p99 = Percentile(sorted, PERCENTILE_99);
+    return stat;
+}
+
+float Gini(std::vector<float> values)
+{
+    if (values.size() < 2) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    double sum = 0;
+    double weighted = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        sum += values[i];
+        weighted += (i + 1) * values[i];
+    }
+    if (sum == 0) {
+        return 0;
+    }
+    double n = values.size();
+    return 2 * weighted / (n * sum) - (n + 1) / n;
+}
+
+int SuggestQueues(float devRate, float queueRate, int rxQueues, int maxQueues)
+{
+    if (queueRate <= 0) {
+        return 0;
+    }
+    int need = std::min(static_cast<int>(std::ceil(devRate / queueRate)), maxQueues);
+    return need > rxQueues ? need : 0;
+}
+
+std::vector<int> SuggestRssWeights(const std::vector<float> &queueMeans, float gini)
+{
+    std::vector<int> weights;
+    if (gini <= GINI_REBALANCE || queueMeans.empty()) {
+        return weights;
+    }
+    double sum = 0;
+    for (auto mean : queueMeans) {
+        sum += mean;
+    }
+    double avg = sum / queueMeans.size();
+    for (auto mean : queueMeans) {
+        int weight = mean <= 0 ? RSS_WEIGHT_MAX : static_cast<int>(std::lround(RSS_WEIGHT_BASE * avg / mean));
+        weights.emplace_back(std::max(1, std::min(weight, RSS_WEIGHT_MAX)));
+    }
+    return weights;
+}
+}
@@ -0,0 +1,53 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef NET_HIRQ_SERIES_H
+#define NET_HIRQ_SERIES_H
+#include <map>
+#include <string>
+#include <vector>
+#include "oeaware/data/net_hardirq_tune_data.h"
+
+namespace oeaware {
+// Per period rates of the last capacity periods, the oldest one is overwritten.
+class RateRing {
+public:
+    explicit RateRing(size_t capacity = OE_NET_HIRQ_STAT_WINDOW) : rates(capacity, 0) { }
+    void Push(float rate);
+    size_t Size() const
+    {
+        return count;
+    }
+    bool AllZero() const;
+    NetHirqRateStat Stat() const;
+private:
+    std::vector<float> rates;
+    size_t head = 0;    // next slot to write
+    size_t count = 0;
+};
+
+struct DevSeries {
+    RateRing total;
+    std::map<int, RateRing> queues;   // queue id to rates
+    int rxQueues = 0;
+};
+
+// Gini coefficient of the values, 0 when all are equal, (n - 1) / n when one value takes all.
+float Gini(std::vector<float> values);
+// Queues needed to keep every queue under queueRate at the device p95 rate, 0 if rxQueues are enough.
+int SuggestQueues(float devRate, float queueRate, int rxQueues, int maxQueues);
+/*
+ * `ethtool -X weight` of the queues by their mean rates when gini is above the rebalance threshold, the busy
+ * queues get less of the indirection table. Empty if no change is suggested.
+ */
+std::vector<int> SuggestRssWeights(const std::vector<float> &queueMeans, float gini);
+}
+#endif
@@ -13,6 +13,9 @@
 #include <algorithm>
 #include <string>
 #include <iomanip>
+#include <dirent.h>
+#include <unistd.h>
+#include <securec.h>
 #include "analysis_utils.h"
 #include "oeaware/data/pmu_plugin.h"
 #include "oeaware/data/pmu_sampling_data.h"
@@ -29,6 +32,50 @@ static std::string FloatToString(float value)
     return out.str();
 }
 
+static int GetRxQueueNum(const std::string &dev)
+{
+    std::string path = "/sys/class/net/" + dev + "/queues/";
+    DIR *dir = opendir(path.c_str());
+    if (dir == nullptr) {
+        return 0;
+    }
+    int count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (std::string(entry->d_name).compare(0, 3, "rx-") == 0) {
+            count++;
+        }
+    }
+    closedir(dir);
+    return count;
+}
+
+static NetHirqDevStat GetDevStat(const std::string &dev, const DevSeries &devSeries, float queueRate,
+    std::vector<int> &rssWeights)
+{
+    NetHirqDevStat devStat = {};
+    (void)strncpy_s(devStat.dev, IFNAMSIZ, dev.c_str(), IFNAMSIZ - 1);
+    devStat.rxQueues = devSeries.rxQueues;
+    devStat.stat = devSeries.total.Stat();
+    // queues without packets count for the imbalance too
+    int queueNum = devSeries.rxQueues;
+    if (!devSeries.queues.empty()) {
+        queueNum = std::max(queueNum, devSeries.queues.rbegin()->first + 1);
+    }
+    std::vector<float> means(queueNum, 0);
+    for (auto &queue : devSeries.queues) {
+        if (!queue.second.AllZero()) {
+            devStat.activeQueues++;
+        }
+        means[queue.first] = queue.second.Stat().mean;
+    }
+    devStat.gini = Gini(means);
+    devStat.suggestQueues = SuggestQueues(devStat.stat.p95, queueRate, devSeries.rxQueues,
+        static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN)));
+    rssWeights = SuggestRssWeights(means, devStat.gini);
+    return devStat;
+}
+
 NetHirqAnalysis::NetHirqAnalysis()
 {
     name = OE_NET_HIRQ_ANALYSIS;
@@ -59,6 +106,9 @@ Result NetHirqAnalysis::OpenTopic(const oeaware::Topic &topic)
 	if (paramsMap.count("t")) {
 		topicCtl[topic.topicName].analysisTime = atoi(paramsMap["t"].data());
 	}
+    if (paramsMap.count("queue_rate") && atof(paramsMap["queue_rate"].data()) > 0) {
+        topicCtl[topic.topicName].queueRate = atof(paramsMap["queue_rate"].data());
+    }
 
     topicCtl[topic.topicName].beginTime = std::chrono::high_resolution_clock::now();
     topicCtl[topic.topicName].isOpen = true;
@@ -78,6 +128,7 @@ void NetHirqAnalysis::CloseTopic(const oeaware::Topic &topic)
     topicCtl[topic.topicName].analysisTime = 0;
     topicCtl[topic.topicName].openParams = "";
     topicCtl[topic.topicName].hasPublished = false;
+    topicCtl[topic.topicName].queueRate = HIRQ_QUEUE_RATE;
 }
 
 AnalysisRst NetHirqAnalysis::GetAnalysisResult(const std::string &dev, const std::vector<NetRx> &netRxVec)
@@ -121,6 +172,7 @@ void NetHirqAnalysis::GenPublishData()
         }
         analysisRst.emplace_back(item.second);
     }
+    auto queueSuggestion = GetQueueSuggestion(topicCtl[OE_NET_HIRQ_ANALYSIS].queueRate);
     std::sort(analysisRst.begin(), analysisRst.end(), [](const AnalysisRst &a, const AnalysisRst &b) {
         return a.peak > b.peak;
         });
@@ -161,6 +213,7 @@ void NetHirqAnalysis::GenPublishData()
         }
         suggestionItem.emplace_back("affinity network threads and interrupts");
     }
+    suggestionItem.insert(suggestionItem.end(), queueSuggestion.begin(), queueSuggestion.end());
     CreateAnalysisResultItem(metrics, conclusion, suggestionItem, type, &analysisResultItem);
 }
 
@@ -202,11 +255,17 @@ void NetHirqAnalysis::UpdateData(const DataList &dataList)
                 continue;
             }
             const std::string dev = std::string(tmpData.deviceName);
-            netRxSum[dev].rxSum += 10; // 10 : NET_RECEIVE_TRACE_SAMPLE_PERIOD
+            // every record stands for period packets, the collector may raise it to stay in its budget
+            netRxSum[dev].rxSum += dataTmp->period;
+            // queue_mapping is the rx queue + 1, 0 if the driver does not record it
+            if (tmpData.queueMapping > 0) {
+                queueRxSum[dev][static_cast<int>(tmpData.queueMapping - 1)] += dataTmp->period;
+            }
         }
         for (auto &dev : netRxSum) {
             dev.second.interval += dataTmp->interval;
         }
+        periodInterval += dataTmp->interval;
     }
 }
 
@@ -226,17 +285,133 @@ void NetHirqAnalysis::Disable()
     for (auto &topic : subscribeTopics) {
         Unsubscribe(topic);
     }
+    netRxSum.clear();
+    netRxSumTrace.clear();
+    queueRxSum.clear();
+    series.clear();
+    periodInterval = 0;
+}
+
+void NetHirqAnalysis::UpdateSeries()
+{
+    if (periodInterval == 0) {
+        return;
+    }
+    for (auto &item : netRxSum) {
+        series[item.first];
+    }
+    for (auto it = series.begin(); it != series.end();) {
+        auto &devSeries = it->second;
+        auto rxIt = netRxSum.find(it->first);
+        uint64_t rxSum = rxIt == netRxSum.end() ? 0 : rxIt->second.rxSum;
+        devSeries.total.Push(static_cast<float>(rxSum) * MS_PER_SEC / periodInterval);
+        auto &queues = queueRxSum[it->first];
+        for (auto &queue : queues) {
+            devSeries.queues[queue.first];
+        }
+        for (auto &queue : devSeries.queues) {
+            auto queIt = queues.find(queue.first);
+            uint64_t queSum = queIt == queues.end() ? 0 : queIt->second;
+            queue.second.Push(static_cast<float>(queSum) * MS_PER_SEC / periodInterval);
+        }
+        // devices without packets in the whole window are dropped, the ring memory stays bounded
+        if (devSeries.total.AllZero()) {
+            it = series.erase(it);
+            continue;
+        }
+        if (devSeries.rxQueues == 0) {
+            devSeries.rxQueues = GetRxQueueNum(it->first);
+        }
+        ++it;
+    }
+    queueRxSum.clear();
+    periodInterval = 0;
+}
+
+void NetHirqAnalysis::PublishQueueStat(const TopicCtl &info)
+{
+    std::vector<NetHirqDevStat> devStats;
+    std::vector<NetHirqQueueStat> queueStats;
+    size_t windowLen = 0;
+    for (auto &item : series) {
+        std::vector<int> rssWeights;
+        devStats.emplace_back(GetDevStat(item.first, item.second, info.queueRate, rssWeights));
+        windowLen = std::max(windowLen, item.second.total.Size());
+        for (auto &queue : item.second.queues) {
+            NetHirqQueueStat queueStat = {};
+            (void)strncpy_s(queueStat.dev, IFNAMSIZ, item.first.c_str(), IFNAMSIZ - 1);
+            queueStat.queueId = queue.first;
+            queueStat.stat = queue.second.Stat();
+            queueStat.rssWeight = rssWeights.empty() ? 0 : rssWeights[queue.first];
+            queueStats.emplace_back(queueStat);
+        }
+    }
+    auto statList = new NetHirqStatList();
+    statList->intervalMs = period;
+    statList->windowLen = static_cast<int>(windowLen);
+    statList->devCount = static_cast<int>(devStats.size());
+    if (!devStats.empty()) {
+        statList->dev = new NetHirqDevStat[devStats.size()];
+        std::copy(devStats.begin(), devStats.end(), statList->dev);
+    }
+    statList->queueCount = static_cast<int>(queueStats.size());
+    if (!queueStats.empty()) {
+        statList->queue = new NetHirqQueueStat[queueStats.size()];
+        std::copy(queueStats.begin(), queueStats.end(), statList->queue);
+    }
+    DataList dataList;
+    SetDataListTopic(&dataList, name, info.topicName, info.openParams);
+    dataList.len = 1;
+    dataList.data = new void *[dataList.len];
+    dataList.data[0] = statList;
+    Publish(dataList);
+}
+
+std::vector<std::string> NetHirqAnalysis::GetQueueSuggestion(float queueRate)
+{
+    std::vector<std::string> suggestion;
+    for (auto &item : series) {
+        std::vector<int> rssWeights;
+        auto devStat = GetDevStat(item.first, item.second, queueRate, rssWeights);
+        if (devStat.stat.p95 <= HIRQ_TUNE_PEAK_THRESHOLD) {
+            continue;
+        }
+        if (devStat.suggestQueues > 0) {
+            suggestion.emplace_back("ethtool -L " + item.first + " combined " +
+                std::to_string(devStat.suggestQueues) + " (p95 " + FloatToString(devStat.stat.p95) +
+                " pkt/s over " + std::to_string(devStat.rxQueues) + " queues)");
+        }
+        if (!rssWeights.empty()) {
+            std::string cmd = "ethtool -X " + item.first + " weight";
+            for (auto weight : rssWeights) {
+                cmd += " " + std::to_string(weight);
+            }
+            suggestion.emplace_back(cmd + " (queue imbalance gini " + FloatToString(devStat.gini) + ")");
+        }
+    }
+    return suggestion;
 }
 void NetHirqAnalysis::Run()
 {
-    for (auto &devIt : netRxSum) {
-        auto &dev = devIt.second;
-        dev.rxAvg = dev.rxSum * MS_PER_SEC / dev.interval;
-        netRxSumTrace[devIt.first].emplace_back(dev);
+    UpdateSeries();
+    // the one-shot report needs the whole trace, the queue stat only the ring
+    if (topicCtl[OE_NET_HIRQ_ANALYSIS].isOpen) {
+        for (auto &devIt : netRxSum) {
+            auto &dev = devIt.second;
+            dev.rxAvg = dev.rxSum * MS_PER_SEC / dev.interval;
+            netRxSumTrace[devIt.first].emplace_back(dev);
+        }
     }
     auto now = std::chrono::system_clock::now();
     for (auto &it : topicCtl) {
         auto &info = it.second;
+        if (!info.isOpen) {
+            continue;
+        }
+        if (info.topicName == OE_TOPIC_NET_HIRQ_QUEUE_STAT) {
+            PublishQueueStat(info);
+            continue;
+        }
         int curTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - info.beginTime).count();
         if (curTimeMs / MS_PER_SEC < info.analysisTime) {
             continue;
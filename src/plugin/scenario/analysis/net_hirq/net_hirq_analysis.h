@@ -14,8 +14,10 @@
 #include "oeaware/interface.h"
 #include "oeaware/data/pmu_sampling_data.h"
 #include "oeaware/data/analysis_data.h"
+#include "hirq_series.h"
 
 namespace oeaware {
+const float HIRQ_QUEUE_RATE = 100000;   // default rx packets per second one queue is suggested to take at most
 struct AnalysisRst {
     std::string dev;
     bool shouldTune = false;
@@ -46,19 +48,26 @@ private:
         bool isOpen = false;
         int analysisTime = 0;
         bool hasPublished = false;
+        float queueRate = HIRQ_QUEUE_RATE; // target rate of one queue, from the queue_rate param
         std::chrono::time_point<std::chrono::high_resolution_clock> beginTime;
     };
-    std::vector<std::string> topicStr = { OE_NET_HIRQ_ANALYSIS };
+    std::vector<std::string> topicStr = { OE_NET_HIRQ_ANALYSIS, OE_TOPIC_NET_HIRQ_QUEUE_STAT };
     std::unordered_map<std::string, TopicCtl> topicCtl; // topic name to topic info
     std::vector<oeaware::Topic> subscribeTopics;
     std::unordered_map<std::string, NetRx> netRxSum;    // dev name to rx sum
     std::unordered_map<std::string, std::vector<NetRx>> netRxSumTrace;
+    std::unordered_map<std::string, std::unordered_map<int, uint64_t>> queueRxSum; // dev name to queue rx sum
+    uint64_t periodInterval = 0;
+    std::unordered_map<std::string, DevSeries> series; // dev name to the rates of the last periods
     bool envIsSupportMultiPath = false;
     std::unordered_map<std::string, AnalysisRst> result; // dev name to analysis result
     AnalysisResultItem analysisResultItem = {};
     AnalysisRst GetAnalysisResult(const std::string &dev, const std::vector<NetRx> &netRxVec);
     void GenPublishData();
     bool DevIsSupportMultiPath(const std::string &dev);
+    void UpdateSeries();
+    void PublishQueueStat(const TopicCtl &info);
+    std::vector<std::string> GetQueueSuggestion(float queueRate);
     bool IsHaveOeNetCls();
 };
 }
@@ -11,6 +11,7 @@
  ******************************************************************************/
 #include "numa_analysis.h"
 #include <string>
+#include <cstring>
 #include <iostream>
 #include <yaml-cpp/yaml.h>
 #include <log4cplus/log4cplus.h>
@@ -20,18 +21,20 @@
 #include "oeaware/interface.h"
 #include "oeaware/data/thread_info.h"
 #include "data_register.h"
-#include "oeaware/data/pmu_counting_data.h"
-#include "oeaware/data/pmu_uncore_data.h"
+#include "oeaware/data/pmu_snapshot_data.h"
 #include "oeaware/data/analysis_data.h"
 
 namespace oeaware {
 
 const int MS_PER_SEC = 1000;
-const int DEFAULT_TIME_WINDOW_MS = 100;
+const uint64_t NS_PER_MS = 1000000;
 const int MAX_THREAD_THRESHOLD = 10000;
 const double NUMA_OPS_THRESHOLD_PER_SEC = 2000000; // Including oeaware analysis background noise
 const double NUMA_REMOTE_ACCESS_RATIO_THRESHOLD = 5.0;
 const double PERCENT_CONVERSION = 100.0;
+const double BYTES_PER_MB = 1024.0 * 1024.0;
+// a node is hot if it serves this many times its fair share of the memory traffic.
+const double HOT_NODE_SHARE_FACTOR = 1.5;
 
 NumaAnalysis::NumaAnalysis()
 {
@@ -80,9 +83,9 @@ Result NumaAnalysis::OpenTopic(const oeaware::Topic &topic)
     topicStatus[topicType].open = true;
     beginTime = std::chrono::high_resolution_clock::now();
 
-    subTopics.emplace_back(oeaware::Topic{OE_PMU_COUNTING_COLLECTOR, "sched:sched_process_fork", ""});
-    subTopics.emplace_back(oeaware::Topic{OE_PMU_COUNTING_COLLECTOR, "sched:sched_process_exit", ""});
-    subTopics.emplace_back(oeaware::Topic{OE_PMU_UNCORE_COLLECTOR, "uncore", ""});
+    // thread creation and hha traffic are read in one window, so the rates share the same interval.
+    subTopics.emplace_back(oeaware::Topic{OE_PMU_SNAPSHOT_COLLECTOR, "snapshot",
+        "sched:sched_process_fork sched:sched_process_exit hha"});
 
     for (auto &subTopic : subTopics) {
         Subscribe(subTopic);
@@ -107,47 +110,55 @@ void NumaAnalysis::UpdateData(const DataList &dataList)
 {
     std::string instanceName = dataList.topic.instanceName;
     std::string topicName = dataList.topic.topicName;
-
-    if (instanceName == OE_PMU_COUNTING_COLLECTOR) {
-        auto countingData = static_cast<PmuCountingData*>(dataList.data[0]);
-        if (topicName == "sched:sched_process_fork" && countingData->len > 0) {
-            for (int i = 0; i < countingData->len; i++) {
-                threadCreatedCount += countingData->pmuData[i].count;
-            }
-            timeWindowMs = countingData->interval;
-        } else if (topicName == "sched:sched_process_exit" && countingData->len > 0) {
-            for (int i = 0; i < countingData->len; i++) {
-                threadDestroyedCount += countingData->pmuData[i].count;
-            }
-            timeWindowMs = countingData->interval;
+    if (instanceName != OE_PMU_SNAPSHOT_COLLECTOR || topicName != "snapshot" || dataList.len <= 0) {
+        return;
+    }
+    auto snapshot = static_cast<PmuSnapshotData*>(dataList.data[0]);
+    if (snapshot->endTs <= snapshot->startTs) {
+        return;
+    }
+    for (int i = 0; i < snapshot->coreLen; i++) {
+        auto &pmuData = snapshot->coreData[i];
+        if (pmuData.evt == nullptr) {
+            continue;
         }
-    } else if (topicName == "uncore") {
-        auto uncoreData = static_cast<PmuUncoreData*>(dataList.data[0]);
-        totalOpsNum = 0;
-        totalRxOuter = 0;
-        totalRxSccl = 0;
-
-        int hhaNum = uncoreData->len / 3; // 3 events：rx_outer, rx_sccl, rx_ops_num
-        if (hhaNum <= 0) {
-            return;
+        if (strcmp(pmuData.evt, "sched:sched_process_fork") == 0) {
+            threadCreatedCount += pmuData.count;
+        } else if (strcmp(pmuData.evt, "sched:sched_process_exit") == 0) {
+            threadDestroyedCount += pmuData.count;
         }
-
-        for (int i = 0; i < hhaNum; i++) {
-            totalRxOuter += uncoreData->pmuData[i].count;
-            totalRxSccl += uncoreData->pmuData[i + hhaNum].count;
-            totalOpsNum += uncoreData->pmuData[i + 2 * hhaNum].count;
+    }
+    for (int i = 0; i < snapshot->uncoreLen; i++) {
+        auto &pmuData = snapshot->uncoreData[i];
+        if (pmuData.evt == nullptr) {
+            continue;
+        }
+        if (strstr(pmuData.evt, "/rx_outer/") != nullptr) {
+            totalRxOuter += pmuData.count;
+        } else if (strstr(pmuData.evt, "/rx_sccl/") != nullptr) {
+            totalRxSccl += pmuData.count;
+        } else if (strstr(pmuData.evt, "/rx_ops_num/") != nullptr) {
+            totalOpsNum += pmuData.count;
+        }
+    }
+    auto topo = snapshot->uncoreTopo;
+    for (int i = 0; topo != nullptr && i < topo->len; i++) {
+        auto &record = topo->records[i];
+        auto &traffic = nodeTraffic[record.loc.numaId];
+        if (strcmp(record.evt, "rx_ops_num") == 0) {
+            traffic.opsNum += record.count;
+        } else if (strcmp(record.evt, "rx_outer") == 0 || strcmp(record.evt, "rx_sccl") == 0) {
+            traffic.remoteNum += record.count;
         }
-
-        isNumaBottleneck = CheckNumaBottleneck();
     }
+    // all counts and the window are accumulated over the whole analysis time.
+    timeWindowNs += snapshot->endTs - snapshot->startTs;
+    isNumaBottleneck = CheckNumaBottleneck();
 }
 
 bool NumaAnalysis::CheckNumaBottleneck()
 {
-    double opsNumPerSecond = 0.0;
-    if (timeWindowMs > 0) {
-        opsNumPerSecond = static_cast<double>(totalOpsNum) * MS_PER_SEC / timeWindowMs;
-    }
+    double opsNumPerSecond = CalculateOpsRate();
 
     if (opsNumPerSecond <= NUMA_OPS_THRESHOLD_PER_SEC) {
         return false;
@@ -191,6 +202,8 @@ void NumaAnalysis::CalculateAndAddMetrics(std::vector<int>& type,
                                                                     : "low remote mem access")});
     }
 
+    AddNodeMetrics(type, metrics);
+
     // Thread creation metric
     type.emplace_back(DATA_TYPE_CPU);
     metrics.emplace_back(std::vector<std::string>{
@@ -199,6 +212,40 @@ void NumaAnalysis::CalculateAndAddMetrics(std::vector<int>& type,
                                                   : "low thread creation")});
 }
 
+void NumaAnalysis::AddNodeMetrics(std::vector<int>& type, std::vector<std::vector<std::string>>& metrics)
+{
+    if (timeWindowNs == 0) {
+        return;
+    }
+    for (auto &item : nodeTraffic) {
+        auto &traffic = item.second;
+        double bandwidth = static_cast<double>(traffic.opsNum) * UNCORE_OP_BYTES * MS_PER_SEC * NS_PER_MS /
+            timeWindowNs / BYTES_PER_MB;
+        double ratio = traffic.opsNum > 0 ?
+            static_cast<double>(traffic.remoteNum) / traffic.opsNum * PERCENT_CONVERSION : 0;
+        type.emplace_back(DATA_TYPE_MEMORY);
+        metrics.emplace_back(std::vector<std::string>{
+            "node" + std::to_string(item.first) + "_mem_bandwidth", std::to_string(bandwidth) + "MB/s",
+            "remote access " + std::to_string(ratio) + "%"});
+    }
+}
+
+int NumaAnalysis::GetHottestNode(double &share)
+{
+    int hottest = -1;
+    uint64_t maxOps = 0;
+    uint64_t totalOps = 0;
+    for (auto &item : nodeTraffic) {
+        totalOps += item.second.opsNum;
+        if (item.second.opsNum > maxOps) {
+            maxOps = item.second.opsNum;
+            hottest = item.first;
+        }
+    }
+    share = totalOps > 0 ? static_cast<double>(maxOps) / totalOps * PERCENT_CONVERSION : 0;
+    return hottest;
+}
+
 void NumaAnalysis::GenerateConclusion(std::vector<int>& type,
                                       std::vector<std::vector<std::string>>& metrics)
 {
@@ -234,24 +281,32 @@ void NumaAnalysis::GenerateConclusion(std::vector<int>& type,
     } else {
         conclusion = "NUMA is not a performance bottleneck. No NUMA-related optimization needed.";
     }
+    double share = 0;
+    int hottest = GetHottestNode(share);
+    // one memory controller serving most of the traffic is worth spreading even if the average looks fine.
+    if (hottest >= 0 && nodeTraffic.size() > 1 &&
+        share > HOT_NODE_SHARE_FACTOR * PERCENT_CONVERSION / nodeTraffic.size()) {
+        conclusion += " Memory of node " + std::to_string(hottest) + " serves " + std::to_string(share) +
+            "% of the memory traffic.";
+    }
 
     CreateAnalysisResultItem(metrics, conclusion, suggestionItem, type, &analysisResultItem);
 }
 
 double NumaAnalysis::CalculateThreadCreationRate()
 {
-    if (timeWindowMs <= 0) {
+    if (timeWindowNs == 0) {
         return 0.0;
     }
-    return static_cast<double>(threadCreatedCount) * MS_PER_SEC / timeWindowMs;
+    return static_cast<double>(threadCreatedCount) * MS_PER_SEC * NS_PER_MS / timeWindowNs;
 }
 
 double NumaAnalysis::CalculateOpsRate()
 {
-    if (timeWindowMs <= 0) {
+    if (timeWindowNs == 0) {
         return 0.0;
     }
-    return static_cast<double>(totalOpsNum) * MS_PER_SEC / timeWindowMs;
+    return static_cast<double>(totalOpsNum) * MS_PER_SEC * NS_PER_MS / timeWindowNs;
 }
 
 void* NumaAnalysis::GetResult()
@@ -273,12 +328,13 @@ void NumaAnalysis::Reset()
 {
     threadCreatedCount = 0;
     threadDestroyedCount = 0;
-    timeWindowMs = DEFAULT_TIME_WINDOW_MS;
+    timeWindowNs = 0;
     totalOpsNum = 0;
     totalRxOuter = 0;
     totalRxSccl = 0;
     remoteAccessRatio = 0.0;
     isNumaBottleneck = false;
+    nodeTraffic.clear();
 }
 
 void NumaAnalysis::Run()
@@ -12,6 +12,7 @@
 #ifndef NUMA_ANALYSIS_H
 #define NUMA_ANALYSIS_H
 
+#include <map>
 #include "oeaware/interface.h"
 #include "analysis.h"
 #include "analysis_utils.h"
@@ -49,6 +50,8 @@ private:
     bool CheckNumaBottleneck();
     void LoadConfig();
     bool IsSupportNumaSchedParal();
+    void AddNodeMetrics(std::vector<int>& type, std::vector<std::vector<std::string>>& metrics);
+    int GetHottestNode(double &share);
 
     std::vector<Topic> subTopics;
     std::vector<std::string> topicStrs{"numa_analysis"};
@@ -60,9 +63,9 @@ private:
     int time = 10;
     std::chrono::time_point<std::chrono::high_resolution_clock> beginTime;
 
-    int threadCreatedCount = 0;
-    int threadDestroyedCount = 0;
-    int timeWindowMs = 100;
+    uint64_t threadCreatedCount = 0;
+    uint64_t threadDestroyedCount = 0;
+    uint64_t timeWindowNs = 0;
     int threadThreshold = 200;
 
     bool isNumaBottleneck = false;
@@ -70,6 +73,12 @@ private:
     uint64_t totalRxOuter = 0;
     uint64_t totalRxSccl = 0;
     double remoteAccessRatio = 0.0;
+    struct NodeTraffic {
+        uint64_t opsNum = 0;
+        uint64_t remoteNum = 0;
+    };
+    // hha traffic by the numa node of the memory, from the located uncore records.
+    std::map<int, NodeTraffic> nodeTraffic;
 
     AnalysisResultItem analysisResultItem = {};
 };
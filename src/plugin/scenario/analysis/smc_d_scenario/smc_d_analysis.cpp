@@ -12,9 +12,13 @@
 #include "smc_d_analysis.h"
 #include "oeaware/utils.h"
 #include "analysis_utils.h"
+#include <fstream>
 
 namespace oeaware {
 const int MS_PER_SEC = 1000;
+const double BYTES_PER_MB = 1024.0 * 1024.0;
+const std::string TCP_STATE_ESTABLISHED = "01";
+const std::string TCP_STATE_CLOSE_WAIT = "08";
 
 SmcDAnalysis::SmcDAnalysis()
 {
@@ -45,6 +49,7 @@ Result SmcDAnalysis::OpenTopic(const Topic &topic)
         netFlowThreshold = atoi(paramsMap["threshold2"].data());
     }
     beginTime = std::chrono::high_resolution_clock::now();
+    loBytesValid = ReadLoBytes(loBytesBegin);
     isPublished = false;
     saveTopic = topic;
     return Result(OK);
@@ -100,76 +105,104 @@ bool SmcDAnalysis::GenNlOpen()
     return true;
 }
 
-std::string SmcDAnalysis::ExecuteCommand(const std::string &cmd)
+bool SmcDAnalysis::ReadLoBytes(uint64_t &bytes)
 {
-    const int bufferSize = 128;
-    std::array<char, bufferSize> buffer;
-    std::string result;
-    std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd.c_str(), "r"), pclose);
-    if (!pipe) {
-        throw std::runtime_error("popen() failed!");
+    std::ifstream file("/proc/net/dev");
+    if (!file.is_open()) {
+        return false;
     }
-    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-        result += buffer.data();
+    std::string line;
+    while (std::getline(file, line)) {
+        auto pos = line.find(':');
+        if (pos == std::string::npos) {
+            continue;
+        }
+        std::istringstream ifName(line.substr(0, pos));
+        std::string dev;
+        if (!(ifName >> dev) || dev != "lo") {
+            continue;
+        }
+        // rx bytes is the first column, tx bytes the ninth
+        const int txBytesCol = 8;
+        std::istringstream stream(line.substr(pos + 1));
+        uint64_t rxBytes = 0;
+        uint64_t txBytes = 0;
+        uint64_t value;
+        if (!(stream >> rxBytes)) {
+            return false;
+        }
+        for (int i = 1; i <= txBytesCol && stream >> value; ++i) {
+            txBytes = value;
+        }
+        bytes = rxBytes + txBytes;
+        return true;
     }
-    return result;
+    return false;
 }
 
 void SmcDAnalysis::GetLoNetworkFlow()
 {
-    std::string cmd = "sar -n DEV 1 1";
-    std::string output = ExecuteCommand(cmd);
-    std::istringstream stream(output);
-    if (output.empty()) {
-        WARN(logger, "The command 'sar -n DEV 1 1' returned no output. Check if 'sysstat' is installed.");
+    uint64_t bytes = 0;
+    if (!loBytesValid || !ReadLoBytes(bytes)) {
+        WARN(logger, "failed to read the lo statistics from /proc/net/dev.");
         netFlow = 0;
         return;
     }
-    std::string line;
-    while (std::getline(stream, line)) {
-        if (line.empty()) {
-            continue;
-        }
-        if (line.find("lo") != std::string::npos) {
-            std::istringstream lineStream(line);
-            std::string iface;
-            std::string rxStr;
-            std::string txStr;
-            std::string rxkBs;
-            std::string txkBs;
-            lineStream >> iface >> iface >> rxStr >> txStr >> rxkBs >> txkBs;
-            if (iface == "lo") {
-                double rx = std::stod(rxkBs);
-                double tx = std::stod(txkBs);
-                int kBtoMB = 2048;
-                netFlow = (rx + tx) / kBtoMB; // MB/S
-                break;
-            }
-        }
+    auto now = std::chrono::high_resolution_clock::now();
+    double sec = std::chrono::duration<double>(now - beginTime).count();
+    if (sec <= 0 || bytes < loBytesBegin) {
+        return;
     }
+    // the mean of rx and tx, they are the same traffic seen twice on lo
+    const int directions = 2;
+    netFlow = static_cast<int>((bytes - loBytesBegin) / directions / BYTES_PER_MB / sec); // MB/S
 }
 
-int SmcDAnalysis::GetConnectionCount(const std::string &state)
+void SmcDAnalysis::CountLoConnections(const std::string &path, int &establishedCount, int &closeWaitCount)
 {
-    std::string cmd = "grep -E '^ *[0-9]+:' /proc/net/tcp | awk '$2 ~ /^0100007F/ && $3 ~ /^0100007F/ && $4 == \""
-                    + state + "\" {count++} END {print count+0}'";
-    std::string output = ExecuteCommand(cmd);
-    if (output.empty()) {
-        return 0;
+    const std::string loV4 = "0100007F";
+    const std::string loV6 = "00000000000000000000000001000000";
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return;
+    }
+    std::string line;
+    // the header line has no "sl:" number, it fails the first read
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string sl;
+        std::string local;
+        std::string remote;
+        std::string state;
+        if (!(stream >> sl >> local >> remote >> state) || sl.back() != ':') {
+            continue;
+        }
+        auto isLo = [&loV4, &loV6](const std::string &addr) {
+            return addr.compare(0, loV4.size(), loV4) == 0 || addr.compare(0, loV6.size(), loV6) == 0;
+        };
+        if (!isLo(local) || !isLo(remote)) {
+            continue;
+        }
+        if (state == TCP_STATE_ESTABLISHED) {
+            establishedCount++;
+        } else if (state == TCP_STATE_CLOSE_WAIT) {
+            closeWaitCount++;
+        }
     }
-    return std::stoi(output);
 }
 
 void SmcDAnalysis::DetectTcpConnectionMode()
 {
-    int currentEstablishedCount = GetConnectionCount("01"); // ESTABLISHED
-    int currentCloseWaitCount = GetConnectionCount("08");   // CLOSE_WAIT
+    int currentEstablishedCount = 0;
+    int currentCloseWaitCount = 0;
+    CountLoConnections("/proc/net/tcp", currentEstablishedCount, currentCloseWaitCount);
+    CountLoConnections("/proc/net/tcp6", currentEstablishedCount, currentCloseWaitCount);
     int establishedDelta = std::abs(currentEstablishedCount - prevEstablishedCount);
     int closeWaitDelta = std::abs(currentCloseWaitCount - prevCloseWaitCount);
     prevEstablishedCount = currentEstablishedCount;
     prevCloseWaitCount = currentCloseWaitCount;
+    GetLoNetworkFlow();
     if (curTime == 0) {
-        GetLoNetworkFlow();
         return;
     }
     totalEstablishedDelta += establishedDelta;
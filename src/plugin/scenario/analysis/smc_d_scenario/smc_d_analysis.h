@@ -35,9 +35,9 @@ public:
 
 private:
     bool GenNlOpen();
-    std::string ExecuteCommand(const std::string &cmd);
+    bool ReadLoBytes(uint64_t &bytes);
     void GetLoNetworkFlow();
-    int GetConnectionCount(const std::string &state);
+    void CountLoConnections(const std::string &path, int &establishedCount, int &closeWaitCount);
     void DetectTcpConnectionMode();
     void* GetResult();
     void PublishData();
@@ -51,6 +51,8 @@ private:
     int netFlowThreshold = 100;
     bool isPublished = false;
     std::chrono::time_point<std::chrono::high_resolution_clock> beginTime;
+    uint64_t loBytesBegin = 0; // lo rx and tx bytes when the topic is opened
+    bool loBytesValid = false;
     Topic saveTopic;
     int prevEstablishedCount = 0; // 上一次的 ESTABLISHED 连接数
     int prevCloseWaitCount = 0; // 上一次的 CLOSE_WAIT 连接数
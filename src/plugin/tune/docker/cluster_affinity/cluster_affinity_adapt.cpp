@@ -50,6 +50,7 @@ ClusterAffinityAdapt::ClusterAffinityAdapt()
     supportTopics.push_back(topic);
     subscribeTopics.emplace_back(oeaware::Topic{OE_PMU_L3C_COLLECTOR, "l3c", ""});
     subscribeTopics.emplace_back(oeaware::Topic{OE_DOCKER_COLLECTOR, OE_DOCKER_COLLECTOR, ""});
+    subscribeTopics.emplace_back(oeaware::Topic{OE_ENV_INFO, "cpu_util", ""});
 }
 
 oeaware::Result ClusterAffinityAdapt::OpenTopic(const oeaware::Topic &topic)
@@ -71,6 +72,8 @@ void ClusterAffinityAdapt::UpdateData(const DataList &dataList)
         clusterSelector.Update(dataList);
     } else if (instance_name == std::string(OE_DOCKER_COLLECTOR) && topic_name == std::string(OE_DOCKER_COLLECTOR)) {
         this->Update(dataList);
+    } else if (instance_name == std::string(OE_ENV_INFO) && topic_name == std::string("cpu_util")) {
+        clusterSelector.UpdateCpuUtil(static_cast<EnvCpuUtilParam*>(dataList.data[0]));
     }
 }
 
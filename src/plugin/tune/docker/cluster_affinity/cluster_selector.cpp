@@ -64,14 +64,8 @@ int ClusterSelector::SelectIdleNode(const std::vector<int> &used)
     int nodeNum = clusterTopology.GetSystemNumaNodeNum();
     std::vector<double> dataVec(nodeNum);
 
-    for (int i = 0; i < nodeNum; ++i) {
-        if (used[i]) {
-            continue;
-        }
-        std::vector<int> cpuList = clusterTopology.GetCpuTopology(i);
-        for (int cpu : cpuList) {
-            dataVec[i] += cpuLoadMap[cpu];
-        }
+    for (int i = 0; i < nodeNum && i < static_cast<int>(nodeLoad.size()); ++i) {
+        dataVec[i] = nodeLoad[i];
     }
 
     double minVal = DBL_MAX;
@@ -144,69 +138,31 @@ void ClusterSelector::Update(const DataList &datalist)
         auto count = l3cData->pmuData[i].count;
         SetL3cCount(count, i);
     }
-
-    UpdateCpuLoad();
 }
 
-bool ClusterSelector::ReadCpuStats(std::map<int, CpuStats>& cpuStatsMap)
+static double CpuLoad(const uint64_t *times)
 {
-    std::ifstream file("/proc/stat");
-    if (file.is_open() == false) {
-        return false;
-    }
-    std::string line;
-
-    while (getline(file, line)) {
-        if (line.substr(0, 3) == "cpu") {
-            std::istringstream iss(line);
-            std::string cpuLabel;
-            int cpuNumber = -1;
-            CpuStats data;
-            iss >> cpuLabel;
-
-            if (cpuLabel.size() > 3) {
-                try {
-                    cpuNumber = std::stoi(cpuLabel.substr(3));
-                } catch(...) {
-                    continue;
-                }
-            }
-
-            if (cpuNumber >= 0) {
-                iss >> data.user >> data.nice >> data.system >> data.idle
-                    >> data.iowait >> data.irq >> data.softirq;
-                cpuStatsMap[cpuNumber] = data;
-            }
-        }
+    if (times[CPU_TIME_SUM] == 0) {
+        return 0.0;
     }
-    return true;
-}
-
-double ClusterSelector::CalculateCpuLoad(const CpuStats& prev, const CpuStats& curr)
-{
-    unsigned long prevTotal = prev.user + prev.nice + prev.system + prev.idle + prev.iowait + prev.irq + prev.softirq;
-    unsigned long currTotal = curr.user + curr.nice + curr.system + curr.idle + curr.iowait + curr.irq + curr.softirq;
-
-    unsigned long prevIdle = prev.idle + prev.iowait;
-    unsigned long currIdle = curr.idle + curr.iowait;
-
-    double totalDelta = currTotal - prevTotal;
-    double idleDelta = currIdle - prevIdle;
-
-    return (1.0 - (idleDelta / totalDelta)) * 100.0;
+    double idle = times[CPU_IDLE] + times[CPU_IOWAIT];
+    return (1.0 - idle / times[CPU_TIME_SUM]) * 100.0;
 }
 
-void ClusterSelector::UpdateCpuLoad()
+void ClusterSelector::UpdateCpuUtil(const EnvCpuUtilParam *data)
 {
-    std::map<int, CpuStats> currentCpuStatsMap;
-    ReadCpuStats(currentCpuStatsMap);
-
-    for (const auto &pair : prevCpuStatsMap) {
-        int cpuNumber = pair.first;
-        double load = CalculateCpuLoad(prevCpuStatsMap[cpuNumber], currentCpuStatsMap[cpuNumber]);
-        cpuLoadMap[cpuNumber] = load;
+    if (data == nullptr || data->dataReady != ENV_DATA_READY) {
+        return;
+    }
+    for (int cpu = 0; cpu < data->cpuNumConfig; ++cpu) {
+        cpuLoadMap[cpu] = CpuLoad(data->matrix + cpu * CPU_UTIL_TYPE_MAX);
+    }
+    nodeLoad.resize(data->numaNum);
+    for (int node = 0; node < data->numaNum; ++node) {
+        // busy time of the node, in the same order as the sum of its cpu loads
+        const uint64_t *times = data->nodeTimes + node * CPU_UTIL_TYPE_MAX;
+        nodeLoad[node] = times[CPU_TIME_SUM] - times[CPU_IDLE] - times[CPU_IOWAIT];
     }
-    prevCpuStatsMap = currentCpuStatsMap;
 }
 
 void ClusterSelector::SetL3cCount(uint64_t count, size_t index)
@@ -20,31 +20,20 @@
 #include "oeaware/interface.h"
 #include "oeaware/data_list.h"
 #include "oeaware/data/pmu_l3c_data.h"
-
-struct CpuStats {
-    unsigned long user;
-    unsigned long nice;
-    unsigned long system;
-    unsigned long idle;
-    unsigned long iowait;
-    unsigned long irq;
-    unsigned long softirq;
-};
+#include "oeaware/data/env_data.h"
 
 class ClusterSelector {
 public:
     ClusterSelector();
     bool Init(log4cplus::Logger &logger);
     void Update(const DataList &datalist);
+    void UpdateCpuUtil(const EnvCpuUtilParam *data);
 
     int SelectIdleNode(const std::vector<int> &used);
     int SelectIdleCluster(int node, const std::vector<int> &used);
     int SelectIdleCpuFromCluster(int clusterId, const std::vector<int> &used);
 
 private:
-    bool ReadCpuStats(std::map<int, CpuStats>& cpuStatsMap);
-    double CalculateCpuLoad(const CpuStats& prev, const CpuStats& curr);
-    void UpdateCpuLoad();
     void SetL3cCount(uint64_t count, size_t index);
 
 private:
@@ -55,7 +44,8 @@ private:
     std::map<std::string, std::queue<uint64_t>> scclL3c;
     std::map<std::string, uint64_t> scclL3cSum;
     std::map<int, double> cpuLoadMap;
-    std::map<int, CpuStats> prevCpuStatsMap;
+    // load of each numa node, from the rollup of env_info cpu_util
+    std::vector<double> nodeLoad;
     // Record last 10s l3c_hit count
     static constexpr int L3C_HIT_QUEUE_LENGTH = 10;
 };
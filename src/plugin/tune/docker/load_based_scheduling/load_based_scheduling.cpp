@@ -13,6 +13,7 @@
 #include <yaml-cpp/yaml.h>
 #include <oeaware/data/env_data.h>
 #include <oeaware/data/pmu_sampling_data.h>
+#include <oeaware/data/pmu_uncore_data.h>
 #include "oeaware/utils.h"
 
 namespace oeaware {
@@ -31,6 +32,8 @@ LoadBasedScheduling::LoadBasedScheduling()
     subscribeTopics.emplace_back(Topic{OE_DOCKER_COLLECTOR, OE_DOCKER_COLLECTOR, ""});
     subscribeTopics.emplace_back(Topic{OE_ENV_INFO, "static", ""});
     subscribeTopics.emplace_back(Topic{OE_PMU_SAMPLING_COLLECTOR, "cycles", ""});
+    // 可选，不支持hha的环境订阅失败，按容器第一个cpu所在的numa节点调度
+    subscribeTopics.emplace_back(Topic{OE_PMU_UNCORE_COLLECTOR, "uncore_node", ""});
 }
 
 Result LoadBasedScheduling::OpenTopic(const oeaware::Topic &topic)
@@ -141,6 +144,29 @@ void LoadBasedScheduling::UpdatePmuData(const DataList &dataList)
     }
 }
 
+void LoadBasedScheduling::UpdateUncoreData(const DataList &dataList)
+{
+    auto topo = static_cast<UncoreTopoData*>(dataList.data[0]);
+    nodeBandwidth.clear();
+    for (int i = 0; i < topo->nodeLen; ++i) {
+        nodeBandwidth[topo->nodes[i].numaId] = topo->nodes[i].bandwidth;
+    }
+}
+
+int LoadBasedScheduling::SelectNode(const std::vector<int> &cpus)
+{
+    // 容器cpu跨多个numa节点时，选择内存控制器带宽最低的节点，避开最忙的内存控制器
+    int node = cpuNuma[cpus[0]];
+    for (auto cpu : cpus) {
+        int candidate = cpuNuma[cpu];
+        if (nodeBandwidth.count(candidate) && nodeBandwidth.count(node) &&
+            nodeBandwidth[candidate] < nodeBandwidth[node]) {
+            node = candidate;
+        }
+    }
+    return node;
+}
+
 void LoadBasedScheduling::UpdateData(const DataList &dataList)
 {
     Topic topic{dataList.topic.instanceName, dataList.topic.topicName, dataList.topic.params};
@@ -151,6 +177,8 @@ void LoadBasedScheduling::UpdateData(const DataList &dataList)
     } else if (topic.instanceName == OE_PMU_SAMPLING_COLLECTOR && topic.topicName == "cycles") {
         // 处理PMU采样数据
         UpdatePmuData(dataList);
+    } else if (topic.instanceName == OE_PMU_UNCORE_COLLECTOR && topic.topicName == "uncore_node") {
+        UpdateUncoreData(dataList);
     } else {
         WARN(logger, "Unknown topic, {instanceName:" + topic.instanceName + ", topicName:" + topic.topicName + "}.");
     }
@@ -228,6 +256,7 @@ void LoadBasedScheduling::Disable()
     cpuNuma.clear();
     containerNuma.clear();
     numaContainers.clear();
+    nodeBandwidth.clear();
     pids.clear();
 }
 
@@ -253,10 +282,11 @@ void LoadBasedScheduling::Run()
         if (!IsHighLoad(container, cpus.size())) {
             continue;
         }
+        int node = SelectNode(cpus);
         // 获取numa节点的上容器的个数
-        numaContainers[cpuNuma[cpus[0]]].containerNum++;
+        numaContainers[node].containerNum++;
         // 记录容器对应的numa节点
-        containerNuma[container.id] = cpuNuma[cpus[0]];
+        containerNuma[container.id] = node;
         tuneContainerIds.emplace_back(container.id);
     }
     
@@ -48,6 +48,8 @@ private:
     void UpdateDockerData(const DataList &dataList);
     void UpdateNumaInfo(const DataList &dataList);
     void UpdatePmuData(const DataList &dataList);
+    void UpdateUncoreData(const DataList &dataList);
+    int SelectNode(const std::vector<int> &cpus);
     bool IsHighLoad(const ContainerCpuInfo &container, int cpuNum);
     std::vector<oeaware::Topic> subscribeTopics;
     std::vector<int64_t> maxCycles; // 每个cpu的最大周期
@@ -58,6 +60,7 @@ private:
     std::unordered_map<std::string, int> containerNuma; // 容器对应的numa节点
     std::unordered_map<int, int> cpuNuma; // cpu对应的numa节点
     std::unordered_map<int, ContainerInfo> numaContainers; // numa节点的容器信息
+    std::unordered_map<int, double> nodeBandwidth; // numa节点内存控制器(hha)的带宽，不支持uncore时为空
     std::string configPath = oeaware::DEFAULT_PLUGIN_CONFIG_PATH + "/load_based_scheduling.yaml";
     const int unlimit = -1;
     double highLoadThreshold = 0.5; // 高负载阈值
@@ -0,0 +1,224 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "coalesce_ctl.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <linux/sockios.h>
+#include <securec.h>
+
+namespace oeaware {
+constexpr uint64_t USEC_PER_SEC = 1000000;
+constexpr uint32_t NSEC_PER_USEC = 1000;
+constexpr uint32_t NAPI_DEFER_IRQS = 2;  // irqs stay masked for two empty polls before they are enabled again
+constexpr uint32_t FRAMES_KEEP_RATIO = 4;
+
+CoalesceSetting DecideCoalesce(const CoalesceBound &bound, const CoalesceSetting &current, uint64_t rxPps,
+    int rxQueues)
+{
+    CoalesceSetting setting;
+    uint64_t queuePps = rxPps / static_cast<uint64_t>(std::max(rxQueues, 1));
+    uint64_t irqRate = std::max<uint32_t>(bound.irqRate, 1);
+    setting.batch = current.batch ? queuePps * 2 >= irqRate : queuePps > irqRate;
+    if (!setting.batch) {
+        setting.usecs = bound.minUsecs;
+        return setting;
+    }
+    // the timer fires at most irqRate times per second
+    uint64_t usecs = (USEC_PER_SEC + irqRate - 1) / irqRate;
+    setting.usecs = static_cast<uint32_t>(std::min<uint64_t>(std::max<uint64_t>(usecs, bound.minUsecs),
+        bound.maxUsecs));
+    // and the frame limit, reached first under bursts, no more than that either
+    uint64_t frames = (queuePps + irqRate - 1) / irqRate;
+    setting.frames = static_cast<uint32_t>(std::min<uint64_t>(std::max<uint64_t>(frames, 1),
+        std::max<uint32_t>(bound.maxFrames, 1)));
+    if (current.batch && current.frames != 0 &&
+        static_cast<uint32_t>(std::abs(static_cast<int64_t>(setting.frames) - current.frames)) * FRAMES_KEEP_RATIO <
+        current.frames) {
+        setting.frames = current.frames;
+    }
+    // NAPI keeps polling instead of enabling the irq, gro_flush_timeout is the time the irq stays masked
+    if (bound.napiDefer && setting.usecs != 0) {
+        setting.deferIrqs = NAPI_DEFER_IRQS;
+        setting.flushNs = setting.usecs * NSEC_PER_USEC;
+    }
+    return setting;
+}
+
+bool NetCoalesceCtl::GetCoalesce(const std::string &dev, struct ethtool_coalesce &coal) const
+{
+    if (dev.empty() || dev.size() >= IFNAMSIZ) {
+        return false;
+    }
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    coal = {};
+    coal.cmd = ETHTOOL_GCOALESCE;
+    struct ifreq ifr = {};
+    if (strncpy_s(ifr.ifr_name, IFNAMSIZ, dev.c_str(), dev.size()) != EOK) {
+        close(fd);
+        return false;
+    }
+    ifr.ifr_data = reinterpret_cast<char*>(&coal);
+    int ret = ioctl(fd, SIOCETHTOOL, &ifr);
+    close(fd);
+    return ret >= 0;
+}
+
+bool NetCoalesceCtl::PutCoalesce(const std::string &dev, struct ethtool_coalesce &coal) const
+{
+    if (dev.empty() || dev.size() >= IFNAMSIZ) {
+        return false;
+    }
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    coal.cmd = ETHTOOL_SCOALESCE;
+    struct ifreq ifr = {};
+    if (strncpy_s(ifr.ifr_name, IFNAMSIZ, dev.c_str(), dev.size()) != EOK) {
+        close(fd);
+        return false;
+    }
+    ifr.ifr_data = reinterpret_cast<char*>(&coal);
+    int ret = ioctl(fd, SIOCETHTOOL, &ifr);
+    close(fd);
+    return ret >= 0;
+}
+
+bool NetCoalesceCtl::Supported(const std::string &dev)
+{
+    if (originCoal.count(dev)) {
+        return true;
+    }
+    struct ethtool_coalesce coal;
+    return GetCoalesce(dev, coal) && !coal.use_adaptive_rx_coalesce;
+}
+
+bool NetCoalesceCtl::SetCoalesce(const std::string &dev, uint32_t usecs, uint32_t frames)
+{
+    struct ethtool_coalesce coal;
+    if (!GetCoalesce(dev, coal)) {
+        return false;
+    }
+    if (coal.rx_coalesce_usecs == usecs && coal.rx_max_coalesced_frames == frames) {
+        return true;
+    }
+    if (originCoal.count(dev) == 0) {
+        originCoal[dev] = coal;
+    }
+    // only the rx fields change, the others are written back as they are read
+    coal.rx_coalesce_usecs = usecs;
+    coal.rx_max_coalesced_frames = frames;
+    return PutCoalesce(dev, coal);
+}
+
+bool NetCoalesceCtl::RestoreCoalesce(const std::string &dev)
+{
+    auto it = originCoal.find(dev);
+    if (it == originCoal.end()) {
+        return true;
+    }
+    struct ethtool_coalesce coal = it->second;
+    return PutCoalesce(dev, coal);
+}
+
+bool NetCoalesceCtl::Write(const std::string &path, const std::string &value)
+{
+    auto it = current.find(path);
+    if (it != current.end() && it->second == value) {
+        return true;
+    }
+    if (origin.count(path) == 0) {
+        std::ifstream in(path);
+        std::string old;
+        if (!in.is_open() || !std::getline(in, old)) {
+            return false;
+        }
+        origin[path] = old;
+    }
+    std::ofstream out(path);
+    if (!out.is_open() || !(out << value << '\n') || !out.flush()) {
+        return false;
+    }
+    current[path] = value;
+    return true;
+}
+
+bool NetCoalesceCtl::SetNapiDefer(const std::string &dev, uint32_t deferIrqs, uint32_t flushNs)
+{
+    std::string defer = netRoot + dev + "/napi_defer_hard_irqs";
+    std::string flush = netRoot + dev + "/gro_flush_timeout";
+    if (deferIrqs == 0) {
+        bool ret = true;
+        for (auto &path : { defer, flush }) {
+            if (origin.count(path)) {
+                ret = Write(path, origin[path]) && ret;
+            }
+        }
+        return ret;
+    }
+    // the timeout first, napi_defer_hard_irqs has no effect without it
+    bool ret = Write(flush, std::to_string(flushNs));
+    return ret && Write(defer, std::to_string(deferIrqs));
+}
+
+bool NetCoalesceCtl::SetBusyPoll(uint32_t usecs)
+{
+    if (usecs == 0) {
+        return true;
+    }
+    bool ret = Write(coreRoot + "busy_poll", std::to_string(usecs));
+    return Write(coreRoot + "busy_read", std::to_string(usecs)) && ret;
+}
+
+int NetCoalesceCtl::GetRxQueues(const std::string &dev) const
+{
+    std::string path = netRoot + dev + "/queues/";
+    DIR *dir = opendir(path.c_str());
+    if (dir == nullptr) {
+        return 1;
+    }
+    int count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (std::string(entry->d_name).compare(0, 3, "rx-") == 0) {
+            count++;
+        }
+    }
+    closedir(dir);
+    return std::max(count, 1);
+}
+
+void NetCoalesceCtl::Restore()
+{
+    for (auto &item : originCoal) {
+        (void)PutCoalesce(item.first, item.second);
+    }
+    for (auto &item : origin) {
+        std::ofstream out(item.first);
+        if (out.is_open()) {
+            out << item.second << '\n';
+        }
+    }
+    originCoal.clear();
+    origin.clear();
+    current.clear();
+}
+}
@@ -0,0 +1,81 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef COALESCE_CTL_H
+#define COALESCE_CTL_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <linux/ethtool.h>
+
+namespace oeaware {
+struct CoalesceBound {
+    uint32_t irqRate = 20000;   // max hard irqs per second of one rx queue
+    uint32_t minUsecs = 0;      // rx-usecs when the rate is below irqRate, 0 means irq per packet
+    uint32_t maxUsecs = 100;    // rx-usecs never exceeds this, the latency bound
+    uint32_t maxFrames = 64;
+    bool napiDefer = true;
+};
+
+struct CoalesceSetting {
+    bool batch = false;         // the queue rate is above the bound, packets are coalesced
+    uint32_t usecs = 0;
+    uint32_t frames = 1;
+    uint32_t deferIrqs = 0;     // napi_defer_hard_irqs, 0 keeps the original one
+    uint32_t flushNs = 0;       // gro_flush_timeout
+    bool operator==(const CoalesceSetting &other) const
+    {
+        return batch == other.batch && usecs == other.usecs && frames == other.frames &&
+            deferIrqs == other.deferIrqs && flushNs == other.flushNs;
+    }
+};
+
+/*
+ * Coalescing of a device with rxPps packets per second on rxQueues queues, the lowest rx-usecs that keeps the irq
+ * rate of every queue under bound.irqRate. Batching starts above irqRate and stops below half of it, and rx-frames
+ * changes of less than a quarter are ignored, so the setting does not flap with the traffic.
+ */
+CoalesceSetting DecideCoalesce(const CoalesceBound &bound, const CoalesceSetting &current, uint64_t rxPps,
+    int rxQueues);
+
+/*
+ * Per device coalescing by the SIOCETHTOOL ioctl and NAPI defer by sysfs, and the global busy poll sysctls.
+ * The values before the first write are saved and written back by Restore.
+ */
+class NetCoalesceCtl {
+public:
+    explicit NetCoalesceCtl(const std::string &netRoot = "/sys/class/net/",
+        const std::string &coreRoot = "/proc/sys/net/core/") : netRoot(netRoot), coreRoot(coreRoot) { }
+    // false if the driver has no coalescing or already uses adaptive rx coalescing
+    bool Supported(const std::string &dev);
+    bool SetCoalesce(const std::string &dev, uint32_t usecs, uint32_t frames);
+    // writes back the coalescing of dev before the first SetCoalesce, true if it was never changed
+    bool RestoreCoalesce(const std::string &dev);
+    // deferIrqs 0 writes back the original napi_defer_hard_irqs and gro_flush_timeout
+    bool SetNapiDefer(const std::string &dev, uint32_t deferIrqs, uint32_t flushNs);
+    // net.core.busy_poll and net.core.busy_read, 0 is left alone
+    bool SetBusyPoll(uint32_t usecs);
+    int GetRxQueues(const std::string &dev) const;
+    void Restore();
+private:
+    bool GetCoalesce(const std::string &dev, struct ethtool_coalesce &coal) const;
+    bool PutCoalesce(const std::string &dev, struct ethtool_coalesce &coal) const;
+    bool Write(const std::string &path, const std::string &value);
+    std::string netRoot;
+    std::string coreRoot;
+    std::map<std::string, struct ethtool_coalesce> originCoal; // dev to the coalescing before tuning
+    std::map<std::string, std::string> origin; // sysfs or sysctl path to the value before tuning
+    std::map<std::string, std::string> current;
+};
+}
+
+#endif
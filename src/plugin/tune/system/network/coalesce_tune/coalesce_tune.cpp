@@ -0,0 +1,251 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "coalesce_tune.h"
+#include <climits>
+#include "oeaware/utils.h"
+#include "oeaware/data/pmu_plugin.h"
+#include "oeaware/data/pmu_sampling_data.h"
+#include "oeaware/data/network_interface_data.h"
+
+using namespace oeaware;
+
+static const int MS_PER_SEC = 1000;
+
+static bool ParseUint(const std::string &str, uint32_t &value)
+{
+    if (!IsInteger(str) || str[0] == '-') {
+        return false;
+    }
+    try {
+        unsigned long num = std::stoul(str);
+        if (num > UINT_MAX) {
+            return false;
+        }
+        value = static_cast<uint32_t>(num);
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+NetCoalesceTune::NetCoalesceTune()
+{
+    name = OE_NET_COALESCE_TUNE;
+    version = "1.0.0";
+    period = 1000;       // 1000 ms
+    priority = 2;        // 2: tune instance
+    type = TUNE;
+    description += "[introduction] \n";
+    description += "               Adjust the rx interrupt coalescing and NAPI defer of the network interfaces by \n";
+    description += "               the receive rate, keep the irq rate of every queue under the bound with the \n";
+    description += "               lowest latency\n";
+    description += "[version] \n";
+    description += "         " + version + "\n";
+    description += "[instance name]\n";
+    description += "                 " + name + "\n";
+    description += "[instance period]\n";
+    description += "                 " + std::to_string(period) + " ms\n";
+    description += "[provide topics]\n";
+    description += "                 none\n";
+    description += "[running require environment]\n";
+    description += "                 network interface driver supports ethtool -C rx-usecs and rx-frames\n";
+    description += "[running require topics]\n";
+    description += "                        1.net_interface_info::base\n";
+    description += "                        2.pmu_sampling_collector::net:napi_gro_receive_entry\n";
+    description += "[usage] \n";
+    description += "        example:You can use `oeawarectl -e " + name + " -params \"irq_rate:20000,max_usecs:50\"` to enable\n";
+}
+
+oeaware::Result NetCoalesceTune::OpenTopic(const oeaware::Topic &topic)
+{
+    (void)topic;
+    return oeaware::Result(OK);
+}
+
+void NetCoalesceTune::CloseTopic(const oeaware::Topic &topic)
+{
+    (void)topic;
+}
+
+bool NetCoalesceTune::ResolveCmd(const std::string &param)
+{
+    bound = CoalesceBound();
+    busyPoll = 0;
+    if (param.empty()) {
+        return true;
+    }
+    auto paramsMap = GetKeyValueFromString(param);
+    for (auto &item : paramsMap) {
+        if (!cmdHelp.count(item.first)) {
+            ERROR(logger, "invalid param: " << item.first);
+            return false;
+        }
+    }
+    std::unordered_map<std::string, uint32_t*> numParams = {
+        {"irq_rate", &bound.irqRate}, {"min_usecs", &bound.minUsecs}, {"max_usecs", &bound.maxUsecs},
+        {"max_frames", &bound.maxFrames}, {"busy_poll", &busyPoll},
+    };
+    for (auto &item : numParams) {
+        if (paramsMap.count(item.first) && !ParseUint(paramsMap[item.first], *item.second)) {
+            ERROR(logger, item.first << " invalid param: " << paramsMap[item.first]);
+            return false;
+        }
+    }
+    if (bound.irqRate == 0 || bound.minUsecs > bound.maxUsecs) {
+        ERROR(logger, "irq_rate should be positive and min_usecs no more than max_usecs");
+        return false;
+    }
+    if (paramsMap.count("defer")) {
+        if (paramsMap["defer"] == "on") {
+            bound.napiDefer = true;
+        } else if (paramsMap["defer"] == "off") {
+            bound.napiDefer = false;
+        } else {
+            ERROR(logger, "defer invalid param: " << paramsMap["defer"]);
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string NetCoalesceTune::GetHelp()
+{
+    std::string output;
+    output += "Usage : oeawarectl -e " + name + " [options] \n";
+    for (const auto &item : cmdHelp) {
+        output +=  item.second + " \n";
+    }
+    return output;
+}
+
+void NetCoalesceTune::UpdateNetIntfInfo(const DataList &dataList)
+{
+    if (std::string(dataList.topic.topicName) != OE_NETWORK_INTERFACE_BASE_TOPIC) {
+        return;
+    }
+    const NetIntfBaseDataList *dataTmp = static_cast<NetIntfBaseDataList *>(dataList.data[0]);
+    // subscribed with operstate_up, only the interfaces that are up
+    upDevs.clear();
+    for (int i = 0; i < dataTmp->count; i++) {
+        upDevs.insert(dataTmp->base[i].name);
+    }
+}
+
+void NetCoalesceTune::UpdatePmuSampleInfo(const DataList &dataList)
+{
+    if (std::string(dataList.topic.topicName) != "net:napi_gro_receive_entry") {
+        return;
+    }
+    PmuSamplingData *dataTmp = static_cast<PmuSamplingData *>(dataList.data[0]);
+    NapiGroRecEntryData tmpData;
+    for (int i = 0; i < dataTmp->len; i++) {
+        if (NapiGroRecEntryResolve(dataTmp->pmuData[i].rawData->data, &tmpData)) {
+            continue;
+        }
+        netRx[std::string(tmpData.deviceName)] += dataTmp->period;
+    }
+    // a batch without records of a dev still counts for its rate
+    rxInterval += dataTmp->interval;
+}
+
+void NetCoalesceTune::UpdateData(const DataList &dataList)
+{
+    std::string instanceName = dataList.topic.instanceName;
+    if (instanceName == OE_NET_INTF_INFO) {
+        UpdateNetIntfInfo(dataList);
+    } else if (instanceName == OE_PMU_SAMPLING_COLLECTOR) {
+        UpdatePmuSampleInfo(dataList);
+    }
+}
+
+void NetCoalesceTune::TuneDev(const std::string &dev, uint64_t rxPps)
+{
+    if (unsupportedDevs.count(dev)) {
+        return;
+    }
+    if (!ctl.Supported(dev)) {
+        INFO(logger, "NetCoalesceTune skip " << dev << ", no coalescing or adaptive rx coalescing is on");
+        unsupportedDevs.insert(dev);
+        return;
+    }
+    auto &cur = setting[dev];
+    auto next = DecideCoalesce(bound, cur, rxPps, ctl.GetRxQueues(dev));
+    if (next == cur) {
+        return;
+    }
+    // back to the latency setting, the original coalescing unless min_usecs is set
+    bool restore = !next.batch && bound.minUsecs == 0;
+    if (restore ? !ctl.RestoreCoalesce(dev) : !ctl.SetCoalesce(dev, next.usecs, next.frames)) {
+        WARN(logger, "NetCoalesceTune set " << dev << (restore ? " original coalescing" : " rx-usecs " +
+            std::to_string(next.usecs) + " rx-frames " + std::to_string(next.frames)) << " failed");
+        // a device which could be coalesced is retried in the next period
+        if (next.batch) {
+            unsupportedDevs.insert(dev);
+        }
+        return;
+    }
+    if (!ctl.SetNapiDefer(dev, next.deferIrqs, next.flushNs)) {
+        WARN(logger, "NetCoalesceTune set " << dev << " napi_defer_hard_irqs failed");
+    }
+    INFO(logger, "NetCoalesceTune " << dev << " rx " << rxPps << " pps, rx-usecs " << next.usecs << ", rx-frames "
+        << next.frames << ", napi_defer_hard_irqs " << next.deferIrqs << ", gro_flush_timeout " << next.flushNs);
+    cur = next;
+}
+
+void NetCoalesceTune::Run()
+{
+    // devices without packets in this period go back to the latency setting
+    for (auto &item : setting) {
+        netRx.emplace(item.first, 0);
+    }
+    for (auto &item : netRx) {
+        if (!upDevs.count(item.first)) {
+            continue;
+        }
+        uint64_t rxPps = rxInterval == 0 ? 0 : item.second * MS_PER_SEC / rxInterval;
+        TuneDev(item.first, rxPps);
+    }
+    netRx.clear();
+    rxInterval = 0;
+}
+
+oeaware::Result NetCoalesceTune::Enable(const std::string &param)
+{
+    if (!ResolveCmd(param)) {
+        return oeaware::Result(FAILED, "NetCoalesceTune resolve cmd failed \n" + GetHelp());
+    }
+    if (!ctl.SetBusyPoll(busyPoll)) {
+        ctl.Restore();
+        return oeaware::Result(FAILED, "set net.core.busy_poll failed.");
+    }
+    subscribeTopics.clear();
+    subscribeTopics.emplace_back(oeaware::Topic{ OE_NET_INTF_INFO, OE_NETWORK_INTERFACE_BASE_TOPIC, "operstate_up" });
+    subscribeTopics.emplace_back(oeaware::Topic{ OE_PMU_SAMPLING_COLLECTOR, "net:napi_gro_receive_entry", "" });
+    for (auto &topic : subscribeTopics) {
+        Subscribe(topic);
+    }
+    return oeaware::Result(OK);
+}
+
+void NetCoalesceTune::Disable()
+{
+    for (auto &topic : subscribeTopics) {
+        Unsubscribe(topic);
+    }
+    ctl.Restore();
+    subscribeTopics.clear();
+    netRx.clear();
+    rxInterval = 0;
+    setting.clear();
+    upDevs.clear();
+    unsupportedDevs.clear();
+}
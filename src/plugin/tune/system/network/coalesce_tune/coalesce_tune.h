@@ -0,0 +1,66 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef COALESCE_TUNE_H
+#define COALESCE_TUNE_H
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include "oeaware/interface.h"
+#include "coalesce_ctl.h"
+
+namespace oeaware {
+class NetCoalesceTune : public Interface {
+public:
+    NetCoalesceTune();
+    ~NetCoalesceTune() override = default;
+    Result OpenTopic(const oeaware::Topic &topic) override;
+    void CloseTopic(const oeaware::Topic &topic) override;
+    void UpdateData(const DataList &dataList) override;
+    Result Enable(const std::string &param) override;
+    void Disable() override;
+    void Run() override;
+
+private:
+    std::vector<oeaware::Topic> subscribeTopics;
+    // dev name to the packets received in this period, every napi_gro_receive_entry record stands for period packets
+    std::unordered_map<std::string, uint64_t> netRx;
+    uint64_t rxInterval = 0;                                    // ms sampled in this period, the same for every dev
+    std::unordered_map<std::string, CoalesceSetting> setting;   // dev name to the setting written last
+    std::unordered_set<std::string> upDevs;
+    std::unordered_set<std::string> unsupportedDevs;
+    CoalesceBound bound;
+    uint32_t busyPoll = 0;
+    NetCoalesceCtl ctl;
+    std::map<std::string, std::string> cmdHelp = {
+        {"irq_rate",
+         "    -irq_rate <n>          max hard irqs per second of one rx queue, coalescing starts above it(default 20000)"},
+        {"min_usecs",
+         "    -min_usecs <n>         rx-usecs when the queue rate is below irq_rate, 0(default):the original one"},
+        {"max_usecs",
+         "    -max_usecs <n>         upper bound of rx-usecs, the latency added by coalescing(default 100)"},
+        {"max_frames",
+         "    -max_frames <n>        upper bound of rx-frames(default 64)"},
+        {"defer",
+         "    -defer <on/off>        on(default):also set napi_defer_hard_irqs and gro_flush_timeout when coalescing, "
+         "off:only set rx-usecs and rx-frames"},
+        {"busy_poll",
+         "    -busy_poll <usecs>     set net.core.busy_poll and net.core.busy_read, 0(default):not set"},
+    };
+    bool ResolveCmd(const std::string &param);
+    std::string GetHelp();
+    void UpdateNetIntfInfo(const DataList &dataList);
+    void UpdatePmuSampleInfo(const DataList &dataList);
+    void TuneDev(const std::string &dev, uint64_t rxPps);
+};
+}
+#endif
@@ -1,6 +1,5 @@
 #include "hardirq_tune.h"
 #include <sstream>
-#include <iomanip>
 #include <dirent.h>
 #include "oeaware/data/env_data.h"
 #include "oeaware/data/pmu_plugin.h"
@@ -69,6 +68,8 @@ void NetHardIrq::CloseTopic(const oeaware::Topic &topic)
 void NetHardIrq::Init()
 {
     showVerbose = false;
+    steerEnable = false;
+    hirqWeight = false;
     debugLog = "";
     runCnt = 0;
     InitIrqInfo();
@@ -124,6 +125,26 @@ bool NetHardIrq::ResolveCmd(const std::string &param)
             return false;
         }
     }
+    if (paramsMap.count("steer")) {
+        if (paramsMap["steer"] == "on") {
+            steerEnable = true;
+        } else if (paramsMap["steer"] == "off") {
+            steerEnable = false;
+        } else {
+            ERROR(logger, "steer invalid param: " << paramsMap["steer"]);
+            return false;
+        }
+    }
+    if (paramsMap.count("weight")) {
+        if (paramsMap["weight"] == "hirq") {
+            hirqWeight = true;
+        } else if (paramsMap["weight"] == "thread") {
+            hirqWeight = false;
+        } else {
+            ERROR(logger, "weight invalid param: " << paramsMap["weight"]);
+            return false;
+        }
+    }
     if (paramsMap.count("netdata")) {
         if (paramsMap["netdata"] == "thread_recv_que") {
             highNoiseSample = false;
@@ -156,6 +177,11 @@ void oeaware::NetHardIrq::UpdateSystemInfo(const DataList &dataList)
         for (int i = 0; i < dataTmp->cpuNumConfig; i++) {
             cpu2Numa[i] = dataTmp->cpu2Node[i];
         }
+        irqCpus.clear();
+        for (int i = 0; i < dataTmp->cpuNumConfig; i++) {
+            irqCpus.emplace_back(IrqCpu{ .cpu = i, .node = cpu2Numa[i] });
+        }
+        ReadIrqCpuTopology(irqCpus);
         envInit = true;
     }
 }
@@ -236,6 +262,19 @@ void NetHardIrq::UpdateNetIntfInfo(const DataList &dataList)
     }
 }
 
+void NetHardIrq::UpdateHirqStat(const DataList &dataList)
+{
+    if (std::string(dataList.topic.instanceName) != OE_NET_HIRQ_ANALYSIS ||
+        std::string(dataList.topic.topicName) != OE_TOPIC_NET_HIRQ_QUEUE_STAT) {
+        return;
+    }
+    const NetHirqStatList *dataTmp = static_cast<NetHirqStatList *>(dataList.data[0]);
+    queueRate.clear();
+    for (int i = 0; i < dataTmp->queueCount; ++i) {
+        queueRate[dataTmp->queue[i].dev][dataTmp->queue[i].queueId] = dataTmp->queue[i].stat.mean;
+    }
+}
+
 void NetHardIrq::UpdateCpuInfo(const EnvCpuUtilParam *data)
 {
     if (data == nullptr) {
@@ -253,10 +292,9 @@ void NetHardIrq::UpdateCpuInfo(const EnvCpuUtilParam *data)
             cpuUtil[i].resize(CPU_UTIL_TYPE_MAX, 0);
         }
     }
-    for (size_t i = 0; i < cpuTimeDiff.size(); ++i) {
-        for (size_t j = 0; j < cpuTimeDiff[i].size(); ++j) {
-            cpuTimeDiff[i][j] = data->times[i][j];
-        }
+    for (size_t i = 0; i < cpuNumConfig; ++i) {
+        const uint64_t *row = data->matrix + i * CPU_UTIL_TYPE_MAX;
+        std::copy(row, row + CPU_UTIL_TYPE_MAX, cpuTimeDiff[i].begin());
     }
 }
 
@@ -422,33 +460,44 @@ void NetHardIrq::MigrateHardIrq()
         return a.rxSum > b.rxSum;
         });
 
-    std::vector<std::vector<CpuSort>> cpuSort = SortNumaCpuUtil();
-    AddLog([&]() { return CpuSortLog(cpuSort); });
-    std::vector<int> newBindCnt(numaNum);
+    std::vector<IrqLoad> irqLoads;
+    for (auto &unit : migUint) {
+        uint64_t weight = static_cast<uint64_t>(unit.rxSum);
+        // the windowed rx rate of the queue is what the irq handles, the thread reads only give the numa.
+        // all weights are rates then, a queue without one has had no packets in the window
+        if (hirqWeight) {
+            weight = 0;
+            auto devIt = queueRate.find(unit.dev);
+            if (devIt != queueRate.end() && devIt->second.count(unit.queId)) {
+                weight = static_cast<uint64_t>(devIt->second.at(unit.queId));
+            }
+        }
+        irqLoads.emplace_back(IrqLoad{ .irqId = unit.irqId, .weight = weight,
+            .preferredNode = unit.preferredNode, .currentCpu = unit.lastBindCore });
+    }
+    float totalIrqLoad = UpdateIrqCpuLoad();
+    // only the irqs whose cpu changes are written
+    auto changed = assigner.Assign(irqCpus, irqLoads, totalIrqLoad);
     for (auto &unit : migUint) {
-        int preferredNode = unit.preferredNode;
         AddLog([&]() {
             return "migUint " + unit.GetInfo();
             });
-        if (unit.lastBindCore != -1 && preferredNode == cpu2Numa[unit.lastBindCore]) {
+        auto it = changed.find(unit.irqId);
+        if (it == changed.end()) {
             AddLog([]() { return " skip\n"; });
             continue;
         }
-        const std::vector<CpuSort> &sortedList = cpuSort[preferredNode];
-        /* 1. different interrupts should be allocated to different cores as much as possible
-           2. interrupt priority binding on cores with low CPU utilization */
-        int preferredCpu = sortedList[newBindCnt[preferredNode] % numaNum].cpu; // this may cause bind to the same core
+        int preferredCpu = it->second;
         int err = IrqSetSmpAffinity(unit.irqId, std::to_string(preferredCpu));
         if (err) {
             WARN(logger, "MigrateHardIrq set irq affinity failed, irqId: " << unit.irqId << ", preferredCpu: "
                 << preferredCpu << ", err: " << err);
         } else {
-            newBindCnt[preferredNode]++;
             AddLog([&]() {
                 return ", set irq from core " + (unit.lastBindCore == -1 ?
                     irqInfo[unit.irqId].originAffinity : std::to_string(unit.lastBindCore))
-                    + " to " + std::to_string(preferredCpu)
-                    + ", numaBindCnt " + std::to_string(newBindCnt[preferredNode]) + " \n";
+                    + " to " + std::to_string(preferredCpu) + ", cpu irq load "
+                    + std::to_string(assigner.GetCpuIrqLoad().at(preferredCpu)) + " \n";
                 });
             netQueue[unit.dev][unit.queId].lastBindCpu = preferredCpu;
             irqInfo[unit.irqId].isTuned = true;
@@ -457,6 +506,22 @@ void NetHardIrq::MigrateHardIrq()
     }
 }
 
+// update the task load of every cpu and return the irq and softirq load of all cpus
+float NetHardIrq::UpdateIrqCpuLoad()
+{
+    float totalIrqLoad = 0;
+    for (auto &cpu : irqCpus) {
+        if (static_cast<size_t>(cpu.cpu) >= cpuUtil.size()) {
+            continue;
+        }
+        const auto &util = cpuUtil[cpu.cpu];
+        // 100.0 is the max cpu util
+        cpu.taskLoad = std::max(0.0f, 100.0f - util[CPU_IDLE] - util[CPU_IRQ] - util[CPU_SOFTIRQ]);
+        totalIrqLoad += util[CPU_IRQ] + util[CPU_SOFTIRQ];
+    }
+    return totalIrqLoad;
+}
+
 void NetHardIrq::ResetCpuInfo()
 {
     for (auto &cpuItem : cpuTimeDiff) {
@@ -478,29 +543,60 @@ void oeaware::NetHardIrq::ResetNetQueue()
     }
 }
 
-std::vector<std::vector<CpuSort>> NetHardIrq::SortNumaCpuUtil()
-{
-    std::vector<std::vector<CpuSort>> rst;
-    rst.resize(numaNum);
-    for (size_t cpu = 0; cpu < cpu2Numa.size(); ++cpu) {
-        int nid = cpu2Numa[cpu];
-        // 100.0 is the max cpu util
-        rst[nid].emplace_back(cpu, 100.0 - cpuUtil[cpu][CPU_IDLE] - cpuUtil[cpu][CPU_IRQ] - cpuUtil[cpu][CPU_SOFTIRQ]);
-    }
-    for (auto &nodeCpuSort : rst) {
-        std::sort(nodeCpuSort.begin(), nodeCpuSort.end(), [](const CpuSort &a, const CpuSort &b) {
-            return a.ratio < b.ratio;
-        });
-    }
-    return rst;
-}
-
 void NetHardIrq::Tune()
 {
     AddIrqToQueueInfo();
     ClearInvalidQueueInfo();
     TunePreprocessing();
     MigrateHardIrq();
+    if (steerEnable) {
+        SteerQueues();
+    }
+}
+
+/*
+ * When a queue is read by threads on several nodes, moving its irq can only make one of them local.
+ * RPS with RFS moves the protocol processing to the cpu of the reading thread within the reading nodes,
+ * XPS makes the cpus of a node send on the queues whose irq is on that node.
+ */
+void NetHardIrq::SteerQueues()
+{
+    std::vector<std::vector<int>> nodeCpus(numaNum);
+    for (size_t cpu = 0; cpu < cpu2Numa.size(); ++cpu) {
+        nodeCpus[cpu2Numa[cpu]].emplace_back(cpu);
+    }
+    if (!steering.SetSockFlowEntries(RFS_SOCK_FLOW_ENTRIES)) {
+        WARN(logger, "SteerQueues set rps_sock_flow_entries failed");
+    }
+    for (auto &devItem : netQueue) {
+        const std::string &dev = devItem.first;
+        uint32_t flowCnt = RFS_SOCK_FLOW_ENTRIES / std::max<size_t>(devItem.second.size(), 1);
+        for (auto &queItem : devItem.second) {
+            auto &info = queItem.second;
+            if (info.rxSum < NET_RXT_THRESHOLD) {
+                continue;
+            }
+            std::vector<int> rxCpus;
+            for (size_t n = 0; n < info.numaRxTimes.size() && n < nodeCpus.size(); ++n) {
+                if (info.numaRxTimes[n] * STEER_NODE_RATIO >= info.rxSum) {
+                    rxCpus.insert(rxCpus.end(), nodeCpus[n].begin(), nodeCpus[n].end());
+                }
+            }
+            if (!steering.SetRxQueue(dev, queItem.first, rxCpus, flowCnt)) {
+                WARN(logger, "SteerQueues set rps of " << dev << " rx-" << queItem.first << " failed");
+            }
+            if (info.lastBindCpu == INVALID_CPU_ID) {
+                continue;
+            }
+            // tx queues without xps_cpus are skipped
+            (void)steering.SetTxQueue(dev, queItem.first, nodeCpus[cpu2Numa[info.lastBindCpu]]);
+            AddLog([&]() {
+                return "SteerQueues " + dev + " queue " + std::to_string(queItem.first) + " rps "
+                    + NetSteering::CpusToMask(rxCpus) + ", xps node " + std::to_string(cpu2Numa[info.lastBindCpu])
+                    + "\n";
+                });
+        }
+    }
 }
 
 void NetHardIrq::MatchThreadAndQueue()
@@ -591,6 +687,7 @@ void NetHardIrq::UpdateData(const DataList &dataList)
     UpdatePmuSampleInfo(dataList);
     UpdateEnvInfo(dataList);
     UpdateNetIntfInfo(dataList);
+    UpdateHirqStat(dataList);
 }
 
 oeaware::Result NetHardIrq::Enable(const std::string &param)
@@ -627,6 +724,9 @@ oeaware::Result NetHardIrq::Enable(const std::string &param)
             OE_PARA_THREAD_RECV_QUE_CNT });
         subscribeTopics.emplace_back(oeaware::Topic{ OE_PMU_SAMPLING_COLLECTOR, "cycles", "" });
     }
+    if (hirqWeight) {
+        subscribeTopics.emplace_back(oeaware::Topic{ OE_NET_HIRQ_ANALYSIS, OE_TOPIC_NET_HIRQ_QUEUE_STAT, "" });
+    }
     for (auto &topic : subscribeTopics) {
         Subscribe(topic);
     }
@@ -644,6 +744,7 @@ void NetHardIrq::Disable()
     for (auto &topic : subscribeTopics) {
         Unsubscribe(topic);
     }
+    steering.Restore();
     for (const auto &info : irqInfo) {
         if (!info.second.isTuned) {
             continue;
@@ -654,8 +755,10 @@ void NetHardIrq::Disable()
     }
     envInit = false;
     cpu2Numa.clear();
+    irqCpus.clear();
     irqInfo.clear();
     netQueue.clear();
+    queueRate.clear();
     subscribeTopics.clear();
     highNoiseSample = false;
 }
@@ -678,21 +781,6 @@ void NetHardIrq::PublishData()
     }
 }
 
-std::string NetHardIrq::CpuSortLog(const std::vector<std::vector<CpuSort>> &cpuSort)
-{
-    std::string log;
-    for (size_t n = 0; n < cpuSort.size(); ++n) {
-        log += "NUMA " + std::to_string(n) + ": ";
-        for (auto &cpuSort : cpuSort[n]) {
-            std::ostringstream oss;
-            oss << "[ " << cpuSort.cpu << "," << std::fixed << std::setprecision(1) << cpuSort.ratio << "]";
-            log += oss.str();
-        }
-        log += "\n";
-    }
-    return log;
-}
-
 void NetHardIrq::Run()
 {
     AddLog([&]() {
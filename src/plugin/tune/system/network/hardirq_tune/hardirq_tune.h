@@ -18,11 +18,15 @@
 #include "oeaware/data/pmu_sampling_data.h"
 #include "libkperf/pmu.h"
 #include "irq_frontend.h"
+#include "irq_assign.h"
+#include "net_steering.h"
 
 namespace oeaware {
 const int INVAILD_IRQ_ID = -1;
 const int INVALID_CPU_ID = -1;
 const int NET_RXT_THRESHOLD = 10; // < 10 means infrequent networks
+const uint32_t RFS_SOCK_FLOW_ENTRIES = 32768;
+const int STEER_NODE_RATIO = 10; // rps to the nodes that read at least 1/10 of the queue packets
 struct RecNetQueue {
     uint64_t ts;
     uint64_t queueMapping;
@@ -45,12 +49,6 @@ struct QueueInfo {
     std::vector<int> numaRxTimes;
 };
 
-struct CpuSort {
-    int cpu;
-    float ratio;
-    CpuSort(int c, float r) : cpu(c), ratio(r) {}
-};
-
 struct HardIrqMigUint {
     int irqId;
     int rxSum;
@@ -98,6 +96,12 @@ private:
     int netDataInterval = 0; // unit ms
     unsigned int numaNum = 0;
     std::vector<int> cpu2Numa;
+    std::vector<IrqCpu> irqCpus; // cpu topology for irq assignment
+    IrqAssigner assigner;
+    bool steerEnable = false;
+    bool hirqWeight = false; // irq weight by the queue rate of net_hirq_analysis instead of the thread reads
+    std::unordered_map<std::string, std::unordered_map<int, float>> queueRate; // dev name to queue mean rx rate
+    NetSteering steering;
     std::unordered_map<uint32_t, std::string> ifIdxToName;
     bool envInit = false;
     std::map<std::string, std::string> cmdHelp = {
@@ -108,6 +112,12 @@ private:
          "                           skb_copy                       use skb copy, high load collect\n"},
         {"verbose",
          "    -verbose <on/off>      on:show verbose info, off(default):hide verbose info"},
+        {"steer",
+         "    -steer <on/off>        on:also set rps/rfs/xps of the queues by the numa of the receiving threads, "
+         "off(default):only set irq affinity"},
+        {"weight",
+         "    -weight <thread/hirq>  thread(default):irq load by the packets read by the threads, "
+         "hirq:by the queue rx rate of net_hirq_analysis::net_hirq_queue_stat"},
     };
     std::vector<std::vector<uint64_t>> cpuTimeDiff;
     std::vector<std::vector<float>> cpuUtil;
@@ -122,6 +132,7 @@ private:
     void UpdatePmuSampleInfo(const DataList &dataList);
     void UpdateEnvInfo(const DataList &dataList);
     void UpdateNetIntfInfo(const DataList &dataList);
+    void UpdateHirqStat(const DataList &dataList);
     void UpdateCpuInfo(const EnvCpuUtilParam *data);
     void UpdateQueueData(const PmuData *data, int dataLen);
     void UpdateThreadData(const PmuData *data, int dataLen);
@@ -134,9 +145,10 @@ private:
     void CalCpuUtil();
     void TunePreprocessing();
     void MigrateHardIrq();
+    void SteerQueues();
     void ResetCpuInfo();
     void ResetNetQueue();
-    std::vector<std::vector<CpuSort>> SortNumaCpuUtil();
+    float UpdateIrqCpuLoad();
     void Tune();
     // read conf and resolve queue to irq
     IrqFrontEnd conf;
@@ -153,7 +165,6 @@ private:
             debugLog += logFunc();
         }
     }
-    std::string CpuSortLog(const std::vector<std::vector<CpuSort>> &cpuSort);
     void PublishData();
 };
 }
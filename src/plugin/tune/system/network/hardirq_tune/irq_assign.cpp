@@ -0,0 +1,127 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "irq_assign.h"
+#include <algorithm>
+#include <fstream>
+#include "oeaware/utils.h"
+
+namespace oeaware {
+static int CoreOf(const IrqCpu &cpu)
+{
+    return cpu.core < 0 ? cpu.cpu : cpu.core;
+}
+
+static int ClusterOf(const IrqCpu &cpu)
+{
+    return cpu.cluster < 0 ? CoreOf(cpu) : cpu.cluster;
+}
+
+static float Get(const std::unordered_map<int, float> &loads, int key)
+{
+    auto it = loads.find(key);
+    return it == loads.end() ? 0 : it->second;
+}
+
+float IrqAssigner::Cost(const IrqCpu &cpu, float load) const
+{
+    float own = Get(cpuIrq, cpu.cpu);
+    float core = Get(coreIrq, CoreOf(cpu));
+    float cluster = Get(clusterIrq, ClusterOf(cpu));
+    return cpu.taskLoad + own + load + option.smtShare * (core - own) + option.clusterShare * (cluster - core);
+}
+
+std::unordered_map<int, int> IrqAssigner::Assign(const std::vector<IrqCpu> &cpus, const std::vector<IrqLoad> &irqs,
+    float totalIrqLoad)
+{
+    std::unordered_map<int, int> changed;
+    cpuIrq.clear();
+    coreIrq.clear();
+    clusterIrq.clear();
+    if (cpus.empty()) {
+        return changed;
+    }
+    uint64_t totalWeight = 0;
+    for (auto &irq : irqs) {
+        totalWeight += irq.weight;
+    }
+    std::vector<std::pair<float, const IrqLoad*>> order;
+    for (auto &irq : irqs) {
+        float load = totalWeight == 0 ? 0 : totalIrqLoad * irq.weight / totalWeight;
+        order.emplace_back(std::max(load, option.minIrqLoad), &irq);
+    }
+    std::sort(order.begin(), order.end(), [](const std::pair<float, const IrqLoad*> &a,
+        const std::pair<float, const IrqLoad*> &b) {
+        if (a.first != b.first) {
+            return a.first > b.first;
+        }
+        return a.second->irqId < b.second->irqId;
+    });
+    std::unordered_map<int, std::vector<const IrqCpu*>> nodeCpus;
+    std::vector<const IrqCpu*> allCpus;
+    for (auto &cpu : cpus) {
+        nodeCpus[cpu.node].emplace_back(&cpu);
+        allCpus.emplace_back(&cpu);
+    }
+    for (auto &item : order) {
+        float load = item.first;
+        const IrqLoad &irq = *item.second;
+        auto it = nodeCpus.find(irq.preferredNode);
+        const auto &candidates = it == nodeCpus.end() ? allCpus : it->second;
+        const IrqCpu *best = nullptr;
+        const IrqCpu *current = nullptr;
+        float bestCost = 0;
+        float currentCost = 0;
+        for (auto cpu : candidates) {
+            float cost = Cost(*cpu, load);
+            if (best == nullptr || cost < bestCost) {
+                best = cpu;
+                bestCost = cost;
+            }
+            if (cpu->cpu == irq.currentCpu) {
+                current = cpu;
+                currentCost = cost;
+            }
+        }
+        // hysteresis, stay if moving does not gain enough
+        if (current != nullptr && currentCost <= bestCost + option.hysteresis) {
+            best = current;
+        }
+        cpuIrq[best->cpu] += load;
+        coreIrq[CoreOf(*best)] += load;
+        clusterIrq[ClusterOf(*best)] += load;
+        if (best->cpu != irq.currentCpu) {
+            changed[irq.irqId] = best->cpu;
+        }
+    }
+    return changed;
+}
+
+static int FirstCpuOfList(const std::string &path)
+{
+    std::ifstream file(path);
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line)) {
+        return -1;
+    }
+    auto list = ParseRange(line);
+    return list.empty() ? -1 : *std::min_element(list.begin(), list.end());
+}
+
+void ReadIrqCpuTopology(std::vector<IrqCpu> &cpus, const std::string &root)
+{
+    for (auto &cpu : cpus) {
+        std::string topo = root + "cpu" + std::to_string(cpu.cpu) + "/topology/";
+        cpu.core = FirstCpuOfList(topo + "thread_siblings_list");
+        cpu.cluster = FirstCpuOfList(topo + "cluster_cpus_list");
+    }
+}
+}
@@ -0,0 +1,73 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef HARDIRQ_IRQ_ASSIGN_H
+#define HARDIRQ_IRQ_ASSIGN_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace oeaware {
+struct IrqCpu {
+    int cpu;
+    int node;
+    int core = -1;     // smallest cpu of the SMT siblings, -1 means the cpu itself
+    int cluster = -1;  // smallest cpu of the cluster, -1 means the core
+    float taskLoad = 0; // busy percent without irq and softirq
+};
+
+struct IrqLoad {
+    int irqId;
+    uint64_t weight;     // received packets of the queue in the last period
+    int preferredNode;
+    int currentCpu = -1; // -1 if the irq is not bound by the tuner yet
+};
+
+/*
+ * Assign the queue irqs of all nics at once.
+ * The irq and softirq load measured on all cpus is split between the irqs by weight, then the irqs are placed from
+ * the heaviest one on the cpu of the preferred node with the lowest cost. The cost of a cpu is its task load plus
+ * the irq load placed on it, and a part of the irq load placed on its SMT siblings and on its cluster.
+ * An irq only moves if the best cpu is cheaper than its current cpu by more than the hysteresis.
+ */
+class IrqAssigner {
+public:
+    struct Option {
+        float smtShare = 0.5;     // part of the sibling irq load that is added to the cost
+        float clusterShare = 0.1; // part of the irq load of other cores in the cluster that is added to the cost
+        float hysteresis = 10.0;  // percent
+        float minIrqLoad = 0.5;   // percent, so that irqs are spread even if no irq load is measured
+    };
+    IrqAssigner() = default;
+    explicit IrqAssigner(const Option &option) : option(option) { }
+    // Return irq to cpu for the irqs whose cpu changes.
+    std::unordered_map<int, int> Assign(const std::vector<IrqCpu> &cpus, const std::vector<IrqLoad> &irqs,
+        float totalIrqLoad);
+    // Irq load placed on every cpu by the last Assign.
+    const std::unordered_map<int, float> &GetCpuIrqLoad() const
+    {
+        return cpuIrq;
+    }
+private:
+    float Cost(const IrqCpu &cpu, float load) const;
+    Option option;
+    std::unordered_map<int, float> cpuIrq;
+    std::unordered_map<int, float> coreIrq;
+    std::unordered_map<int, float> clusterIrq;
+};
+
+// Fill core and cluster of the cpus from sysfs, they are left to -1 if the topology is not exported.
+void ReadIrqCpuTopology(std::vector<IrqCpu> &cpus, const std::string &root = "/sys/devices/system/cpu/");
+}
+
+#endif
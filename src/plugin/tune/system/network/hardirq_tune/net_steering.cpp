@@ -0,0 +1,105 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "net_steering.h"
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+
+namespace oeaware {
+constexpr int MASK_GROUP_BITS = 32;
+constexpr int MASK_GROUP_LEN = 8;
+
+std::string NetSteering::CpusToMask(const std::vector<int> &cpus)
+{
+    int maxCpu = 0;
+    for (auto cpu : cpus) {
+        maxCpu = std::max(maxCpu, cpu);
+    }
+    std::vector<uint32_t> groups(maxCpu / MASK_GROUP_BITS + 1, 0);
+    for (auto cpu : cpus) {
+        if (cpu >= 0) {
+            groups[cpu / MASK_GROUP_BITS] |= 1U << (cpu % MASK_GROUP_BITS);
+        }
+    }
+    std::string mask;
+    char buf[MASK_GROUP_LEN + 1];
+    for (auto it = groups.rbegin(); it != groups.rend(); ++it) {
+        (void)snprintf(buf, sizeof(buf), "%08x", *it);
+        if (!mask.empty()) {
+            mask += ",";
+        }
+        mask += buf;
+    }
+    return mask;
+}
+
+bool NetSteering::Write(const std::string &path, const std::string &value)
+{
+    auto it = current.find(path);
+    if (it != current.end() && it->second == value) {
+        return true;
+    }
+    if (origin.count(path) == 0) {
+        std::ifstream in(path);
+        std::string old;
+        if (!in.is_open() || !std::getline(in, old)) {
+            return false;
+        }
+        origin[path] = old;
+    }
+    std::ofstream out(path);
+    if (!out.is_open() || !(out << value << '\n') || !out.flush()) {
+        return false;
+    }
+    current[path] = value;
+    return true;
+}
+
+bool NetSteering::SetRxQueue(const std::string &dev, int queueId, const std::vector<int> &cpus, uint32_t flowCnt)
+{
+    std::string queue = netRoot + dev + "/queues/rx-" + std::to_string(queueId) + "/";
+    bool ret = Write(queue + "rps_cpus", CpusToMask(cpus));
+    // without RFS entries RPS only hashes flows to the cpus
+    return Write(queue + "rps_flow_cnt", std::to_string(flowCnt)) && ret;
+}
+
+bool NetSteering::SetTxQueue(const std::string &dev, int queueId, const std::vector<int> &cpus)
+{
+    return Write(netRoot + dev + "/queues/tx-" + std::to_string(queueId) + "/xps_cpus", CpusToMask(cpus));
+}
+
+bool NetSteering::SetSockFlowEntries(uint32_t entries)
+{
+    std::string path = coreRoot + "rps_sock_flow_entries";
+    std::ifstream in(path);
+    unsigned long old = 0;
+    if (!(in >> old)) {
+        return false;
+    }
+    if (old >= entries) {
+        return true;
+    }
+    return Write(path, std::to_string(entries));
+}
+
+void NetSteering::Restore()
+{
+    for (auto &item : origin) {
+        std::ofstream out(item.first);
+        if (out.is_open()) {
+            out << item.second << '\n';
+        }
+    }
+    origin.clear();
+    current.clear();
+}
+}
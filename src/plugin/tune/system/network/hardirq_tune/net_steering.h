@@ -0,0 +1,47 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef HARDIRQ_NET_STEERING_H
+#define HARDIRQ_NET_STEERING_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace oeaware {
+/*
+ * RPS/RFS/XPS settings of the nic queues, used with the irq affinity when a queue is shared by threads on
+ * several numa nodes. The original value of every file is saved before the first write and written back by Restore.
+ */
+class NetSteering {
+public:
+    explicit NetSteering(const std::string &netRoot = "/sys/class/net/",
+        const std::string &coreRoot = "/proc/sys/net/core/") : netRoot(netRoot), coreRoot(coreRoot) { }
+    // rps_cpus and rps_flow_cnt of rx-<queueId>
+    bool SetRxQueue(const std::string &dev, int queueId, const std::vector<int> &cpus, uint32_t flowCnt);
+    // xps_cpus of tx-<queueId>, false if the queue has no xps
+    bool SetTxQueue(const std::string &dev, int queueId, const std::vector<int> &cpus);
+    // rps_sock_flow_entries, the global RFS table, is only increased
+    bool SetSockFlowEntries(uint32_t entries);
+    void Restore();
+    // "0-3,32" -> "00000001,0000000f", 32 bit groups like the kernel prints cpumasks
+    static std::string CpusToMask(const std::vector<int> &cpus);
+private:
+    bool Write(const std::string &path, const std::string &value);
+    std::string netRoot;
+    std::string coreRoot;
+    std::map<std::string, std::string> origin; // path to the value before tuning
+    std::map<std::string, std::string> current; // path to the value written last
+};
+}
+
+#endif
@@ -10,10 +10,20 @@
  * See the Mulan PSL v2 for more details.
  ******************************************************************************/
 #include "multi_net_path.h"
+#include <dirent.h>
+#include <sys/stat.h>
 #include <sys/utsname.h>
+#include <securec.h>
 #include "oeaware/data_list.h"
+#include "oeaware/data/network_interface_data.h"
+#include "oeaware/data/thread_info.h"
+#include "oeaware/data/multi_net_path_data.h"
 
 using namespace oeaware;
+static const std::string HARDIRQ_CONFIG_PATH = oeaware::DEFAULT_PLUGIN_CONFIG_PATH + "/hardirq_tune.conf";
+static const std::string OENETCLS_PARAM_PATH = "/sys/module/oenetcls/parameters/";
+static const std::string SCHED_STAT_TOPIC = "thread_sched_stat";
+
 MultiNetPath::MultiNetPath()
 {
     name = OE_MULTI_NET_PATH_TUNE;
@@ -24,29 +34,126 @@ MultiNetPath::MultiNetPath()
     description += "[introduction] \n";
     description += "               The queue of the network interface is compatible with the NUMA \n";
     description += "               where the service is located and is only allocated to this service \n";
+    description += "               The queues follow the NUMA of the service threads and are released by idle apps \n";
+    description += "[provide topics]\n";
+    description += "                 " + std::string(OE_TOPIC_MULTI_NET_PATH_LOCALITY) + "\n";
+    supportTopics.emplace_back(Topic{name, OE_TOPIC_MULTI_NET_PATH_LOCALITY, ""});
 }
 
 oeaware::Result MultiNetPath::OpenTopic(const oeaware::Topic &topic)
 {
-    (void)topic;
+    if (topic.topicName != OE_TOPIC_MULTI_NET_PATH_LOCALITY || !topic.params.empty()) {
+        return oeaware::Result(FAILED, "topic " + topic.GetType() + " not support");
+    }
+    localityTopicOpen = true;
     return oeaware::Result(OK);
 }
 
 void MultiNetPath::CloseTopic(const oeaware::Topic &topic)
 {
-    (void)topic;
+    if (topic.topicName == OE_TOPIC_MULTI_NET_PATH_LOCALITY) {
+        localityTopicOpen = false;
+    }
+}
+
+bool MultiNetPath::AppMatch(int pid)
+{
+    if (appname == "all_app") {
+        return true;
+    }
+    auto it = appComm.find(pid);
+    if (it == appComm.end()) {
+        std::ifstream file("/proc/" + std::to_string(pid) + "/comm");
+        std::string comm;
+        std::getline(file, comm);
+        it = appComm.emplace(pid, comm).first;
+    }
+    return it->second == appname;
+}
+
+void MultiNetPath::UpdateNetIntfInfo(const DataList &dataList)
+{
+    const std::string topicName = dataList.topic.topicName;
+    if (topicName == OE_NETWORK_INTERFACE_BASE_TOPIC) {
+        auto data = static_cast<NetIntfBaseDataList *>(dataList.data[0]);
+        for (int i = 0; i < data->count; ++i) {
+            ifIdxToName[data->base[i].ifindex] = data->base[i].name;
+        }
+    } else if (topicName == OE_NETWORK_INTERFACE_DRIVER_TOPIC) {
+        auto data = static_cast<NetIntfDriverDataList *>(dataList.data[0]);
+        for (int i = 0; i < data->count; ++i) {
+            std::string dev = data->driver[i].name;
+            if (std::find(ifname.begin(), ifname.end(), dev) == ifname.end()) {
+                continue;
+            }
+            auto &info = ethDriver[dev];
+            info.dev = dev;
+            info.busInfo = data->driver[i].busInfo;
+            info.driver = data->driver[i].driver;
+        }
+    } else if (topicName == OE_NET_THREAD_QUE_DATA) {
+        auto data = static_cast<NetThreadQueDataList *>(dataList.data[0]);
+        for (int i = 0; i < data->count; ++i) {
+            auto &que = data->queData[i];
+            auto it = ifIdxToName.find(que.ifIndex);
+            if (it == ifIdxToName.end() || std::find(ifname.begin(), ifname.end(), it->second) == ifname.end()) {
+                continue;
+            }
+            if (!AppMatch(que.pid)) {
+                continue;
+            }
+            appQueueRx[que.pid][it->second][que.queueId] += que.times;
+        }
+    }
+}
+
+void MultiNetPath::UpdateSchedStat(const DataList &dataList)
+{
+    auto data = static_cast<ThreadSchedStatList *>(dataList.data[0]);
+    for (int i = 0; i < data->len; ++i) {
+        auto &stat = data->stats[i];
+        if (stat.node < 0 || stat.node >= static_cast<int>(nodeCpus.size()) || !AppMatch(stat.pid)) {
+            continue;
+        }
+        auto &run = appNodeRun[stat.pid];
+        run.resize(nodeCpus.size(), 0);
+        run[stat.node] += stat.runTime;
+    }
 }
 
 void MultiNetPath::UpdateData(const DataList &dataList)
 {
-    (void)dataList;
-    // todo : low load update net and check
+    if (!planner || dataList.len == 0 || dataList.data == nullptr) {
+        return;
+    }
+    std::string instanceName = dataList.topic.instanceName;
+    if (instanceName == OE_NET_INTF_INFO) {
+        UpdateNetIntfInfo(dataList);
+    } else if (instanceName == OE_THREAD_COLLECTOR && std::string(dataList.topic.topicName) == SCHED_STAT_TOPIC) {
+        UpdateSchedStat(dataList);
+    }
+}
+
+bool MultiNetPath::InitNodeCpus()
+{
+    nodeCpus.clear();
+    for (int node = 0;; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file.is_open()) {
+            break;
+        }
+        std::string cpus;
+        std::getline(file, cpus);
+        nodeCpus.emplace_back(cpus);
+    }
+    return !nodeCpus.empty();
 }
 
 oeaware::Result MultiNetPath::Enable(const std::string &param)
 {
     bool isActive;
     irqbalanceStatus = false;
+    loadedByTune = false;
 
     if (!ResolveCmd(param)) {
         return oeaware::Result(FAILED, "param resolve failed\n" + GetHelp());
@@ -54,6 +161,12 @@ oeaware::Result MultiNetPath::Enable(const std::string &param)
     if (!CheckParam()) {
         return oeaware::Result(FAILED, "param check failed" + GetHelp());
     }
+    if (!InitNodeCpus()) {
+        return oeaware::Result(FAILED, "failed to read the numa nodes");
+    }
+    if (!conf.InitConf(HARDIRQ_CONFIG_PATH)) {
+        return oeaware::Result(FAILED, "read " + HARDIRQ_CONFIG_PATH + " failed.");
+    }
     // confilct with irqbalance, disable it before insert ko
     if (ServiceIsActive("irqbalance", isActive)) {
         irqbalanceStatus = isActive;
@@ -62,29 +175,184 @@ oeaware::Result MultiNetPath::Enable(const std::string &param)
         ServiceControl("irqbalance", "stop");
     }
 
-    if (InsertOeNetCls()) {
-        return oeaware::Result(OK);
+    if (!ReuseOeNetCls() && !InsertOeNetCls()) {
+        // exit and restore irqbalance status
+        if (irqbalanceStatus) {
+            ServiceControl("irqbalance", "start");
+        }
+        return oeaware::Result(FAILED, "Insert oenetcls.ko failed");
     }
-    // exit and restore irqbalance status
-    if (irqbalanceStatus) {
-        ServiceControl("irqbalance", "start");
+    planner = std::make_unique<QueuePlanner>(static_cast<int>(nodeCpus.size()));
+    subscribeTopics.clear();
+    subscribeTopics.emplace_back(Topic{OE_NET_INTF_INFO, OE_NETWORK_INTERFACE_BASE_TOPIC, "operstate_up"});
+    subscribeTopics.emplace_back(Topic{OE_NET_INTF_INFO, OE_NETWORK_INTERFACE_DRIVER_TOPIC, "operstate_up"});
+    subscribeTopics.emplace_back(Topic{OE_NET_INTF_INFO, OE_NET_THREAD_QUE_DATA, OE_PARA_THREAD_RECV_QUE_CNT});
+    subscribeTopics.emplace_back(Topic{OE_THREAD_COLLECTOR, SCHED_STAT_TOPIC, ""});
+    for (auto &topic : subscribeTopics) {
+        Subscribe(topic);
     }
-    return oeaware::Result(FAILED, "Insert oenetcls.ko failed");
+    return oeaware::Result(OK);
+}
+
+void MultiNetPath::RestoreIrqs()
+{
+    for (auto &item : originAffinity) {
+        int err = IrqSetSmpAffinity(item.first, item.second);
+        if (err != 0) {
+            WARN(logger, "restore irq " << item.first << " affinity " << item.second << " failed, " << strerror(err));
+        }
+    }
+    originAffinity.clear();
+    devPlan.clear();
 }
 
 void MultiNetPath::Disable()
 {
-    int result = system("rmmod oenetcls");
-    if (result != 0) {
-        ERROR(logger, "rmmod oenetcls failed");
+    for (auto &topic : subscribeTopics) {
+        Unsubscribe(topic);
     }
+    subscribeTopics.clear();
+    RestoreIrqs();
+    if (loadedByTune) {
+        int result = system("rmmod oenetcls");
+        if (result != 0) {
+            ERROR(logger, "rmmod oenetcls failed");
+        }
+    }
+    loadedByTune = false;
     if (irqbalanceStatus) {
         ServiceControl("irqbalance", "start");
     }
+    planner.reset();
+    ifIdxToName.clear();
+    ethDriver.clear();
+    appQueueRx.clear();
+    appNodeRun.clear();
+    appComm.clear();
+}
+
+void MultiNetPath::ApplyPlan(const std::unordered_map<int, int> &que2Irq, const std::vector<int> &last,
+    const std::vector<int> &plan)
+{
+    for (auto &item : que2Irq) {
+        size_t queue = static_cast<size_t>(item.first);
+        int irq = item.second;
+        int node = queue < plan.size() ? plan[queue] : -1;
+        int lastNode = queue < last.size() ? last[queue] : -1;
+        if (node == lastNode) {
+            continue;
+        }
+        if (!originAffinity.count(irq)) {
+            originAffinity[irq] = IrqGetSmpAffinity(irq);
+        }
+        // a released queue goes back to where it was before tuning
+        const std::string &cpus = node >= 0 ? nodeCpus[node] : originAffinity[irq];
+        int err = IrqSetSmpAffinity(irq, cpus);
+        if (err != 0) {
+            WARN(logger, "set irq " << irq << " affinity " << cpus << " failed, " << strerror(err));
+        } else {
+            INFO(logger, "queue " << queue << " irq " << irq << " moved from node " << lastNode << " to " << node);
+        }
+    }
+}
+
+void MultiNetPath::Rebalance()
+{
+    std::vector<AppRx> appRx;
+    for (auto &app : appQueueRx) {
+        AppRx rx;
+        rx.pid = app.first;
+        for (auto &dev : app.second) {
+            for (auto &queue : dev.second) {
+                rx.rxPackets += queue.second;
+            }
+        }
+        auto it = appNodeRun.find(app.first);
+        if (it != appNodeRun.end()) {
+            rx.nodeRunTime = it->second;
+        }
+        appRx.emplace_back(rx);
+    }
+    planner->Update(appRx);
+
+    // the regexes are added on every call, so the devices are copied for each run
+    std::unordered_map<std::string, EthQueInfo> ethQueData = ethDriver;
+    conf.GetEthQueData(ethQueData, conf.GetQueRegex());
+    for (auto &item : ethQueData) {
+        auto &que2Irq = item.second.que2Irq;
+        if (que2Irq.empty()) {
+            continue;
+        }
+        int queueNum = 0;
+        for (auto &que : que2Irq) {
+            queueNum = std::max(queueNum, que.first + 1);
+        }
+        auto &last = devPlan[item.first];
+        auto plan = planner->Assign(queueNum, last);
+        ApplyPlan(que2Irq, last, plan);
+        last = plan;
+    }
+}
+
+void MultiNetPath::PublishLocality()
+{
+    if (!localityTopicOpen) {
+        return;
+    }
+    auto data = new MultiNetPathLocalityList();
+    data->intervalMs = period;
+    data->count = static_cast<int>(appQueueRx.size());
+    if (data->count > 0) {
+        data->apps = new MultiNetPathAppLocality[data->count]();
+    }
+    int n = 0;
+    for (auto &app : appQueueRx) {
+        auto &out = data->apps[n++];
+        out.pid = app.first;
+        auto comm = appComm.find(app.first);
+        if (comm != appComm.end()) {
+            (void)strncpy_s(out.comm, sizeof(out.comm), comm->second.c_str(), sizeof(out.comm) - 1);
+        }
+        out.node = planner->GetHome(app.first);
+        for (auto &dev : app.second) {
+            auto plan = devPlan.find(dev.first);
+            for (auto &queue : dev.second) {
+                out.rxPackets += queue.second;
+                if (out.node >= 0 && plan != devPlan.end() && queue.first >= 0 &&
+                    queue.first < static_cast<int>(plan->second.size()) && plan->second[queue.first] == out.node) {
+                    out.localPackets += queue.second;
+                }
+            }
+        }
+        for (auto &plan : devPlan) {
+            if (out.node >= 0) {
+                out.queues += std::count(plan.second.begin(), plan.second.end(), out.node);
+            }
+        }
+        out.locality = out.rxPackets == 0 ? 0 : static_cast<float>(out.localPackets) / out.rxPackets;
+    }
+    DataList dataList;
+    if (!SetDataListTopic(&dataList, name, OE_TOPIC_MULTI_NET_PATH_LOCALITY, "")) {
+        delete[] data->apps;
+        delete data;
+        return;
+    }
+    dataList.len = 1;
+    dataList.data = new void *[1];
+    dataList.data[0] = data;
+    Publish(dataList);
 }
 
 void MultiNetPath::Run()
 {
+    if (!planner) {
+        return;
+    }
+    Rebalance();
+    PublishLocality();
+    appQueueRx.clear();
+    appNodeRun.clear();
+    appComm.clear();
 }
 
 bool oeaware::MultiNetPath::CheckParam()
@@ -115,6 +383,42 @@ std::string oeaware::MultiNetPath::GetHelp()
     return output;
 }
 
+/*
+ * A loaded oenetcls is kept when it serves the same devices, the app name and the ip match flag are written to
+ * its parameters instead of reloading it. Parameters the module does not allow to write keep their values.
+ */
+bool oeaware::MultiNetPath::ReuseOeNetCls()
+{
+    struct stat st;
+    if (stat(OENETCLS_PARAM_PATH.c_str(), &st) != 0) {
+        return false;
+    }
+    std::ifstream ifnameFile(OENETCLS_PARAM_PATH + "ifname");
+    std::string loaded;
+    std::getline(ifnameFile, loaded);
+    if (loaded != ifnamePara) {
+        ERROR(logger, "oenetcls is loaded with ifname " << loaded << ", not " << ifnamePara);
+        return false;
+    }
+    std::map<std::string, std::string> params = { {"appname", appname == "all_app" ? "" : appname} };
+    if (matchIp != invaildParam) {
+        params["match_ip_flag"] = std::to_string(matchIp);
+    }
+    for (auto &item : params) {
+        std::string path = OENETCLS_PARAM_PATH + item.first;
+        if (stat(path.c_str(), &st) != 0 || !(st.st_mode & S_IWUSR)) {
+            WARN(logger, "oenetcls " << item.first << " is read only, it keeps the value it was loaded with");
+            continue;
+        }
+        std::ofstream file(path);
+        if (!file.is_open() || !(file << item.second << '\n')) {
+            WARN(logger, "failed to write oenetcls " << item.first);
+        }
+    }
+    INFO(logger, "reuse the loaded oenetcls");
+    return true;
+}
+
 bool oeaware::MultiNetPath::InsertOeNetCls()
 {
     int result = 0;
@@ -142,6 +446,7 @@ bool oeaware::MultiNetPath::InsertOeNetCls()
         return false;
     }
     INFO(logger, modCmd << " success");
+    loadedByTune = true;
 
     return true;
 }
@@ -176,6 +481,8 @@ bool MultiNetPath::ResolveCmd(const std::string &param)
         ERROR(logger, name << " param is empty");
         return false;
     }
+    matchIp = invaildParam;
+    mode = invaildParam;
     auto paramsMap = GetKeyValueFromString(param);
     for (auto &item : paramsMap) {
         if (!cmdHelp.count(item.first) || !CheckLegal(item.second)) {
@@ -207,6 +514,21 @@ bool MultiNetPath::ResolveCmd(const std::string &param)
         }
     }
 
+    if (paramsMap.count("matchip")) {
+        if (paramsMap["matchip"] != "0" && paramsMap["matchip"] != "1") {
+            ERROR(logger, "matchip should be 0 or 1");
+            return false;
+        }
+        matchIp = atoi(paramsMap["matchip"].data());
+    }
+    if (paramsMap.count("mode")) {
+        if (paramsMap["mode"] != "0" && paramsMap["mode"] != "1") {
+            ERROR(logger, "mode should be 0 or 1");
+            return false;
+        }
+        mode = atoi(paramsMap["mode"].data());
+    }
+
     if (matchIp != invaildParam) {
         cmd += " match_ip_flag=" + std::to_string(matchIp);
     }
@@ -12,7 +12,11 @@
 #ifndef MULTI_NET_PATH_TUNE
 #define MULTI_NET_PATH_TUNE
 
+#include <memory>
+#include <unordered_map>
 #include "oeaware/interface.h"
+#include "irq_frontend.h"
+#include "queue_plan.h"
 
 namespace oeaware {
 class MultiNetPath : public Interface {
@@ -53,6 +57,31 @@ private:
     bool CheckParam();
     std::string GetHelp();
     bool InsertOeNetCls();
+    bool ReuseOeNetCls();
+    bool InitNodeCpus();
+    bool AppMatch(int pid);
+    void UpdateNetIntfInfo(const DataList &dataList);
+    void UpdateSchedStat(const DataList &dataList);
+    void Rebalance();
+    void ApplyPlan(const std::unordered_map<int, int> &que2Irq, const std::vector<int> &last,
+        const std::vector<int> &plan);
+    void RestoreIrqs();
+    void PublishLocality();
+
+    bool loadedByTune = false;   // oenetcls is removed on disable only if the tune loaded it
+    bool localityTopicOpen = false;
+    std::vector<oeaware::Topic> subscribeTopics;
+    std::vector<std::string> nodeCpus;  // node to its cpu list
+    std::unique_ptr<QueuePlanner> planner;
+    IrqFrontEnd conf;
+    std::unordered_map<int, std::string> ifIdxToName;
+    std::unordered_map<std::string, EthQueInfo> ethDriver;  // dev, bus info and driver of the tuned devices
+    // pid to dev to queue id to packets received in the period
+    std::unordered_map<int, std::unordered_map<std::string, std::unordered_map<int, uint64_t>>> appQueueRx;
+    std::unordered_map<int, std::vector<uint64_t>> appNodeRun; // pid to run time on each node in the period
+    std::unordered_map<int, std::string> appComm; // pid to comm, refreshed every period
+    std::unordered_map<std::string, std::vector<int>> devPlan;  // dev to the queue to node plan applied last
+    std::unordered_map<int, std::string> originAffinity;  // irq to smp_affinity_list before tuning
 };
 
 }
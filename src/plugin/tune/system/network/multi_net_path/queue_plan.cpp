@@ -0,0 +1,138 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "queue_plan.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace oeaware {
+static int BusiestNode(const std::vector<uint64_t> &nodeRunTime)
+{
+    int best = -1;
+    for (size_t node = 0; node < nodeRunTime.size(); ++node) {
+        if (nodeRunTime[node] > 0 && (best < 0 || nodeRunTime[node] > nodeRunTime[best])) {
+            best = static_cast<int>(node);
+        }
+    }
+    return best;
+}
+
+void QueuePlanner::Update(const std::vector<AppRx> &appRx)
+{
+    std::unordered_set<int> seen;
+    for (auto &rx : appRx) {
+        seen.insert(rx.pid);
+        auto &state = apps[rx.pid];
+        state.demand = option.rxWeight * rx.rxPackets + (1 - option.rxWeight) * state.demand;
+        state.idle = rx.rxPackets < option.idleRx ? state.idle + 1 : 0;
+        int busiest = BusiestNode(rx.nodeRunTime);
+        if (busiest < 0 || busiest >= nodeNum) {
+            continue;
+        }
+        if (state.home < 0 || static_cast<size_t>(state.home) >= rx.nodeRunTime.size()) {
+            state.home = busiest;
+        } else if (busiest != state.home &&
+            rx.nodeRunTime[busiest] > rx.nodeRunTime[state.home] * (1 + option.homeMargin)) {
+            state.home = busiest;
+        }
+    }
+    for (auto it = apps.begin(); it != apps.end();) {
+        if (!seen.count(it->first)) {
+            it->second.demand *= 1 - option.rxWeight;
+            it->second.idle++;
+        }
+        if (it->second.idle >= option.idleRuns) {
+            it = apps.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+int QueuePlanner::GetHome(int pid) const
+{
+    auto it = apps.find(pid);
+    return it == apps.end() ? -1 : it->second.home;
+}
+
+std::vector<int> QueuePlanner::NodeTarget(int queueNum) const
+{
+    std::vector<double> demand(nodeNum, 0);
+    double total = 0;
+    for (auto &item : apps) {
+        if (item.second.home >= 0 && item.second.home < nodeNum) {
+            demand[item.second.home] += item.second.demand;
+            total += item.second.demand;
+        }
+    }
+    std::vector<int> target(nodeNum, 0);
+    if (total <= 0 || queueNum <= 0) {
+        return target;
+    }
+    // largest remainder, every node with demand gets a queue while there are enough
+    std::vector<std::pair<double, int>> remainder;
+    int left = queueNum;
+    for (int node = 0; node < nodeNum; ++node) {
+        double share = queueNum * demand[node] / total;
+        target[node] = static_cast<int>(std::floor(share));
+        left -= target[node];
+        remainder.emplace_back(share - target[node], node);
+    }
+    std::sort(remainder.begin(), remainder.end(), [](const std::pair<double, int> &a,
+        const std::pair<double, int> &b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    for (int i = 0; i < left; ++i) {
+        target[remainder[i % remainder.size()].second]++;
+    }
+    for (int node = 0; node < nodeNum; ++node) {
+        if (demand[node] <= 0 || target[node] > 0) {
+            continue;
+        }
+        auto most = std::max_element(target.begin(), target.end());
+        if (*most > 1) {
+            (*most)--;
+            target[node]++;
+        }
+    }
+    return target;
+}
+
+std::vector<int> QueuePlanner::Assign(int queueNum, const std::vector<int> &current) const
+{
+    std::vector<int> plan(std::max(queueNum, 0), -1);
+    std::vector<int> target = NodeTarget(queueNum);
+    std::vector<int> count(nodeNum, 0);
+    for (int q = 0; q < queueNum && q < static_cast<int>(current.size()); ++q) {
+        int node = current[q];
+        if (node >= 0 && node < nodeNum && count[node] < target[node]) {
+            plan[q] = node;
+            count[node]++;
+        }
+    }
+    int node = 0;
+    for (int q = 0; q < queueNum; ++q) {
+        if (plan[q] >= 0) {
+            continue;
+        }
+        while (node < nodeNum && count[node] >= target[node]) {
+            node++;
+        }
+        if (node == nodeNum) {
+            break;
+        }
+        plan[q] = node;
+        count[node]++;
+    }
+    return plan;
+}
+}
@@ -0,0 +1,65 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef MULTI_NET_PATH_QUEUE_PLAN_H
+#define MULTI_NET_PATH_QUEUE_PLAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace oeaware {
+struct AppRx {
+    int pid = 0;
+    uint64_t rxPackets = 0;              // packets of the app on the tuned devices in the last period
+    std::vector<uint64_t> nodeRunTime;   // ns the threads of the app ran on each node in the last period
+};
+
+struct QueuePlanOption {
+    double homeMargin = 0.25;   // the home node changes when another node runs the app this much more
+    uint64_t idleRx = 10;       // a period with fewer packets is an idle period
+    int idleRuns = 10;          // the app releases its queues after this many idle periods in a row
+    double rxWeight = 0.5;      // weight of the last period in the rx demand of the app
+};
+
+/*
+ * Follows the apps receiving on the tuned devices and splits the queues of a device between the numa nodes by the
+ * rx demand of the apps homed on each node. An app is homed on the node its threads run on most, and released with
+ * its demand after idleRuns idle periods. Queues stay on their node as long as the node still needs them, so only
+ * the difference moves when the demand changes.
+ */
+class QueuePlanner {
+public:
+    explicit QueuePlanner(int nodeNum, const QueuePlanOption &option = QueuePlanOption())
+        : nodeNum(nodeNum), option(option) { }
+    void Update(const std::vector<AppRx> &appRx);
+    // -1 if the app is not followed or has no home yet
+    int GetHome(int pid) const;
+    // queue id to node, -1 for a queue no app needs, which keeps its original affinity.
+    // current is the last plan of the device, it may be shorter than queueNum.
+    std::vector<int> Assign(int queueNum, const std::vector<int> &current) const;
+    size_t AppCount() const { return apps.size(); }
+    void Clear() { apps.clear(); }
+private:
+    struct AppState {
+        int home = -1;
+        double demand = 0;
+        int idle = 0;
+    };
+    std::vector<int> NodeTarget(int queueNum) const;
+    int nodeNum;
+    QueuePlanOption option;
+    std::unordered_map<int, AppState> apps;
+};
+}
+
+#endif
@@ -0,0 +1,194 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "affinity_partition.h"
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include "oeaware/utils.h"
+
+namespace oeaware {
+std::unordered_map<int, int> AffinityPartitioner::Partition(const std::vector<AffinityDomain> &domains,
+    const std::vector<AffinityTask> &tasks, const std::vector<AffinityEdge> &edges) const
+{
+    std::unordered_map<int, int> result;
+    if (domains.empty()) {
+        return result;
+    }
+    std::unordered_map<int, const AffinityTask*> taskMap;
+    for (auto &task : tasks) {
+        taskMap[task.pid] = &task;
+    }
+    std::vector<float> capacity;
+    float maxCapacity = 0;
+    for (auto &domain : domains) {
+        capacity.emplace_back(domain.cpus.size() * option.capacityRatio);
+        maxCapacity = std::max(maxCapacity, capacity.back());
+    }
+    std::vector<AffinityEdge> sorted;
+    std::unordered_map<int, std::vector<std::pair<int, double>>> adjacent;
+    for (auto &edge : edges) {
+        if (edge.pid1 == edge.pid2 || !taskMap.count(edge.pid1) || !taskMap.count(edge.pid2)) {
+            continue;
+        }
+        sorted.emplace_back(edge);
+        adjacent[edge.pid1].emplace_back(edge.pid2, edge.weight);
+        adjacent[edge.pid2].emplace_back(edge.pid1, edge.weight);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const AffinityEdge &a, const AffinityEdge &b) {
+        if (a.weight != b.weight) {
+            return a.weight > b.weight;
+        }
+        return std::make_pair(a.pid1, a.pid2) < std::make_pair(b.pid1, b.pid2);
+    });
+    // contract the heavy edges while the group fits in one domain
+    std::unordered_map<int, int> parent;
+    std::unordered_map<int, float> groupLoad;
+    for (auto &item : adjacent) {
+        parent[item.first] = item.first;
+        groupLoad[item.first] = taskMap[item.first]->load;
+    }
+    auto find = [&parent](int pid) {
+        int root = pid;
+        while (parent[root] != root) {
+            root = parent[root];
+        }
+        while (parent[pid] != root) {
+            int next = parent[pid];
+            parent[pid] = root;
+            pid = next;
+        }
+        return root;
+    };
+    for (auto &edge : sorted) {
+        int a = find(edge.pid1);
+        int b = find(edge.pid2);
+        if (a == b || groupLoad[a] + groupLoad[b] > maxCapacity) {
+            continue;
+        }
+        parent[b] = a;
+        groupLoad[a] += groupLoad[b];
+    }
+    std::map<int, std::vector<int>> groups;
+    for (auto &item : parent) {
+        groups[find(item.first)].emplace_back(item.first);
+    }
+    std::vector<std::pair<float, int>> order;
+    for (auto &group : groups) {
+        order.emplace_back(groupLoad[group.first], group.first);
+    }
+    std::sort(order.begin(), order.end(), [](const std::pair<float, int> &a, const std::pair<float, int> &b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    std::unordered_map<int, size_t> domainIndex;
+    for (size_t i = 0; i < domains.size(); ++i) {
+        domainIndex[domains[i].id] = i;
+    }
+    std::vector<float> used(domains.size(), 0);
+    for (auto &item : order) {
+        float load = item.first;
+        const auto &members = groups[item.second];
+        // traffic from the group to the groups already placed, per domain
+        std::vector<double> score(domains.size(), 0);
+        for (int pid : members) {
+            for (auto &adj : adjacent[pid]) {
+                auto it = result.find(adj.first);
+                if (it == result.end()) {
+                    continue;
+                }
+                size_t placed = domainIndex[it->second];
+                for (size_t d = 0; d < domains.size(); ++d) {
+                    if (d == placed) {
+                        score[d] += adj.second;
+                    } else if (domains[d].node == domains[placed].node) {
+                        score[d] += option.nodeShare * adj.second;
+                    }
+                }
+            }
+        }
+        int best = -1;
+        for (size_t d = 0; d < domains.size(); ++d) {
+            if (used[d] + load > capacity[d]) {
+                continue;
+            }
+            if (best < 0 || score[d] > score[best] ||
+                (score[d] == score[best] && used[d] / capacity[d] < used[best] / capacity[best])) {
+                best = static_cast<int>(d);
+            }
+        }
+        if (best < 0) {
+            continue;
+        }
+        // stay where most of the group load is bound if it is nearly as good, new members join it there
+        std::unordered_map<int, float> currentLoad;
+        for (int pid : members) {
+            currentLoad[taskMap[pid]->current] += taskMap[pid]->load;
+        }
+        int current = -1;
+        float maxLoad = 0;
+        for (auto &cur : currentLoad) {
+            if (cur.first >= 0 && (cur.second > maxLoad || (cur.second == maxLoad && cur.first < current))) {
+                current = cur.first;
+                maxLoad = cur.second;
+            }
+        }
+        auto curIt = domainIndex.find(current);
+        if (curIt != domainIndex.end() && maxLoad * 2 > load && used[curIt->second] + load <= capacity[curIt->second] &&
+            score[curIt->second] >= score[best] * (1 - option.stayGain)) {
+            best = static_cast<int>(curIt->second);
+        }
+        used[best] += load;
+        for (int pid : members) {
+            result[pid] = domains[best].id;
+        }
+    }
+    return result;
+}
+
+static int FirstCpuOfList(const std::string &path)
+{
+    std::ifstream file(path);
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line)) {
+        return -1;
+    }
+    auto list = ParseRange(line);
+    return list.empty() ? -1 : *std::min_element(list.begin(), list.end());
+}
+
+std::vector<AffinityDomain> ReadAffinityDomains(const std::vector<int> &cpu2Node, const std::string &root)
+{
+    std::set<int> online;
+    std::ifstream file(root + "online");
+    std::string line;
+    if (file.is_open() && std::getline(file, line)) {
+        for (auto cpu : ParseRange(line)) {
+            online.insert(cpu);
+        }
+    }
+    // (node, first cpu of the L3), -1 if the L3 is unknown and the node is one domain
+    std::map<std::pair<int, int>, std::vector<int>> groups;
+    for (size_t cpu = 0; cpu < cpu2Node.size(); ++cpu) {
+        if (cpu2Node[cpu] < 0 || (!online.empty() && !online.count(cpu))) {
+            continue;
+        }
+        int l3 = FirstCpuOfList(root + "cpu" + std::to_string(cpu) + "/cache/index3/shared_cpu_list");
+        groups[std::make_pair(cpu2Node[cpu], l3)].emplace_back(cpu);
+    }
+    std::vector<AffinityDomain> domains;
+    for (auto &group : groups) {
+        domains.emplace_back(AffinityDomain{ .id = static_cast<int>(domains.size()), .node = group.first.first,
+            .cpus = group.second });
+    }
+    return domains;
+}
+}
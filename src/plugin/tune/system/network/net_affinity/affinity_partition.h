@@ -0,0 +1,68 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef NET_AFFINITY_PARTITION_H
+#define NET_AFFINITY_PARTITION_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace oeaware {
+// cpus sharing one L3 within a numa node
+struct AffinityDomain {
+    int id;
+    int node;
+    std::vector<int> cpus;
+};
+
+struct AffinityTask {
+    int pid;
+    float load;             // cpus used
+    int current = -1;       // domain the task is bound to, -1 if not bound by the tuner
+};
+
+struct AffinityEdge {
+    int pid1;
+    int pid2;
+    double weight;          // bytes per second between the processes
+};
+
+/*
+ * Place the processes of a communication graph on the domains so that the traffic crossing domains, and then
+ * crossing nodes, is small. Heavy edges are contracted first as long as the merged group fits in one domain
+ * (the coarsening of multilevel min-cut partitioners), then the groups are packed largest first onto the domain
+ * with most traffic to the groups already placed there. A group stays on the domain most of its load is bound to
+ * unless another one takes stayGain more of its traffic.
+ */
+class AffinityPartitioner {
+public:
+    struct Option {
+        float capacityRatio = 0.8;  // share of the domain cpus the placed load may use
+        float nodeShare = 0.5;      // traffic to the same node, other domain, counts this much
+        float stayGain = 0.2;
+    };
+    AffinityPartitioner() = default;
+    explicit AffinityPartitioner(const Option &option) : option(option) { }
+    // pid to domain id, the pids that fit nowhere are left out
+    std::unordered_map<int, int> Partition(const std::vector<AffinityDomain> &domains,
+        const std::vector<AffinityTask> &tasks, const std::vector<AffinityEdge> &edges) const;
+private:
+    Option option;
+};
+
+// split the cpus of every node by the L3 they share, cpu2Node[cpu] is the node of the cpu
+std::vector<AffinityDomain> ReadAffinityDomains(const std::vector<int> &cpu2Node,
+    const std::string &root = "/sys/devices/system/cpu/");
+}
+
+#endif
@@ -0,0 +1,414 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include "net_affinity_tune.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <dirent.h>
+#include <unistd.h>
+#include "oeaware/utils.h"
+#include "oeaware/data/env_data.h"
+#include "oeaware/data/network_interface_data.h"
+
+using namespace oeaware;
+
+static const int MS_PER_SEC = 1000;
+static const int UINT32_BITS = 32;
+static const uint64_t DEFAULT_MIN_RATE = 1048576; // 1 MB/s
+static const int DEFAULT_MAX_MOVES = 4;
+static const int MIN_STAY_RUNS = 6;           // a process is not moved again within 6 periods
+static const double RATE_DECAY = 0.5;         // weight of the old rate in the smoothed one
+static const double RATE_FORGET = 0.1;        // pairs below this share of min_rate are forgotten
+static const int STAT_UTIME_FIELD = 14;       // fields of /proc/<pid>/stat, utime and stime follow
+static const int STAT_COMM_FIELDS = 2;        // pid and (comm) before the field after ')'
+
+static uint64_t PairKey(uint32_t pid1, uint32_t pid2)
+{
+    if (pid1 > pid2) {
+        std::swap(pid1, pid2);
+    }
+    return (static_cast<uint64_t>(pid1) << UINT32_BITS) | pid2;
+}
+
+// an unbound task inherits all possible cpus, which may include offline ones
+static bool CoversCpus(const cpu_set_t &mask, const cpu_set_t &cpus)
+{
+    cpu_set_t both;
+    CPU_AND(&both, &mask, &cpus);
+    return CPU_EQUAL(&both, &cpus);
+}
+
+static bool ProcessAlive(int pid)
+{
+    return access(("/proc/" + std::to_string(pid)).c_str(), F_OK) == 0;
+}
+
+static std::vector<int> GetTids(int pid)
+{
+    std::vector<int> tids;
+    std::string path = "/proc/" + std::to_string(pid) + "/task";
+    DIR *dir = opendir(path.c_str());
+    if (dir == nullptr) {
+        return tids;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (IsInteger(entry->d_name)) {
+            tids.emplace_back(atoi(entry->d_name));
+        }
+    }
+    closedir(dir);
+    return tids;
+}
+
+// utime + stime of the process in clock ticks
+static bool ReadProcessTicks(int pid, uint64_t &ticks)
+{
+    std::ifstream file("/proc/" + std::to_string(pid) + "/stat");
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line)) {
+        return false;
+    }
+    // comm may contain spaces, the fields are counted after the last ')'
+    auto pos = line.rfind(')');
+    if (pos == std::string::npos) {
+        return false;
+    }
+    std::istringstream fields(line.substr(pos + 1));
+    std::string field;
+    uint64_t utime = 0;
+    uint64_t stime = 0;
+    for (int i = STAT_COMM_FIELDS + 1; i < STAT_UTIME_FIELD; ++i) {
+        if (!(fields >> field)) {
+            return false;
+        }
+    }
+    if (!(fields >> utime >> stime)) {
+        return false;
+    }
+    ticks = utime + stime;
+    return true;
+}
+
+NetAffinityTune::NetAffinityTune()
+{
+    name = OE_NET_AFFINITY_TUNE;
+    version = "1.0.0";
+    period = 5000;       // 5000 ms
+    priority = 2;        // 2: tune instance
+    type = TUNE;
+    description += "[introduction] \n";
+    description += "               Bind the local processes that talk to each other over loopback or local \n";
+    description += "               sockets to the cpus of one L3 or numa node, keep cache lines in one socket\n";
+    description += "[version] \n";
+    description += "         " + version + "\n";
+    description += "[instance name]\n";
+    description += "                 " + name + "\n";
+    description += "[instance period]\n";
+    description += "                 " + std::to_string(period) + " ms\n";
+    description += "[provide topics]\n";
+    description += "                 none\n";
+    description += "[running require topics]\n";
+    description += "                        1.env_info_collector::static\n";
+    description += "                        2.net_interface_info::local_net_affinity\n";
+    description += "[usage] \n";
+    description += "        example:You can use `oeawarectl -e " + name + "` to enable\n";
+    CPU_ZERO(&allCpus);
+}
+
+oeaware::Result NetAffinityTune::OpenTopic(const oeaware::Topic &topic)
+{
+    (void)topic;
+    return oeaware::Result(OK);
+}
+
+void NetAffinityTune::CloseTopic(const oeaware::Topic &topic)
+{
+    (void)topic;
+}
+
+bool NetAffinityTune::ResolveCmd(const std::string &param)
+{
+    minRate = DEFAULT_MIN_RATE;
+    maxMoves = DEFAULT_MAX_MOVES;
+    if (param.empty()) {
+        return true;
+    }
+    auto paramsMap = GetKeyValueFromString(param);
+    for (auto &item : paramsMap) {
+        if (!cmdHelp.count(item.first)) {
+            ERROR(logger, "invalid param: " << item.first);
+            return false;
+        }
+    }
+    if (paramsMap.count("min_rate")) {
+        if (!IsInteger(paramsMap["min_rate"]) || paramsMap["min_rate"][0] == '-') {
+            ERROR(logger, "min_rate invalid param: " << paramsMap["min_rate"]);
+            return false;
+        }
+        minRate = std::stoull(paramsMap["min_rate"]);
+    }
+    if (paramsMap.count("max_moves")) {
+        if (!IsInteger(paramsMap["max_moves"]) || atoi(paramsMap["max_moves"].data()) <= 0) {
+            ERROR(logger, "max_moves invalid param: " << paramsMap["max_moves"]);
+            return false;
+        }
+        maxMoves = atoi(paramsMap["max_moves"].data());
+    }
+    return true;
+}
+
+std::string NetAffinityTune::GetHelp()
+{
+    std::string output;
+    output += "Usage : oeawarectl -e " + name + " [options] \n";
+    for (const auto &item : cmdHelp) {
+        output +=  item.second + " \n";
+    }
+    return output;
+}
+
+void NetAffinityTune::InitDomains(const DataList &dataList)
+{
+    auto *dataTmp = static_cast<EnvStaticInfo *>(dataList.data[0]);
+    cpu2Node.assign(dataTmp->cpu2Node, dataTmp->cpu2Node + dataTmp->cpuNumConfig);
+    domains = ReadAffinityDomains(cpu2Node);
+    CPU_ZERO(&allCpus);
+    for (auto &domain : domains) {
+        for (int cpu : domain.cpus) {
+            CPU_SET(cpu, &allCpus);
+        }
+    }
+    INFO(logger, "NetAffinityTune " << domains.size() << " domains");
+}
+
+void NetAffinityTune::UpdateData(const DataList &dataList)
+{
+    std::string instanceName = dataList.topic.instanceName;
+    std::string topicName = dataList.topic.topicName;
+    if (instanceName == OE_ENV_INFO && topicName == "static") {
+        if (domains.empty()) {
+            InitDomains(dataList);
+        }
+        return;
+    }
+    if (instanceName != OE_NET_INTF_INFO || topicName != OE_LOCAL_NET_AFFINITY) {
+        return;
+    }
+    auto *dataTmp = static_cast<ProcessNetAffinityDataList *>(dataList.data[0]);
+    for (int i = 0; i < dataTmp->count; ++i) {
+        auto &item = dataTmp->affinity[i];
+        if (item.pid1 == item.pid2) {
+            continue;
+        }
+        periodBytes[PairKey(item.pid1, item.pid2)] += item.level;
+    }
+}
+
+void NetAffinityTune::UpdatePairRate()
+{
+    for (auto &item : periodBytes) {
+        pairRate.emplace(item.first, 0);
+    }
+    for (auto it = pairRate.begin(); it != pairRate.end();) {
+        auto bytesIt = periodBytes.find(it->first);
+        double rate = bytesIt == periodBytes.end() ? 0 : static_cast<double>(bytesIt->second) * MS_PER_SEC / period;
+        it->second = it->second * RATE_DECAY + rate * (1 - RATE_DECAY);
+        if (it->second < minRate * RATE_FORGET) {
+            it = pairRate.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    periodBytes.clear();
+}
+
+std::vector<AffinityTask> NetAffinityTune::GetTasks(const std::vector<AffinityEdge> &edges)
+{
+    std::vector<AffinityTask> tasks;
+    std::unordered_map<int, uint64_t> ticks;
+    for (auto &edge : edges) {
+        for (int pid : { edge.pid1, edge.pid2 }) {
+            uint64_t value;
+            if (ticks.count(pid) || !ReadProcessTicks(pid, value)) {
+                continue;
+            }
+            ticks[pid] = value;
+        }
+    }
+    long hz = sysconf(_SC_CLK_TCK);
+    for (auto &item : ticks) {
+        int pid = item.first;
+        if (pid <= 1 || pid == getpid()) {
+            continue;
+        }
+        // processes bound by others are left alone
+        cpu_set_t mask;
+        if (!tuned.count(pid) && (sched_getaffinity(pid, sizeof(mask), &mask) != 0 || !CoversCpus(mask, allCpus))) {
+            continue;
+        }
+        AffinityTask task{ .pid = pid, .load = 0 };
+        auto it = lastTicks.find(pid);
+        if (it != lastTicks.end() && item.second >= it->second && hz > 0) {
+            task.load = static_cast<float>(item.second - it->second) * MS_PER_SEC / hz / period;
+        }
+        auto tunedIt = tuned.find(pid);
+        task.current = tunedIt == tuned.end() ? -1 : tunedIt->second.domain;
+        tasks.emplace_back(task);
+    }
+    lastTicks = ticks;
+    return tasks;
+}
+
+bool NetAffinityTune::BindProcess(int pid, int domain)
+{
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu : domains[domain].cpus) {
+        CPU_SET(cpu, &mask);
+    }
+    auto &process = tuned[pid];
+    bool ret = false;
+    for (int tid : GetTids(pid)) {
+        cpu_set_t old;
+        if (sched_getaffinity(tid, sizeof(old), &old) != 0) {
+            continue;
+        }
+        if (!process.originMask.count(tid)) {
+            process.originMask[tid] = old;
+        }
+        if (sched_setaffinity(tid, sizeof(mask), &mask) == 0) {
+            ret = true;
+        }
+    }
+    if (!ret) {
+        tuned.erase(pid);
+        return false;
+    }
+    process.domain = domain;
+    process.stayRuns = 0;
+    return true;
+}
+
+void NetAffinityTune::RestoreProcess(int pid)
+{
+    auto it = tuned.find(pid);
+    if (it == tuned.end()) {
+        return;
+    }
+    auto &originMask = it->second.originMask;
+    for (int tid : GetTids(pid)) {
+        // threads created after binding get the mask of the process
+        auto maskIt = originMask.find(tid);
+        const cpu_set_t &mask = maskIt != originMask.end() ? maskIt->second :
+            (originMask.count(pid) ? originMask[pid] : allCpus);
+        (void)sched_setaffinity(tid, sizeof(mask), &mask);
+    }
+    tuned.erase(it);
+}
+
+void NetAffinityTune::Run()
+{
+    UpdatePairRate();
+    if (domains.size() < 2) {
+        return;
+    }
+    for (auto it = tuned.begin(); it != tuned.end();) {
+        if (!ProcessAlive(it->first)) {
+            it = tuned.erase(it);
+        } else {
+            it->second.stayRuns++;
+            ++it;
+        }
+    }
+    std::vector<AffinityEdge> edges;
+    std::unordered_map<int, double> pidRate;
+    for (auto &item : pairRate) {
+        if (item.second < minRate) {
+            continue;
+        }
+        int pid1 = static_cast<int>(item.first >> UINT32_BITS);
+        int pid2 = static_cast<int>(item.first & UINT32_MAX);
+        edges.emplace_back(AffinityEdge{ .pid1 = pid1, .pid2 = pid2, .weight = item.second });
+        pidRate[pid1] += item.second;
+        pidRate[pid2] += item.second;
+    }
+    auto place = partitioner.Partition(domains, GetTasks(edges), edges);
+    // the busiest processes move first, at most maxMoves of them
+    std::vector<std::pair<double, int>> moves;
+    for (auto &item : place) {
+        auto it = tuned.find(item.first);
+        if (it != tuned.end() && (it->second.domain == item.second || it->second.stayRuns < MIN_STAY_RUNS)) {
+            continue;
+        }
+        moves.emplace_back(pidRate[item.first], item.first);
+    }
+    for (auto &item : tuned) {
+        if (!place.count(item.first) && item.second.stayRuns >= MIN_STAY_RUNS) {
+            moves.emplace_back(pidRate[item.first], item.first);
+        }
+    }
+    std::sort(moves.begin(), moves.end(), [](const std::pair<double, int> &a, const std::pair<double, int> &b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    int moved = 0;
+    for (auto &item : moves) {
+        if (moved >= maxMoves) {
+            break;
+        }
+        int pid = item.second;
+        auto it = place.find(pid);
+        if (it == place.end()) {
+            INFO(logger, "NetAffinityTune restore pid " << pid << ", local traffic stopped");
+            RestoreProcess(pid);
+        } else if (BindProcess(pid, it->second)) {
+            INFO(logger, "NetAffinityTune bind pid " << pid << " to node " << domains[it->second].node << " cpus "
+                << domains[it->second].cpus.front() << "-" << domains[it->second].cpus.back() << ", local traffic "
+                << static_cast<uint64_t>(item.first) << " B/s");
+        }
+        moved++;
+    }
+}
+
+oeaware::Result NetAffinityTune::Enable(const std::string &param)
+{
+    if (!ResolveCmd(param)) {
+        return oeaware::Result(FAILED, "NetAffinityTune resolve cmd failed \n" + GetHelp());
+    }
+    subscribeTopics.clear();
+    subscribeTopics.emplace_back(oeaware::Topic{ OE_ENV_INFO, "static", "" });
+    subscribeTopics.emplace_back(oeaware::Topic{ OE_NET_INTF_INFO, OE_LOCAL_NET_AFFINITY, OE_PARA_PROCESS_AFFINITY });
+    for (auto &topic : subscribeTopics) {
+        Subscribe(topic);
+    }
+    return oeaware::Result(OK);
+}
+
+void NetAffinityTune::Disable()
+{
+    for (auto &topic : subscribeTopics) {
+        Unsubscribe(topic);
+    }
+    std::vector<int> pids;
+    for (auto &item : tuned) {
+        pids.emplace_back(item.first);
+    }
+    for (int pid : pids) {
+        RestoreProcess(pid);
+    }
+    subscribeTopics.clear();
+    periodBytes.clear();
+    pairRate.clear();
+    lastTicks.clear();
+    domains.clear();
+    cpu2Node.clear();
+}
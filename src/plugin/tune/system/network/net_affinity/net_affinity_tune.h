@@ -0,0 +1,64 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#ifndef NET_AFFINITY_TUNE_H
+#define NET_AFFINITY_TUNE_H
+
+#include <map>
+#include <sched.h>
+#include "oeaware/interface.h"
+#include "affinity_partition.h"
+
+namespace oeaware {
+class NetAffinityTune : public Interface {
+public:
+    NetAffinityTune();
+    ~NetAffinityTune() override = default;
+    Result OpenTopic(const oeaware::Topic &topic) override;
+    void CloseTopic(const oeaware::Topic &topic) override;
+    void UpdateData(const DataList &dataList) override;
+    Result Enable(const std::string &param) override;
+    void Disable() override;
+    void Run() override;
+
+private:
+    struct TunedProcess {
+        int domain = -1;
+        int stayRuns = 0;                           // runs since the last move
+        std::unordered_map<int, cpu_set_t> originMask; // tid to the affinity before tuning
+    };
+    std::vector<oeaware::Topic> subscribeTopics;
+    std::vector<int> cpu2Node;
+    std::vector<AffinityDomain> domains;
+    cpu_set_t allCpus;
+    AffinityPartitioner partitioner;
+    std::unordered_map<uint64_t, uint64_t> periodBytes; // pid pair to the bytes of this period
+    std::unordered_map<uint64_t, double> pairRate;      // pid pair to the smoothed bytes per second
+    std::unordered_map<int, uint64_t> lastTicks;        // pid to the cpu ticks at the last run
+    std::unordered_map<int, TunedProcess> tuned;
+    uint64_t minRate = 0;
+    int maxMoves = 0;
+    std::map<std::string, std::string> cmdHelp = {
+        {"min_rate",
+         "    -min_rate <bytes>      pairs with less local traffic per second are ignored(default 1048576)"},
+        {"max_moves",
+         "    -max_moves <n>         processes moved at most every period(default 4)"},
+    };
+    bool ResolveCmd(const std::string &param);
+    std::string GetHelp();
+    void InitDomains(const DataList &dataList);
+    void UpdatePairRate();
+    std::vector<AffinityTask> GetTasks(const std::vector<AffinityEdge> &edges);
+    bool BindProcess(int pid, int domain);
+    void RestoreProcess(int pid);
+};
+}
+#endif
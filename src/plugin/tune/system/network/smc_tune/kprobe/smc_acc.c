@@ -17,6 +17,10 @@
 #include <linux/version.h>
 #include <linux/sockptr.h>
 #include <linux/net.h>
+#include <linux/idr.h>
+#include <linux/slab.h>
+#include <linux/sched.h>
+#include <linux/rcupdate.h>
 
 static struct kprobe kp_smc_connect = {
     .symbol_name = "smc_connect",
@@ -86,27 +90,145 @@ static int is_smc_loaded = SMC_LOADED;
 
 #define VALID_VALUE 1
 #define STR_LEN 512
-static char blackPortList[STR_LEN] = "";
-static char whitePortList[STR_LEN] = "";
 static int short_connection = 1;
+static int acc_enable = 1;
+
+/*
+ * A set of ports or pids written by a module parameter. Readers in the probes look it up under rcu, a write
+ * of the parameter builds a new set and replaces the old one, so the policy changes without reloading the module.
+ */
+struct id_set {
+    struct idr ids;
+    char str[STR_LEN];
+};
+static struct id_set __rcu *black_port_set;
+static struct id_set __rcu *white_port_set;
+static struct id_set __rcu *pid_set;
+
+static void id_set_free(struct id_set *set)
+{
+    if (!set) {
+        return;
+    }
+    idr_destroy(&set->ids);
+    kfree(set);
+}
+
+static int id_set_parse(struct id_set *set)
+{
+    char *token;
+    int id, rc = 0;
+    char *dup = kstrdup(set->str, GFP_KERNEL);
+    char *buf = dup;
 
-module_param_string(black_port_list_param, blackPortList, sizeof(blackPortList), 0644);
+    if (!dup) {
+        return -ENOMEM;
+    }
+    while ((token = strsep(&buf, ",")) != NULL) {
+        token = strim(token);
+        if (strlen(token) == 0) {
+            continue;
+        }
+        if (kstrtoint(token, 10, &id) || id < 0) {
+            pr_err("Failed to convert token to int: %s\n", token);
+            rc = -EINVAL;
+            break;
+        }
+        if (idr_find(&set->ids, id)) {
+            continue;
+        }
+        if (idr_alloc(&set->ids, (void *)VALID_VALUE, id, id + 1, GFP_KERNEL) < 0) {
+            pr_err("Failed to allocate idr for id: %d\n", id);
+            rc = -ENOMEM;
+            break;
+        }
+    }
+    kfree(dup);
+    return rc;
+}
+
+static int id_set_param_set(const char *val, const struct kernel_param *kp)
+{
+    struct id_set __rcu **slot = kp->arg;
+    struct id_set *set, *old;
+    int rc;
+
+    if (strlen(val) >= STR_LEN) {
+        return -ENOSPC;
+    }
+    set = kzalloc(sizeof(*set), GFP_KERNEL);
+    if (!set) {
+        return -ENOMEM;
+    }
+    idr_init(&set->ids);
+    strscpy(set->str, val, STR_LEN);
+    strim(set->str);
+    rc = id_set_parse(set);
+    if (rc) {
+        id_set_free(set);
+        return rc;
+    }
+    // parameter writes are serialized by the kernel param lock
+    old = rcu_dereference_protected(*slot, 1);
+    rcu_assign_pointer(*slot, set);
+    if (old) {
+        synchronize_rcu();
+        id_set_free(old);
+    }
+    return 0;
+}
+
+static int id_set_param_get(char *buffer, const struct kernel_param *kp)
+{
+    struct id_set __rcu **slot = kp->arg;
+    struct id_set *set = rcu_dereference_protected(*slot, 1);
+
+    return scnprintf(buffer, PAGE_SIZE, "%s\n", set ? set->str : "");
+}
+
+static const struct kernel_param_ops id_set_param_ops = {
+    .set = id_set_param_set,
+    .get = id_set_param_get,
+};
+
+/* -1 if the set is empty, otherwise whether id is in it */
+static int id_set_lookup(struct id_set __rcu **slot, int id)
+{
+    struct id_set *set;
+    int ret = -1;
+
+    rcu_read_lock();
+    set = rcu_dereference(*slot);
+    if (set && !idr_is_empty(&set->ids)) {
+        ret = idr_find(&set->ids, id) != NULL;
+    }
+    rcu_read_unlock();
+    return ret;
+}
+
+static void id_set_release(struct id_set __rcu **slot)
+{
+    struct id_set *set = rcu_dereference_protected(*slot, 1);
+
+    RCU_INIT_POINTER(*slot, NULL);
+    id_set_free(set);
+}
+
+module_param_cb(black_port_list_param, &id_set_param_ops, &black_port_set, 0644);
 MODULE_PARM_DESC(black_port_list_param, " A string parameter for filtering port not to switch TCP to SMC.\n"
                                         "       By default, accelerate all ports except those on the blacklist.\n"
                                         "       Separated by \',\' between ports. String length: 512 \n"
                                         "       e.g. black_port_list_param=\"80,8448\"");
-static DEFINE_IDR(black_port_map);
-module_param_string(white_port_list_param, whitePortList, sizeof(whitePortList), 0644);
+module_param_cb(white_port_list_param, &id_set_param_ops, &white_port_set, 0644);
 MODULE_PARM_DESC(white_port_list_param, " A string parameter for filtering ports to switch TCP to SMC.\n "
                                         "       By default, accelerate all ports except those on the blacklist.\n"
                                         "       Separated by \',\' between ports. String length: 512.\n"
                                         "       e.g. white_port_list_param=\"80,8448\"");
-static DEFINE_IDR(white_port_map);
-module_param(short_connection, int, 0644);
-MODULE_PARM_DESC(short_connection, " Short connection suppression switch.\n"
-                                   "       If short_connection = true, the SMC is running properly.\n"
-                                   "       If short_connection = false, SMC ignores short connections in the \
-                                   system.\n");
+module_param_cb(pid_list_param, &id_set_param_ops, &pid_set, 0644);
+MODULE_PARM_DESC(pid_list_param, " A string parameter for filtering processes to switch TCP to SMC.\n"
+                                 "       By default, accelerate all processes.\n"
+                                 "       Separated by \',\' between pids. String length: 512.\n"
+                                 "       e.g. pid_list_param=\"1024,2048\"");
 
 static long long unsigned int conn_count_smc;
 static long long unsigned int send_count_smc;
@@ -130,49 +252,58 @@ static int _kallsyms_lookup_kprobe(struct kprobe *p, struct pt_regs *regs)
     return 0;
 }
 
-static int parse_and_store_ports(const char *port_list, struct idr *port_map)
+static unsigned long long tcp2smc_threshold(void)
 {
-    char *token;
-    int port, rc = 0;
-    char *buf = (char *)port_list;  // 直接使用 blackPortList
+    return READ_ONCE(short_connection) ? NET_TCP2SMC_THRESHOLD : ~0ULL;
+}
 
-    // 使用 strsep 分割字符串
-    while ((token = strsep(&buf, ",")) != NULL) {
-        if (strlen(token) == 0) {
-            continue;
-        }
-        if (kstrtoint(token, 10, &port)) {
-            pr_err("Failed to convert token to int: %s\n", token);
-            rc = -EINVAL;
-            break;
-        }
+/* switching either parameter starts the short connection detection over with smc on */
+static int acc_param_set_int(const char *val, const struct kernel_param *kp)
+{
+    int rc = param_set_int(val, kp);
 
-        // 将 port 存储到 idr map
-        if (idr_alloc(port_map, (void *)VALID_VALUE, port, port + 1, GFP_KERNEL) < 0) {
-            pr_err("Failed to allocate idr for port: %d\n", port);
-            rc = -ENOMEM;
-            break;
-        }
+    if (rc) {
+        return rc;
     }
-
-    return rc;
+    REFRESH_COUNT(smc);
+    REFRESH_COUNT(tcp);
+    WRITE_ONCE(net_tcp2smc, 1);
+    return 0;
 }
 
-static bool is_port_in_map(struct idr *port_map, int port)
-{
-    return idr_find(port_map, port) != NULL;
-}
+static const struct kernel_param_ops acc_param_int_ops = {
+    .set = acc_param_set_int,
+    .get = param_get_int,
+};
+
+module_param_cb(short_connection, &acc_param_int_ops, &short_connection, 0644);
+MODULE_PARM_DESC(short_connection, " Short connection suppression switch.\n"
+                                   "       If short_connection = true, the SMC is running properly.\n"
+                                   "       If short_connection = false, SMC ignores short connections in the \
+                                   system.\n");
+module_param_cb(enable, &acc_param_int_ops, &acc_enable, 0644);
+MODULE_PARM_DESC(enable, " Acceleration switch, the probes stay registered and do nothing while it is 0.\n"
+                         "       Writing it takes effect for the next listen or connect, no reload is needed.\n");
 
 static bool check_port(int port)
 {
-    if (!idr_is_empty(&black_port_map))
-        return !is_port_in_map(&black_port_map, port);
+    int ret = id_set_lookup(&black_port_set, port);
 
-    if (!idr_is_empty(&white_port_map))
-        return is_port_in_map(&white_port_map, port);
+    if (ret >= 0) {
+        return !ret;
+    }
+    ret = id_set_lookup(&white_port_set, port);
+    if (ret >= 0) {
+        return ret;
+    }
     return true;
 }
 
+static bool check_pid(void)
+{
+    return id_set_lookup(&pid_set, current->tgid) != 0;
+}
+
 static int handler_smc(int ifd)
 {
     long ret;
@@ -199,7 +330,7 @@ static int handler_smc(int ifd)
             u16 type = sk->sk_type;
             if ((family == AF_INET || family == AF_INET6) && ((type & 0xf) == SOCK_STREAM) &&
                 (protocol == IPPROTO_TCP || protocol == IPPROTO_IP)) {
-                if (!check_port(sk->sk_num)) {
+                if (!check_port(sk->sk_num) || !check_pid()) {
                     goto out;
                 }
                 ret = tcp_setsockopt(sk, SOL_TCP, TCP_ULP, KERNEL_SOCKPTR("smc"), sizeof("smc"));
@@ -218,7 +349,7 @@ static int __kprobes handler_sys_listen(struct kprobe *p, struct pt_regs *regs)
 {
     int ifd = REGS_PARM1(regs);
 
-    if (!p) {
+    if (!p || !READ_ONCE(acc_enable)) {
         return 0;
     }
 
@@ -265,7 +396,7 @@ static int __init check_smc_module(void)
 
 static int __kprobes handle_smc_connect(struct kprobe *p, struct pt_regs *regs)
 {
-    if (!net_tcp2smc) {
+    if (!net_tcp2smc || !READ_ONCE(acc_enable)) {
         return 0;
     }
 
@@ -275,7 +406,7 @@ static int __kprobes handle_smc_connect(struct kprobe *p, struct pt_regs *regs)
 
 static int __kprobes handle_smc_sendmsg(struct kprobe *p, struct pt_regs *regs)
 {
-    if (!net_tcp2smc) {
+    if (!net_tcp2smc || !READ_ONCE(acc_enable)) {
         return 0;
     }
 
@@ -286,12 +417,12 @@ static int __kprobes handle_smc_sendmsg(struct kprobe *p, struct pt_regs *regs)
 
 static int __kprobes handle_smc_release(struct kprobe *p, struct pt_regs *regs)
 {
-    if (!net_tcp2smc) {
+    if (!net_tcp2smc || !READ_ONCE(acc_enable)) {
         return 0;
     }
 
     release_count_smc += 1;
-    if (conn_count_smc > NET_TCP2SMC_THRESHOLD && release_count_smc >= NET_TCP2SMC_THRESHOLD) {
+    if (conn_count_smc > tcp2smc_threshold() && release_count_smc >= tcp2smc_threshold()) {
         long long unsigned int real_send_count = send_count_smc / 2;
         if (conn_count_smc * 80 > real_send_count) {
             printk(KERN_INFO "handle_smc_release : close net_tcp2smc conn_count_smc %llu real_send_count %llu\n",
@@ -306,7 +437,7 @@ static int __kprobes handle_smc_release(struct kprobe *p, struct pt_regs *regs)
 
 static int __kprobes handle_tcp_conn(struct kprobe *p, struct pt_regs *regs)
 {
-    if (net_tcp2smc) {
+    if (net_tcp2smc || !READ_ONCE(acc_enable)) {
         return 0;
     }
 
@@ -316,7 +447,7 @@ static int __kprobes handle_tcp_conn(struct kprobe *p, struct pt_regs *regs)
 
 static int __kprobes handle_tcp_recv(struct kprobe *p, struct pt_regs *regs)
 {
-    if (net_tcp2smc) {
+    if (net_tcp2smc || !READ_ONCE(acc_enable)) {
         return 0;
     }
 
@@ -326,12 +457,12 @@ static int __kprobes handle_tcp_recv(struct kprobe *p, struct pt_regs *regs)
 
 static int __kprobes handle_tcp_fin(struct kprobe *p, struct pt_regs *regs)
 {
-    if (net_tcp2smc) {
+    if (net_tcp2smc || !READ_ONCE(acc_enable)) {
         return 0;
     }
 
     release_count_tcp += 1;
-    if (conn_count_tcp > NET_TCP2SMC_THRESHOLD && release_count_tcp >= NET_TCP2SMC_THRESHOLD) {
+    if (conn_count_tcp > tcp2smc_threshold() && release_count_tcp >= tcp2smc_threshold()) {
         long long unsigned int real_send_count = send_count_tcp / 2;
 
         if (conn_count_tcp * 80 < real_send_count) {
@@ -355,7 +486,7 @@ static int __kprobes handler_connect_file(struct kprobe *p, struct pt_regs *regs
 #if LINUX_VERSION_CODE <= KERNEL_VERSION(5, 10, 0)
     int tmperr;
 #endif
-    if (!net_tcp2smc) {
+    if (!net_tcp2smc || !READ_ONCE(acc_enable)) {
         return 0;
     }
     file = (struct file *)(uintptr_t)REGS_PARM1(regs);
@@ -388,7 +519,7 @@ static int __kprobes handler_connect_file(struct kprobe *p, struct pt_regs *regs
                     struct sockaddr_in6 *addr_in6 = (struct sockaddr_in6 *)address;
                     dst_port = ntohs(addr_in6->sin6_port);
                 }
-                if (!check_port(dst_port)) {
+                if (!check_port(dst_port) || !check_pid()) {
                     return 0;
                 }
                 ret = tcp_setsockopt(sk, SOL_TCP, TCP_ULP, KERNEL_SOCKPTR("smc"), sizeof("smc"));
@@ -409,17 +540,6 @@ static int __init kprobe_init(void)
         rc = -ENOENT;
         goto out;
     }
-    rc = parse_and_store_ports(blackPortList, &black_port_map);
-    if (rc != 0) {
-        goto out;
-    }
-    rc = parse_and_store_ports(whitePortList, &white_port_map);
-    if (rc != 0) {
-        goto out;
-    }
-    if (!short_connection) {
-        NET_TCP2SMC_THRESHOLD = ~0ULL;
-    }
     kp_sys_listen.pre_handler = handler_sys_listen;
     kp_sys_connect_file.pre_handler = handler_connect_file;
     kp_smc_connect.pre_handler = handle_smc_connect;
@@ -437,11 +557,12 @@ static int __init kprobe_init(void)
     register_kprobe(&kp_tcp_conn);
     register_kprobe(&kp_tcp_fin);
     register_kprobe(&kp_tcp_recv);
-    printk(KERN_INFO "smc_acc : module loaded, short_connection=%d\n", short_connection);
+    printk(KERN_INFO "smc_acc : module loaded, short_connection=%d enable=%d\n", short_connection, acc_enable);
     return rc;
 out:
-    idr_destroy(&white_port_map);
-    idr_destroy(&black_port_map);
+    id_set_release(&pid_set);
+    id_set_release(&white_port_set);
+    id_set_release(&black_port_set);
     return rc;
 }
 
@@ -460,8 +581,9 @@ static void __exit kprobe_exit(void)
     unregister_kprobe(&kp_tcp_fin);
     unregister_kprobe(&kp_tcp_recv);
 out:
-    idr_destroy(&black_port_map);
-    idr_destroy(&white_port_map);
+    id_set_release(&black_port_set);
+    id_set_release(&white_port_set);
+    id_set_release(&pid_set);
     printk(KERN_INFO "smc_acc : module unloaded\n");
     return;
 }
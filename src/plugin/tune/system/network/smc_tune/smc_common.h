@@ -72,6 +72,7 @@ extern log4cplus::Logger g_smcLogger;
 #define SMCLOG_FATAL(fmt) LOG4CPLUS_FATAL(g_smcLogger, fmt)
 
 #define SMC_ACC_KO_PATH "/usr/lib/smc/smc_acc.ko"
+#define SMC_ACC_PARAM_PATH "/sys/module/smc_acc/parameters/"
 
 #define SMC_UEID_NAME "SMCV2-OPENEULER-UEID"
 
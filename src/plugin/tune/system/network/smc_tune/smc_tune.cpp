@@ -56,11 +56,12 @@ oeaware::Result SmcTune::Enable(const std::string &param)
     }
     SMC_OP->SetShortConnection(shortConnection);
     SMC_OP->InputPortList(blackPortList, whitePortList);
+    SMC_OP->InputPidList(pidList);
     auto smcRet = (SMC_OP->EnableSmcAcc() == EXIT_SUCCESS ? OK : FAILED);
     if (smcRet == OK) {
         return Result(OK);
     } else {
-        return Result(FAILED, "failed to enable smc acc, please check if the kernel module is loaded.");
+        return Result(FAILED, "failed to enable smc acc, please check if the smc module is loaded.");
     }
 }
 
@@ -73,13 +74,19 @@ void SmcTune::Disable()
 
 void SmcTune::Run()
 {
-    ReadConfig(SMC_CONFIG_PATH);
-    if (SMC_OP->IsSamePortList(blackPortList, whitePortList)) {
+    if (ReadConfig(SMC_CONFIG_PATH).code != OK) {
+        return;
+    }
+    if (SMC_OP->IsSamePortList(blackPortList, whitePortList) && SMC_OP->IsSamePidList(pidList) &&
+        SMC_OP->IsSameShortConnection(shortConnection)) {
         return;
     }
     SMC_OP->InputPortList(blackPortList, whitePortList);
-    if (SMC_OP->ReRunSmcAcc() != EXIT_SUCCESS)
-        WARN(logger, "failed to ReRunSmcAcc");
+    SMC_OP->InputPidList(pidList);
+    SMC_OP->SetShortConnection(shortConnection);
+    // the policy is written to the loaded module in place, connections being set up keep working
+    if (SMC_OP->UpdateSmcAcc() != EXIT_SUCCESS)
+        WARN(logger, "failed to update smc acc policy");
 }
 
 Result SmcTune::ReadConfig(const std::string &path)
@@ -99,6 +106,10 @@ Result SmcTune::ReadConfig(const std::string &path)
         }
         blackPortList = node["black_port_list_param"] ? node["black_port_list_param"].as<std::string>() : "";
         whitePortList = node["white_port_list_param"] ? node["white_port_list_param"].as<std::string>() : "";
+        pidList = node["pid_list_param"] ? node["pid_list_param"].as<std::string>() : "";
+        if (pidList.find_first_not_of("0123456789,") != std::string::npos) {
+            return Result(FAILED, "smc_acc.yaml 'pid_list_param' value invalid.");
+        }
         auto s = node["short_connection"] ? node["short_connection"].as<std::string>() : "";
         if (!oeaware::IsNum(s)) {
             return Result(FAILED, "smc_acc.yaml 'short_connection' error.");
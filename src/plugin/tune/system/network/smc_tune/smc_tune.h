@@ -31,9 +31,10 @@ private:
     Result ReadConfig(const std::string &path);
     std::string blackPortList;
     std::string whitePortList;
+    std::string pidList;
     int shortConnection = 1;
     std::unordered_set<std::string> configStrs = {
-        "black_port_list_param", "white_port_list_param", "short_connection"
+        "black_port_list_param", "white_port_list_param", "pid_list_param", "short_connection"
     };
 };
 } // namespace oeaware
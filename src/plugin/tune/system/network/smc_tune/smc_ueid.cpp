@@ -11,20 +11,16 @@
  ******************************************************************************/
 
 #include "smc_ueid.h"
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/syscall.h>
 
-static const int SMC_CMD_MAX_LEN = 128;
 const struct nla_policy smc_gen_ueid_policy[SMC_ACC_NLA_EID_TABLE_MAX + 1] = {
     [SMC_ACC_NLA_EID_TABLE_UNSPEC] = {.type = NLA_UNSPEC},
     [SMC_ACC_NLA_EID_TABLE_ENTRY]  = {.type = NLA_NUL_STRING},
 };
 
-const std::vector<std::string> whiteList ={
-    "lsmod",
-    "grep",
-    "rmmod",
-    "insmod"
-};
-
 static int HandleGenUeidReply(struct nl_msg *msg, void *arg)
 {
     struct nlattr *attrs[SMC_ACC_NLA_EID_TABLE_ENTRY + 1];
@@ -49,43 +45,6 @@ static inline int FileExist(const char *path)
     return access(path, F_OK) == 0;
 }
 
-static inline bool IsValidCmd(const std::string& cmd)
-{
-    for (const auto& allowed_cmd : whiteList) {
-        if(cmd.find(allowed_cmd) != std::string::npos) {
-            return true;
-        }
-    }
-    return false;
-}
-
-static int Exec(const std::string &cmd)
-{
-    FILE *output;
-    char buffer[SMC_CMD_MAX_LEN];
-    if (cmd.length() > SMC_CMD_MAX_LEN) {
-        SMCLOG_ERROR("Too many words");
-    }
-    int status;
-
-    if (!IsValidCmd(cmd)) {
-        SMCLOG_ERROR("Invalid command: " << cmd);
-        return -1;
-    }
-    // 使用白名单检查命令是否合法，外部无法随意控制
-    output = popen(cmd.c_str(), "r");
-    if (output == NULL) {
-        return -1;
-    }
-    // Discard all output to avoid blocking pipe
-    while (fgets(buffer, sizeof(buffer), output) != NULL) {
-    }
-
-    status = pclose(output);
-    SMCLOG_INFO(" command: " << cmd << ", status:" << WEXITSTATUS(status));
-    return WEXITSTATUS(status);
-}
-
 int SmcOperator::InvokeUeid(int act)
 {
     int rc = EXIT_SUCCESS;
@@ -127,48 +86,89 @@ void SmcOperator::SetEnable(int isEnable)
     enable = isEnable;
 }
 
-int SmcOperator::RunSmcAcc()
+bool SmcOperator::IsModuleLoaded(const std::string &module)
 {
-    int rc = EXIT_SUCCESS;
-    std::stringstream args;
-
-    if (enable == SMC_DISABLE) {
-        if (!Exec("lsmod | grep -w smc_acc")) {
-            rc = Exec("rmmod smc_acc");
-            goto out;
-        }
-        goto out;
-    }
+    return FileExist(("/sys/module/" + module).c_str());
+}
 
+std::string SmcOperator::SmcAccArgs()
+{
+    std::stringstream args;
     if (!blackPortList.empty()) {
         args << "black_port_list_param=\"" << blackPortList << "\" ";
     }
     if (!whitePortList.empty()) {
         args << "white_port_list_param=\"" << whitePortList << "\" ";
     }
-    args << "short_connection=" << shortConnection;
+    if (!pidList.empty()) {
+        args << "pid_list_param=\"" << pidList << "\" ";
+    }
+    args << "short_connection=" << shortConnection << " enable=1";
+    return args.str();
+}
+
+int SmcOperator::LoadSmcAcc()
+{
     if (!FileExist(SMC_ACC_KO_PATH)) {
-        SMCLOG_ERROR(SMC_ACC_KO_PATH << "  is not exist.");
-        rc = EXIT_FAILURE;
-        goto out;
+        SMCLOG_ERROR(SMC_ACC_KO_PATH << " is not exist.");
+        return EXIT_FAILURE;
     }
-    if (Exec("lsmod | grep -w smc_acc")) {
-        std::string cmd = std::string("insmod ") + SMC_ACC_KO_PATH + " " + args.str();
-        rc = Exec(cmd);
+    int fd = open(SMC_ACC_KO_PATH, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        SMCLOG_ERROR("failed to open " << SMC_ACC_KO_PATH << ", " << strerror(errno));
+        return EXIT_FAILURE;
     }
+    std::string args = SmcAccArgs();
+    long ret = syscall(SYS_finit_module, fd, args.c_str(), 0);
+    int err = errno;
+    close(fd);
+    if (ret != 0 && err != EEXIST) {
+        SMCLOG_ERROR("failed to load smc_acc, " << strerror(err));
+        return EXIT_FAILURE;
+    }
+    SMCLOG_INFO("smc_acc loaded, args: " << args);
+    return EXIT_SUCCESS;
+}
 
-out:
-    return rc;
+int SmcOperator::WriteSmcAccParam(const std::string &param, const std::string &value)
+{
+    std::ofstream file(SMC_ACC_PARAM_PATH + param);
+    if (!file.is_open() || !(file << value << std::endl)) {
+        SMCLOG_ERROR("failed to write smc_acc " << param << ": " << value);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/*
+ * smc_acc is loaded once and stays loaded, enable and disable only flip its enable parameter, and the port and pid
+ * lists are written to the parameters in place, so neither needs a module reload.
+ */
+int SmcOperator::RunSmcAcc()
+{
+    if (enable == SMC_DISABLE) {
+        if (!IsModuleLoaded("smc_acc")) {
+            return EXIT_SUCCESS;
+        }
+        return WriteSmcAccParam("enable", "0");
+    }
+    if (!IsModuleLoaded("smc_acc")) {
+        return LoadSmcAcc();
+    }
+    if (UpdateSmcAcc() != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+    return WriteSmcAccParam("enable", "1");
 }
 
 int SmcOperator::CheckSmcKo()
 {
     int rc = EXIT_SUCCESS;
-    if (Exec("lsmod | grep -w smc") == EXIT_FAILURE) {
+    if (!IsModuleLoaded("smc")) {
         rc = EXIT_FAILURE;
         SMCLOG_ERROR("smc ko is not running");
     }
-    if (Exec("lsmod | grep -w smc_acc") == EXIT_FAILURE) {
+    if (!IsModuleLoaded("smc_acc")) {
         rc = EXIT_FAILURE;
         SMCLOG_ERROR("smc_acc ko is not running");
     }
@@ -256,33 +256,35 @@ void SmcOperator::SetShortConnection(int value)
     this->shortConnection = value;
 }
 
-int SmcOperator::ReRunSmcAcc()
+int SmcOperator::InputPidList(const std::string &pidStr)
 {
-    int rc = EXIT_SUCCESS;
-    std::stringstream args;
+    pidList = pidStr;
+    return 0;
+}
 
-    if (!Exec("lsmod | grep -w smc_acc")) {
-        rc = Exec("rmmod smc_acc");
-    }
+bool SmcOperator::IsSamePidList(const std::string &pidStr)
+{
+    return pidList == pidStr;
+}
 
-    if (!blackPortList.empty()) {
-        args << "black_port_list_param=\"" << blackPortList << "\" ";
-    }
-    if (!whitePortList.empty()) {
-        args << "white_port_list_param=\"" << whitePortList << "\" ";
+bool SmcOperator::IsSameShortConnection(int value)
+{
+    return shortConnection == value;
+}
+
+int SmcOperator::UpdateSmcAcc()
+{
+    if (!IsModuleLoaded("smc_acc")) {
+        return EXIT_SUCCESS;
     }
-    args << "short_connection=" << shortConnection;
-    SMCLOG_INFO("ReRunSmcAcc args:" << args.str());
-    if (!FileExist(SMC_ACC_KO_PATH)) {
-        SMCLOG_ERROR(SMC_ACC_KO_PATH << " is not exist.");
+    int rc = EXIT_SUCCESS;
+    // the black list first, it takes precedence over the white list in the module
+    if (WriteSmcAccParam("black_port_list_param", blackPortList) != EXIT_SUCCESS ||
+        WriteSmcAccParam("white_port_list_param", whitePortList) != EXIT_SUCCESS ||
+        WriteSmcAccParam("pid_list_param", pidList) != EXIT_SUCCESS ||
+        WriteSmcAccParam("short_connection", std::to_string(shortConnection)) != EXIT_SUCCESS) {
         rc = EXIT_FAILURE;
-        goto out;
-    }
-    if (Exec("lsmod | grep -w smc_acc")) {
-        std::string cmd = std::string("insmod ") + SMC_ACC_KO_PATH + " " + args.str();
-        rc = Exec(cmd);
     }
-
-out:
+    SMCLOG_INFO("UpdateSmcAcc args:" << SmcAccArgs());
     return rc;
 }
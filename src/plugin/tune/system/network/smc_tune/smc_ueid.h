@@ -40,8 +40,11 @@ public:
     int AbleSmcAcc(int isEnable);
     int InputPortList(const std::string &blackPortStr, const std::string &whitePortStr);
     bool IsSamePortList(const std::string &blackPortStr, const std::string &whitePortStr);
+    int InputPidList(const std::string &pidStr);
+    bool IsSamePidList(const std::string &pidStr);
     void SetShortConnection(int value);
-    int ReRunSmcAcc();
+    bool IsSameShortConnection(int value);
+    int UpdateSmcAcc();
 
 private:
     SmcOperator()
@@ -51,12 +54,17 @@ private:
     ~SmcOperator()
     {
     }
+    bool IsModuleLoaded(const std::string &module);
+    int LoadSmcAcc();
+    int WriteSmcAccParam(const std::string &param, const std::string &value);
+    std::string SmcAccArgs();
     int enable;
     struct nl_sock *sk;
     bool isInit;
     char targetEid[SMC_MAX_EID_LEN + 1];
     std::string blackPortList;
     std::string whitePortList;
+    std::string pidList;
     int shortConnection;
 };
 
@@ -23,6 +23,7 @@
 #include "cpu/numa_sched_tune/numa_sched_tune.h"
 #include "preload/preload_tune.h"
 #include "binary/binary_tune.h"
+#include "network/net_affinity/net_affinity_tune.h"
 #ifdef BUILD_REALTIME
 #include "realtime/realtime_tune.h"
 #endif
@@ -32,6 +33,9 @@
 #ifdef BUILD_MULTI_NET_PATH_TUNE
 #include "network/multi_net_path/multi_net_path.h"
 #endif
+#ifdef BUILD_COALESCE_TUNE
+#include "network/coalesce_tune/coalesce_tune.h"
+#endif
 using namespace oeaware;
 
 extern "C" void GetInstance(std::vector<std::shared_ptr<oeaware::Interface>> &interface)
@@ -48,6 +52,7 @@ extern "C" void GetInstance(std::vector<std::shared_ptr<oeaware::Interface>> &in
     interface.emplace_back(std::make_shared<PreloadTune>());
     interface.emplace_back(std::make_shared<BinaryTune>());
     interface.emplace_back(std::make_shared<NumaSchedTune>());
+    interface.emplace_back(std::make_shared<NetAffinityTune>());
 #ifdef BUILD_REALTIME
     interface.emplace_back(std::make_shared<RealTimeTune>());
 #endif
@@ -57,4 +62,7 @@ extern "C" void GetInstance(std::vector<std::shared_ptr<oeaware::Interface>> &in
 #ifdef BUILD_MULTI_NET_PATH_TUNE
     interface.emplace_back(std::make_shared<MultiNetPath>());
 #endif
+#ifdef BUILD_COALESCE_TUNE
+    interface.emplace_back(std::make_shared<NetCoalesceTune>());
+#endif
 }
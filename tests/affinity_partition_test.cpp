@@ -0,0 +1,105 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <fstream>
+#include <cstdlib>
+#include <sys/stat.h>
+#include "affinity_partition.h"
+
+using namespace oeaware;
+
+namespace {
+// 2 nodes with 2 L3 domains each, 4 cpus per domain
+std::vector<AffinityDomain> MakeDomains()
+{
+    const int domainNum = 4;
+    const int cpusPerDomain = 4;
+    std::vector<AffinityDomain> domains;
+    for (int d = 0; d < domainNum; ++d) {
+        AffinityDomain domain{ .id = d, .node = d / 2, .cpus = {} };
+        for (int cpu = 0; cpu < cpusPerDomain; ++cpu) {
+            domain.cpus.emplace_back(d * cpusPerDomain + cpu);
+        }
+        domains.emplace_back(domain);
+    }
+    return domains;
+}
+}
+
+TEST(AffinityPartitionTest, ColocateChattyPairs)
+{
+    AffinityPartitioner partitioner;
+    std::vector<AffinityTask> tasks;
+    for (int pid = 100; pid < 104; ++pid) {
+        tasks.emplace_back(AffinityTask{ .pid = pid, .load = 1 });
+    }
+    std::vector<AffinityEdge> edges = {
+        { 100, 101, 1e8 }, { 102, 103, 1e8 }, { 100, 102, 1e3 },
+    };
+    auto place = partitioner.Partition(MakeDomains(), tasks, edges);
+    ASSERT_EQ(place.size(), 4);
+    EXPECT_EQ(place[100], place[101]);
+    EXPECT_EQ(place[102], place[103]);
+}
+
+TEST(AffinityPartitionTest, SplitOverCapacityOnOneNode)
+{
+    AffinityPartitioner partitioner;
+    // 3 cpus of load per process, one domain holds 3.2, a chain of 4 does not fit in one domain
+    std::vector<AffinityTask> tasks;
+    for (int pid = 1000; pid < 1002; ++pid) {
+        tasks.emplace_back(AffinityTask{ .pid = pid, .load = 3 });
+    }
+    std::vector<AffinityEdge> edges = { { 1000, 1001, 1e8 } };
+    auto domains = MakeDomains();
+    auto place = partitioner.Partition(domains, tasks, edges);
+    ASSERT_EQ(place.size(), 2);
+    EXPECT_NE(place[1000], place[1001]);
+    // the split halves stay on the same node
+    EXPECT_EQ(domains[place[1000]].node, domains[place[1001]].node);
+}
+
+TEST(AffinityPartitionTest, StayOnCurrentDomain)
+{
+    AffinityPartitioner partitioner;
+    std::vector<AffinityTask> tasks = {
+        { .pid = 10, .load = 1, .current = 3 }, { .pid = 11, .load = 1, .current = 3 },
+        { .pid = 12, .load = 1, .current = -1 },
+    };
+    std::vector<AffinityEdge> edges = { { 10, 11, 1e8 }, { 11, 12, 1e7 } };
+    auto place = partitioner.Partition(MakeDomains(), tasks, edges);
+    EXPECT_EQ(place[10], 3);
+    EXPECT_EQ(place[11], 3);
+    EXPECT_EQ(place[12], 3);
+}
+
+TEST(AffinityPartitionTest, ReadDomains)
+{
+    char tmpl[] = "/tmp/affinity_partition_XXXXXX";
+    ASSERT_NE(mkdtemp(tmpl), nullptr);
+    std::string root = std::string(tmpl) + "/";
+    std::ofstream(root + "online") << "0-3\n";
+    for (int cpu = 0; cpu < 4; ++cpu) {
+        std::string dir = root + "cpu" + std::to_string(cpu);
+        mkdir(dir.c_str(), 0755);
+        mkdir((dir + "/cache").c_str(), 0755);
+        mkdir((dir + "/cache/index3").c_str(), 0755);
+        std::ofstream(dir + "/cache/index3/shared_cpu_list") << (cpu < 2 ? "0-1\n" : "2-3\n");
+    }
+    // cpu 4 is offline
+    auto domains = ReadAffinityDomains({ 0, 0, 0, 0, 0 }, root);
+    ASSERT_EQ(domains.size(), 2);
+    EXPECT_EQ(domains[0].cpus, std::vector<int>({ 0, 1 }));
+    EXPECT_EQ(domains[1].cpus, std::vector<int>({ 2, 3 }));
+    std::string cmd = "rm -rf " + std::string(tmpl);
+    (void)system(cmd.c_str());
+}
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <fstream>
+#include <cstdlib>
+#include <sys/stat.h>
+#include "coalesce_ctl.h"
+
+using namespace oeaware;
+
+TEST(CoalesceCtlTest, LatencyBelowIrqRate)
+{
+    CoalesceBound bound;
+    auto setting = DecideCoalesce(bound, CoalesceSetting(), 8 * 20000, 8);
+    EXPECT_FALSE(setting.batch);
+    EXPECT_EQ(setting.usecs, bound.minUsecs);
+    EXPECT_EQ(setting.frames, 1);
+    EXPECT_EQ(setting.deferIrqs, 0);
+}
+
+TEST(CoalesceCtlTest, BatchWithinBound)
+{
+    CoalesceBound bound;
+    auto setting = DecideCoalesce(bound, CoalesceSetting(), 8 * 100000, 8);
+    EXPECT_TRUE(setting.batch);
+    EXPECT_EQ(setting.usecs, 50);
+    EXPECT_EQ(setting.frames, 5);
+    EXPECT_EQ(setting.deferIrqs, 2);
+    EXPECT_EQ(setting.flushNs, 50000);
+    bound.maxUsecs = 20;
+    bound.maxFrames = 4;
+    bound.napiDefer = false;
+    setting = DecideCoalesce(bound, CoalesceSetting(), 8 * 100000, 8);
+    EXPECT_EQ(setting.usecs, 20);
+    EXPECT_EQ(setting.frames, 4);
+    EXPECT_EQ(setting.deferIrqs, 0);
+}
+
+TEST(CoalesceCtlTest, Hysteresis)
+{
+    CoalesceBound bound;
+    auto batch = DecideCoalesce(bound, CoalesceSetting(), 600000, 1);
+    ASSERT_TRUE(batch.batch);
+    EXPECT_EQ(batch.frames, 30);
+    // small rate changes keep the frames
+    EXPECT_EQ(DecideCoalesce(bound, batch, 660000, 1), batch);
+    EXPECT_EQ(DecideCoalesce(bound, batch, 1000000, 1).frames, 50);
+    // batching stops below half of irq_rate only
+    EXPECT_TRUE(DecideCoalesce(bound, batch, 15000, 1).batch);
+    EXPECT_FALSE(DecideCoalesce(bound, batch, 9000, 1).batch);
+}
+
+TEST(CoalesceCtlTest, NapiDeferAndRestore)
+{
+    char tmpl[] = "/tmp/coalesce_ctl_XXXXXX";
+    ASSERT_NE(mkdtemp(tmpl), nullptr);
+    std::string root = tmpl;
+    for (auto dir : { "/net", "/net/eth0", "/net/eth0/queues", "/net/eth0/queues/rx-0", "/net/eth0/queues/rx-1",
+        "/net/eth0/queues/tx-0", "/core" }) {
+        mkdir((root + dir).c_str(), 0755);
+    }
+    auto write = [&root](const std::string &path, const std::string &value) {
+        std::ofstream(root + path) << value << "\n";
+    };
+    auto read = [&root](const std::string &path) {
+        std::ifstream file(root + path);
+        std::string value;
+        std::getline(file, value);
+        return value;
+    };
+    write("/net/eth0/napi_defer_hard_irqs", "0");
+    write("/net/eth0/gro_flush_timeout", "0");
+    write("/core/busy_poll", "0");
+    write("/core/busy_read", "0");
+    NetCoalesceCtl ctl(root + "/net/", root + "/core/");
+    EXPECT_EQ(ctl.GetRxQueues("eth0"), 2);
+    EXPECT_FALSE(ctl.SetCoalesce("coalesce_none", 50, 4));
+    // never written, nothing to write back
+    EXPECT_TRUE(ctl.RestoreCoalesce("coalesce_none"));
+    ASSERT_TRUE(ctl.SetNapiDefer("eth0", 2, 50000));
+    ASSERT_TRUE(ctl.SetBusyPoll(50));
+    EXPECT_EQ(read("/net/eth0/napi_defer_hard_irqs"), "2");
+    EXPECT_EQ(read("/net/eth0/gro_flush_timeout"), "50000");
+    EXPECT_EQ(read("/core/busy_read"), "50");
+    // no defer writes back the original values of the device
+    ASSERT_TRUE(ctl.SetNapiDefer("eth0", 0, 0));
+    EXPECT_EQ(read("/net/eth0/napi_defer_hard_irqs"), "0");
+    EXPECT_EQ(read("/net/eth0/gro_flush_timeout"), "0");
+    ASSERT_TRUE(ctl.SetNapiDefer("eth0", 2, 20000));
+    ctl.Restore();
+    EXPECT_EQ(read("/net/eth0/napi_defer_hard_irqs"), "0");
+    EXPECT_EQ(read("/net/eth0/gro_flush_timeout"), "0");
+    EXPECT_EQ(read("/core/busy_poll"), "0");
+    EXPECT_EQ(read("/core/busy_read"), "0");
+    std::string cmd = "rm -rf " + root;
+    (void)system(cmd.c_str());
+}
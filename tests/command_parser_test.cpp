@@ -0,0 +1,103 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <cmath>
+#include "command_parser.h"
+#include "data_register.h"
+
+static CommandTypedData *GetTyped(const DataList &dataList, size_t index)
+{
+    return static_cast<CommandTypedData*>(dataList.data[index]);
+}
+
+TEST(TypedCommand, ParseMpstat)
+{
+    TypedCommand typed;
+    // "-A" has no native implementation, so the command output is parsed.
+    typed.Init(oeaware::Topic{"command_collector", "mpstat_typed", "-A 1"});
+    ASSERT_FALSE(typed.IsNative());
+    std::vector<std::string> lines = {
+        "Linux 5.10.0 (host) \t01/01/2025 \t_aarch64_\t(4 CPU)\n",
+        "\n",
+        "10:00:01 AM  CPU    %usr   %nice    %sys\n",
+        "10:00:02 AM  all    1.50    0.00    0.25\n",
+        "10:00:02 AM    0    3.00    0.00    0.50\n",
+        "10:00:02 AM    1       -    0.00\n",
+    };
+    for (auto &line : lines) {
+        std::vector<char> buf(line.begin(), line.end());
+        buf.push_back('\0');
+        typed.ParseLine(buf.data(), line.size());
+    }
+    DataList dataList;
+    ASSERT_TRUE(typed.FillDataStruct(&dataList));
+    ASSERT_EQ(1U, dataList.len);
+    auto data = GetTyped(dataList, 0);
+    ASSERT_EQ(6, data->colLen);
+    ASSERT_EQ(3, data->rowLen);
+    EXPECT_STREQ("CPU", data->colNames[2]);
+    EXPECT_EQ(COMMAND_COLUMN_TEXT, data->colTypes[2]);
+    EXPECT_EQ(COMMAND_COLUMN_NUMERIC, data->colTypes[3]);
+    EXPECT_STREQ("all", data->textPool + data->textOffset[2 * data->rowLen]);
+    EXPECT_STREQ("1", data->textPool + data->textOffset[2 * data->rowLen + 2]);
+    EXPECT_DOUBLE_EQ(3.0, data->values[3 * data->rowLen + 1]);
+    EXPECT_TRUE(std::isnan(data->values[3 * data->rowLen + 2]));
+    EXPECT_TRUE(std::isnan(data->values[5 * data->rowLen + 2]));
+
+    oeaware::OutStream out;
+    oeaware::Register::GetInstance().InitRegisterData();
+    auto se = oeaware::Register::GetInstance().GetDataSerialize("command_collector::mpstat_typed");
+    auto de = oeaware::Register::GetInstance().GetDataDeserialize("command_collector::mpstat_typed");
+    ASSERT_NE(nullptr, se);
+    se(data, out);
+    oeaware::InStream in(out.Str());
+    void *result = nullptr;
+    ASSERT_EQ(0, de(&result, in));
+    auto newData = static_cast<CommandTypedData*>(result);
+    EXPECT_EQ(data->schemaId, newData->schemaId);
+    EXPECT_EQ(data->rowLen, newData->rowLen);
+    EXPECT_STREQ("%sys", newData->colNames[5]);
+    EXPECT_DOUBLE_EQ(0.25, newData->values[5 * newData->rowLen]);
+    EXPECT_STREQ("0", newData->textPool + newData->textOffset[2 * newData->rowLen + 1]);
+}
+
+TEST(TypedCommand, NativeBackend)
+{
+    TypedCommand typed;
+    typed.Init(oeaware::Topic{"command_collector", "mpstat_typed", "-P ALL 1"});
+    EXPECT_TRUE(typed.IsNative());
+    TypedCommand pidstat;
+    pidstat.Init(oeaware::Topic{"command_collector", "pidstat_typed", "1"});
+    EXPECT_FALSE(pidstat.IsNative());
+    // "-d" alone prints the basic device report, which is not sampled natively
+    TypedCommand iostat;
+    iostat.Init(oeaware::Topic{"command_collector", "iostat_typed", "-d 1"});
+    EXPECT_FALSE(iostat.IsNative());
+    TypedCommand iostatExt;
+    iostatExt.Init(oeaware::Topic{"command_collector", "iostat_typed", "-d -x 1"});
+    EXPECT_TRUE(iostatExt.IsNative());
+
+    CommandSection section;
+    MpstatNative mpstat(true);
+    section.SetHeader(mpstat.GetAttr(), mpstat.GetColNames());
+    ASSERT_TRUE(mpstat.Sample(section, 0));
+    EXPECT_EQ(0, section.rowLen);
+    ASSERT_TRUE(mpstat.Sample(section, 1));
+    EXPECT_EQ(sysconf(_SC_NPROCESSORS_ONLN) + 1, section.rowLen);
+    EXPECT_EQ(COMMAND_COLUMN_TEXT, section.colTypes[0]);
+
+    // after a reset the first sample only records the counters again
+    section.Clear();
+    mpstat.Reset();
+    ASSERT_TRUE(mpstat.Sample(section, 0));
+    EXPECT_EQ(0, section.rowLen);
+}
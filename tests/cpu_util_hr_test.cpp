@@ -0,0 +1,46 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include "cpu_util_hr.h"
+
+static oeaware::Topic HrTopic(const std::string &params)
+{
+    return oeaware::Topic{OE_ENV_INFO_HR, "cpu_util_hr", params};
+}
+
+TEST(CpuUtilHrTest, DefaultInterval)
+{
+    CpuUtilHr hr;
+    ASSERT_EQ(hr.OpenTopic(HrTopic("")).code, OK);
+    EXPECT_EQ(hr.GetPeriod(), 100);
+    hr.Disable();
+}
+
+TEST(CpuUtilHrTest, SmallestIntervalWins)
+{
+    CpuUtilHr hr;
+    ASSERT_EQ(hr.OpenTopic(HrTopic("50")).code, OK);
+    ASSERT_EQ(hr.OpenTopic(HrTopic("20")).code, OK);
+    EXPECT_EQ(hr.GetPeriod(), 20);
+    hr.CloseTopic(HrTopic("20"));
+    EXPECT_EQ(hr.GetPeriod(), 50);
+    hr.Disable();
+}
+
+TEST(CpuUtilHrTest, RejectIntervalOffSchedulerCycle)
+{
+    CpuUtilHr hr;
+    EXPECT_EQ(hr.OpenTopic(HrTopic("15")).code, FAILED);
+    EXPECT_EQ(hr.OpenTopic(HrTopic("5")).code, FAILED);
+    EXPECT_EQ(hr.OpenTopic(HrTopic("110")).code, FAILED);
+    EXPECT_EQ(hr.GetPeriod(), 100);
+}
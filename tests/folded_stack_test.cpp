@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include "folded_stack.h"
+
+using oeaware::FoldedStack;
+
+static std::vector<FoldedStack::Item> Filter(const std::vector<FoldedStack::Item> &items, int type)
+{
+    std::vector<FoldedStack::Item> result;
+    for (auto &item : items) {
+        if (item.type == type) {
+            result.emplace_back(item);
+        }
+    }
+    return result;
+}
+
+TEST(FoldedStackTest, TopFunctionsAndPaths)
+{
+    FoldedStack profile;
+    profile.Add("nginx:1", {"memcpy", "send", "main"}, 3);
+    profile.Add("nginx:1", {"memcpy", "recv", "main"}, 2);
+    profile.Add("nginx:1", {"poll", "main"});
+    profile.Add("redis:2", {"memcpy", "main"});
+    EXPECT_EQ(profile.GetSamples(), 7U);
+    auto items = profile.Top(2);
+    auto funcs = Filter(items, FoldedStack::SELF);
+    ASSERT_EQ(funcs.size(), 2U);
+    EXPECT_EQ(funcs[0].group, "nginx:1");
+    EXPECT_EQ(funcs[0].name, "memcpy");
+    EXPECT_EQ(funcs[0].samples, 5U);
+    auto paths = Filter(items, FoldedStack::PATH);
+    ASSERT_EQ(paths.size(), 2U);
+    EXPECT_EQ(paths[0].name, "main;send;memcpy");
+    EXPECT_EQ(paths[0].samples, 3U);
+    EXPECT_EQ(paths[1].name, "main;recv;memcpy");
+}
+
+TEST(FoldedStackTest, DeltaAgainstPreviousWindow)
+{
+    FoldedStack profile;
+    profile.Add("app:1", {"foo", "main"}, 4);
+    profile.Add("app:1", {"bar", "main"}, 1);
+    profile.Roll();
+    profile.Add("app:1", {"foo", "main"}, 2);
+    profile.Add("app:1", {"bar", "main"}, 6);
+    auto items = profile.Top(1);
+    auto funcs = Filter(items, FoldedStack::SELF);
+    ASSERT_EQ(funcs.size(), 1U);
+    EXPECT_EQ(funcs[0].name, "bar");
+    EXPECT_EQ(funcs[0].delta, 5);
+    auto paths = Filter(items, FoldedStack::PATH);
+    ASSERT_EQ(paths.size(), 1U);
+    EXPECT_EQ(paths[0].delta, 5);
+    auto regressions = Filter(items, FoldedStack::REGRESSION);
+    ASSERT_EQ(regressions.size(), 1U);
+    EXPECT_EQ(regressions[0].name, "bar");
+}
+
+TEST(FoldedStackTest, NodeLimit)
+{
+    FoldedStack profile(3);
+    profile.Add("app:1", {"foo", "main"});
+    profile.Add("app:1", {"bar", "main"}, 2);
+    EXPECT_EQ(profile.GetTruncated(), 2U);
+    auto paths = Filter(profile.Top(2), FoldedStack::PATH);
+    ASSERT_EQ(paths.size(), 2U);
+    EXPECT_EQ(paths[0].name, "main");
+    EXPECT_EQ(paths[1].name, "main;foo");
+}
@@ -0,0 +1,77 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include "hirq_series.h"
+
+using namespace oeaware;
+
+TEST(HirqSeriesTest, RingStat)
+{
+    RateRing ring(4);
+    EXPECT_EQ(ring.Stat().mean, 0);
+    ring.Push(100);
+    ring.Push(300);
+    auto stat = ring.Stat();
+    EXPECT_EQ(ring.Size(), 2);
+    EXPECT_FLOAT_EQ(stat.rate, 300);
+    EXPECT_FLOAT_EQ(stat.mean, 200);
+    EXPECT_FLOAT_EQ(stat.p50, 100);
+    EXPECT_FLOAT_EQ(stat.p99, 300);
+    EXPECT_FLOAT_EQ(stat.burstiness, 0.5);
+    // the oldest periods are overwritten
+    for (int i = 0; i < 4; ++i) {
+        ring.Push(1000);
+    }
+    stat = ring.Stat();
+    EXPECT_EQ(ring.Size(), 4);
+    EXPECT_FLOAT_EQ(stat.mean, 1000);
+    EXPECT_FLOAT_EQ(stat.burstiness, 0);
+    EXPECT_FALSE(ring.AllZero());
+    for (int i = 0; i < 4; ++i) {
+        ring.Push(0);
+    }
+    EXPECT_TRUE(ring.AllZero());
+}
+
+TEST(HirqSeriesTest, Percentile)
+{
+    RateRing ring(100);
+    for (int i = 1; i <= 100; ++i) {
+        ring.Push(i);
+    }
+    auto stat = ring.Stat();
+    EXPECT_FLOAT_EQ(stat.p50, 50);
+    EXPECT_FLOAT_EQ(stat.p95, 95);
+    EXPECT_FLOAT_EQ(stat.p99, 99);
+}
+
+TEST(HirqSeriesTest, Gini)
+{
+    EXPECT_FLOAT_EQ(Gini({ 10, 10, 10, 10 }), 0);
+    EXPECT_FLOAT_EQ(Gini({ 0, 0, 0, 40 }), 0.75);
+    EXPECT_FLOAT_EQ(Gini({ 0, 0, 0, 0 }), 0);
+    EXPECT_FLOAT_EQ(Gini({ 5 }), 0);
+}
+
+TEST(HirqSeriesTest, Suggestion)
+{
+    EXPECT_EQ(SuggestQueues(450000, 100000, 4, 64), 5);
+    EXPECT_EQ(SuggestQueues(350000, 100000, 4, 64), 0);
+    EXPECT_EQ(SuggestQueues(9000000, 100000, 4, 64), 64);
+    EXPECT_TRUE(SuggestRssWeights({ 10, 10, 10, 10 }, Gini({ 10, 10, 10, 10 })).empty());
+    std::vector<float> means = { 80000, 10000, 10000, 0 };
+    auto weights = SuggestRssWeights(means, Gini(means));
+    ASSERT_EQ(weights.size(), 4);
+    EXPECT_EQ(weights[0], 1);
+    EXPECT_EQ(weights[1], 10);
+    EXPECT_EQ(weights[3], 16);
+}
@@ -0,0 +1,292 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <set>
+#include <cstdlib>
+#include <sys/stat.h>
+#include "irq_assign.h"
+
+using namespace oeaware;
+
+namespace {
+// 2 nodes, 8 cpus per node, 2 SMT threads per core, 4 cpus per cluster.
+std::vector<IrqCpu> MakeCpus(float taskLoad)
+{
+    const int cpuNum = 16;
+    const int cpusPerNode = 8;
+    const int cpusPerCluster = 4;
+    std::vector<IrqCpu> cpus;
+    for (int cpu = 0; cpu < cpuNum; ++cpu) {
+        cpus.emplace_back(IrqCpu{ .cpu = cpu, .node = cpu / cpusPerNode, .core = cpu / 2 * 2,
+            .cluster = cpu / cpusPerCluster * cpusPerCluster, .taskLoad = taskLoad });
+    }
+    return cpus;
+}
+
+/*
+ * Trace written by tests/workload/net_irq/record_irq_trace.sh, lines starting with '#' are comments:
+ *   topology <cpu> <node> <core> <cluster>  before the first period, MakeCpus(0) without it
+ *   period
+ *   cpu <cpu> <idle> <irq> <softirq>      percent, as env_info_collector::cpu_util
+ *   queue <irq> <weight> <preferredNode>  rx of the queue in the period
+ */
+struct Period {
+    std::vector<IrqCpu> cpus;
+    std::vector<IrqLoad> irqs;
+    float irqLoad = 0;
+};
+
+std::vector<Period> ParseRecord(const std::string &record)
+{
+    std::vector<Period> periods;
+    std::vector<IrqCpu> topology;
+    std::istringstream in(record);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream words(line);
+        std::string kind;
+        words >> kind;
+        if (kind == "topology") {
+            IrqCpu cpu = {};
+            words >> cpu.cpu >> cpu.node >> cpu.core >> cpu.cluster;
+            topology.emplace_back(cpu);
+        } else if (kind == "period") {
+            periods.emplace_back();
+            periods.back().cpus = topology.empty() ? MakeCpus(0) : topology;
+        } else if (kind == "cpu") {
+            int cpu;
+            float idle;
+            float irq;
+            float softirq;
+            words >> cpu >> idle >> irq >> softirq;
+            for (auto &item : periods.back().cpus) {
+                if (item.cpu == cpu) {
+                    item.taskLoad = 100 - idle - irq - softirq;
+                }
+            }
+            periods.back().irqLoad += irq + softirq;
+        } else if (kind == "queue") {
+            IrqLoad irq;
+            words >> irq.irqId >> irq.weight >> irq.preferredNode;
+            periods.back().irqs.emplace_back(irq);
+        }
+    }
+    return periods;
+}
+
+// Replay the periods, the cpu chosen in one period is the current cpu of the next one.
+std::vector<size_t> Replay(IrqAssigner &assigner, std::vector<Period> &periods, std::unordered_map<int, int> &bind)
+{
+    std::vector<size_t> writes;
+    for (auto &period : periods) {
+        for (auto &irq : period.irqs) {
+            irq.currentCpu = bind.count(irq.irqId) ? bind[irq.irqId] : -1;
+        }
+        auto changed = assigner.Assign(period.cpus, period.irqs, period.irqLoad);
+        for (auto &item : changed) {
+            bind[item.first] = item.second;
+        }
+        writes.emplace_back(changed.size());
+    }
+    return writes;
+}
+
+// a 16 cpu host with a few hot queues and a long tail, one cpu is taken by a busy task
+std::string SyntheticNic(int periods, int queues, int busyCpu)
+{
+    std::ostringstream os;
+    for (int p = 0; p < periods; ++p) {
+        os << "period\n";
+        for (int cpu = 0; cpu < 16; ++cpu) {
+            os << "cpu " << cpu << (cpu == busyCpu ? " 10 2 8\n" : " 80 2 8\n");
+        }
+        for (int q = 0; q < queues; ++q) {
+            // small noise between periods
+            int rx = (q < 4 ? 5000 : 200 + q * 10) + p * 3;
+            os << "queue " << 100 + q << " " << rx << " 0\n";
+        }
+    }
+    return os.str();
+}
+}
+
+TEST(IrqAssignTest, SpreadOverPhysicalCores)
+{
+    IrqAssigner assigner;
+    auto cpus = MakeCpus(0);
+    std::vector<IrqLoad> irqs;
+    for (int i = 0; i < 4; ++i) {
+        irqs.emplace_back(IrqLoad{ .irqId = i, .weight = 100, .preferredNode = 0 });
+    }
+    auto changed = assigner.Assign(cpus, irqs, 40);
+    ASSERT_EQ(changed.size(), 4);
+    std::set<int> cores;
+    for (auto &item : changed) {
+        EXPECT_LT(item.second, 8);
+        cores.insert(item.second / 2);
+    }
+    // every irq has its own physical core before SMT siblings are used
+    EXPECT_EQ(cores.size(), 4);
+}
+
+TEST(IrqAssignTest, WeightedBinPacking)
+{
+    IrqAssigner assigner;
+    auto cpus = MakeCpus(0);
+    std::vector<IrqLoad> irqs;
+    irqs.emplace_back(IrqLoad{ .irqId = 0, .weight = 800, .preferredNode = 1 });
+    for (int i = 1; i <= 16; ++i) {
+        irqs.emplace_back(IrqLoad{ .irqId = i, .weight = 50, .preferredNode = 1 });
+    }
+    auto changed = assigner.Assign(cpus, irqs, 160);
+    ASSERT_EQ(changed.size(), irqs.size());
+    int heavyCpu = changed[0];
+    for (auto &item : changed) {
+        EXPECT_GE(item.second, 8);
+        if (item.first != 0) {
+            EXPECT_NE(item.second, heavyCpu);
+        }
+    }
+    auto &load = assigner.GetCpuIrqLoad();
+    float maxLight = 0;
+    for (auto &item : load) {
+        if (item.first != heavyCpu) {
+            maxLight = std::max(maxLight, item.second);
+        }
+    }
+    EXPECT_LE(maxLight, load.at(heavyCpu));
+}
+
+TEST(IrqAssignTest, AvoidBusyCpu)
+{
+    IrqAssigner assigner;
+    auto cpus = MakeCpus(0);
+    cpus[3].taskLoad = 90;
+    std::vector<IrqLoad> irqs;
+    for (int i = 0; i < 7; ++i) {
+        irqs.emplace_back(IrqLoad{ .irqId = i, .weight = 100, .preferredNode = 0 });
+    }
+    for (auto &item : assigner.Assign(cpus, irqs, 70)) {
+        EXPECT_NE(item.second, 3);
+    }
+}
+
+TEST(IrqAssignTest, Hysteresis)
+{
+    IrqAssigner assigner;
+    auto cpus = MakeCpus(0);
+    std::vector<IrqLoad> irqs;
+    for (int i = 0; i < 8; ++i) {
+        irqs.emplace_back(IrqLoad{ .irqId = i, .weight = 100, .preferredNode = 0 });
+    }
+    auto first = assigner.Assign(cpus, irqs, 40);
+    for (auto &irq : irqs) {
+        irq.currentCpu = first[irq.irqId];
+    }
+    EXPECT_TRUE(assigner.Assign(cpus, irqs, 40).empty());
+    // small changes of the load do not move irqs
+    cpus[first[0]].taskLoad = 5;
+    irqs[1].weight = 120;
+    EXPECT_TRUE(assigner.Assign(cpus, irqs, 40).empty());
+    // a cpu taken by a busy task is left
+    cpus[first[0]].taskLoad = 95;
+    auto changed = assigner.Assign(cpus, irqs, 40);
+    ASSERT_EQ(changed.size(), 1);
+    EXPECT_NE(changed[0], first[0]);
+}
+
+TEST(IrqAssignTest, ReplaySyntheticNic)
+{
+    const int periodNum = 5;
+    const int queueNum = 64;
+    const int busyCpu = 2;
+    auto periods = ParseRecord(SyntheticNic(periodNum, queueNum, busyCpu));
+    ASSERT_EQ(periods.size(), periodNum);
+    IrqAssigner assigner;
+    std::unordered_map<int, int> bind;
+    auto writes = Replay(assigner, periods, bind);
+    EXPECT_EQ(writes[0], queueNum);
+    for (int p = 1; p < periodNum; ++p) {
+        EXPECT_EQ(writes[p], 0);
+    }
+    std::vector<int> hot(8, 0);
+    for (auto &item : bind) {
+        ASSERT_LT(item.second, 8);
+        if (item.first < 100 + 4) {
+            hot[item.second]++;
+        }
+    }
+    // the 4 hot queues get different cpus and none of them the busy one
+    for (int cpu = 0; cpu < 8; ++cpu) {
+        EXPECT_LE(hot[cpu], 1);
+    }
+    EXPECT_EQ(hot[busyCpu], 0);
+    // irq load is balanced within the node, the sibling of the busy cpu takes more since it shares no irq
+    float maxLoad = 0;
+    float minLoad = 1e9;
+    for (int cpu = 0; cpu < 8; ++cpu) {
+        if (cpu == busyCpu || cpu == (busyCpu ^ 1)) {
+            continue;
+        }
+        float load = assigner.GetCpuIrqLoad().count(cpu) ? assigner.GetCpuIrqLoad().at(cpu) : 0;
+        maxLoad = std::max(maxLoad, load);
+        minLoad = std::min(minLoad, load);
+    }
+    EXPECT_LT(maxLoad - minLoad, 10);
+}
+
+TEST(IrqAssignTest, ReplayRecordedVirtioNic)
+{
+    std::ifstream file(std::string(IRQ_TRACE_DIR) + "/irq_trace_virtio_1cpu.txt");
+    ASSERT_TRUE(file.is_open());
+    std::stringstream record;
+    record << file.rdbuf();
+    auto periods = ParseRecord(record.str());
+    ASSERT_EQ(periods.size(), 10);
+    ASSERT_EQ(periods[0].cpus.size(), 1);
+    IrqAssigner assigner;
+    std::unordered_map<int, int> bind;
+    auto writes = Replay(assigner, periods, bind);
+    // the only rx irq goes to the only cpu once, the rate changes between periods move nothing
+    EXPECT_EQ(writes[0], 1);
+    for (size_t p = 1; p < writes.size(); ++p) {
+        EXPECT_EQ(writes[p], 0);
+    }
+    ASSERT_EQ(bind.count(40), 1);
+    EXPECT_EQ(bind[40], 0);
+}
+
+TEST(IrqAssignTest, ReadTopology)
+{
+    char tmpl[] = "/tmp/irq_assign_XXXXXX";
+    ASSERT_NE(mkdtemp(tmpl), nullptr);
+    std::string root = std::string(tmpl) + "/";
+    for (int cpu = 0; cpu < 2; ++cpu) {
+        std::string dir = root + "cpu" + std::to_string(cpu);
+        mkdir(dir.c_str(), 0755);
+        mkdir((dir + "/topology").c_str(), 0755);
+        std::ofstream(dir + "/topology/thread_siblings_list") << "0-1\n";
+        if (cpu == 0) {
+            std::ofstream(dir + "/topology/cluster_cpus_list") << "0-3\n";
+        }
+    }
+    std::vector<IrqCpu> cpus = { IrqCpu{ .cpu = 0, .node = 0 }, IrqCpu{ .cpu = 1, .node = 0 } };
+    ReadIrqCpuTopology(cpus, root);
+    EXPECT_EQ(cpus[0].core, 0);
+    EXPECT_EQ(cpus[1].core, 0);
+    EXPECT_EQ(cpus[0].cluster, 0);
+    EXPECT_EQ(cpus[1].cluster, -1);
+    std::string cmd = "rm -rf " + std::string(tmpl);
+    (void)system(cmd.c_str());
+}
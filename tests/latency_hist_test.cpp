@@ -0,0 +1,60 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include "latency_hist.h"
+
+using namespace oeaware;
+
+constexpr int SLOTS = 32;
+
+TEST(LatencyHistTest, Slot)
+{
+    EXPECT_EQ(HistSlot(0, SLOTS), 0);
+    EXPECT_EQ(HistSlot(1, SLOTS), 0);
+    EXPECT_EQ(HistSlot(2, SLOTS), 1);
+    EXPECT_EQ(HistSlot(3, SLOTS), 1);
+    EXPECT_EQ(HistSlot(1024, SLOTS), 10);
+    EXPECT_EQ(HistSlot(2047, SLOTS), 10);
+    // larger values are all in the last slot
+    EXPECT_EQ(HistSlot(1ULL << 40, SLOTS), SLOTS - 1);
+}
+
+TEST(LatencyHistTest, AddAndCount)
+{
+    uint64_t sum[SLOTS] = { 0 };
+    uint64_t cpu0[SLOTS] = { 0 };
+    uint64_t cpu1[SLOTS] = { 0 };
+    cpu0[HistSlot(100, SLOTS)] = 3;
+    cpu1[HistSlot(100, SLOTS)] = 2;
+    cpu1[HistSlot(5000, SLOTS)] = 1;
+    AddHist(sum, cpu0, SLOTS);
+    AddHist(sum, cpu1, SLOTS);
+    EXPECT_EQ(sum[HistSlot(100, SLOTS)], 5);
+    EXPECT_EQ(sum[HistSlot(5000, SLOTS)], 1);
+    EXPECT_EQ(HistCount(sum, SLOTS), 6);
+}
+
+TEST(LatencyHistTest, Percentile)
+{
+    uint64_t hist[SLOTS] = { 0 };
+    EXPECT_EQ(HistPercentile(hist, SLOTS, 0.5), 0);
+    // 90 samples in [64, 128), 10 in [1024, 2048)
+    hist[HistSlot(100, SLOTS)] = 90;
+    hist[HistSlot(1500, SLOTS)] = 10;
+    EXPECT_EQ(HistPercentile(hist, SLOTS, 0.5), 127);
+    EXPECT_EQ(HistPercentile(hist, SLOTS, 0.9), 127);
+    EXPECT_EQ(HistPercentile(hist, SLOTS, 0.91), 2047);
+    EXPECT_EQ(HistPercentile(hist, SLOTS, 1), 2047);
+    // the last slot has no upper bound, its lower bound is reported
+    hist[SLOTS - 1] = 1000;
+    EXPECT_EQ(HistPercentile(hist, SLOTS, 0.99), 1ULL << (SLOTS - 1));
+}
@@ -0,0 +1,146 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <unistd.h>
+#include <bpf/bpf.h>
+#include <bpf/libbpf.h>
+#include "net_flow_comm.h"
+
+/*
+ * Reads of the net_interface flow maps, the key by key walk of a shared hash used before against draining a
+ * per-cpu hash with lookup_and_delete_batch. Only maps are created, no program is loaded and no nic is needed.
+ */
+namespace {
+constexpr uint32_t MAP_BATCH_SIZE = 256;
+constexpr size_t PERCPU_VALUE_ALIGN = 8;
+const std::vector<uint32_t> ENTRY_NUMS = { 1000, 10000, 60000 };
+
+class MapFd {
+public:
+    explicit MapFd(int fd) : fd(fd) { }
+    ~MapFd()
+    {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    int fd;
+};
+
+SockKey MakeKey(uint32_t n)
+{
+    SockKey key;
+    key.localIp = n;
+    key.remoteIp = ~n;
+    key.localPort = static_cast<uint16_t>(n);
+    key.remotePort = static_cast<uint16_t>(n >> 16);
+    return key;
+}
+
+double ElapsedUs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// the path before, get_next_key and lookup for every entry, the map is kept
+int ReadByKey(int fd)
+{
+    SockKey key;
+    SockKey prev;
+    SockInfo value;
+    const void *prevKey = nullptr;
+    int count = 0;
+    while (bpf_map_get_next_key(fd, prevKey, &key) == 0) {
+        if (bpf_map_lookup_elem(fd, &key, &value) == 0) {
+            count++;
+        }
+        prev = key;
+        prevKey = &prev;
+    }
+    return count;
+}
+
+// the current path, the map is emptied, -errno if the kernel does not support it
+int DrainByBatch(int fd, int cpuNum)
+{
+    size_t valueSize = (sizeof(SockInfo) + PERCPU_VALUE_ALIGN - 1) / PERCPU_VALUE_ALIGN * PERCPU_VALUE_ALIGN * cpuNum;
+    std::vector<SockKey> keys(MAP_BATCH_SIZE);
+    std::vector<char> values(valueSize * MAP_BATCH_SIZE);
+    DECLARE_LIBBPF_OPTS(bpf_map_batch_opts, opts, .elem_flags = 0, .flags = 0);
+    uint32_t inBatch = 0;
+    uint32_t outBatch = 0;
+    bool first = true;
+    int total = 0;
+    while (true) {
+        uint32_t count = MAP_BATCH_SIZE;
+        int err = bpf_map_lookup_and_delete_batch(fd, first ? nullptr : &inBatch, &outBatch, keys.data(),
+            values.data(), &count, &opts);
+        err = err < 0 ? errno : 0;
+        if (err != 0 && err != ENOENT) {
+            return -err;
+        }
+        total += count;
+        if (err == ENOENT) {
+            break;
+        }
+        inBatch = outBatch;
+        first = false;
+    }
+    return total;
+}
+}
+
+TEST(NetMapBench, BatchDrainAgainstKeyWalk)
+{
+    int cpuNum = libbpf_num_possible_cpus();
+    ASSERT_GT(cpuNum, 0);
+    SockInfo info = {};
+    info.flow = 1;
+    std::vector<SockInfo> percpuInfo(cpuNum, info);
+    printf("%10s %16s %16s %16s\n", "entries", "key walk(us)", "batch drain(us)", "speedup");
+    for (auto num : ENTRY_NUMS) {
+        MapFd shared(bpf_map_create(BPF_MAP_TYPE_HASH, "bench_shared", sizeof(SockKey), sizeof(SockInfo), num,
+            nullptr));
+        if (shared.fd < 0 && (errno == EPERM || errno == EACCES)) {
+            GTEST_SKIP() << "creating bpf maps needs CAP_BPF";
+        }
+        ASSERT_GE(shared.fd, 0) << "errno " << errno;
+        MapFd percpu(bpf_map_create(BPF_MAP_TYPE_PERCPU_HASH, "bench_percpu", sizeof(SockKey), sizeof(SockInfo),
+            num, nullptr));
+        ASSERT_GE(percpu.fd, 0) << "errno " << errno;
+        for (uint32_t n = 0; n < num; ++n) {
+            SockKey key = MakeKey(n);
+            ASSERT_EQ(bpf_map_update_elem(shared.fd, &key, &info, BPF_ANY), 0);
+            ASSERT_EQ(bpf_map_update_elem(percpu.fd, &key, percpuInfo.data(), BPF_ANY), 0);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        int walked = ReadByKey(shared.fd);
+        double walkUs = ElapsedUs(start);
+        start = std::chrono::steady_clock::now();
+        int drained = DrainByBatch(percpu.fd, cpuNum);
+        double batchUs = ElapsedUs(start);
+        if (drained == -EINVAL || drained == -ENOTSUP || drained == -EOPNOTSUPP) {
+            GTEST_SKIP() << "lookup_and_delete_batch is not supported by the kernel";
+        }
+        EXPECT_EQ(walked, static_cast<int>(num));
+        EXPECT_EQ(drained, static_cast<int>(num));
+        SockKey key;
+        EXPECT_NE(bpf_map_get_next_key(percpu.fd, nullptr, &key), 0);
+        printf("%10u %16.0f %16.0f %15.1fx\n", num, walkUs, batchUs, batchUs > 0 ? walkUs / batchUs : 0);
+    }
+}
@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <fstream>
+#include <cstdlib>
+#include <sys/stat.h>
+#include "net_steering.h"
+
+using namespace oeaware;
+
+class NetSteeringTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/net_steering_XXXXXX";
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        root = tmpl;
+        for (auto dir : { "/net", "/net/eth0", "/net/eth0/queues", "/net/eth0/queues/rx-0",
+            "/net/eth0/queues/tx-0", "/core" }) {
+            mkdir((root + dir).c_str(), 0755);
+        }
+        Write("/net/eth0/queues/rx-0/rps_cpus", "00000000");
+        Write("/net/eth0/queues/rx-0/rps_flow_cnt", "0");
+        Write("/net/eth0/queues/tx-0/xps_cpus", "00000000");
+        Write("/core/rps_sock_flow_entries", "0");
+    }
+    void TearDown() override
+    {
+        std::string cmd = "rm -rf " + root;
+        (void)system(cmd.c_str());
+    }
+    void Write(const std::string &path, const std::string &value)
+    {
+        std::ofstream file(root + path);
+        file << value << "\n";
+    }
+    std::string Read(const std::string &path)
+    {
+        std::ifstream file(root + path);
+        std::string value;
+        std::getline(file, value);
+        return value;
+    }
+    std::string root;
+};
+
+TEST_F(NetSteeringTest, CpusToMask)
+{
+    EXPECT_EQ(NetSteering::CpusToMask({}), "00000000");
+    EXPECT_EQ(NetSteering::CpusToMask({ 0, 1, 2, 3 }), "0000000f");
+    EXPECT_EQ(NetSteering::CpusToMask({ 0, 32, 65 }), "00000002,00000001,00000001");
+}
+
+TEST_F(NetSteeringTest, SetAndRestore)
+{
+    NetSteering steering(root + "/net/", root + "/core/");
+    ASSERT_TRUE(steering.SetSockFlowEntries(32768));
+    ASSERT_TRUE(steering.SetRxQueue("eth0", 0, { 4, 5, 6, 7 }, 4096));
+    ASSERT_TRUE(steering.SetTxQueue("eth0", 0, { 4, 5, 6, 7 }));
+    EXPECT_FALSE(steering.SetTxQueue("eth0", 1, { 0 }));
+    EXPECT_EQ(Read("/core/rps_sock_flow_entries"), "32768");
+    EXPECT_EQ(Read("/net/eth0/queues/rx-0/rps_cpus"), "000000f0");
+    EXPECT_EQ(Read("/net/eth0/queues/rx-0/rps_flow_cnt"), "4096");
+    EXPECT_EQ(Read("/net/eth0/queues/tx-0/xps_cpus"), "000000f0");
+
+    // the value before the first write is restored
+    ASSERT_TRUE(steering.SetRxQueue("eth0", 0, { 0 }, 4096));
+    EXPECT_EQ(Read("/net/eth0/queues/rx-0/rps_cpus"), "00000001");
+    steering.Restore();
+    EXPECT_EQ(Read("/core/rps_sock_flow_entries"), "0");
+    EXPECT_EQ(Read("/net/eth0/queues/rx-0/rps_cpus"), "00000000");
+    EXPECT_EQ(Read("/net/eth0/queues/rx-0/rps_flow_cnt"), "0");
+    EXPECT_EQ(Read("/net/eth0/queues/tx-0/xps_cpus"), "00000000");
+}
+
+TEST_F(NetSteeringTest, KeepLargerFlowTable)
+{
+    Write("/core/rps_sock_flow_entries", "65536");
+    NetSteering steering(root + "/net/", root + "/core/");
+    ASSERT_TRUE(steering.SetSockFlowEntries(32768));
+    EXPECT_EQ(Read("/core/rps_sock_flow_entries"), "65536");
+}
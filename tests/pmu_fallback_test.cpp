@@ -0,0 +1,149 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include "pmu_fallback.h"
+
+class PmuFallbackTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/pmu_fallback_XXXXXX";
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        root = tmpl;
+        WriteSchedstat(1000, 3000);
+        Write("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq", "2000000\n");
+        Write("/sys/devices/system/cpu/cpu1/cpufreq/scaling_cur_freq", "1000000\n");
+        Write("/sys/kernel/tracing/events/sched/sched_process_fork/id", "312\n");
+        Write("/sys/kernel/debug/tracing/events/net/netif_rx/id", "1420\n");
+    }
+    void TearDown() override
+    {
+        std::string cmd = "rm -rf " + root;
+        (void)system(cmd.c_str());
+    }
+    void Write(const std::string &path, const std::string &value)
+    {
+        auto dir = root + path.substr(0, path.rfind('/'));
+        std::string cmd = "mkdir -p " + dir;
+        ASSERT_EQ(system(cmd.c_str()), 0);
+        std::ofstream file(root + path);
+        file << value;
+    }
+    void WriteSchedstat(uint64_t cpu0RunNs, uint64_t cpu1RunNs)
+    {
+        Write("/proc/schedstat", "version 15\ntimestamp 4295\n"
+            "cpu0 0 0 0 0 0 0 " + std::to_string(cpu0RunNs) + " 200 10\n"
+            "domain0 00000003 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n"
+            "cpu1 0 0 0 0 0 0 " + std::to_string(cpu1RunNs) + " 400 20\n");
+    }
+    std::string root;
+};
+
+TEST_F(PmuFallbackTest, ReadSchedstat)
+{
+    CyclesEstimate estimate(2, root);
+    std::vector<uint64_t> runNs;
+    ASSERT_TRUE(estimate.ReadSchedstat(runNs));
+    ASSERT_EQ(runNs.size(), 2U);
+    EXPECT_EQ(runNs[0], 1000U);
+    EXPECT_EQ(runNs[1], 3000U);
+
+    // cpus missing in the file are left at 0.
+    CyclesEstimate more(4, root);
+    ASSERT_TRUE(more.ReadSchedstat(runNs));
+    ASSERT_EQ(runNs.size(), 4U);
+    EXPECT_EQ(runNs[3], 0U);
+
+    CyclesEstimate missing(2, root + "/none");
+    EXPECT_FALSE(missing.ReadSchedstat(runNs));
+    EXPECT_FALSE(missing.Init());
+}
+
+TEST_F(PmuFallbackTest, ReadCyclesEstimate)
+{
+    CyclesEstimate estimate(2, root);
+    ASSERT_TRUE(estimate.Init());
+    WriteSchedstat(1500, 3600);
+    std::vector<uint64_t> cycles;
+    ASSERT_TRUE(estimate.Read(cycles));
+    ASSERT_EQ(cycles.size(), 2U);
+    // 500 ns at 2 GHz and 600 ns at 1 GHz.
+    EXPECT_EQ(cycles[0], 1000U);
+    EXPECT_EQ(cycles[1], 600U);
+
+    // the run time went backwards, e.g. the cpu was hotplugged.
+    WriteSchedstat(100, 3700);
+    ASSERT_TRUE(estimate.Read(cycles));
+    EXPECT_EQ(cycles[0], 0U);
+    EXPECT_EQ(cycles[1], 100U);
+}
+
+TEST_F(PmuFallbackTest, GetEventConfig)
+{
+    CountingFallback fallback(root);
+    uint32_t type = 0;
+    uint64_t config = 0;
+    ASSERT_TRUE(fallback.GetEventConfig("cycles", type, config));
+    EXPECT_EQ(type, static_cast<uint32_t>(PERF_TYPE_HARDWARE));
+    EXPECT_EQ(config, static_cast<uint64_t>(PERF_COUNT_HW_CPU_CYCLES));
+    ASSERT_TRUE(fallback.GetEventConfig("dTLB-load-misses", type, config));
+    EXPECT_EQ(type, static_cast<uint32_t>(PERF_TYPE_HW_CACHE));
+    EXPECT_EQ(config, static_cast<uint64_t>(PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)));
+#ifdef __aarch64__
+    ASSERT_TRUE(fallback.GetEventConfig("l1d_tlb", type, config));
+    EXPECT_EQ(type, static_cast<uint32_t>(PERF_TYPE_RAW));
+    EXPECT_EQ(config, 0x25U);
+#endif
+    ASSERT_TRUE(fallback.GetEventConfig("sched:sched_process_fork", type, config));
+    EXPECT_EQ(type, static_cast<uint32_t>(PERF_TYPE_TRACEPOINT));
+    EXPECT_EQ(config, 312U);
+    // tracefs mounted under debugfs only.
+    ASSERT_TRUE(fallback.GetEventConfig("net:netif_rx", type, config));
+    EXPECT_EQ(config, 1420U);
+    EXPECT_FALSE(fallback.GetEventConfig("sched:sched_process_exit", type, config));
+    EXPECT_FALSE(fallback.GetEventConfig("unknown_event", type, config));
+
+    std::string err;
+    EXPECT_FALSE(fallback.Open("sched:sched_process_exit", err));
+    EXPECT_EQ(err, "tracepoint sched:sched_process_exit is not found in tracefs");
+}
+
+TEST(PmuSamplingFallback, SampleTask)
+{
+    SamplingFallback fallback;
+    std::string err;
+    // cycles falls back to the cpu clock without a cycles counter.
+    if (!fallback.Open("cycles", {getpid()}, 1000, true, true, err)) {
+        GTEST_SKIP() << "perf_event_open is not permitted, " << err;
+    }
+    auto begin = std::chrono::steady_clock::now();
+    volatile uint64_t sum = 0;
+    while (std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(200)) {
+        sum = sum + 1;
+    }
+    PmuData *data = nullptr;
+    int len = fallback.Read(data);
+    ASSERT_GT(len, 0);
+    for (int i = 0; i < len; ++i) {
+        EXPECT_STREQ(data[i].evt, "cycles");
+        EXPECT_EQ(data[i].pid, getpid());
+        ASSERT_NE(data[i].stack, nullptr);
+        EXPECT_NE(data[i].stack->symbol->addr, 0U);
+        EXPECT_EQ(data[i].rawData, nullptr);
+    }
+}
@@ -0,0 +1,102 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "queue_plan.h"
+
+using namespace oeaware;
+
+namespace {
+AppRx MakeApp(int pid, uint64_t rxPackets, int node)
+{
+    AppRx app;
+    app.pid = pid;
+    app.rxPackets = rxPackets;
+    app.nodeRunTime = { 0, 0 };
+    app.nodeRunTime[node] = 1000000;
+    return app;
+}
+}
+
+TEST(QueuePlanTest, SplitQueuesByDemand)
+{
+    QueuePlanner planner(2);
+    planner.Update({ MakeApp(100, 3000, 0), MakeApp(200, 1000, 1) });
+    EXPECT_EQ(planner.GetHome(100), 0);
+    EXPECT_EQ(planner.GetHome(200), 1);
+    auto plan = planner.Assign(8, {});
+    EXPECT_EQ(std::count(plan.begin(), plan.end(), 0), 6);
+    EXPECT_EQ(std::count(plan.begin(), plan.end(), 1), 2);
+
+    // a small app still gets one queue on its node
+    QueuePlanner small(2);
+    small.Update({ MakeApp(100, 100000, 0), MakeApp(200, 10, 1) });
+    plan = small.Assign(4, {});
+    EXPECT_EQ(std::count(plan.begin(), plan.end(), 1), 1);
+}
+
+TEST(QueuePlanTest, KeepQueuesOnTheirNode)
+{
+    QueuePlanner planner(2);
+    planner.Update({ MakeApp(100, 1000, 0), MakeApp(200, 1000, 1) });
+    std::vector<int> current = { 1, 0, 1, 0 };
+    auto plan = planner.Assign(4, current);
+    EXPECT_EQ(plan, current);
+
+    // node 1 needs one queue less, only one queue moves
+    planner.Update({ MakeApp(100, 3000, 0), MakeApp(200, 1000, 1) });
+    plan = planner.Assign(4, current);
+    int moved = 0;
+    for (size_t q = 0; q < plan.size(); ++q) {
+        moved += plan[q] != current[q];
+    }
+    EXPECT_EQ(moved, 1);
+    EXPECT_EQ(std::count(plan.begin(), plan.end(), 0), 3);
+}
+
+TEST(QueuePlanTest, FollowThreadsWithMargin)
+{
+    QueuePlanner planner(2);
+    planner.Update({ MakeApp(100, 1000, 0) });
+    AppRx app = MakeApp(100, 1000, 0);
+    // slightly more on node 1 is not enough to move
+    app.nodeRunTime = { 1000, 1100 };
+    planner.Update({ app });
+    EXPECT_EQ(planner.GetHome(100), 0);
+    app.nodeRunTime = { 1000, 2000 };
+    planner.Update({ app });
+    EXPECT_EQ(planner.GetHome(100), 1);
+    auto plan = planner.Assign(2, { 0, 0 });
+    EXPECT_EQ(plan, std::vector<int>({ 1, 1 }));
+}
+
+TEST(QueuePlanTest, ReleaseIdleApps)
+{
+    QueuePlanOption option;
+    option.idleRuns = 3;
+    QueuePlanner planner(2, option);
+    planner.Update({ MakeApp(100, 1000, 0), MakeApp(200, 1000, 1) });
+    for (int i = 0; i < option.idleRuns; ++i) {
+        planner.Update({ MakeApp(100, 1000, 0) });
+    }
+    EXPECT_EQ(planner.AppCount(), 1);
+    EXPECT_EQ(planner.GetHome(200), -1);
+    auto plan = planner.Assign(4, { 0, 1, 0, 1 });
+    EXPECT_EQ(plan, std::vector<int>({ 0, 0, 0, 0 }));
+
+    // without apps every queue goes back to its original affinity
+    for (int i = 0; i < option.idleRuns; ++i) {
+        planner.Update({});
+    }
+    plan = planner.Assign(4, plan);
+    EXPECT_EQ(plan, std::vector<int>({ -1, -1, -1, -1 }));
+}
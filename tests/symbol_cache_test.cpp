@@ -0,0 +1,54 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <unistd.h>
+#include "symbol_cache.h"
+
+extern "C" __attribute__((noinline)) int SymbolCacheTestTarget(int value)
+{
+    return value + 1;
+}
+
+TEST(SymbolCacheTest, ResolveSelf)
+{
+    auto &cache = oeaware::SymbolCache::GetInstance();
+    cache.Clear();
+    std::string symbol;
+    std::string module;
+    auto addr = reinterpret_cast<uint64_t>(&SymbolCacheTestTarget);
+    ASSERT_TRUE(cache.Resolve(getpid(), addr, symbol, module));
+    EXPECT_EQ(symbol, "SymbolCacheTestTarget");
+    EXPECT_NE(module.find("symbol_cache_test"), std::string::npos);
+    EXPECT_EQ(cache.GetHits(), 0U);
+    EXPECT_EQ(cache.GetMisses(), 1U);
+    // the second lookup of the same address is served from the cache.
+    symbol.clear();
+    ASSERT_TRUE(cache.Resolve(getpid(), addr, symbol, module));
+    EXPECT_EQ(symbol, "SymbolCacheTestTarget");
+    EXPECT_EQ(cache.GetHits(), 1U);
+    EXPECT_EQ(cache.GetMisses(), 1U);
+    // another offset in the same function reads the symbol table.
+    ASSERT_TRUE(cache.Resolve(getpid(), addr + 1, symbol, module));
+    EXPECT_EQ(symbol, "SymbolCacheTestTarget");
+    EXPECT_EQ(cache.GetMisses(), 2U);
+    cache.Clear();
+    EXPECT_EQ(cache.GetHits(), 0U);
+}
+
+TEST(SymbolCacheTest, ResolveUnmapped)
+{
+    std::string symbol;
+    std::string module;
+    EXPECT_FALSE(oeaware::SymbolCache::GetInstance().Resolve(getpid(), 0, symbol, module));
+    EXPECT_FALSE(oeaware::SymbolCache::GetInstance().Resolve(-1, 0, symbol, module));
+}
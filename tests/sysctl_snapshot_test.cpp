@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+ * oeAware is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
+#include "sysctl_snapshot.h"
+#include "native_cmd.h"
+
+class SysctlSnapshotTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/sysctl_snapshot_XXXXXX";
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        root = tmpl;
+        mkdir((root + "/net").c_str(), 0755);
+        mkdir((root + "/net/eth0.100").c_str(), 0755);
+        Write("net/eth0.100/mtu", "1500\n");
+        Write("vm_swappiness", "60\n");
+    }
+    void TearDown() override
+    {
+        std::string cmd = "rm -rf " + root;
+        (void)system(cmd.c_str());
+    }
+    void Write(const std::string &path, const std::string &value)
+    {
+        std::ofstream file(root + "/" + path);
+        file << value;
+    }
+    std::string root;
+};
+
+TEST_F(SysctlSnapshotTest, ChangedSince)
+{
+    SysctlSnapshot snapshot(root);
+    ASSERT_TRUE(snapshot.Refresh());
+    uint64_t first = snapshot.GetVersion();
+    std::string value;
+    ASSERT_TRUE(snapshot.Get("net.eth0/100.mtu", value));
+    EXPECT_EQ(value, "1500");
+    EXPECT_EQ(snapshot.ChangedSince(0, {}).size(), 2);
+
+    ASSERT_TRUE(snapshot.Refresh());
+    EXPECT_EQ(snapshot.GetVersion(), first);
+    EXPECT_TRUE(snapshot.ChangedSince(first, {}).empty());
+
+    Write("vm_swappiness", "10\n");
+    ASSERT_TRUE(snapshot.Refresh());
+    EXPECT_GT(snapshot.GetVersion(), first);
+    auto keys = snapshot.ChangedSince(first, {});
+    ASSERT_EQ(keys.size(), 1);
+    EXPECT_EQ(keys[0], "vm_swappiness");
+    EXPECT_TRUE(snapshot.ChangedSince(first, {"net"}).empty());
+}
+
+TEST_F(SysctlSnapshotTest, NativeCmd)
+{
+    std::string output;
+    EXPECT_TRUE(NativeCmd::Run({"cat " + root + "/vm_swappiness", "grep 6"}, output));
+    EXPECT_EQ(output, "60\n");
+    EXPECT_FALSE(NativeCmd::Run({"cat " + root + "/*"}, output));
+    EXPECT_FALSE(NativeCmd::Run({"grep 6"}, output));
+    EXPECT_FALSE(NativeCmd::Run({"ethtool -k eth0"}, output));
+    // the native summary is shorter than lscpu, a plain lscpu runs the real command
+    EXPECT_FALSE(NativeCmd::Run({"lscpu"}, output));
+    EXPECT_TRUE(NativeCmd::Run({"lscpu", "grep Architecture"}, output));
+    EXPECT_EQ(output.compare(0, strlen("Architecture:"), "Architecture:"), 0);
+    // a line the native summary does not have is left to the real lscpu
+    EXPECT_FALSE(NativeCmd::Run({"lscpu", "grep NoSuchField"}, output));
+}
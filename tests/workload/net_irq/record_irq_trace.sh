@@ -0,0 +1,69 @@
+#!/bin/bash
+# Copyright (c) 2025 Huawei Technologies Co., Ltd. All rights reserved.
+# oeAware is licensed under Mulan PSL v2.
+# You can use this software according to the terms and conditions of the Mulan PSL v2.
+# You may obtain a copy of Mulan PSL v2 at:
+#          http://license.coscl.org.cn/MulanPSL2
+# THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+# EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+# MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+# See the Mulan PSL v2 for more details.
+#
+# Record the cpu utilization and the rx irqs of a net device in the trace format replayed by irq_assign_test:
+#   topology <cpu> <node> <core> <cluster>
+#   period
+#   cpu <cpu> <idle> <irq> <softirq>      percent of the period, as env_info_collector::cpu_util
+#   queue <irq> <count> <node>           hard irqs of the rx queue in the period and the numa node of the device
+# usage: record_irq_trace.sh <dev> <irq desc regex, the first group is the queue> <periods> [interval s] > trace
+# example: record_irq_trace.sh eth0 'virtio3-input\.([0-9]+)' 10 1
+
+dev=$1
+pattern=$2
+periods=$3
+interval=${4:-1}
+if [ -z "$dev" ] || [ -z "$pattern" ] || [ -z "$periods" ]; then
+    echo "usage: $0 <dev> <irq desc regex> <periods> [interval s]" >&2
+    exit 1
+fi
+
+first_cpu() {
+    [ -f "$1" ] && sed 's/[,-].*//' "$1" || echo -1
+}
+
+node=$(cat /sys/class/net/"$dev"/device/numa_node 2>/dev/null || \
+    cat /sys/class/net/"$dev"/device/../numa_node 2>/dev/null || echo -1)
+[ "$node" -lt 0 ] && node=0
+
+for dir in /sys/devices/system/cpu/cpu[0-9]*; do
+    cpu=${dir##*cpu}
+    [ -f "$dir/online" ] && [ "$(cat "$dir/online")" = "0" ] && continue
+    cpu_node=$(ls -d "$dir"/node* 2>/dev/null | head -1 | sed 's/.*node//')
+    echo "topology $cpu ${cpu_node:-0} $(first_cpu "$dir/topology/thread_siblings_list")" \
+        "$(first_cpu "$dir/topology/cluster_cpus_list")"
+done | sort -n -k2
+
+snapshot() {
+    grep '^cpu[0-9]' /proc/stat
+    grep -E "$pattern" /proc/interrupts | sed 's/^ *\([0-9]*\):/irq \1/'
+}
+
+prev=$(snapshot)
+for ((p = 0; p < periods; p++)); do
+    sleep "$interval"
+    cur=$(snapshot)
+    echo "period"
+    awk -v pattern="$pattern" -v node="$node" '
+        # cpuN user nice system idle iowait irq softirq steal
+        FNR == NR && /^cpu/ { for (i = 2; i <= 9; i++) old[$1, i] = $i; next }
+        FNR == NR && /^irq/ { for (i = 3; $i ~ /^[0-9]+$/; i++) oldIrq[$2] += $i; next }
+        /^cpu/ {
+            total = 0
+            for (i = 2; i <= 9; i++) { d[i] = $i - old[$1, i]; total += d[i] }
+            if (total == 0) total = 1
+            printf "cpu %s %.2f %.2f %.2f\n", substr($1, 4), d[5] * 100 / total, d[7] * 100 / total,
+                d[8] * 100 / total
+        }
+        /^irq/ { sum = 0; for (i = 3; $i ~ /^[0-9]+$/; i++) sum += $i; printf "queue %s %d %d\n", $2, sum - oldIrq[$2], node }
+    ' <(echo "$prev") <(echo "$cur")
+    prev=$cur
+done